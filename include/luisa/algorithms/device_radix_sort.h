@@ -0,0 +1,121 @@
+#pragma once
+
+#include <luisa/algorithms/device_scan.h>
+
+namespace luisa::compute {
+
+/**
+ * @brief Stable least-significant-digit radix sort of uint keys, optionally with uint values.
+ *
+ * Each pass sorts by a 4-bit digit: every thread counts the digits of its
+ * tile, the digit-major histogram (all tiles of digit 0, then of digit 1,
+ * ...) is exclusive-scanned into scatter offsets, and every thread then
+ * walks its tile again to scatter in order, which keeps the sort stable.
+ * Values usually carry indices into a payload, e.g., sort-by-material.
+ */
+class DeviceRadixSort {
+
+public:
+    static constexpr auto digit_bits = 4u;
+    static constexpr auto digit_count = 1u << digit_bits;
+
+private:
+    uint _tile_size;
+    DeviceScan<uint> _scan;
+    // (keys, histogram, n, tile_size, tile_count, shift, mask)
+    Shader1D<Buffer<uint>, Buffer<uint>, uint, uint, uint, uint, uint> _count;
+    // (keys_in, values_in, keys_out, values_out, offsets, n, tile_size, tile_count, shift, mask, has_values)
+    Shader1D<Buffer<uint>, Buffer<uint>, Buffer<uint>, Buffer<uint>, Buffer<uint>,
+             uint, uint, uint, uint, uint, uint>
+        _scatter;
+
+private:
+    void _sort(CommandList &list, BufferArena &arena,
+               BufferView<uint> keys, BufferView<uint> values, bool has_values,
+               uint begin_bit, uint end_bit) noexcept {
+        LUISA_ASSERT(begin_bit < end_bit && end_bit <= 32u, "Invalid key bit range [{}, {}).", begin_bit, end_bit);
+        auto n = static_cast<uint>(keys.size());
+        if (n <= 1u) { return; }
+        auto tile_count = (n + _tile_size - 1u) / _tile_size;
+        auto histogram = arena.allocate_transient<uint>(tile_count * digit_count);
+        auto keys_tmp = arena.allocate_transient<uint>(n);
+        auto values_tmp = has_values ? arena.allocate_transient<uint>(n) : keys_tmp;
+        auto keys_in = keys, keys_out = keys_tmp;
+        auto values_in = has_values ? values : keys_in;
+        auto values_out = has_values ? values_tmp : keys_out;
+        auto pass_count = 0u;
+        for (auto shift = begin_bit; shift < end_bit; shift += digit_bits) {
+            // the last digit may be narrower, so that bits past end_bit are ignored
+            auto mask = (1u << std::min(digit_bits, end_bit - shift)) - 1u;
+            list << _count(keys_in, histogram, n, _tile_size, tile_count, shift, mask).dispatch(tile_count);
+            _scan.exclusive_sum(list, arena, histogram, histogram);
+            list << _scatter(keys_in, values_in, keys_out, values_out, histogram,
+                             n, _tile_size, tile_count, shift, mask, has_values ? 1u : 0u)
+                        .dispatch(tile_count);
+            std::swap(keys_in, keys_out);
+            if (has_values) { std::swap(values_in, values_out); }
+            pass_count++;
+        }
+        // an odd number of passes leaves the result in the temporary buffers
+        if (pass_count % 2u == 1u) {
+            list << keys.copy_from(keys_tmp);
+            if (has_values) { list << values.copy_from(values_tmp); }
+        }
+    }
+
+public:
+    explicit DeviceRadixSort(Device &device, uint tile_size = 256u) noexcept
+        : _tile_size{std::max(tile_size, 1u)},
+          _scan{device},
+          _count{device.compile<1>([](BufferUInt keys, BufferUInt histogram,
+                                      UInt n, UInt tile_size, UInt tile_count, UInt shift, UInt mask) noexcept {
+              auto tile = dispatch_id().x;
+              auto begin = tile * tile_size;
+              auto end = min(begin + tile_size, n);
+              ArrayUInt<digit_count> counts;
+              for (auto d = 0u; d < digit_count; d++) { counts[d] = 0u; }
+              for (auto i : dynamic_range(begin, end)) {
+                  auto d = (keys.read(i) >> shift) & mask;
+                  counts[d] += 1u;
+              }
+              for (auto d = 0u; d < digit_count; d++) {
+                  histogram.write(d * tile_count + tile, counts[d]);
+              }
+          })},
+          _scatter{device.compile<1>([](BufferUInt keys_in, BufferUInt values_in,
+                                        BufferUInt keys_out, BufferUInt values_out, BufferUInt offsets,
+                                        UInt n, UInt tile_size, UInt tile_count, UInt shift, UInt mask,
+                                        UInt has_values) noexcept {
+              auto tile = dispatch_id().x;
+              auto begin = tile * tile_size;
+              auto end = min(begin + tile_size, n);
+              ArrayUInt<digit_count> next;
+              for (auto d = 0u; d < digit_count; d++) {
+                  next[d] = offsets.read(d * tile_count + tile);
+              }
+              for (auto i : dynamic_range(begin, end)) {
+                  auto key = keys_in.read(i);
+                  auto d = (key >> shift) & mask;
+                  auto index = def(next[d]);
+                  next[d] = index + 1u;
+                  keys_out.write(index, key);
+                  if_(has_values != 0u, [&] { values_out.write(index, values_in.read(i)); });
+              }
+          })} {}
+
+    /// Sort keys in [begin_bit, end_bit) ascending; the other bits are ignored
+    void sort_keys(CommandList &list, BufferArena &arena, BufferView<uint> keys,
+                   uint begin_bit = 0u, uint end_bit = 32u) noexcept {
+        _sort(list, arena, keys, keys, false, begin_bit, end_bit);
+    }
+
+    /// Sort key-value pairs by keys in [begin_bit, end_bit) ascending
+    void sort_pairs(CommandList &list, BufferArena &arena,
+                    BufferView<uint> keys, BufferView<uint> values,
+                    uint begin_bit = 0u, uint end_bit = 32u) noexcept {
+        LUISA_ASSERT(values.size() == keys.size(), "Key and value counts mismatch.");
+        _sort(list, arena, keys, values, true, begin_bit, end_bit);
+    }
+};
+
+}// namespace luisa::compute
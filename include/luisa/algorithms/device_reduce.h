@@ -0,0 +1,104 @@
+#pragma once
+
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/shader.h>
+#include <luisa/runtime/command_list.h>
+#include <luisa/runtime/buffer_arena.h>
+#include <luisa/dsl/syntax.h>
+
+namespace luisa::compute {
+
+enum struct ReduceOp : uint {
+    SUM,
+    MIN,
+    MAX,
+};
+
+/**
+ * @brief Device-wide and segmented reductions.
+ *
+ * Like DeviceScan, each thread folds a contiguous tile and partial results
+ * are reduced recursively with transient buffers taken from the arena.
+ */
+template<typename T>
+class DeviceReduce {
+
+    static_assert(is_scalar_v<T> || is_vector_v<T>);
+
+private:
+    uint _tile_size;
+    // (in, out, n, tile_size, op)
+    Shader1D<Buffer<T>, Buffer<T>, uint, uint, uint> _reduce_tiles;
+    // (in, segment_offsets, out, init, op)
+    Shader1D<Buffer<T>, Buffer<uint>, Buffer<T>, T, uint> _reduce_segments;
+
+private:
+    [[nodiscard]] static auto _combine(Expr<uint> op, Expr<T> lhs, Expr<T> rhs) noexcept {
+        auto r = def(lhs);
+        if_(op == to_underlying(ReduceOp::SUM), [&] {
+            r = lhs + rhs;
+        }).else_([&] {
+            if_(op == to_underlying(ReduceOp::MIN), [&] {
+                r = min(lhs, rhs);
+            }).else_([&] {
+                r = max(lhs, rhs);
+            });
+        });
+        return r;
+    }
+
+public:
+    explicit DeviceReduce(Device &device, uint tile_size = 32u) noexcept
+        : _tile_size{std::max(tile_size, 1u)},
+          _reduce_tiles{device.compile<1>([](BufferVar<T> in, BufferVar<T> out, UInt n, UInt tile_size, UInt op) noexcept {
+              auto tile = dispatch_id().x;
+              auto begin = tile * tile_size;
+              auto end = min(begin + tile_size, n);
+              auto r = def(in.read(begin));
+              for (auto i : dynamic_range(begin + 1u, end)) { r = _combine(op, r, in.read(i)); }
+              out.write(tile, r);
+          })},
+          _reduce_segments{device.compile<1>([](BufferVar<T> in, BufferVar<uint> segment_offsets,
+                                                BufferVar<T> out, Var<T> init, UInt op) noexcept {
+              auto segment = dispatch_id().x;
+              auto r = def(init);
+              auto begin = segment_offsets.read(segment);
+              auto end = segment_offsets.read(segment + 1u);
+              for (auto i : dynamic_range(begin, end)) { r = _combine(op, r, in.read(i)); }
+              out.write(segment, r);
+          })} {}
+
+    /// out[0] = in[0] op ... op in[n - 1]; in must not be empty
+    void reduce(CommandList &list, BufferArena &arena,
+                BufferView<T> in, BufferView<T> out, ReduceOp op = ReduceOp::SUM) noexcept {
+        LUISA_ASSERT(!in.empty() && !out.empty(), "Invalid reduction input or output.");
+        auto n = static_cast<uint>(in.size());
+        auto tile_count = (n + _tile_size - 1u) / _tile_size;
+        if (tile_count == 1u) {
+            list << _reduce_tiles(in, out, n, _tile_size, to_underlying(op)).dispatch(1u);
+            return;
+        }
+        auto partials = arena.allocate_transient<T>(tile_count);
+        list << _reduce_tiles(in, partials, n, _tile_size, to_underlying(op)).dispatch(tile_count);
+        reduce(list, arena, partials, out, op);
+    }
+
+    /**
+     * @brief Reduce each segment [offsets[i], offsets[i + 1]) of the input into out[i].
+     *
+     * Segments are given as CSR offsets with one more entry than the number
+     * of segments. Empty segments produce init, which is also folded into
+     * every non-empty segment and should therefore be the identity of op.
+     */
+    void segmented_reduce(CommandList &list, BufferView<T> in,
+                          BufferView<uint> segment_offsets, BufferView<T> out,
+                          T init, ReduceOp op = ReduceOp::SUM) noexcept {
+        LUISA_ASSERT(!segment_offsets.empty() && out.size() + 1u >= segment_offsets.size(),
+                     "Invalid segment offsets or output.");
+        auto segment_count = static_cast<uint>(segment_offsets.size() - 1u);
+        if (segment_count == 0u) { return; }
+        list << _reduce_segments(in, segment_offsets, out, init, to_underlying(op)).dispatch(segment_count);
+    }
+};
+
+}// namespace luisa::compute
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/shader.h>
+#include <luisa/runtime/command_list.h>
+#include <luisa/runtime/buffer_arena.h>
+#include <luisa/dsl/syntax.h>
+
+namespace luisa::compute {
+
+/**
+ * @brief Device-wide prefix sums.
+ *
+ * Every thread scans a contiguous tile of the input, so the primitive
+ * needs neither shared memory nor block synchronization and runs on all
+ * backends. Tile sums are scanned recursively, with transient buffers
+ * taken from the arena, which must outlive the execution of the commands
+ * and recycles the buffers in BufferArena::end_frame().
+ */
+template<typename T>
+class DeviceScan {
+
+    static_assert(is_scalar_v<T> || is_vector_v<T>);
+
+private:
+    uint _tile_size;
+    // (in, sums, n, tile_size)
+    Shader1D<Buffer<T>, Buffer<T>, uint, uint> _reduce_tiles;
+    // (in, out, offsets, n, tile_size, use_offsets, inclusive)
+    Shader1D<Buffer<T>, Buffer<T>, Buffer<T>, uint, uint, uint, uint> _scan_tiles;
+
+private:
+    void _scan(CommandList &list, BufferArena &arena,
+               BufferView<T> in, BufferView<T> out, bool inclusive) noexcept {
+        LUISA_ASSERT(out.size() >= in.size(), "Scan output is too small.");
+        auto n = static_cast<uint>(in.size());
+        if (n == 0u) { return; }
+        auto tile_count = (n + _tile_size - 1u) / _tile_size;
+        if (tile_count == 1u) {
+            list << _scan_tiles(in, out, out, n, _tile_size, 0u, inclusive ? 1u : 0u).dispatch(1u);
+            return;
+        }
+        auto sums = arena.allocate_transient<T>(tile_count);
+        list << _reduce_tiles(in, sums, n, _tile_size).dispatch(tile_count);
+        _scan(list, arena, sums, sums, false);
+        list << _scan_tiles(in, out, sums, n, _tile_size, 1u, inclusive ? 1u : 0u).dispatch(tile_count);
+    }
+
+public:
+    explicit DeviceScan(Device &device, uint tile_size = 32u) noexcept
+        : _tile_size{std::max(tile_size, 1u)},
+          _reduce_tiles{device.compile<1>([](BufferVar<T> in, BufferVar<T> sums, UInt n, UInt tile_size) noexcept {
+              auto tile = dispatch_id().x;
+              auto begin = tile * tile_size;
+              auto end = min(begin + tile_size, n);
+              auto sum = def<T>(T{});
+              for (auto i : dynamic_range(begin, end)) { sum += in.read(i); }
+              sums.write(tile, sum);
+          })},
+          _scan_tiles{device.compile<1>([](BufferVar<T> in, BufferVar<T> out, BufferVar<T> offsets,
+                                           UInt n, UInt tile_size, UInt use_offsets, UInt inclusive) noexcept {
+              auto tile = dispatch_id().x;
+              auto begin = tile * tile_size;
+              auto end = min(begin + tile_size, n);
+              auto sum = def<T>(T{});
+              if_(use_offsets != 0u, [&] { sum = offsets.read(tile); });
+              // in and out may alias, so read before writing
+              for (auto i : dynamic_range(begin, end)) {
+                  auto x = in.read(i);
+                  if_(inclusive != 0u, [&] {
+                      sum += x;
+                      out.write(i, sum);
+                  }).else_([&] {
+                      out.write(i, sum);
+                      sum += x;
+                  });
+              }
+          })} {}
+
+    /// out[i] = in[0] + ... + in[i - 1]; in and out may alias
+    void exclusive_sum(CommandList &list, BufferArena &arena,
+                       BufferView<T> in, BufferView<T> out) noexcept {
+        _scan(list, arena, in, out, false);
+    }
+
+    /// out[i] = in[0] + ... + in[i]; in and out may alias
+    void inclusive_sum(CommandList &list, BufferArena &arena,
+                       BufferView<T> in, BufferView<T> out) noexcept {
+        _scan(list, arena, in, out, true);
+    }
+};
+
+}// namespace luisa::compute
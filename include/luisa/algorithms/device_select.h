@@ -0,0 +1,76 @@
+#pragma once
+
+#include <luisa/algorithms/device_scan.h>
+
+namespace luisa::compute {
+
+/**
+ * @brief Stream compaction: keep the elements with non-zero flags, in order.
+ *
+ * Every thread counts the flags of its tile, the counts are exclusive-scanned
+ * into output offsets, and every thread then copies its selected elements.
+ * The number of selected elements is written to the device so that the
+ * following passes can be dispatched indirectly without a host round trip.
+ */
+template<typename T>
+class DeviceSelect {
+
+private:
+    static constexpr uint _zero = 0u;
+    uint _tile_size;
+    DeviceScan<uint> _scan;
+    // (flags, counts, n, tile_size)
+    Shader1D<Buffer<uint>, Buffer<uint>, uint, uint> _count;
+    // (in, flags, offsets, out, selected_count, n, tile_size, tile_count)
+    Shader1D<Buffer<T>, Buffer<uint>, Buffer<uint>, Buffer<T>, Buffer<uint>, uint, uint, uint> _scatter;
+
+public:
+    explicit DeviceSelect(Device &device, uint tile_size = 32u) noexcept
+        : _tile_size{std::max(tile_size, 1u)},
+          _scan{device},
+          _count{device.compile<1>([](BufferUInt flags, BufferUInt counts, UInt n, UInt tile_size) noexcept {
+              auto tile = dispatch_id().x;
+              auto begin = tile * tile_size;
+              auto end = min(begin + tile_size, n);
+              auto count = def(0u);
+              for (auto i : dynamic_range(begin, end)) {
+                  count += cast<uint>(flags.read(i) != 0u);
+              }
+              counts.write(tile, count);
+          })},
+          _scatter{device.compile<1>([](BufferVar<T> in, BufferUInt flags, BufferUInt offsets,
+                                        BufferVar<T> out, BufferUInt selected_count,
+                                        UInt n, UInt tile_size, UInt tile_count) noexcept {
+              auto tile = dispatch_id().x;
+              auto begin = tile * tile_size;
+              auto end = min(begin + tile_size, n);
+              auto index = def(offsets.read(tile));
+              for (auto i : dynamic_range(begin, end)) {
+                  if_(flags.read(i) != 0u, [&] {
+                      out.write(index, in.read(i));
+                      index += 1u;
+                  });
+              }
+              if_(tile == tile_count - 1u, [&] { selected_count.write(0u, index); });
+          })} {}
+
+    /// Copy in[i] with flags[i] != 0 to the front of out and write their number to selected_count[0]
+    void flagged(CommandList &list, BufferArena &arena,
+                 BufferView<T> in, BufferView<uint> flags,
+                 BufferView<T> out, BufferView<uint> selected_count) noexcept {
+        LUISA_ASSERT(flags.size() == in.size() && out.size() >= in.size() && !selected_count.empty(),
+                     "Invalid selection buffers.");
+        auto n = static_cast<uint>(in.size());
+        if (n == 0u) {
+            list << selected_count.subview(0u, 1u).copy_from(&_zero);
+            return;
+        }
+        auto tile_count = (n + _tile_size - 1u) / _tile_size;
+        auto offsets = arena.allocate_transient<uint>(tile_count);
+        list << _count(flags, offsets, n, _tile_size).dispatch(tile_count);
+        _scan.exclusive_sum(list, arena, offsets, offsets);
+        list << _scatter(in, flags, offsets, out, selected_count, n, _tile_size, tile_count).dispatch(tile_count);
+    }
+};
+
+}// namespace luisa::compute
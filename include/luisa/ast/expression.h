@@ -348,7 +348,8 @@ public:
 class LC_AST_API CallExpr final : public Expression {
 
 public:
-    using ArgumentList = luisa::vector<const Expression *>;
+    // the argument array is owned by the arena of the function builder
+    using ArgumentList = luisa::span<const Expression *const>;
 
     using CustomCallee = const detail::FunctionBuilder *;
     using ExternalCallee = const ExternalFunction *;
@@ -394,7 +395,7 @@ public:
      */
     CallExpr(const Type *type, const ExternalFunction *external, ArgumentList args) noexcept;
     [[nodiscard]] auto op() const noexcept { return _op; }
-    [[nodiscard]] auto arguments() const noexcept { return luisa::span{_arguments}; }
+    [[nodiscard]] auto arguments() const noexcept { return _arguments; }
     [[nodiscard]] auto is_builtin() const noexcept { return _op > CallOp::EXTERNAL; }
     [[nodiscard]] auto is_custom() const noexcept { return _op == CallOp::CUSTOM; }
     [[nodiscard]] auto is_external() const noexcept { return _op == CallOp::EXTERNAL; }
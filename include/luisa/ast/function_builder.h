@@ -5,7 +5,10 @@
 #pragma once
 
 #include <luisa/core/stl/vector.h>
+#include <luisa/core/stl/unordered_map.h>
+#include <luisa/core/arena.h>
 #include <luisa/core/spin_mutex.h>
+#include <luisa/core/clock.h>
 
 #include <luisa/ast/statement.h>
 #include <luisa/ast/function.h>
@@ -22,6 +25,7 @@ class Device;
 namespace luisa::compute {
 class Statement;
 class Expression;
+class FunctionSerializer;
 }// namespace luisa::compute
 
 namespace luisa::compute::detail {
@@ -34,6 +38,7 @@ namespace luisa::compute::detail {
 class LC_AST_API FunctionBuilder : public luisa::enable_shared_from_this<FunctionBuilder> {
 
     friend class lc::validation::Device;
+    friend class luisa::compute::FunctionSerializer;
 
 public:
     /**
@@ -76,10 +81,11 @@ public:
     using CpuCallback = Function::CpuCallback;
 
 private:
+    // owns all the expressions and statements (and call arguments);
+    // declared first so that the nodes outlive the other members
+    luisa::Arena _arena;
     ScopeStmt _body;
     luisa::optional<const Type *> _return_type;
-    luisa::vector<luisa::unique_ptr<Expression>> _all_expressions;
-    luisa::vector<luisa::unique_ptr<Statement>> _all_statements;
     luisa::vector<ScopeStmt *> _scope_stack;
     luisa::vector<Variable> _builtin_variables;
     luisa::vector<Constant> _captured_constants;
@@ -92,13 +98,19 @@ private:
     luisa::vector<Usage> _variable_usages;
     luisa::vector<std::pair<std::byte *, size_t /* alignment */>> _temporary_data;
     luisa::vector<CpuCallback> _cpu_callbacks;
+    // literal values of local variables known at the current build position,
+    // with the scopes they are assigned in (only tracked for constant folding)
+    luisa::unordered_map<uint32_t, std::pair<const ScopeStmt *, const Expression *>> _known_literals;
     CallOpSet _direct_builtin_callables;
     CallOpSet _propagated_builtin_callables;
     uint64_t _hash;
+    size_t _expression_count{0u};
+    size_t _statement_count{0u};
     uint3 _block_size;
     Tag _tag;
     bool _hash_computed{false};
     bool _requires_atomic_float{false};
+    bool _constant_folding;
 
 protected:
     [[nodiscard]] static luisa::vector<FunctionBuilder *> &_function_stack() noexcept;
@@ -110,22 +122,29 @@ protected:
     [[nodiscard]] const RefExpr *_ref(Variable v) noexcept;
     void _void_expr(const Expression *expr) noexcept;
     void _compute_hash() noexcept;
+    [[nodiscard]] const Expression *_fold_constant(const Expression *expr) noexcept;
+    [[nodiscard]] const Expression *_known_value(const Expression *expr) const noexcept;
+    void _forget_known_value(const Expression *expr) noexcept;
+    void _fold_constant_branches(ScopeStmt *scope) noexcept;
+    void _prune_unreachable_records() noexcept;
+    void _record_trace(double milliseconds) const noexcept;
 
     template<typename Stmt, typename... Args>
     auto _create_and_append_statement(Args &&...args) noexcept {
-        auto stmt = luisa::make_unique<Stmt>(std::forward<Args>(args)...);
-        auto p = stmt.get();
-        _all_statements.emplace_back(std::move(stmt));
+        auto p = _arena.create<Stmt>(std::forward<Args>(args)...);
+        _statement_count++;
         _append(p);
         return p;
     }
 
     template<typename Expr, typename... Args>
     [[nodiscard]] auto _create_expression(Args &&...args) noexcept {
-        auto expr = luisa::make_unique<Expr>(std::forward<Args>(args)...);
-        auto p = expr.get();
-        _all_expressions.emplace_back(std::move(expr));
-        return p;
+        _expression_count++;
+        return _arena.create<Expr>(std::forward<Args>(args)...);
+    }
+
+    [[nodiscard]] CallExpr::ArgumentList _create_argument_list(luisa::span<const Expression *const> args) noexcept {
+        return _arena.copy(args);
     }
 
 private:
@@ -138,11 +157,13 @@ private:
      */
     template<typename Def>
     static auto _define(Function::Tag tag, Def &&def) {
+        Clock clock;
         auto f = make_shared<FunctionBuilder>(tag);
         {
             FunctionStackGuard guard{f.get()};
             f->with(&f->_body, std::forward<Def>(def));
         }
+        if (tag == Function::Tag::KERNEL) { f->_record_trace(clock.toc()); }
         return luisa::const_pointer_cast<const FunctionBuilder>(f);
     }
 
@@ -193,6 +214,8 @@ public:
     [[nodiscard]] auto direct_builtin_callables() const noexcept { return _direct_builtin_callables; }
     /// Return a CallOpSet of builtin callables that are directly called.
     [[nodiscard]] auto propagated_builtin_callables() const noexcept { return _propagated_builtin_callables; }
+    /// Return if constant folding is enabled for this function.
+    [[nodiscard]] auto constant_folding() const noexcept { return _constant_folding; }
     /// Return tag(KERNEL, CALLABLE).
     [[nodiscard]] auto tag() const noexcept { return _tag; }
     /// Return pointer to body.
@@ -207,6 +230,12 @@ public:
     [[nodiscard]] auto block_size() const noexcept { return _block_size; }
     /// Return hash.
     [[nodiscard]] uint64_t hash() const noexcept;
+    /// Return bytes of memory held by the AST nodes.
+    [[nodiscard]] auto ast_memory_size() const noexcept { return _arena.total_size(); }
+    /// Return number of expressions created, including those folded away.
+    [[nodiscard]] auto expression_count() const noexcept { return _expression_count; }
+    /// Return number of statements created, including those folded away.
+    [[nodiscard]] auto statement_count() const noexcept { return _statement_count; }
     /// Return if is raytracing.
     [[nodiscard]] bool requires_raytracing() const noexcept;
     /// Return if uses atomic operations
@@ -287,28 +316,28 @@ public:
     // expressions
     /// Create literal expression
     [[nodiscard]] const LiteralExpr *literal(const Type *type, LiteralExpr::Value value) noexcept;
-    /// Create unary expression
-    [[nodiscard]] const UnaryExpr *unary(const Type *type, UnaryOp op, const Expression *expr) noexcept;
-    /// Create binary expression
-    [[nodiscard]] const BinaryExpr *binary(const Type *type, BinaryOp op, const Expression *lhs, const Expression *rhs) noexcept;
+    /// Create unary expression (folded into a literal if constant folding is enabled and the operand is a literal)
+    [[nodiscard]] const Expression *unary(const Type *type, UnaryOp op, const Expression *expr) noexcept;
+    /// Create binary expression (folded into a literal if constant folding is enabled and the operands are literals)
+    [[nodiscard]] const Expression *binary(const Type *type, BinaryOp op, const Expression *lhs, const Expression *rhs) noexcept;
     /// Create member expression
     [[nodiscard]] const MemberExpr *member(const Type *type, const Expression *self, size_t member_index) noexcept;
     /// Create swizzle expression
     [[nodiscard]] const Expression *swizzle(const Type *type, const Expression *self, size_t swizzle_size, uint64_t swizzle_code) noexcept;
     /// Create access expression
     [[nodiscard]] const AccessExpr *access(const Type *type, const Expression *range, const Expression *index) noexcept;
-    /// Create cast expression
-    [[nodiscard]] const CastExpr *cast(const Type *type, CastOp op, const Expression *expr) noexcept;
-    /// Create call expression
-    [[nodiscard]] const CallExpr *call(const Type *type /* nullptr for void */, CallOp call_op, std::initializer_list<const Expression *> args) noexcept;
+    /// Create cast expression (folded into a literal if constant folding is enabled and the source is a literal)
+    [[nodiscard]] const Expression *cast(const Type *type, CastOp op, const Expression *expr) noexcept;
+    /// Create call expression (folded into a literal if constant folding is enabled and the arguments are literals)
+    [[nodiscard]] const Expression *call(const Type *type /* nullptr for void */, CallOp call_op, std::initializer_list<const Expression *> args) noexcept;
     /// Create call expression
     [[nodiscard]] const CallExpr *call(const Type *type /* nullptr for void */, Function custom, std::initializer_list<const Expression *> args) noexcept;
     /// Call function
     void call(CallOp call_op, std::initializer_list<const Expression *> args) noexcept;
     /// Call custom function
     void call(Function custom, std::initializer_list<const Expression *> args) noexcept;
-    /// Create call expression
-    [[nodiscard]] const CallExpr *call(const Type *type /* nullptr for void */, CallOp call_op, luisa::span<const Expression *const> args) noexcept;
+    /// Create call expression (folded into a literal if constant folding is enabled and the arguments are literals)
+    [[nodiscard]] const Expression *call(const Type *type /* nullptr for void */, CallOp call_op, luisa::span<const Expression *const> args) noexcept;
     /// Create call expression
     [[nodiscard]] const CallExpr *call(const Type *type /* nullptr for void */, Function custom, luisa::span<const Expression *const> args) noexcept;
     /// Call function
@@ -347,7 +376,8 @@ public:
     [[nodiscard]] SwitchCaseStmt *case_(const Expression *expr) noexcept;
     /// Add default statement
     [[nodiscard]] SwitchDefaultStmt *default_() noexcept;
-    /// Add for statement
+    /// Add for statement. Note: the condition and update are evaluated in every iteration,
+    /// so build them after forget_known_values() if constant folding is enabled
     [[nodiscard]] ForStmt *for_(const Expression *var, const Expression *condition, const Expression *update) noexcept;
     /// Add ray query statement
     [[nodiscard]] RayQueryStmt *ray_query_(const RefExpr *query) noexcept;
@@ -376,6 +406,22 @@ public:
             std::forward<Args>(args)...);
     }
 
+    /**
+     * @brief Enable or disable constant folding for function builders created afterwards (disabled by default).
+     *
+     * When enabled, unary/binary/cast/builtin-call expressions on literals are
+     * evaluated with ASTEvaluator and replaced by literals as they are built;
+     * local variables assigned with literals are propagated into later reads
+     * that are known to observe the assigned values. On pop, if statements with literal conditions are replaced by the
+     * taken branch, loops that are never entered and statements after
+     * break/continue/return are removed, together with the callables,
+     * constants and variable usages only recorded by them. This happens
+     * before hashing, so equivalent kernels share the same hash.
+     */
+    static void set_constant_folding(bool enabled) noexcept;
+    /// Return if constant folding is enabled for function builders created afterwards.
+    [[nodiscard]] static bool constant_folding_default() noexcept;
+
     /// Push a function builder in stack
     static void push(FunctionBuilder *) noexcept;
     /// Pop a function builder in stack
@@ -385,6 +431,8 @@ public:
     void push_scope(ScopeStmt *) noexcept;
     /// Pop a scope
     void pop_scope(const ScopeStmt *) noexcept;
+    /// Forget the literal values of local variables known for constant folding
+    void forget_known_values() noexcept { _known_literals.clear(); }
     /// Mark variable uasge
     void mark_variable_usage(uint32_t uid, Usage usage) noexcept;
     /// separate arguments and bindings, make command need no bindings info, only work with kernel.
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <luisa/core/stl/vector.h>
+#include <luisa/core/stl/memory.h>
+#include <luisa/core/stl/functional.h>
+#include <luisa/ast/function.h>
+
+namespace luisa::compute {
+
+/**
+ * @brief Binary serializer of AST functions.
+ *
+ * The encoding is self-contained: the function, all the custom callables
+ * it (transitively) calls, the external functions and the types involved
+ * are written into a single blob, so that a kernel can be restored without
+ * re-running the DSL, e.g., for warm starts or for shipping it to another
+ * process. The blob is keyed by the hash of the root function, which is
+ * preserved across serialization and available through peek_hash().
+ *
+ * @note Captured resources (buffer/texture/bindless array/accel bindings) are
+ * stored by their handles, which are only meaningful in the process that
+ * created the resources unless they are remapped on deserialization.
+ * CPU/GPU custom-op expressions cannot be serialized.
+ */
+class LC_AST_API FunctionSerializer {
+
+public:
+    using HandleRemap = luisa::function<uint64_t(uint64_t)>;
+    static constexpr uint32_t magic = 0x4641434cu;// "LCAF"
+    static constexpr uint32_t version = 1u;
+
+private:
+    class Writer;
+    class Reader;
+
+public:
+    /// Serialize the function (with its callables) into a binary blob
+    [[nodiscard]] static luisa::vector<std::byte> serialize(Function function) noexcept;
+    /// Restore the function from a binary blob produced by serialize(), optionally remapping the bound resource handles.
+    /// Aborts if the blob is corrupt, peek_hash() only validates the header
+    [[nodiscard]] static luisa::shared_ptr<const detail::FunctionBuilder> deserialize(
+        luisa::span<const std::byte> data, const HandleRemap &remap_handle = {}) noexcept;
+    /// Read the hash of the serialized function without deserializing it, returns 0 if the blob is invalid
+    [[nodiscard]] static uint64_t peek_hash(luisa::span<const std::byte> data) noexcept;
+};
+
+}// namespace luisa::compute
@@ -280,9 +280,31 @@ enum struct CallOp : uint32_t {
     INDIRECT_CLEAR_DISPATCH_BUFFER,  // (Buffer): void
     INDIRECT_EMPLACE_DISPATCH_KERNEL,// (Buffer, uint3 block_size, uint3 dispatch_size, uint kernel_id)
 
+    // warp (subgroup) operations over the active lanes
+    WARP_SIZE,                  // (): uint
+    WARP_LANE_ID,               // (): uint
+    WARP_IS_FIRST_ACTIVE_LANE,  // (): bool
+    WARP_FIRST_ACTIVE_LANE,     // (): uint
+    WARP_ACTIVE_ALL_EQUAL,      // (scalar/vector): bool/boolN
+    WARP_ACTIVE_BIT_AND,        // (intN/uintN): intN/uintN
+    WARP_ACTIVE_BIT_OR,         // (intN/uintN): intN/uintN
+    WARP_ACTIVE_BIT_XOR,        // (intN/uintN): intN/uintN
+    WARP_ACTIVE_COUNT_BITS,     // (bool): uint
+    WARP_ACTIVE_MAX,            // (scalar/vector): scalar/vector
+    WARP_ACTIVE_MIN,            // (scalar/vector): scalar/vector
+    WARP_ACTIVE_PRODUCT,        // (scalar/vector): scalar/vector
+    WARP_ACTIVE_SUM,            // (scalar/vector): scalar/vector
+    WARP_ACTIVE_ALL,            // (bool): bool
+    WARP_ACTIVE_ANY,            // (bool): bool
+    WARP_ACTIVE_BIT_MASK,       // (bool): uint4 (ballot, lane i in bit i % 32 of component i / 32)
+    WARP_PREFIX_COUNT_BITS,     // (bool): uint (true count over the preceding active lanes)
+    WARP_PREFIX_SUM,            // (scalar/vector): scalar/vector (exclusive)
+    WARP_PREFIX_PRODUCT,        // (scalar/vector): scalar/vector (exclusive)
+    WARP_READ_LANE,             // (value, lane: uint): value (shuffle)
+    WARP_READ_FIRST_ACTIVE_LANE,// (value): value (broadcast)
 };
 
-static constexpr size_t call_op_count = to_underlying(CallOp::INDIRECT_EMPLACE_DISPATCH_KERNEL) + 1u;
+static constexpr size_t call_op_count = to_underlying(CallOp::WARP_READ_FIRST_ACTIVE_LANE) + 1u;
 
 [[nodiscard]] constexpr auto is_atomic_operation(CallOp op) noexcept {
     auto op_value = luisa::to_underlying(op) ;
@@ -365,6 +387,12 @@ public:
                test(CallOp::ATOMIC_EXCHANGE) ||
                test(CallOp::ATOMIC_COMPARE_EXCHANGE);
     }
+    [[nodiscard]] auto uses_warp() const noexcept {
+        for (auto i = to_underlying(CallOp::WARP_SIZE); i < call_op_count; i++) {
+            if (_bits.test(i)) { return true; }
+        }
+        return false;
+    }
     [[nodiscard]] auto uses_autodiff() const noexcept {
         return test(CallOp::REQUIRES_GRADIENT) ||
                test(CallOp::GRADIENT) ||
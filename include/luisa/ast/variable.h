@@ -10,6 +10,7 @@
 namespace luisa {
 
 namespace compute {
+class FunctionSerializer;
 namespace detail {
 class FunctionBuilder;
 class SSABuilder;
@@ -52,6 +53,7 @@ private:
 private:
     friend class detail::FunctionBuilder;
     friend class detail::SSABuilder;
+    friend class FunctionSerializer;
     Variable(const Type *type, Tag tag, uint32_t uid) noexcept
         : _type{type}, _uid{uid}, _tag{tag}{}
 
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <luisa/core/stl/string.h>
+#include <luisa/core/stl/vector.h>
+#include <luisa/core/stl/filesystem.h>
+#include <luisa/runtime/rhi/device_interface.h>
+
+namespace luisa::compute {
+
+/**
+ * @brief Extension exposed by the profiling layer.
+ *
+ * Enabled with Context::create_device(..., enable_profiling = true). The layer
+ * timestamps every command list (and, with per-command timing, every
+ * command) when it is submitted and when its completion callback fires,
+ * records event signals and waits between streams, in-flight command lists
+ * per stream and live buffer/texture memory. Timings are observed on the
+ * host, so they include backend scheduling latency but need no vendor
+ * profiler or timestamp queries.
+ */
+class ProfilingExt : public DeviceExtension {
+
+protected:
+    ~ProfilingExt() noexcept = default;
+
+public:
+    static constexpr luisa::string_view name = "ProfilingExt";
+
+    struct ShaderStatistics {
+        uint64_t handle;
+        luisa::string name;
+        uint64_t dispatch_count;
+        uint64_t thread_count;// direct dispatches only
+        // zero unless per-command timing is enabled
+        double total_milliseconds;
+        double min_milliseconds;
+        double max_milliseconds;
+    };
+
+    /**
+     * @brief Split command lists so that every command is timed on its own.
+     *
+     * Enabled by default. This serializes the commands of a list, so disable
+     * it to measure whole command lists with less overhead.
+     */
+    virtual void set_per_command_timing(bool enabled) noexcept = 0;
+    /// Drop the events recorded so far; resource and shader names are kept
+    virtual void clear() noexcept = 0;
+    /// Recorded events as Chrome trace JSON, loadable by chrome://tracing or Perfetto
+    [[nodiscard]] virtual luisa::string chrome_trace() noexcept = 0;
+    virtual void dump_chrome_trace(const luisa::filesystem::path &path) noexcept = 0;
+    /// Per-shader aggregates, sorted by total time and then by dispatch count
+    [[nodiscard]] virtual luisa::vector<ShaderStatistics> shader_statistics() noexcept = 0;
+    /// Human-readable table of shader_statistics()
+    [[nodiscard]] virtual luisa::string dump_shader_statistics() noexcept = 0;
+};
+
+}// namespace luisa::compute
@@ -21,10 +21,17 @@ public:
         Success = 0,
         Failed = 1
     };
+    enum class Quality : uint8_t {
+        Fastest,
+        Default,
+        Best
+    };
     // TODO: astc
     virtual Result compress_bc6h(Stream &stream, Image<float> const &src, BufferView<uint> const &result) noexcept { return Result::NotImplemented; }
     virtual Result compress_bc7(Stream &stream, Image<float> const &src, BufferView<uint> const &result, float alpha_importance) noexcept { return Result::NotImplemented; }
     virtual Result check_builtin_shader() noexcept { return Result::NotImplemented; }
+    // applies to the compressions issued afterwards
+    virtual Result set_quality(Quality quality) noexcept { return Result::NotImplemented; }
 };
 
 }// namespace luisa::compute
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <luisa/core/stl/vector.h>
+#include <luisa/core/stl/memory.h>
+
+namespace luisa {
+
+/**
+ * @brief Bump-pointer arena
+ *
+ * Objects created in the arena are never freed individually;
+ * all the memory (and the objects' destructors, if any) are
+ * released at once when the arena is destroyed. Not thread-safe.
+ */
+class Arena {
+
+public:
+    static constexpr auto default_block_size = 64_k;
+    static constexpr auto max_block_size = 4_M;
+
+private:
+    struct Destructor {
+        void (*destroy)(void *) noexcept;
+        void *object;
+        Destructor *next;
+    };
+
+private:
+    luisa::vector<std::byte *> _blocks;
+    std::byte *_cursor{nullptr};
+    std::byte *_end{nullptr};
+    Destructor *_destructors{nullptr};
+    size_t _next_block_size;
+    size_t _total_size{0u};
+
+private:
+    [[nodiscard]] auto _allocate_block(size_t size) noexcept {
+        auto p = static_cast<std::byte *>(
+            detail::allocator_allocate(size, alignof(std::max_align_t)));
+        _blocks.emplace_back(p);
+        _total_size += size;
+        return p;
+    }
+
+public:
+    explicit Arena(size_t block_size = default_block_size) noexcept
+        : _next_block_size{std::max<size_t>(block_size, 64u)} {}
+    Arena(Arena &&) noexcept = delete;
+    Arena(const Arena &) noexcept = delete;
+    Arena &operator=(Arena &&) noexcept = delete;
+    Arena &operator=(const Arena &) noexcept = delete;
+    ~Arena() noexcept {
+        for (auto d = _destructors; d != nullptr; d = d->next) {
+            d->destroy(d->object);
+        }
+        for (auto b : _blocks) {
+            detail::allocator_deallocate(b, alignof(std::max_align_t));
+        }
+    }
+
+    /// Allocate uninitialized memory with given size and alignment
+    [[nodiscard]] void *allocate(size_t size, size_t alignment) noexcept {
+        auto p = reinterpret_cast<std::byte *>(
+            luisa::align(reinterpret_cast<size_t>(_cursor), alignment));
+        if (_cursor == nullptr || p + size > _end) [[unlikely]] {
+            // dedicated block for large allocations, to not waste the current one
+            if (auto padded = size + alignment; padded > _next_block_size / 4u) {
+                auto b = _allocate_block(padded);
+                return reinterpret_cast<std::byte *>(
+                    luisa::align(reinterpret_cast<size_t>(b), alignment));
+            }
+            _cursor = _allocate_block(_next_block_size);
+            _end = _cursor + _next_block_size;
+            _next_block_size = std::min(_next_block_size * 2u, max_block_size);
+            p = reinterpret_cast<std::byte *>(
+                luisa::align(reinterpret_cast<size_t>(_cursor), alignment));
+        }
+        _cursor = p + size;
+        return p;
+    }
+
+    /// Allocate uninitialized array of n elements of type T
+    template<typename T>
+    [[nodiscard]] auto allocate_array(size_t n) noexcept {
+        static_assert(std::is_trivially_destructible_v<T>);
+        if (n == 0u) { return static_cast<T *>(nullptr); }
+        return static_cast<T *>(allocate(sizeof(T) * n, alignof(T)));
+    }
+
+    /// Copy the elements into the arena and return a span to the copy
+    template<typename T>
+    [[nodiscard]] auto copy(luisa::span<const T> elements) noexcept {
+        auto p = allocate_array<T>(elements.size());
+        std::uninitialized_copy(elements.begin(), elements.end(), p);
+        return luisa::span<const T>{p, elements.size()};
+    }
+
+    /// Construct an object of type T in the arena. The destructor (if non-trivial) is called on arena destruction.
+    template<typename T, typename... Args>
+    [[nodiscard]] auto create(Args &&...args) noexcept {
+        auto p = static_cast<T *>(allocate(sizeof(T), alignof(T)));
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            auto d = static_cast<Destructor *>(
+                allocate(sizeof(Destructor), alignof(Destructor)));
+            d->destroy = [](void *object) noexcept { static_cast<T *>(object)->~T(); };
+            d->object = p;
+            d->next = _destructors;
+            _destructors = d;
+        }
+        return std::construct_at(p, std::forward<Args>(args)...);
+    }
+
+    /// Total bytes of memory blocks held by the arena
+    [[nodiscard]] auto total_size() const noexcept { return _total_size; }
+};
+
+}// namespace luisa
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <luisa/core/clock.h>
+#include <luisa/core/stl/memory.h>
+#include <luisa/core/stl/string.h>
+#include <luisa/core/stl/vector.h>
+#include <luisa/core/stl/optional.h>
+#include <luisa/core/stl/functional.h>
+
+namespace luisa {
+
+/**
+ * @brief Structured report of a single shader compilation.
+ *
+ * Phases are recorded in the order they finish, e.g., "trace", "codegen",
+ * "compile" and "load". Counters carry sizes and node counts, e.g.,
+ * "ast.expressions" or "source.bytes". Cache events record a hit or a miss
+ * for each cache layer that was consulted, e.g., "disk".
+ */
+struct LC_CORE_API ShaderCompileReport {
+
+    struct Phase {
+        luisa::string name;
+        double milliseconds{};
+    };
+
+    struct Counter {
+        luisa::string name;
+        uint64_t value{};
+    };
+
+    struct CacheEvent {
+        luisa::string layer;
+        bool hit{};
+    };
+
+    luisa::string name;
+    uint64_t hash{};
+    double total_milliseconds{};
+    luisa::vector<Phase> phases;
+    luisa::vector<Counter> counters;
+    luisa::vector<CacheEvent> cache_events;
+
+    /// Total time spent in phases with the given name
+    [[nodiscard]] double phase_milliseconds(luisa::string_view phase) const noexcept;
+    /// Value of the counter with the given name, if recorded
+    [[nodiscard]] luisa::optional<uint64_t> counter(luisa::string_view counter) const noexcept;
+    /// Whether any of the consulted cache layers hit
+    [[nodiscard]] bool cache_hit() const noexcept;
+    /// Human-readable single-shader summary
+    [[nodiscard]] luisa::string dump() const noexcept;
+};
+
+/**
+ * @brief Collects compile reports for shaders created on the current thread.
+ *
+ * Profiling is disabled by default. When enabled, each JIT shader creation
+ * opens a Scope, and the frontend and backends record phases, counters and
+ * cache events into the innermost open scope of the calling thread. Finished
+ * reports are passed to the callback (if any), kept as the thread's last
+ * report, and appended to the session for an aggregated dump.
+ */
+class LC_CORE_API CompileProfiler {
+
+public:
+    using Callback = luisa::function<void(const ShaderCompileReport &)>;
+
+    /// RAII guard that collects one report
+    class LC_CORE_API Scope {
+
+    private:
+        Clock _clock;
+        bool _active;
+
+    public:
+        Scope(luisa::string name, uint64_t hash) noexcept;
+        ~Scope() noexcept;
+        Scope(Scope &&) noexcept = delete;
+        Scope(const Scope &) noexcept = delete;
+        Scope &operator=(Scope &&) noexcept = delete;
+        Scope &operator=(const Scope &) noexcept = delete;
+    };
+
+    /// RAII guard that times one phase of the innermost open scope
+    class LC_CORE_API Phase {
+
+    private:
+        Clock _clock;
+        luisa::string_view _name;
+
+    public:
+        explicit Phase(luisa::string_view name) noexcept;
+        ~Phase() noexcept;
+        Phase(Phase &&) noexcept = delete;
+        Phase(const Phase &) noexcept = delete;
+        Phase &operator=(Phase &&) noexcept = delete;
+        Phase &operator=(const Phase &) noexcept = delete;
+    };
+
+public:
+    static void set_enabled(bool enabled) noexcept;
+    [[nodiscard]] static bool is_enabled() noexcept;
+    /// Set a callback invoked on the compiling thread when a report is finished
+    static void set_callback(Callback callback) noexcept;
+
+    // recorders, no-ops if there is no open scope on the calling thread
+    static void phase(luisa::string_view name, double milliseconds) noexcept;
+    static void counter(luisa::string_view name, uint64_t value) noexcept;
+    static void cache(luisa::string_view layer, bool hit) noexcept;
+
+    /**
+     * @brief Record frontend (DSL tracing) statistics of a kernel.
+     *
+     * Kernels are usually traced well before they are compiled, so the
+     * statistics are kept until a scope with the same hash is opened. Only
+     * the traces of the most recently traced kernels are kept.
+     */
+    static void record_trace(uint64_t hash, double milliseconds,
+                             luisa::span<const ShaderCompileReport::Counter> counters) noexcept;
+
+    /// The last report finished on the calling thread
+    [[nodiscard]] static luisa::optional<ShaderCompileReport> last_report() noexcept;
+    [[nodiscard]] static luisa::vector<ShaderCompileReport> session_reports() noexcept;
+    /// Aggregated per-phase totals, cache hit rates and the slowest shaders of the session
+    [[nodiscard]] static luisa::string dump_session() noexcept;
+    static void clear_session() noexcept;
+};
+
+}// namespace luisa
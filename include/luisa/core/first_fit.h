@@ -49,6 +49,8 @@ public:
     void free(Node *node) noexcept;
     [[nodiscard]] auto size() const noexcept { return _free_list._size; }
     [[nodiscard]] auto alignment() const noexcept { return _alignment; }
+    [[nodiscard]] size_t free_size() const noexcept;
+    [[nodiscard]] size_t largest_free_size() const noexcept;
     [[nodiscard]] luisa::string dump_free_list() const noexcept;
 };
 
@@ -1715,6 +1715,161 @@ inline void sync_block() noexcept {
         CallOp::SYNCHRONIZE_BLOCK, {});
 }
 
+// warp (subgroup) operations over the active lanes of the warp
+
+/// Number of lanes in a warp.
+[[nodiscard]] inline auto warp_lane_count() noexcept {
+    return def<uint>(detail::FunctionBuilder::current()->call(
+        Type::of<uint>(), CallOp::WARP_SIZE, {}));
+}
+
+/// Index of the current lane in its warp.
+[[nodiscard]] inline auto warp_lane_id() noexcept {
+    return def<uint>(detail::FunctionBuilder::current()->call(
+        Type::of<uint>(), CallOp::WARP_LANE_ID, {}));
+}
+
+/// Test if the current lane is the first active lane in its warp.
+[[nodiscard]] inline auto warp_is_first_active_lane() noexcept {
+    return def<bool>(detail::FunctionBuilder::current()->call(
+        Type::of<bool>(), CallOp::WARP_IS_FIRST_ACTIVE_LANE, {}));
+}
+
+/// Index of the first active lane in the warp.
+[[nodiscard]] inline auto warp_first_active_lane() noexcept {
+    return def<uint>(detail::FunctionBuilder::current()->call(
+        Type::of<uint>(), CallOp::WARP_FIRST_ACTIVE_LANE, {}));
+}
+
+/// Test (component-wise) if x is the same on all active lanes.
+template<typename T>
+    requires is_dsl_v<T> && (is_scalar_expr_v<T> || is_vector_expr_v<T>)
+[[nodiscard]] inline auto warp_active_all_equal(T &&x) noexcept {
+    return detail::make_vector_call<bool>(
+        CallOp::WARP_ACTIVE_ALL_EQUAL, std::forward<T>(x));
+}
+
+/// Bitwise and of x over the active lanes.
+template<typename T>
+    requires is_dsl_v<T> && (is_int_or_vector_expr_v<T> || is_uint_or_vector_expr_v<T>)
+[[nodiscard]] inline auto warp_active_bit_and(T &&x) noexcept {
+    return detail::make_vector_call<vector_expr_element_t<T>>(
+        CallOp::WARP_ACTIVE_BIT_AND, std::forward<T>(x));
+}
+
+/// Bitwise or of x over the active lanes.
+template<typename T>
+    requires is_dsl_v<T> && (is_int_or_vector_expr_v<T> || is_uint_or_vector_expr_v<T>)
+[[nodiscard]] inline auto warp_active_bit_or(T &&x) noexcept {
+    return detail::make_vector_call<vector_expr_element_t<T>>(
+        CallOp::WARP_ACTIVE_BIT_OR, std::forward<T>(x));
+}
+
+/// Bitwise xor of x over the active lanes.
+template<typename T>
+    requires is_dsl_v<T> && (is_int_or_vector_expr_v<T> || is_uint_or_vector_expr_v<T>)
+[[nodiscard]] inline auto warp_active_bit_xor(T &&x) noexcept {
+    return detail::make_vector_call<vector_expr_element_t<T>>(
+        CallOp::WARP_ACTIVE_BIT_XOR, std::forward<T>(x));
+}
+
+/// Number of active lanes with pred being true.
+[[nodiscard]] inline auto warp_active_count_bits(Expr<bool> pred) noexcept {
+    return def<uint>(detail::FunctionBuilder::current()->call(
+        Type::of<uint>(), CallOp::WARP_ACTIVE_COUNT_BITS, {pred.expression()}));
+}
+
+/// Maximum of x over the active lanes.
+template<typename T>
+    requires is_dsl_v<T> && (is_scalar_expr_v<T> || is_vector_expr_v<T>)
+[[nodiscard]] inline auto warp_active_max(T &&x) noexcept {
+    return detail::make_vector_call<vector_expr_element_t<T>>(
+        CallOp::WARP_ACTIVE_MAX, std::forward<T>(x));
+}
+
+/// Minimum of x over the active lanes.
+template<typename T>
+    requires is_dsl_v<T> && (is_scalar_expr_v<T> || is_vector_expr_v<T>)
+[[nodiscard]] inline auto warp_active_min(T &&x) noexcept {
+    return detail::make_vector_call<vector_expr_element_t<T>>(
+        CallOp::WARP_ACTIVE_MIN, std::forward<T>(x));
+}
+
+/// Product of x over the active lanes.
+template<typename T>
+    requires is_dsl_v<T> && (is_scalar_expr_v<T> || is_vector_expr_v<T>)
+[[nodiscard]] inline auto warp_active_product(T &&x) noexcept {
+    return detail::make_vector_call<vector_expr_element_t<T>>(
+        CallOp::WARP_ACTIVE_PRODUCT, std::forward<T>(x));
+}
+
+/// Sum of x over the active lanes.
+template<typename T>
+    requires is_dsl_v<T> && (is_scalar_expr_v<T> || is_vector_expr_v<T>)
+[[nodiscard]] inline auto warp_active_sum(T &&x) noexcept {
+    return detail::make_vector_call<vector_expr_element_t<T>>(
+        CallOp::WARP_ACTIVE_SUM, std::forward<T>(x));
+}
+
+/// Test if pred is true on all active lanes.
+[[nodiscard]] inline auto warp_active_all(Expr<bool> pred) noexcept {
+    return def<bool>(detail::FunctionBuilder::current()->call(
+        Type::of<bool>(), CallOp::WARP_ACTIVE_ALL, {pred.expression()}));
+}
+
+/// Test if pred is true on any active lane.
+[[nodiscard]] inline auto warp_active_any(Expr<bool> pred) noexcept {
+    return def<bool>(detail::FunctionBuilder::current()->call(
+        Type::of<bool>(), CallOp::WARP_ACTIVE_ANY, {pred.expression()}));
+}
+
+/// Ballot. Bit (i % 32) of component (i / 32) is set if pred is true on active lane i.
+[[nodiscard]] inline auto warp_active_bit_mask(Expr<bool> pred) noexcept {
+    return def<uint4>(detail::FunctionBuilder::current()->call(
+        Type::of<uint4>(), CallOp::WARP_ACTIVE_BIT_MASK, {pred.expression()}));
+}
+
+/// Number of active lanes before the current one with pred being true.
+[[nodiscard]] inline auto warp_prefix_count_bits(Expr<bool> pred) noexcept {
+    return def<uint>(detail::FunctionBuilder::current()->call(
+        Type::of<uint>(), CallOp::WARP_PREFIX_COUNT_BITS, {pred.expression()}));
+}
+
+/// Exclusive prefix sum of x over the active lanes.
+template<typename T>
+    requires is_dsl_v<T> && (is_scalar_expr_v<T> || is_vector_expr_v<T>)
+[[nodiscard]] inline auto warp_prefix_sum(T &&x) noexcept {
+    return detail::make_vector_call<vector_expr_element_t<T>>(
+        CallOp::WARP_PREFIX_SUM, std::forward<T>(x));
+}
+
+/// Exclusive prefix product of x over the active lanes.
+template<typename T>
+    requires is_dsl_v<T> && (is_scalar_expr_v<T> || is_vector_expr_v<T>)
+[[nodiscard]] inline auto warp_prefix_product(T &&x) noexcept {
+    return detail::make_vector_call<vector_expr_element_t<T>>(
+        CallOp::WARP_PREFIX_PRODUCT, std::forward<T>(x));
+}
+
+/// Shuffle. Read x from the given lane, which must be active.
+template<typename T>
+    requires is_dsl_v<T> && is_basic_expr_v<T>
+[[nodiscard]] inline auto warp_read_lane(T &&x, Expr<uint> lane) noexcept {
+    using V = expr_value_t<T>;
+    return def<V>(detail::FunctionBuilder::current()->call(
+        Type::of<V>(), CallOp::WARP_READ_LANE,
+        {LUISA_EXPR(x), lane.expression()}));
+}
+
+/// Broadcast. Read x from the first active lane.
+template<typename T>
+    requires is_dsl_v<T> && is_basic_expr_v<T>
+[[nodiscard]] inline auto warp_read_first_active_lane(T &&x) noexcept {
+    using V = expr_value_t<T>;
+    return def<V>(detail::FunctionBuilder::current()->call(
+        Type::of<V>(), CallOp::WARP_READ_FIRST_ACTIVE_LANE, {LUISA_EXPR(x)}));
+}
+
 #undef LUISA_EXPR
 
 }// namespace dsl
@@ -6,6 +6,7 @@
 
 #include <type_traits>
 #include <luisa/core/stl/memory.h>
+#include <luisa/core/logging.h>
 #include <luisa/ast/external_function.h>
 #include <luisa/runtime/rhi/command.h>
 #include <luisa/runtime/device.h>
@@ -242,6 +243,22 @@ public:
         });
         _builder = detail::transform_function(ast->function());
     }
+
+    /**
+     * @brief Create Kernel object from a previously built function, e.g., restored by FunctionSerializer.
+     *
+     * The function must be a kernel whose unbound arguments match Args.
+     *
+     * @param builder the function builder of the kernel
+     */
+    [[nodiscard]] static Kernel from_function(SharedFunctionBuilder builder) noexcept {
+        LUISA_ASSERT(builder != nullptr &&
+                         builder->tag() == Function::Tag::KERNEL &&
+                         builder->unbound_arguments().size() == sizeof...(Args),
+                     "Invalid function for Kernel{}D with {} argument(s).",
+                     N, sizeof...(Args));
+        return Kernel{std::move(builder)};
+    }
     [[nodiscard]] const auto &function() const noexcept { return _builder; }
 };
 
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <mutex>
+
 #include <luisa/core/logging.h>
 #include <luisa/runtime/buffer.h>
 #include <luisa/runtime/event.h>
@@ -30,14 +32,24 @@ public:
             : size{size}, f{std::move(f)} {}
     };
 
+    /// Number of host buffers used by flush(), i.e. flushes that may be in flight at once
+    static constexpr uint streaming_slot_count = 3u;
+
+private:
+    struct Streaming;
+
 private:
     Buffer<uint> _buffer;// count & records (desc_id, arg0, arg1, ...)
     luisa::vector<uint> _host_buffer;
     luisa::vector<Item> _items;
+    mutable std::mutex _items_mutex;// items are decoded on the streaming thread
     luisa::logger _logger;
     std::atomic_bool _reset_called{false};
+    luisa::unique_ptr<Streaming> _streaming;
 
 private:
+    void _print(luisa::span<const uint> data, bool abort_on_error) noexcept;
+
     void _log_to_buffer(Expr<uint>, uint) noexcept {}
 
     template<typename Curr, typename... Other>
@@ -63,6 +75,10 @@ private:
 public:
     /// Create printer object on device. Will create a buffer in it.
     explicit Printer(Device &device, luisa::string_view name = "device", size_t capacity = 1_M) noexcept;
+    /// Wait for the flushed logs to be printed.
+    ~Printer() noexcept;
+    Printer(Printer &&) noexcept = delete;
+    Printer(const Printer &) noexcept = delete;
     /// Reset the printer. Must be called before any shader dispatch that uses this printer.
     [[nodiscard]] luisa::unique_ptr<Command> reset() noexcept;
     /// Retrieve and print the logs. Will automatically reset the printer for future use.
@@ -71,6 +87,24 @@ public:
                              luisa::unique_ptr<Command> /* reset */,
                              Stream::Synchronize /* synchronize */>
     retrieve(bool abort_on_error = false) noexcept;
+    /**
+     * @brief Retrieve the logs without synchronizing the stream.
+     *
+     * The logs are downloaded into one of the streaming_slot_count host
+     * buffers and printed by a background thread once the command list
+     * completes, then the printer is reset. If every host buffer is still
+     * waiting for the device or for the printing thread, flush() blocks until
+     * one is released, so a slow consumer throttles the submitting thread
+     * instead of losing logs. Records that overflow the device buffer between
+     * two flushes are still dropped and reported; flush more often or increase
+     * the capacity if that happens.
+     */
+    [[nodiscard]] std::tuple<luisa::unique_ptr<Command> /* download */,
+                             luisa::move_only_function<void()> /* print asynchronously */,
+                             luisa::unique_ptr<Command> /* reset */>
+    flush(bool abort_on_error = false) noexcept;
+    /// Block until all completed flushes have been printed.
+    void wait_flushed() noexcept;
 
     /// Log in kernel at debug level.
     template<typename... Args>
@@ -121,17 +155,15 @@ public:
               std::forward<Args>(args)..., p.x, p.y, p.z);
     }
     /// Check if there are any logs.
-    [[nodiscard]] auto empty() const noexcept { return _items.empty(); }
+    [[nodiscard]] auto empty() const noexcept {
+        std::scoped_lock lock{_items_mutex};
+        return _items.empty();
+    }
 };
 
 template<typename... Args>
 void Printer::_log(luisa::log_level level, luisa::string fmt, const Args &...args) noexcept {
     auto count = (1u /* desc_id */ + ... + static_cast<uint>(is_dsl_v<Args>));
-    auto size = static_cast<uint>(_buffer.size() - 1u);
-    auto offset = _buffer->atomic(size).fetch_add(count);
-    auto item = static_cast<uint>(_items.size());
-    dsl::if_(offset < size, [&] { _buffer->write(offset, item); });
-    dsl::if_(offset + count <= size, [&] { _log_to_buffer(offset, 0u, args...); });
     // create decoder...
     auto counter = 0u;
     auto convert = [&counter]<typename T>(const T &arg) noexcept {
@@ -169,7 +201,18 @@ void Printer::_log(luisa::log_level level, luisa::string fmt, const Args &...arg
         };
         do_print(std::index_sequence_for<Args...>{});
     };
-    _items.emplace_back(count, decode);
+    // the index is taken and the decoder registered under one lock, so that
+    // kernels recorded concurrently with the same printer get distinct items
+    auto item = [&] {
+        std::scoped_lock lock{_items_mutex};
+        auto index = static_cast<uint>(_items.size());
+        _items.emplace_back(count, std::move(decode));
+        return index;
+    }();
+    auto size = static_cast<uint>(_buffer.size() - 1u);
+    auto offset = _buffer->atomic(size).fetch_add(count);
+    dsl::if_(offset < size, [&] { _buffer->write(offset, item); });
+    dsl::if_(offset + count <= size, [&] { _log_to_buffer(offset, 0u, args...); });
 }
 
 }// namespace luisa::compute
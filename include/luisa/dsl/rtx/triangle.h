@@ -9,3 +9,4 @@
 
 LUISA_STRUCT(luisa::compute::Triangle, i0, i1, i2) {};
 
+LUISA_STRUCT(luisa::compute::Triangle16, i0, i1, i2) {};
@@ -212,6 +212,8 @@ public:
             auto f = FunctionBuilder::current();
             Var var{_begin};
             _var = var.expression();
+            // the condition is evaluated in every iteration, do not fold it with the initial values
+            f->forget_known_values();
             auto bool_type = Type::of<bool>();
             _cond = f->binary(bool_type, BinaryOp::LESS, _var, _end.expression());
             if constexpr (has_step) {
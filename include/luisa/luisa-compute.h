@@ -7,6 +7,7 @@
 #include <luisa/ast/external_function.h>
 #include <luisa/ast/function.h>
 #include <luisa/ast/function_builder.h>
+#include <luisa/ast/function_serializer.h>
 #include <luisa/ast/interface.h>
 #include <luisa/ast/op.h>
 #include <luisa/ast/statement.h>
@@ -15,6 +16,7 @@
 #include <luisa/ast/usage.h>
 #include <luisa/ast/variable.h>
 
+#include <luisa/core/arena.h>
 #include <luisa/core/basic_traits.h>
 #include <luisa/core/basic_types.h>
 #include <luisa/core/binary_buffer.h>
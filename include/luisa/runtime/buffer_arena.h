@@ -1,47 +1,116 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+
+#include <luisa/core/spin_mutex.h>
+#include <luisa/core/stl/unordered_map.h>
 #include <luisa/runtime/buffer.h>
 #include <luisa/runtime/device.h>
 
 namespace luisa::compute {
 
-class BufferArena {
+class CommandList;
+
+/**
+ * @brief Suballocator for device buffers.
+ *
+ * Blocks are carved from pages of `capacity` bytes. Small requests are
+ * rounded up to power-of-two size classes whose freed blocks are kept in
+ * per-thread caches for reuse; larger ones are placed with a first-fit
+ * free list and returned to it on free; requests larger than a page get
+ * a dedicated buffer. Blocks are never freed implicitly, except transient
+ * ones, which are recycled when the command list passed to end_frame()
+ * has completed. All device memory is released when the arena dies.
+ */
+class LC_RUNTIME_API BufferArena {
+
+public:
+    static constexpr size_t block_alignment = 256u;
+    static constexpr size_t size_class_count = 9u;// 256B to 64KB
+    static constexpr size_t small_block_max = block_alignment << (size_class_count - 1u);
+    static constexpr size_t thread_cache_count = 8u;
+
+    struct Statistics {
+        size_t reserved_bytes;        // pages and dedicated buffers
+        size_t allocated_bytes;       // live blocks, including transient ones
+        size_t cached_bytes;          // freed small blocks kept for reuse
+        size_t page_free_bytes;       // not yet carved from the pages
+        size_t largest_page_free_bytes;
+        size_t page_count;
+        size_t dedicated_buffer_count;
+        [[nodiscard]] double occupancy() const noexcept {
+            return reserved_bytes == 0u ? 0. : static_cast<double>(allocated_bytes) /
+                                                   static_cast<double>(reserved_bytes);
+        }
+        // 0 when the free space in the pages is contiguous, towards 1 as it splinters
+        [[nodiscard]] double fragmentation() const noexcept {
+            return page_free_bytes == 0u ? 0. : 1. - static_cast<double>(largest_page_free_bytes) /
+                                                         static_cast<double>(page_free_bytes);
+        }
+    };
+
+private:
+    struct Page;
+    struct ThreadCache {
+        luisa::spin_mutex mutex;
+        std::array<luisa::vector<BufferView<float4>>, size_class_count> blocks;
+    };
 
 private:
     std::mutex _mutex;
     Device &_device;
-    luisa::vector<luisa::unique_ptr<Resource>> _buffers;
-    luisa::optional<BufferView<float4>> _current_buffer;
-    size_t _capacity;
+    size_t _page_size;
+    luisa::vector<luisa::unique_ptr<Page>> _pages;
+    luisa::unordered_map<uint64_t, luisa::unique_ptr<Buffer<float4>>> _dedicated_buffers;
+    luisa::vector<BufferView<float4>> _transient_blocks;
+    std::array<ThreadCache, thread_cache_count> _thread_caches;
+    std::atomic<size_t> _allocated_bytes{0u};
+    std::atomic<size_t> _cached_bytes{0u};
+
+private:
+    [[nodiscard]] BufferView<float4> _allocate(size_t size_bytes) noexcept;
+    [[nodiscard]] BufferView<float4> _allocate_from_pages(size_t block_size) noexcept;
+    void _free(uint64_t handle, size_t offset_bytes, size_t size_bytes) noexcept;
+    void _free_to_page(uint64_t handle, size_t offset_bytes) noexcept;
+    void _add_transient(BufferView<float4> block) noexcept;
 
 public:
-    explicit BufferArena(Device &device, size_t capacity = 4_M) noexcept
-        : _device{device}, _capacity{std::max(next_pow2(capacity), 64_k) / sizeof(float4)} {}
-    // Allocate sub buffer by stack-allocator
+    explicit BufferArena(Device &device, size_t capacity = 4_M) noexcept;
+    ~BufferArena() noexcept;
+    BufferArena(BufferArena &&) noexcept = delete;
+    BufferArena(const BufferArena &) noexcept = delete;
+    BufferArena &operator=(BufferArena &&) noexcept = delete;
+    BufferArena &operator=(const BufferArena &) noexcept = delete;
+
+    // Allocate a sub buffer that lives until it is freed or the arena dies
     template<typename T>
     [[nodiscard]] BufferView<T> allocate(size_t n) noexcept {
         static_assert(alignof(T) <= 16u);
-        std::scoped_lock lock{_mutex};
-        auto size = n * sizeof(T);
-        auto n_elem = (size + sizeof(float4) - 1u) / sizeof(float4);
-        if (n_elem > _capacity) {// too big, will not use the arena
-            auto buffer = luisa::make_unique<Buffer<T>>(_device.create_buffer<T>(n));
-            auto view = buffer->view();
-            _buffers.emplace_back(std::move(buffer));
-            return view;
-        }
-        if (!_current_buffer || n_elem > _current_buffer->size()) {
-            auto buffer = luisa::make_unique<Buffer<float4>>(
-                _device.create_buffer<float4>(_capacity));
-            _current_buffer = buffer->view();
-            _buffers.emplace_back(std::move(buffer));
-        }
-        auto view = _current_buffer->subview(0u, n_elem);
-        _current_buffer = _current_buffer->subview(
-            n_elem, _current_buffer->size() - n_elem);
-        return view.template as<T>().subview(0u, n);
+        return _allocate(n * sizeof(T)).template as<T>().subview(0u, n);
+    }
+    // Allocate a sub buffer that is recycled when the current frame completes
+    template<typename T>
+    [[nodiscard]] BufferView<T> allocate_transient(size_t n) noexcept {
+        static_assert(alignof(T) <= 16u);
+        auto block = _allocate(n * sizeof(T));
+        _add_transient(block);
+        return block.template as<T>().subview(0u, n);
     }
+    // Return a view obtained from allocate() to the arena. The caller must
+    // make sure no pending command still uses it, since it can be handed out
+    // again (or destroyed, if it had a dedicated buffer) right away.
+    template<typename T>
+    void free(BufferView<T> view) noexcept {
+        _free(view.handle(), view.offset_bytes(), view.size_bytes());
+    }
+    // Close the current frame: its transient blocks are recycled once `list`
+    // has been executed, so the arena must outlive the list's execution
+    void end_frame(CommandList &list) noexcept;
+    // Release the cached blocks and the pages left empty
+    void shrink() noexcept;
+    [[nodiscard]] Statistics statistics() noexcept;
+    [[nodiscard]] auto page_size() const noexcept { return _page_size; }
 };
 
 }// namespace luisa::compute
-
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <mutex>
+#include <fstream>
+
+#include <luisa/core/stl/vector.h>
+#include <luisa/core/stl/string.h>
+#include <luisa/core/stl/filesystem.h>
+#include <luisa/core/stl/unordered_map.h>
+#include <luisa/runtime/rhi/device_interface.h>
+
+namespace luisa::compute {
+
+class Device;
+
+/**
+ * @brief Operations recorded in a capture file.
+ *
+ * A capture file starts with CaptureWriter::magic and CaptureWriter::version
+ * (both u32), followed by records of (op: u32, payload size: u64, payload).
+ * Handles are stored as they were in the captured process and are remapped
+ * on replay.
+ */
+enum struct CaptureOp : uint32_t {
+    CREATE_BUFFER,
+    DESTROY_BUFFER,
+    CREATE_TEXTURE,
+    DESTROY_TEXTURE,
+    CREATE_BINDLESS_ARRAY,
+    DESTROY_BINDLESS_ARRAY,
+    CREATE_STREAM,
+    DESTROY_STREAM,
+    SYNCHRONIZE_STREAM,
+    DISPATCH,
+    CREATE_SHADER,
+    LOAD_SHADER,
+    DESTROY_SHADER,
+    CREATE_EVENT,
+    DESTROY_EVENT,
+    SIGNAL_EVENT,
+    WAIT_EVENT,
+    SYNCHRONIZE_EVENT,
+    CREATE_MESH,
+    DESTROY_MESH,
+    CREATE_PROCEDURAL_PRIMITIVE,
+    DESTROY_PROCEDURAL_PRIMITIVE,
+    CREATE_ACCEL,
+    DESTROY_ACCEL,
+    SET_NAME,
+};
+
+/**
+ * @brief Serializes DeviceInterface calls into a capture file.
+ *
+ * Used by the capture layer, which is stacked on top of the device when the
+ * LUISA_CAPTURE_FILE environment variable names the output file. Command
+ * lists are written with the data they upload, and kernels are written with
+ * FunctionSerializer, so the file is self-contained. Callbacks, swapchains,
+ * sparse resources, custom commands and kernels created from IR modules are
+ * not captured.
+ */
+class LC_RUNTIME_API CaptureWriter {
+
+public:
+    static constexpr uint32_t magic = 0x50434c4cu;// "LLCP"
+    static constexpr uint32_t version = 2u;
+
+private:
+    std::mutex _mutex;
+    std::ofstream _file;
+    luisa::vector<std::byte> _payload;
+
+private:
+    void _write_raw(const void *data, size_t size) noexcept;
+    template<typename T>
+        requires std::is_trivially_copyable_v<T>
+    void _write(const T &x) noexcept { _write_raw(&x, sizeof(T)); }
+    void _write(luisa::string_view s) noexcept;
+    void _write(luisa::span<const std::byte> bytes) noexcept;
+    void _write_command(const Command *command) noexcept;
+    void _commit(CaptureOp op) noexcept;
+
+public:
+    explicit CaptureWriter(const luisa::filesystem::path &path) noexcept;
+    ~CaptureWriter() noexcept;
+    CaptureWriter(CaptureWriter &&) noexcept = delete;
+    CaptureWriter(const CaptureWriter &) noexcept = delete;
+
+    /// Record a call whose arguments are trivially copyable values or strings
+    template<typename... Args>
+    void record(CaptureOp op, const Args &...args) noexcept {
+        std::scoped_lock lock{_mutex};
+        (_write(args), ...);
+        _commit(op);
+    }
+    void record_buffer(uint64_t handle, const Type *element, size_t element_count) noexcept;
+    void record_shader(uint64_t handle, const ShaderOption &option, Function kernel) noexcept;
+    void record_shader(uint64_t handle, luisa::string_view name, luisa::span<const Type *const> arg_types) noexcept;
+    void record_dispatch(uint64_t stream_handle, const CommandList &list) noexcept;
+    /// Write the pending records to the file
+    void flush() noexcept;
+};
+
+/**
+ * @brief Re-issues a capture file on a device.
+ *
+ * Replay is deterministic in the order of the captured calls. Resources are
+ * created as captured, uploads read from the file, downloads write to scratch
+ * memory, and host synchronizations split the replay into frames that are
+ * timed individually. Resource and shader creation is timed separately so
+ * that shader compilation does not pollute the frame times.
+ */
+class LC_RUNTIME_API CaptureReplayer {
+
+public:
+    struct Statistics {
+        size_t record_count;
+        size_t command_list_count;
+        size_t command_count;
+        double setup_milliseconds;  // resource and shader creation
+        double replay_milliseconds; // everything else, including the final synchronization
+        luisa::vector<double> frame_milliseconds;// between consecutive host synchronizations
+    };
+
+private:
+    DeviceInterface *_device;
+    luisa::vector<std::byte> _data;
+    luisa::unordered_map<uint64_t, uint64_t> _handles;// captured -> replayed
+    luisa::unordered_map<uint64_t, CaptureOp> _live;  // replayed -> creation op
+
+private:
+    [[nodiscard]] uint64_t _remap(uint64_t handle) const noexcept;
+    void _add(uint64_t captured, uint64_t replayed, CaptureOp op) noexcept;
+    [[nodiscard]] uint64_t _remove(uint64_t captured) noexcept;
+    void _destroy(uint64_t handle, CaptureOp op) noexcept;
+
+public:
+    explicit CaptureReplayer(const Device &device) noexcept;
+    ~CaptureReplayer() noexcept;
+    CaptureReplayer(CaptureReplayer &&) noexcept = delete;
+    CaptureReplayer(const CaptureReplayer &) noexcept = delete;
+    /// Replay the capture, destroying the resources left alive at its end
+    [[nodiscard]] Statistics replay(const luisa::filesystem::path &path) noexcept;
+};
+
+}// namespace luisa::compute
@@ -48,10 +48,12 @@ public:
     [[nodiscard]] const luisa::filesystem::path &create_runtime_subdir(luisa::string_view folder_name) const noexcept;
     // Create a virtual device
     // backend "metal", "dx", "cuda" is supported currently
+    // set the LUISA_CAPTURE_FILE environment variable to capture the device calls for replay (see CaptureWriter)
     [[nodiscard]] Device create_device(
         luisa::string_view backend_name,
         const DeviceConfig *settings = nullptr,
-        bool enable_validation = false) noexcept;
+        bool enable_validation = false,
+        bool enable_profiling = false) noexcept;
     // installed backends automatically detacted
     // The compiled backends' name is returned
     [[nodiscard]] luisa::span<const luisa::string> installed_backends() const noexcept;
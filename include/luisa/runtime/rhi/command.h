@@ -402,6 +402,17 @@ enum struct AccelBuildRequest : uint32_t {
     FORCE_BUILD,
 };
 
+enum struct MeshVertexFormat : uint32_t {
+    FLOAT3,   // 3 x float
+    HALF3,    // 3 x half
+    SNORM16_3,// 3 x int16, normalized to [-1, 1]
+};
+
+enum struct MeshIndexFormat : uint32_t {
+    UINT32,// Triangle
+    UINT16,// Triangle16
+};
+
 class MeshBuildCommand final : public Command {
 
 private:
@@ -414,6 +425,8 @@ private:
     uint64_t _triangle_buffer{};
     size_t _triangle_buffer_offset{};
     size_t _triangle_buffer_size{};
+    MeshVertexFormat _vertex_format{};
+    MeshIndexFormat _index_format{};
 
 private:
     MeshBuildCommand() noexcept
@@ -422,12 +435,15 @@ private:
 public:
     MeshBuildCommand(uint64_t handle, AccelBuildRequest request, uint64_t vertex_buffer,
                      size_t vertex_buffer_offset, size_t vertex_buffer_size, size_t vertex_stride,
-                     uint64_t triangle_buffer, size_t triangle_buffer_offset, size_t triangle_buffer_size) noexcept
+                     uint64_t triangle_buffer, size_t triangle_buffer_offset, size_t triangle_buffer_size,
+                     MeshVertexFormat vertex_format = MeshVertexFormat::FLOAT3,
+                     MeshIndexFormat index_format = MeshIndexFormat::UINT32) noexcept
         : Command{Command::Tag::EMeshBuildCommand}, _handle{handle}, _request{request},
           _vertex_buffer{vertex_buffer}, _vertex_buffer_offset{vertex_buffer_offset},
           _vertex_buffer_size{vertex_buffer_size}, _vertex_stride{vertex_stride},
           _triangle_buffer{triangle_buffer}, _triangle_buffer_offset{triangle_buffer_offset},
-          _triangle_buffer_size{triangle_buffer_size} {
+          _triangle_buffer_size{triangle_buffer_size},
+          _vertex_format{vertex_format}, _index_format{index_format} {
     }
     [[nodiscard]] auto handle() const noexcept { return _handle; }
     [[nodiscard]] auto request() const noexcept { return _request; }
@@ -438,6 +454,12 @@ public:
     [[nodiscard]] auto triangle_buffer() const noexcept { return _triangle_buffer; }
     [[nodiscard]] auto triangle_buffer_offset() const noexcept { return _triangle_buffer_offset; }
     [[nodiscard]] auto triangle_buffer_size() const noexcept { return _triangle_buffer_size; }
+    [[nodiscard]] auto vertex_format() const noexcept { return _vertex_format; }
+    [[nodiscard]] auto index_format() const noexcept { return _index_format; }
+    // size of a triangle (three indices) in the triangle buffer
+    [[nodiscard]] auto triangle_stride() const noexcept {
+        return _index_format == MeshIndexFormat::UINT16 ? sizeof(uint16_t) * 3u : sizeof(uint32_t) * 3u;
+    }
     LUISA_MAKE_COMMAND_COMMON(StreamTag::COMPUTE)
 };
 
@@ -11,6 +11,46 @@
 namespace luisa::compute {
 
 class Accel;
+
+namespace detail {
+
+// vertex positions are float3/float4, half3/half4, or short3/short4 normalized
+// to [-1, 1], the fourth component is ignored; non-vector vertex types (e.g.
+// structs with the position first) must start with 3 floats
+template<typename T>
+[[nodiscard]] constexpr auto mesh_vertex_format() noexcept {
+    if constexpr (is_vector_v<T>) {
+        using E = vector_element_t<T>;
+        if constexpr (vector_dimension_v<T> < 3u) {
+            static_assert(always_false_v<T>, "Mesh vertices must have at least 3 components.");
+        } else if constexpr (std::same_as<E, float>) {
+            return MeshVertexFormat::FLOAT3;
+        } else if constexpr (std::same_as<E, half>) {
+            return MeshVertexFormat::HALF3;
+        } else if constexpr (std::same_as<E, short>) {
+            return MeshVertexFormat::SNORM16_3;
+        } else {
+            static_assert(always_false_v<T>, "Unsupported mesh vertex element type.");
+        }
+    } else if constexpr (sizeof(T) >= sizeof(float) * 3u &&
+                         alignof(T) % alignof(float) == 0u) {
+        return MeshVertexFormat::FLOAT3;
+    } else {
+        static_assert(always_false_v<T>, "Unsupported mesh vertex type.");
+    }
+}
+
+template<typename T>
+[[nodiscard]] constexpr auto mesh_index_format() noexcept {
+    if constexpr (std::same_as<T, Triangle16>) {
+        return MeshIndexFormat::UINT16;
+    } else {
+        return MeshIndexFormat::UINT32;
+    }
+}
+
+}// namespace detail
+
 // Mesh is buttom-level acceleration structure(BLAS) for ray-tracing, it present triangle-mesh only, custom intersection see ProceduralPrimitive
 class LC_RUNTIME_API Mesh final : public Resource {
 
@@ -26,6 +66,8 @@ private:
     uint64_t _t_buffer{};
     size_t _t_buffer_offset{};
     size_t _t_buffer_size{};
+    MeshVertexFormat _v_format{};
+    MeshIndexFormat _t_format{};
 
 private:
     friend class Device;
@@ -33,7 +75,8 @@ private:
     template<typename VBuffer, typename TBuffer>
         requires is_buffer_or_view_v<VBuffer> &&
                  is_buffer_or_view_v<TBuffer> &&
-                 std::same_as<buffer_element_t<TBuffer>, Triangle>
+                 (std::same_as<buffer_element_t<TBuffer>, Triangle> ||
+                  std::same_as<buffer_element_t<TBuffer>, Triangle16>)
     [[nodiscard]] static ResourceCreationInfo _create_resource(
         DeviceInterface *device, const AccelOption &option,
         const VBuffer &vertex_buffer, const TBuffer &triangle_buffer) noexcept {
@@ -53,7 +96,9 @@ private:
           _v_stride(vertex_buffer.stride()),
           _t_buffer{BufferView{triangle_buffer}.handle()},
           _t_buffer_offset{BufferView{triangle_buffer}.offset_bytes()},
-          _t_buffer_size{BufferView{triangle_buffer}.size_bytes()} {}
+          _t_buffer_size{BufferView{triangle_buffer}.size_bytes()},
+          _v_format{detail::mesh_vertex_format<buffer_element_t<VBuffer>>()},
+          _t_format{detail::mesh_index_format<buffer_element_t<TBuffer>>()} {}
 
 public:
     Mesh() noexcept = default;
@@ -72,6 +117,14 @@ public:
         _check_is_valid();
         return _triangle_count;
     }
+    [[nodiscard]] auto vertex_format() const noexcept {
+        _check_is_valid();
+        return _v_format;
+    }
+    [[nodiscard]] auto index_format() const noexcept {
+        _check_is_valid();
+        return _t_format;
+    }
 };
 
 template<typename VBuffer, typename TBuffer>
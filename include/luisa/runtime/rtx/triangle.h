@@ -14,5 +14,15 @@ struct Triangle {
     uint32_t i2;
 };
 
+// triangle with 16-bit indices, for meshes with at most 65536 vertices
+struct Triangle16 {
+    uint16_t i0;
+    uint16_t i1;
+    uint16_t i2;
+};
+
+static_assert(sizeof(Triangle) == 12u);
+static_assert(sizeof(Triangle16) == 6u);
+
 }// namespace luisa::compute
 
@@ -9,6 +9,7 @@
 #endif
 
 #include <luisa/core/basic_types.h>
+#include <luisa/core/compile_report.h>
 #include <luisa/ast/function_builder.h>
 #include <luisa/runtime/rhi/resource.h>
 #include <luisa/runtime/device.h>
@@ -207,7 +208,11 @@ private:
     Shader(DeviceInterface *device,
            Function kernel,
            const ShaderOption &option) noexcept
-        : Shader{device, device->create_shader(option, kernel),
+        : Shader{device,
+                 [&] {
+                     CompileProfiler::Scope report{option.name, kernel.hash()};
+                     return device->create_shader(option, kernel);
+                 }(),
                  ShaderDispatchCmdEncoder::compute_uniform_size(kernel.arguments())} {}
 
 #ifdef LUISA_ENABLE_IR
@@ -215,7 +220,12 @@ private:
     Shader(DeviceInterface *device,
            const ir::KernelModule *const module,
            const ShaderOption &option) noexcept
-        : Shader{device, device->create_shader(option, module),
+        : Shader{device,
+                 [&] {
+                     // IR modules are not traced by the DSL, so there is no AST hash to match
+                     CompileProfiler::Scope report{option.name, 0u};
+                     return device->create_shader(option, module);
+                 }(),
                  [module] {
                      luisa::vector<const Type *> arg_types;
                      arg_types.reserve(module->args.len);
@@ -19,6 +19,12 @@ typedef enum LCAccelUsageHint {
     LC_ACCEL_USAGE_HINT_FAST_BUILD,
 } LCAccelUsageHint;
 
+typedef enum LCMeshVertexFormat {
+    LC_MESH_VERTEX_FORMAT_FLOAT3,
+    LC_MESH_VERTEX_FORMAT_HALF3,
+    LC_MESH_VERTEX_FORMAT_SNORM16X3,
+} LCMeshVertexFormat;
+
 typedef enum LCBindlessArrayUpdateOperation {
     LC_BINDLESS_ARRAY_UPDATE_OPERATION_NONE,
     LC_BINDLESS_ARRAY_UPDATE_OPERATION_EMPLACE,
@@ -56,6 +62,10 @@ typedef enum LCPixelFormat {
     LC_PIXEL_FORMAT_R32F,
     LC_PIXEL_FORMAT_RG32F,
     LC_PIXEL_FORMAT_RGBA32F,
+    LC_PIXEL_FORMAT_BC4_UNORM,
+    LC_PIXEL_FORMAT_BC5_UNORM,
+    LC_PIXEL_FORMAT_BC6H_UF16,
+    LC_PIXEL_FORMAT_BC7_UNORM,
 } LCPixelFormat;
 
 typedef enum LCPixelStorage {
@@ -74,6 +84,10 @@ typedef enum LCPixelStorage {
     LC_PIXEL_STORAGE_FLOAT1,
     LC_PIXEL_STORAGE_FLOAT2,
     LC_PIXEL_STORAGE_FLOAT4,
+    LC_PIXEL_STORAGE_BC4,
+    LC_PIXEL_STORAGE_BC5,
+    LC_PIXEL_STORAGE_BC6,
+    LC_PIXEL_STORAGE_BC7,
 } LCPixelStorage;
 
 typedef enum LCSamplerAddress {
@@ -96,6 +110,13 @@ typedef enum LCStreamTag {
     LC_STREAM_TAG_COPY,
 } LCStreamTag;
 
+typedef enum LCCompileEventKind {
+    LC_COMPILE_EVENT_KIND_PHASE,
+    LC_COMPILE_EVENT_KIND_COUNTER,
+    LC_COMPILE_EVENT_KIND_CACHE_HIT,
+    LC_COMPILE_EVENT_KIND_CACHE_MISS,
+} LCCompileEventKind;
+
 typedef struct LCBuffer {
     uint64_t _0;
 } LCBuffer;
@@ -287,6 +308,7 @@ typedef struct LCMeshBuildCommand {
     size_t vertex_buffer_offset;
     size_t vertex_buffer_size;
     size_t vertex_stride;
+    enum LCMeshVertexFormat vertex_format;
     struct LCBuffer index_buffer;
     size_t index_buffer_offset;
     size_t index_buffer_size;
@@ -509,6 +531,13 @@ typedef struct LCLoggerMessage {
     const char *message;
 } LCLoggerMessage;
 
+typedef struct LCCompileEvent {
+    LCCompileEventKind kind;
+    const char *name;
+    double milliseconds;
+    uint64_t value;
+} LCCompileEvent;
+
 typedef struct LCLibInterface {
     void *inner;
     void (*set_logger_callback)(void(*)(struct LCLoggerMessage));
@@ -516,4 +545,5 @@ typedef struct LCLibInterface {
     void (*destroy_context)(struct LCContext);
     struct LCDeviceInterface (*create_device)(struct LCContext, const char*, const char*);
     void (*free_string)(char*);
+    void (*set_compile_event_callback)(void(*)(struct LCCompileEvent));
 } LCLibInterface;
@@ -22,6 +22,12 @@ enum class AccelUsageHint {
     FAST_BUILD,
 };
 
+enum class MeshVertexFormat {
+    FLOAT3,
+    HALF3,
+    SNORM16X3,
+};
+
 enum class BindlessArrayUpdateOperation {
     NONE,
     EMPLACE,
@@ -59,6 +65,10 @@ enum class PixelFormat {
     R32F,
     RG32F,
     RGBA32F,
+    BC4_UNORM,
+    BC5_UNORM,
+    BC6H_UF16,
+    BC7_UNORM,
 };
 
 enum class PixelStorage {
@@ -77,6 +87,10 @@ enum class PixelStorage {
     FLOAT1,
     FLOAT2,
     FLOAT4,
+    BC4,
+    BC5,
+    BC6,
+    BC7,
 };
 
 enum class SamplerAddress {
@@ -99,6 +113,13 @@ enum class StreamTag {
     COPY,
 };
 
+enum class CompileEventKind {
+    PHASE,
+    COUNTER,
+    CACHE_HIT,
+    CACHE_MISS,
+};
+
 struct Buffer {
     uint64_t _0;
 };
@@ -328,6 +349,7 @@ struct MeshBuildCommand {
     size_t vertex_buffer_offset;
     size_t vertex_buffer_size;
     size_t vertex_stride;
+    MeshVertexFormat vertex_format;
     Buffer index_buffer;
     size_t index_buffer_offset;
     size_t index_buffer_size;
@@ -566,6 +588,13 @@ struct LoggerMessage {
     const char *message;
 };
 
+struct CompileEvent {
+    CompileEventKind kind;
+    const char *name;
+    double milliseconds;
+    uint64_t value;
+};
+
 struct LibInterface {
     void *inner;
     void (*set_logger_callback)(void(*)(LoggerMessage));
@@ -573,6 +602,7 @@ struct LibInterface {
     void (*destroy_context)(Context);
     DeviceInterface (*create_device)(Context, const char*, const char*);
     void (*free_string)(char*);
+    void (*set_compile_event_callback)(void(*)(CompileEvent));
 };
 
 } // namespace luisa::compute::api
@@ -356,6 +356,48 @@ struct Func {
         Transpose,
         Inverse,
         SynchronizeBlock,
+        /// () -> uint: number of lanes in a warp
+        WarpSize,
+        /// () -> uint: index of the current lane in its warp
+        WarpLaneId,
+        /// () -> bool
+        WarpIsFirstActiveLane,
+        /// () -> uint
+        WarpFirstActiveLane,
+        /// (scalar/vector) -> bool/boolN
+        WarpActiveAllEqual,
+        /// (intN/uintN) -> intN/uintN
+        WarpActiveBitAnd,
+        /// (intN/uintN) -> intN/uintN
+        WarpActiveBitOr,
+        /// (intN/uintN) -> intN/uintN
+        WarpActiveBitXor,
+        /// (bool) -> uint
+        WarpActiveCountBits,
+        /// (scalar/vector) -> scalar/vector
+        WarpActiveMax,
+        /// (scalar/vector) -> scalar/vector
+        WarpActiveMin,
+        /// (scalar/vector) -> scalar/vector
+        WarpActiveProduct,
+        /// (scalar/vector) -> scalar/vector
+        WarpActiveSum,
+        /// (bool) -> bool
+        WarpActiveAll,
+        /// (bool) -> bool
+        WarpActiveAny,
+        /// (bool) -> uint4: ballot of the active lanes, lane i in bit (i % 32) of component (i / 32)
+        WarpActiveBitMask,
+        /// (bool) -> uint: count of the preceding active lanes with true
+        WarpPrefixCountBits,
+        /// (scalar/vector) -> scalar/vector: exclusive sum over the preceding active lanes
+        WarpPrefixSum,
+        /// (scalar/vector) -> scalar/vector: exclusive product over the preceding active lanes
+        WarpPrefixProduct,
+        /// (value, lane: uint) -> value: reads the value from the given lane
+        WarpReadLaneAt,
+        /// (value) -> value: reads the value from the first active lane
+        WarpReadFirstLane,
         /// (buffer/smem, index, desired) -> old: stores desired, returns old.
         AtomicExchange,
         /// (buffer/smem, index, expected, desired) -> old: stores (old == expected ? desired : old), returns old.
@@ -85,6 +85,18 @@ private:
             }
             LUISA_ERROR_WITH_LOCATION("Unreachable.");
         };
+        auto convert_vertex_format = [](LCMeshVertexFormat format) noexcept {
+            switch (format) {
+                case LC_MESH_VERTEX_FORMAT_FLOAT3:
+                    return MeshVertexFormat::FLOAT3;
+                case LC_MESH_VERTEX_FORMAT_HALF3:
+                    return MeshVertexFormat::HALF3;
+                case LC_MESH_VERTEX_FORMAT_SNORM16X3:
+                    return MeshVertexFormat::SNORM16_3;
+                default: break;
+            }
+            LUISA_ERROR_WITH_LOCATION("Unreachable.");
+        };
         switch (cmd.tag) {
             case LC_COMMAND_BUFFER_COPY: {
                 auto c = cmd.buffer_copy;
@@ -230,16 +242,18 @@ private:
             }
             case LC_COMMAND_MESH_BUILD: {
                 auto [mesh, request,
-                      vertex_buffer, vertex_buffer_offset, vertex_buffer_size, vertex_stride,
+                      vertex_buffer, vertex_buffer_offset, vertex_buffer_size, vertex_stride, vertex_format,
                       index_buffer, index_buffer_offset, index_buffer_size, index_stride] = cmd.mesh_build;
-                LUISA_ASSERT(index_stride == sizeof(Triangle),
-                             "Index stride must be {} (got {}).",
-                             sizeof(Triangle), index_stride);
+                LUISA_ASSERT(index_stride == sizeof(Triangle) || index_stride == sizeof(Triangle16),
+                             "Index stride must be {} or {} (got {}).",
+                             sizeof(Triangle), sizeof(Triangle16), index_stride);
                 return luisa::make_unique<MeshBuildCommand>(
                     mesh._0,
                     convert_accel_request(request),
                     vertex_buffer._0, vertex_buffer_offset, vertex_buffer_size, vertex_stride,
-                    index_buffer._0, index_buffer_offset, index_buffer_size);
+                    index_buffer._0, index_buffer_offset, index_buffer_size,
+                    convert_vertex_format(vertex_format),
+                    index_stride == sizeof(Triangle16) ? MeshIndexFormat::UINT16 : MeshIndexFormat::UINT32);
             }
             case LC_COMMAND_PROCEDURAL_PRIMITIVE_BUILD: {
                 auto [primitive, request, aabb_buffer, aabb_offset, aabb_count] = cmd.procedural_primitive_build;
@@ -738,5 +752,7 @@ LUISA_EXPORT_API LCLibInterface luisa_compute_lib_interface() {
     interface.destroy_context = luisa_compute_context_destroy;
     interface.create_device = luisa_compute_device_interface_create;
     interface.free_string = luisa_compute_free_c_string;
+    // devices of this library record compile events into CompileProfiler directly
+    interface.set_compile_event_callback = [](void (*)(LCCompileEvent)) {};
     return interface;
 }
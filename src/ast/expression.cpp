@@ -106,18 +106,18 @@ uint64_t CallExpr::_compute_hash() const noexcept {
 
 CallExpr::CallExpr(const Type *type, CallOp builtin, CallExpr::ArgumentList args) noexcept
     : Expression{Tag::CALL, type},
-      _arguments{std::move(args)},
+      _arguments{args},
       _op{builtin} { _mark(); }
 
 CallExpr::CallExpr(const Type *type, Function callable, CallExpr::ArgumentList args) noexcept
     : Expression{Tag::CALL, type},
-      _arguments{std::move(args)},
+      _arguments{args},
       _op{CallOp::CUSTOM},
       _func{callable.builder()} { _mark(); }
 
 CallExpr::CallExpr(const Type *type, const ExternalFunction *external, ArgumentList args) noexcept
     : Expression{Tag::CALL, type},
-      _arguments{std::move(args)},
+      _arguments{args},
       _op{CallOp::EXTERNAL},
       _func{external} { _mark(); }
 
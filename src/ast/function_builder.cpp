@@ -2,11 +2,40 @@
 // Created by Mike Smith on 2020/12/2.
 //
 
+#include <array>
+#include <atomic>
+
 #include <luisa/core/logging.h>
+#include <luisa/core/compile_report.h>
 #include <luisa/ast/function_builder.h>
+#include <luisa/ast/ast_evaluator.h>
 
 namespace luisa::compute::detail {
 
+namespace {
+std::atomic<bool> constant_folding_enabled{false};
+}// namespace
+
+void FunctionBuilder::set_constant_folding(bool enabled) noexcept {
+    constant_folding_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool FunctionBuilder::constant_folding_default() noexcept {
+    return constant_folding_enabled.load(std::memory_order_relaxed);
+}
+
+void FunctionBuilder::_record_trace(double milliseconds) const noexcept {
+    if (!CompileProfiler::is_enabled()) { return; }
+    std::array counters{
+        ShaderCompileReport::Counter{"ast.expressions", _expression_count},
+        ShaderCompileReport::Counter{"ast.statements", _statement_count},
+        ShaderCompileReport::Counter{"ast.memory_bytes", _arena.total_size()},
+        ShaderCompileReport::Counter{"ast.local_variables", _local_variables.size()},
+        ShaderCompileReport::Counter{"ast.arguments", _arguments.size()},
+        ShaderCompileReport::Counter{"ast.custom_callables", _used_custom_callables.size()}};
+    CompileProfiler::record_trace(hash(), milliseconds, luisa::span{counters.data(), counters.size()});
+}
+
 luisa::vector<FunctionBuilder *> &FunctionBuilder::_function_stack() noexcept {
     static thread_local luisa::vector<FunctionBuilder *> stack;
     return stack;
@@ -41,11 +70,18 @@ void FunctionBuilder::pop(FunctionBuilder *func) noexcept {
             f->_arguments.size(), f->_bound_arguments.size());
     }
 
-    // hash
-    f->_compute_hash();
+    // fold constant branches before hashing so that equivalent functions hash equal
+    if (f->_constant_folding) {
+        f->_fold_constant_branches(&f->_body);
+        f->_prune_unreachable_records();
+    }
+
+    // hash the arguments in their final order so that the hash
+    // can be recomputed from a deserialized function
     if (f->_tag == Function::Tag::KERNEL) {
         f->sort_bindings();
     }
+    f->_compute_hash();
 
     // clear temporary data
     for (auto p : f->_temporary_data) {
@@ -100,19 +136,27 @@ void FunctionBuilder::return_(const Expression *expr) noexcept {
     }
 }
 
+// Note: the bodies of loops, ray queries and autodiff scopes might be executed
+//  multiple times, so reads inside them may observe values written later in the
+//  bodies. We simply forget all the known literals when entering such statements.
+
 RayQueryStmt *FunctionBuilder::ray_query_(const RefExpr *query) noexcept {
+    _known_literals.clear();
     return _create_and_append_statement<RayQueryStmt>(query);
 }
 
 AutoDiffStmt *FunctionBuilder::autodiff_() noexcept {
+    _known_literals.clear();
     return _create_and_append_statement<AutoDiffStmt>();
 }
 
 IfStmt *FunctionBuilder::if_(const Expression *cond) noexcept {
+    if (_constant_folding) { cond = _known_value(cond); }
     return _create_and_append_statement<IfStmt>(cond);
 }
 
 LoopStmt *FunctionBuilder::loop_() noexcept {
+    _known_literals.clear();
     return _create_and_append_statement<LoopStmt>();
 }
 
@@ -121,6 +165,7 @@ void FunctionBuilder::_void_expr(const Expression *expr) noexcept {
 }
 
 SwitchStmt *FunctionBuilder::switch_(const Expression *expr) noexcept {
+    if (_constant_folding) { expr = _known_value(expr); }
     return _create_and_append_statement<SwitchStmt>(expr);
 }
 
@@ -133,6 +178,20 @@ SwitchDefaultStmt *FunctionBuilder::default_() noexcept {
 }
 
 void FunctionBuilder::assign(const Expression *lhs, const Expression *rhs) noexcept {
+    if (_constant_folding) {
+        rhs = _known_value(rhs);
+        if (lhs->tag() == Expression::Tag::REF &&
+            rhs->tag() == Expression::Tag::LITERAL &&
+            *lhs->type() == *rhs->type()) {
+            if (auto v = static_cast<const RefExpr *>(lhs)->variable();
+                v.tag() == Variable::Tag::LOCAL) {
+                _known_literals.insert_or_assign(
+                    v.uid(), std::make_pair(_scope_stack.back(), rhs));
+            }
+        } else {
+            _forget_known_value(lhs);
+        }
+    }
     _create_and_append_statement<AssignStmt>(lhs, rhs);
 }
 
@@ -240,12 +299,62 @@ const RefExpr *FunctionBuilder::buffer_binding(const Type *type, uint64_t handle
     return _ref(v);
 }
 
-const UnaryExpr *FunctionBuilder::unary(const Type *type, UnaryOp op, const Expression *expr) noexcept {
-    return _create_expression<UnaryExpr>(type, op, expr);
+const Expression *FunctionBuilder::unary(const Type *type, UnaryOp op, const Expression *expr) noexcept {
+    if (_constant_folding) { expr = _known_value(expr); }
+    auto e = _create_expression<UnaryExpr>(type, op, expr);
+    if (_constant_folding && expr->tag() == Expression::Tag::LITERAL) {
+        // the evaluator does not distinguish logical from arithmetic negation
+        auto is_bool = expr->type()->is_bool() ||
+                       (expr->type()->is_vector() && expr->type()->element()->is_bool());
+        if ((op == UnaryOp::NOT) == is_bool) { return _fold_constant(e); }
+    }
+    return e;
+}
+
+[[nodiscard]] static auto is_safe_to_fold(BinaryOp op, const Expression *rhs) noexcept {
+    if (op != BinaryOp::DIV && op != BinaryOp::MOD &&
+        op != BinaryOp::SHL && op != BinaryOp::SHR) { return true; }
+    // integer division by zero (or of INT_MIN by -1) and over-wide
+    // shifts are undefined on the host, so leave them to the device
+    auto check = [op]<typename T>(T x) noexcept {
+        if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>) {
+            if (op == BinaryOp::DIV || op == BinaryOp::MOD) {
+                return x != T{0} && !(std::is_signed_v<T> && x == static_cast<T>(-1));
+            }
+            return static_cast<std::make_unsigned_t<T>>(x) < sizeof(T) * 8u;
+        } else {
+            return true;
+        }
+    };
+    return luisa::visit(
+        [&]<typename T>(const T &v) noexcept {
+            if constexpr (is_scalar_v<T>) {
+                return check(v);
+            } else if constexpr (is_vector_v<T>) {
+                for (auto i = 0u; i < vector_dimension_v<T>; i++) {
+                    if (!check(v[i])) { return false; }
+                }
+                return true;
+            } else {
+                return true;
+            }
+        },
+        static_cast<const LiteralExpr *>(rhs)->value());
 }
 
-const BinaryExpr *FunctionBuilder::binary(const Type *type, BinaryOp op, const Expression *lhs, const Expression *rhs) noexcept {
-    return _create_expression<BinaryExpr>(type, op, lhs, rhs);
+const Expression *FunctionBuilder::binary(const Type *type, BinaryOp op, const Expression *lhs, const Expression *rhs) noexcept {
+    if (_constant_folding) {
+        lhs = _known_value(lhs);
+        rhs = _known_value(rhs);
+    }
+    auto e = _create_expression<BinaryExpr>(type, op, lhs, rhs);
+    if (_constant_folding &&
+        lhs->tag() == Expression::Tag::LITERAL &&
+        rhs->tag() == Expression::Tag::LITERAL &&
+        is_safe_to_fold(op, rhs)) {
+        return _fold_constant(e);
+    }
+    return e;
 }
 
 const MemberExpr *FunctionBuilder::member(const Type *type, const Expression *self, size_t member_index) noexcept {
@@ -303,8 +412,248 @@ const AccessExpr *FunctionBuilder::access(const Type *type, const Expression *ra
     return _create_expression<AccessExpr>(type, range, index);
 }
 
-const CastExpr *FunctionBuilder::cast(const Type *type, CastOp op, const Expression *expr) noexcept {
-    return _create_expression<CastExpr>(type, op, expr);
+const Expression *FunctionBuilder::cast(const Type *type, CastOp op, const Expression *expr) noexcept {
+    if (_constant_folding) { expr = _known_value(expr); }
+    auto e = _create_expression<CastExpr>(type, op, expr);
+    if (_constant_folding && expr->tag() == Expression::Tag::LITERAL) {
+        return _fold_constant(e);
+    }
+    return e;
+}
+
+const Expression *FunctionBuilder::_fold_constant(const Expression *expr) noexcept {
+    ASTEvaluator evaluator;
+    return luisa::visit(
+        [&]<typename T>(const T &v) noexcept -> const Expression * {
+            if constexpr (std::is_same_v<T, luisa::monostate>) {
+                return expr;
+            } else {
+                // the evaluator may compute in a different type (e.g.,
+                // for 16- and 64-bit scalars), keep the expression then
+                if (!(*expr->type() == *Type::of<T>())) { return expr; }
+                return literal(expr->type(), v);
+            }
+        },
+        evaluator.try_eval(expr));
+}
+
+const Expression *FunctionBuilder::_known_value(const Expression *expr) const noexcept {
+    if (expr->tag() != Expression::Tag::REF) { return expr; }
+    auto iter = _known_literals.find(static_cast<const RefExpr *>(expr)->variable().uid());
+    if (iter == _known_literals.end()) { return expr; }
+    // the value is only observed in the scope it's assigned in and the nested ones
+    auto [scope, value] = iter->second;
+    return std::find(_scope_stack.cbegin(), _scope_stack.cend(), scope) == _scope_stack.cend() ?
+               expr :
+               value;
+}
+
+void FunctionBuilder::_forget_known_value(const Expression *expr) noexcept {
+    if (_known_literals.empty()) { return; }
+    // find the root variable of the (possibly partially) written expression
+    for (;;) {
+        if (expr->tag() == Expression::Tag::MEMBER) {
+            expr = static_cast<const MemberExpr *>(expr)->self();
+        } else if (expr->tag() == Expression::Tag::ACCESS) {
+            expr = static_cast<const AccessExpr *>(expr)->range();
+        } else {
+            break;
+        }
+    }
+    if (expr->tag() == Expression::Tag::REF) {
+        _known_literals.erase(static_cast<const RefExpr *>(expr)->variable().uid());
+    }
+}
+
+[[nodiscard]] static bool is_dead_loop_body(const ScopeStmt *body) noexcept {
+    if (body->statements().empty()) { return false; }
+    auto first = body->statements().front();
+    if (first->tag() == Statement::Tag::BREAK) { return true; }
+    return first->tag() == Statement::Tag::SCOPE &&
+           is_dead_loop_body(static_cast<const ScopeStmt *>(first));
+}
+
+// The DSL initializes the loop variable and bounds of for loops right before the loops.
+// If they are initialized with literals and not referenced since, we know the values
+// on loop entry and can check if the loop is ever entered.
+static void seed_initial_values(ASTEvaluator &evaluator,
+                                luisa::span<const Statement *const> preceding,
+                                const Expression *cond) noexcept {
+    luisa::vector<Variable> variables;
+    traverse_subexpressions(
+        cond,
+        [&variables](const Expression *e) noexcept {
+            if (e->tag() == Expression::Tag::REF) {
+                if (auto v = static_cast<const RefExpr *>(e)->variable();
+                    v.tag() == Variable::Tag::LOCAL) { variables.emplace_back(v); }
+            }
+        },
+        [](auto) noexcept {});
+    auto refers_to = [](const Expression *e, Variable v) noexcept {
+        return e->tag() == Expression::Tag::REF &&
+               static_cast<const RefExpr *>(e)->variable() == v;
+    };
+    for (auto v : variables) {
+        for (auto iter = preceding.rbegin(); iter != preceding.rend(); iter++) {
+            auto s = *iter;
+            if (s->tag() == Statement::Tag::ASSIGN) {
+                if (auto assign = static_cast<const AssignStmt *>(s);
+                    refers_to(assign->lhs(), v)) {
+                    if (assign->rhs()->tag() == Expression::Tag::LITERAL) {
+                        evaluator.assign(assign);
+                    }
+                    break;
+                }
+            }
+            auto referenced = false;
+            traverse_expressions<true>(
+                s,
+                [&](const Expression *e) noexcept { referenced |= refers_to(e, v); },
+                [](auto) noexcept {},
+                [](auto) noexcept {});
+            if (referenced) { break; }
+        }
+    }
+}
+
+void FunctionBuilder::_fold_constant_branches(ScopeStmt *scope) noexcept {
+    luisa::vector<const Statement *> statements{scope->statements().begin(),
+                                                scope->statements().end()};
+    while (!scope->statements().empty()) { static_cast<void>(scope->pop()); }
+    auto folded = [this](const ScopeStmt *s) noexcept {
+        // nested scopes are owned by this builder, so it's safe to modify them in-place
+        auto mutable_scope = const_cast<ScopeStmt *>(s);
+        _fold_constant_branches(mutable_scope);
+        return mutable_scope;
+    };
+    // statements after unconditional control transfers are unreachable
+    auto reachable = true;
+    auto emit = [scope, &reachable](const Statement *stmt) noexcept {
+        scope->append(stmt);
+        reachable = stmt->tag() != Statement::Tag::BREAK &&
+                    stmt->tag() != Statement::Tag::CONTINUE &&
+                    stmt->tag() != Statement::Tag::RETURN;
+    };
+    for (auto i = 0u; reachable && i < statements.size(); i++) {
+        auto stmt = statements[i];
+        switch (stmt->tag()) {
+            case Statement::Tag::SCOPE: folded(static_cast<const ScopeStmt *>(stmt)); break;
+            case Statement::Tag::IF: {
+                auto if_stmt = static_cast<const IfStmt *>(stmt);
+                ASTEvaluator evaluator;
+                if (auto taken = evaluator.map_if(if_stmt); taken != nullptr) {
+                    // local variables are declared at function scope, so
+                    // the taken branch can be spliced into this scope
+                    for (auto s : folded(static_cast<const ScopeStmt *>(taken))->statements()) {
+                        if (reachable) { emit(s); }
+                    }
+                    continue;
+                }
+                folded(if_stmt->true_branch());
+                folded(if_stmt->false_branch());
+                break;
+            }
+            case Statement::Tag::LOOP: {
+                auto body = folded(static_cast<const LoopStmt *>(stmt)->body());
+                if (is_dead_loop_body(body)) { continue; }
+                break;
+            }
+            case Statement::Tag::SWITCH: {
+                for (auto c : static_cast<const SwitchStmt *>(stmt)->body()->statements()) {
+                    if (c->tag() == Statement::Tag::SWITCH_CASE) {
+                        folded(static_cast<const SwitchCaseStmt *>(c)->body());
+                    } else if (c->tag() == Statement::Tag::SWITCH_DEFAULT) {
+                        folded(static_cast<const SwitchDefaultStmt *>(c)->body());
+                    }
+                }
+                break;
+            }
+            case Statement::Tag::FOR: {
+                auto for_stmt = static_cast<const ForStmt *>(stmt);
+                ASTEvaluator evaluator;
+                seed_initial_values(evaluator, luisa::span{statements}.subspan(0u, i),
+                                    for_stmt->condition());
+                if (auto cond = evaluator.try_eval(for_stmt->condition());
+                    luisa::holds_alternative<bool>(cond) && !luisa::get<bool>(cond)) {
+                    continue;
+                }
+                folded(for_stmt->body());
+                break;
+            }
+            case Statement::Tag::RAY_QUERY: {
+                auto q = static_cast<const RayQueryStmt *>(stmt);
+                folded(q->on_triangle_candidate());
+                folded(q->on_procedural_candidate());
+                break;
+            }
+            case Statement::Tag::AUTO_DIFF: folded(static_cast<const AutoDiffStmt *>(stmt)->body()); break;
+            default: break;
+        }
+        emit(stmt);
+    }
+}
+
+void FunctionBuilder::_prune_unreachable_records() noexcept {
+    // re-collect variable usages and callees from the statements that survived
+    // folding, so that removed branches leave no trace in the function. Note:
+    //  references to the same variable may share the expression node, so the
+    //  recorded usages are conservative (but never miss a surviving access)
+    luisa::vector<Usage> usages(_variable_usages.size(), Usage::NONE);
+    luisa::vector<uint64_t> constants;
+    luisa::vector<const FunctionBuilder *> customs;
+    luisa::vector<const ExternalFunction *> externals;
+    CallOpSet builtins;
+    auto requires_atomic_float = false;
+    traverse_expressions<true>(
+        &_body,
+        [&](const Expression *expr) noexcept {
+            switch (expr->tag()) {
+                case Expression::Tag::REF: {
+                    auto uid = static_cast<const RefExpr *>(expr)->variable().uid();
+                    usages[uid] = static_cast<Usage>(to_underlying(usages[uid]) |
+                                                     to_underlying(expr->usage()));
+                    break;
+                }
+                case Expression::Tag::CONSTANT:
+                    constants.emplace_back(static_cast<const ConstantExpr *>(expr)->data().hash());
+                    break;
+                case Expression::Tag::CALL: {
+                    auto call = static_cast<const CallExpr *>(expr);
+                    if (call->is_custom()) {
+                        customs.emplace_back(call->custom().builder());
+                    } else if (call->is_external()) {
+                        externals.emplace_back(call->external());
+                    } else {
+                        builtins.mark(call->op());
+                        if (is_atomic_operation(call->op()) &&
+                            call->arguments().front()->type()->element()->is_float32()) {
+                            requires_atomic_float = true;
+                        }
+                    }
+                    break;
+                }
+                default: break;
+            }
+        },
+        [](auto) noexcept {},
+        [](auto) noexcept {});
+    auto prune = [](auto &records, const auto &used, auto key) noexcept {
+        records.erase(std::remove_if(records.begin(), records.end(), [&](auto &&r) noexcept {
+                          return std::find(used.cbegin(), used.cend(), key(r)) == used.cend();
+                      }),
+                      records.end());
+    };
+    prune(_captured_constants, constants, [](auto &&c) noexcept { return c.hash(); });
+    prune(_used_custom_callables, customs, [](auto &&f) noexcept { return f.get(); });
+    prune(_used_external_functions, externals, [](auto &&f) noexcept { return f.get(); });
+    _variable_usages = std::move(usages);
+    _direct_builtin_callables = builtins;
+    _propagated_builtin_callables = builtins;
+    _requires_atomic_float = requires_atomic_float;
+    for (auto &&f : _used_custom_callables) {
+        _propagated_builtin_callables.propagate(f->_propagated_builtin_callables);
+        _requires_atomic_float |= f->_requires_atomic_float;
+    }
 }
 
 const RefExpr *FunctionBuilder::_ref(Variable v) noexcept {
@@ -338,6 +687,7 @@ void FunctionBuilder::pop_scope(const ScopeStmt *s) noexcept {
 }
 
 ForStmt *FunctionBuilder::for_(const Expression *var, const Expression *condition, const Expression *update) noexcept {
+    _known_literals.clear();
     return _create_and_append_statement<ForStmt>(var, condition, update);
 }
 
@@ -350,7 +700,7 @@ void FunctionBuilder::mark_variable_usage(uint32_t uid, Usage usage) noexcept {
 FunctionBuilder::~FunctionBuilder() noexcept = default;
 
 FunctionBuilder::FunctionBuilder(FunctionBuilder::Tag tag) noexcept
-    : _hash{0ul}, _tag{tag} {}
+    : _hash{0ul}, _tag{tag}, _constant_folding{constant_folding_default()} {}
 
 const RefExpr *FunctionBuilder::texture(const Type *type) noexcept {
     Variable v{type, Variable::Tag::TEXTURE, _next_variable_uid()};
@@ -385,7 +735,7 @@ const RefExpr *FunctionBuilder::texture_binding(const Type *type, uint64_t handl
     return _ref(v);
 }
 
-const CallExpr *FunctionBuilder::call(const Type *type, CallOp call_op, std::initializer_list<const Expression *> args) noexcept {
+const Expression *FunctionBuilder::call(const Type *type, CallOp call_op, std::initializer_list<const Expression *> args) noexcept {
     luisa::vector<const Expression *> arg_list{args};
     return call(type, call_op, arg_list);
 }
@@ -485,12 +835,31 @@ const RefExpr *FunctionBuilder::accel() noexcept {
 }
 
 // call builtin functions
-const CallExpr *FunctionBuilder::call(const Type *type, CallOp call_op, luisa::span<const Expression *const> args) noexcept {
+const Expression *FunctionBuilder::call(const Type *type, CallOp call_op, luisa::span<const Expression *const> args) noexcept {
     if (call_op == CallOp::CUSTOM) [[unlikely]] {
         LUISA_ERROR_WITH_LOCATION(
             "Custom functions are not allowed to "
             "be called with enum CallOp.");
     }
+    // fold before marking the call op, so that folded calls are not reported as used
+    if (_constant_folding) {
+        if (type != nullptr && !args.empty()) {
+            luisa::vector<const Expression *> known_args;
+            known_args.reserve(args.size());
+            for (auto arg : args) { known_args.emplace_back(_known_value(arg)); }
+            if (std::all_of(known_args.cbegin(), known_args.cend(), [](auto arg) noexcept {
+                    return arg->tag() == Expression::Tag::LITERAL;
+                })) {
+                auto candidate = _create_expression<CallExpr>(
+                    type, call_op, _create_argument_list(known_args));
+                if (auto folded = _fold_constant(candidate); folded != candidate) { return folded; }
+            }
+        }
+        // conservatively assume that builtins may write to their arguments
+        for (auto arg : args) { _forget_known_value(arg); }
+    }
+    auto expr = _create_expression<CallExpr>(
+        type, call_op, _create_argument_list(args));
     _direct_builtin_callables.mark(call_op);
     _propagated_builtin_callables.mark(call_op);
     if (is_atomic_operation(call_op)) {
@@ -499,8 +868,6 @@ const CallExpr *FunctionBuilder::call(const Type *type, CallOp call_op, luisa::s
             _requires_atomic_float = true;
         }
     }
-    auto expr = _create_expression<CallExpr>(
-        type, call_op, CallExpr::ArgumentList{args.begin(), args.end()});
     if (type == nullptr) {
         _void_expr(expr);
         return nullptr;
@@ -511,9 +878,11 @@ const CallExpr *FunctionBuilder::call(const Type *type, CallOp call_op, luisa::s
 const CallExpr *FunctionBuilder::call(const Type *type,
                                       luisa::shared_ptr<const ExternalFunction> func,
                                       luisa::span<const Expression *const> args) noexcept {
+    if (_constant_folding) {
+        for (auto arg : args) { _forget_known_value(arg); }
+    }
     auto expr = _create_expression<CallExpr>(
-        type, func.get(),
-        CallExpr::ArgumentList{args.begin(), args.end()});
+        type, func.get(), _create_argument_list(args));
     if (auto iter = std::find(_used_external_functions.cbegin(),
                               _used_external_functions.cend(), func);
         iter == _used_external_functions.cend()) {
@@ -537,8 +906,12 @@ const CallExpr *FunctionBuilder::call(const Type *type, Function custom, luisa::
         LUISA_ERROR_WITH_LOCATION(
             "Calling non-callable function in device code.");
     }
+    if (_constant_folding) {
+        // arguments might be passed by reference and modified by the callee
+        for (auto arg : args) { _forget_known_value(arg); }
+    }
     auto f = custom.builder();
-    CallExpr::ArgumentList call_args(f->_arguments.size(), nullptr);
+    auto call_args = _arena.allocate_array<const Expression *>(f->_arguments.size());
     auto in_iter = args.begin();
     for (auto i = 0u; i < f->_arguments.size(); i++) {
         if (auto arg = f->_arguments[i]; arg.is_builtin()) {
@@ -585,7 +958,8 @@ const CallExpr *FunctionBuilder::call(const Type *type, Function custom, luisa::
             "Expected {}, but received {}.",
             custom.hash(), expected_args, received_args);
     }
-    auto expr = _create_expression<CallExpr>(type, custom, std::move(call_args));
+    auto expr = _create_expression<CallExpr>(
+        type, custom, CallExpr::ArgumentList{call_args, f->_arguments.size()});
     if (auto iter = std::find_if(
             _used_custom_callables.cbegin(), _used_custom_callables.cend(),
             [&](auto &&p) noexcept { return f == p.get(); });
@@ -0,0 +1,815 @@
+#include <luisa/core/logging.h>
+#include <luisa/core/stl/optional.h>
+#include <luisa/core/stl/unordered_map.h>
+#include <luisa/ast/function_builder.h>
+#include <luisa/ast/function_serializer.h>
+
+namespace luisa::compute {
+
+// Layout of the blob (integers are LEB128 varints unless noted):
+//   magic (u32, raw) | version | root hash (u64, raw)
+//   types: count, descriptions
+//   external functions: count, {name, return type, argument types, usages}
+//   functions: count, {function record}, dependencies first and the root last
+// Types are referenced by index + 1 (0 for void), expressions by their index
+// in the per-function expression table, which is written in post-order.
+
+namespace detail {
+
+class SerializedBytesWriter {
+
+private:
+    luisa::vector<std::byte> &_bytes;
+
+public:
+    explicit SerializedBytesWriter(luisa::vector<std::byte> &bytes) noexcept
+        : _bytes{bytes} {}
+    void write_raw(const void *data, size_t size) noexcept {
+        auto p = static_cast<const std::byte *>(data);
+        _bytes.insert(_bytes.end(), p, p + size);
+    }
+    void write(uint64_t x) noexcept {
+        while (x >= 0x80u) {
+            _bytes.emplace_back(static_cast<std::byte>((x & 0x7fu) | 0x80u));
+            x >>= 7u;
+        }
+        _bytes.emplace_back(static_cast<std::byte>(x));
+    }
+    void write(luisa::string_view s) noexcept {
+        write(s.size());
+        write_raw(s.data(), s.size());
+    }
+};
+
+class SerializedBytesReader {
+
+private:
+    luisa::span<const std::byte> _bytes;
+    size_t _offset{0u};
+
+public:
+    explicit SerializedBytesReader(luisa::span<const std::byte> bytes) noexcept
+        : _bytes{bytes} {}
+    [[nodiscard]] auto valid(size_t size) const noexcept { return _offset + size <= _bytes.size(); }
+    void read_raw(void *data, size_t size) noexcept {
+        LUISA_ASSERT(valid(size), "Unexpected end of serialized function.");
+        std::memcpy(data, _bytes.data() + _offset, size);
+        _offset += size;
+    }
+    // returns nullopt on a truncated or overlong varint, leaving the offset unchanged
+    [[nodiscard]] luisa::optional<uint64_t> try_read() noexcept {
+        auto x = static_cast<uint64_t>(0u);
+        for (auto offset = _offset, shift = 0u; valid(offset - _offset + 1u) && shift < 64u; shift += 7u) {
+            auto b = static_cast<uint64_t>(_bytes[offset++]);
+            x |= (b & 0x7fu) << shift;
+            if ((b & 0x80u) == 0u) {
+                _offset = offset;
+                return x;
+            }
+        }
+        return luisa::nullopt;
+    }
+    [[nodiscard]] uint64_t read() noexcept {
+        auto x = try_read();
+        LUISA_ASSERT(x.has_value(), "Invalid varint in serialized function.");
+        return *x;
+    }
+    [[nodiscard]] luisa::string read_string() noexcept {
+        auto size = read();
+        luisa::string s(size, '\0');
+        read_raw(s.data(), size);
+        return s;
+    }
+};
+
+}// namespace detail
+
+class FunctionSerializer::Writer {
+
+private:
+    luisa::unordered_map<const Type *, uint> _type_indices;
+    luisa::vector<const Type *> _types;
+    luisa::unordered_map<const ExternalFunction *, uint> _external_indices;
+    luisa::vector<const ExternalFunction *> _externals;
+    luisa::unordered_map<const detail::FunctionBuilder *, uint> _function_indices;
+    luisa::vector<luisa::vector<std::byte>> _functions;
+
+    // per-function states
+    luisa::unordered_map<const Expression *, uint> _expression_indices;
+    luisa::unordered_map<uint64_t, uint> _constant_indices;
+    luisa::vector<std::byte> _expression_bytes;
+    uint _expression_count{0u};
+
+private:
+    [[nodiscard]] uint _type(const Type *type) noexcept {
+        if (type == nullptr) { return 0u; }
+        auto [iter, first] = _type_indices.try_emplace(
+            type, static_cast<uint>(_types.size() + 1u));
+        if (first) { _types.emplace_back(type); }
+        return iter->second;
+    }
+
+    [[nodiscard]] uint _external(const ExternalFunction *f) noexcept {
+        auto [iter, first] = _external_indices.try_emplace(
+            f, static_cast<uint>(_externals.size()));
+        if (first) {
+            _externals.emplace_back(f);
+            static_cast<void>(_type(f->return_type()));
+            for (auto t : f->argument_types()) { static_cast<void>(_type(t)); }
+        }
+        return iter->second;
+    }
+
+    void _variable(detail::SerializedBytesWriter &w, Variable v) noexcept {
+        w.write(_type(v.type()));
+        w.write(luisa::to_underlying(v.tag()));
+        w.write(v.uid());
+    }
+
+    [[nodiscard]] uint _expression(const Expression *expr) noexcept {
+        if (auto iter = _expression_indices.find(expr);
+            iter != _expression_indices.end()) {
+            return iter->second;
+        }
+        // children first, so that the reader can construct the nodes in order
+        luisa::vector<std::byte> record;
+        detail::SerializedBytesWriter w{record};
+        w.write(luisa::to_underlying(expr->tag()));
+        w.write(_type(expr->type()));
+        switch (expr->tag()) {
+            case Expression::Tag::UNARY: {
+                auto e = static_cast<const UnaryExpr *>(expr);
+                auto operand = _expression(e->operand());
+                w.write(luisa::to_underlying(e->op()));
+                w.write(operand);
+                break;
+            }
+            case Expression::Tag::BINARY: {
+                auto e = static_cast<const BinaryExpr *>(expr);
+                auto lhs = _expression(e->lhs());
+                auto rhs = _expression(e->rhs());
+                w.write(luisa::to_underlying(e->op()));
+                w.write(lhs);
+                w.write(rhs);
+                break;
+            }
+            case Expression::Tag::MEMBER: {
+                auto e = static_cast<const MemberExpr *>(expr);
+                auto self = _expression(e->self());
+                w.write(self);
+                if (e->is_swizzle()) {
+                    w.write(e->swizzle_size());
+                    w.write(e->swizzle_code());
+                } else {
+                    w.write(0u);
+                    w.write(e->member_index());
+                }
+                break;
+            }
+            case Expression::Tag::ACCESS: {
+                auto e = static_cast<const AccessExpr *>(expr);
+                auto range = _expression(e->range());
+                auto index = _expression(e->index());
+                w.write(range);
+                w.write(index);
+                break;
+            }
+            case Expression::Tag::LITERAL: {
+                auto e = static_cast<const LiteralExpr *>(expr);
+                w.write(e->value().index());
+                luisa::visit([&w](auto v) noexcept { w.write_raw(&v, sizeof(v)); }, e->value());
+                break;
+            }
+            case Expression::Tag::REF: {
+                auto e = static_cast<const RefExpr *>(expr);
+                _variable(w, e->variable());
+                break;
+            }
+            case Expression::Tag::CONSTANT: {
+                auto e = static_cast<const ConstantExpr *>(expr);
+                auto iter = _constant_indices.find(e->data().hash());
+                LUISA_ASSERT(iter != _constant_indices.end(),
+                             "Constant not captured by the function.");
+                w.write(iter->second);
+                break;
+            }
+            case Expression::Tag::CALL: {
+                auto e = static_cast<const CallExpr *>(expr);
+                luisa::vector<uint> args;
+                args.reserve(e->arguments().size());
+                for (auto arg : e->arguments()) { args.emplace_back(_expression(arg)); }
+                w.write(luisa::to_underlying(e->op()));
+                if (e->is_custom()) {
+                    auto iter = _function_indices.find(e->custom().builder());
+                    LUISA_ASSERT(iter != _function_indices.end(),
+                                 "Callable not registered in the function.");
+                    w.write(iter->second);
+                } else if (e->is_external()) {
+                    w.write(_external(e->external()));
+                }
+                w.write(args.size());
+                for (auto a : args) { w.write(a); }
+                break;
+            }
+            case Expression::Tag::CAST: {
+                auto e = static_cast<const CastExpr *>(expr);
+                auto source = _expression(e->expression());
+                w.write(luisa::to_underlying(e->op()));
+                w.write(source);
+                break;
+            }
+            case Expression::Tag::CPUCUSTOM:
+            case Expression::Tag::GPUCUSTOM:
+                LUISA_ERROR_WITH_LOCATION(
+                    "Custom-op expressions cannot be serialized.");
+        }
+        _expression_bytes.insert(_expression_bytes.end(), record.cbegin(), record.cend());
+        auto index = _expression_count++;
+        _expression_indices.emplace(expr, index);
+        return index;
+    }
+
+    void _scope(detail::SerializedBytesWriter &w, const ScopeStmt *scope) noexcept {
+        w.write(scope->statements().size());
+        for (auto s : scope->statements()) { _statement(w, s); }
+    }
+
+    void _statement(detail::SerializedBytesWriter &w, const Statement *stmt) noexcept {
+        w.write(luisa::to_underlying(stmt->tag()));
+        switch (stmt->tag()) {
+            case Statement::Tag::BREAK: break;
+            case Statement::Tag::CONTINUE: break;
+            case Statement::Tag::RETURN: {
+                auto s = static_cast<const ReturnStmt *>(stmt);
+                w.write(s->expression() == nullptr ? 0u : _expression(s->expression()) + 1u);
+                break;
+            }
+            case Statement::Tag::SCOPE: {
+                _scope(w, static_cast<const ScopeStmt *>(stmt));
+                break;
+            }
+            case Statement::Tag::IF: {
+                auto s = static_cast<const IfStmt *>(stmt);
+                w.write(_expression(s->condition()));
+                _scope(w, s->true_branch());
+                _scope(w, s->false_branch());
+                break;
+            }
+            case Statement::Tag::LOOP: {
+                _scope(w, static_cast<const LoopStmt *>(stmt)->body());
+                break;
+            }
+            case Statement::Tag::EXPR: {
+                w.write(_expression(static_cast<const ExprStmt *>(stmt)->expression()));
+                break;
+            }
+            case Statement::Tag::SWITCH: {
+                auto s = static_cast<const SwitchStmt *>(stmt);
+                w.write(_expression(s->expression()));
+                _scope(w, s->body());
+                break;
+            }
+            case Statement::Tag::SWITCH_CASE: {
+                auto s = static_cast<const SwitchCaseStmt *>(stmt);
+                w.write(_expression(s->expression()));
+                _scope(w, s->body());
+                break;
+            }
+            case Statement::Tag::SWITCH_DEFAULT: {
+                _scope(w, static_cast<const SwitchDefaultStmt *>(stmt)->body());
+                break;
+            }
+            case Statement::Tag::ASSIGN: {
+                auto s = static_cast<const AssignStmt *>(stmt);
+                auto lhs = _expression(s->lhs());
+                auto rhs = _expression(s->rhs());
+                w.write(lhs);
+                w.write(rhs);
+                break;
+            }
+            case Statement::Tag::FOR: {
+                auto s = static_cast<const ForStmt *>(stmt);
+                auto var = _expression(s->variable());
+                auto cond = _expression(s->condition());
+                auto step = _expression(s->step());
+                w.write(var);
+                w.write(cond);
+                w.write(step);
+                _scope(w, s->body());
+                break;
+            }
+            case Statement::Tag::COMMENT: {
+                w.write(static_cast<const CommentStmt *>(stmt)->comment());
+                break;
+            }
+            case Statement::Tag::RAY_QUERY: {
+                auto s = static_cast<const RayQueryStmt *>(stmt);
+                w.write(_expression(s->query()));
+                _scope(w, s->on_triangle_candidate());
+                _scope(w, s->on_procedural_candidate());
+                break;
+            }
+            case Statement::Tag::AUTO_DIFF: {
+                _scope(w, static_cast<const AutoDiffStmt *>(stmt)->body());
+                break;
+            }
+        }
+    }
+
+    static void _call_op_set(detail::SerializedBytesWriter &w, CallOpSet ops) noexcept {
+        luisa::vector<uint> list;
+        for (auto op : ops) { list.emplace_back(luisa::to_underlying(op)); }
+        w.write(list.size());
+        for (auto op : list) { w.write(op); }
+    }
+
+    static void _binding(detail::SerializedBytesWriter &w, const Function::Binding &binding) noexcept {
+        w.write(binding.index());
+        luisa::visit(
+            [&w]<typename T>(const T &b) noexcept {
+                if constexpr (std::is_same_v<T, Function::BufferBinding>) {
+                    w.write(b.handle);
+                    w.write(b.offset);
+                    w.write(b.size);
+                } else if constexpr (std::is_same_v<T, Function::TextureBinding>) {
+                    w.write(b.handle);
+                    w.write(b.level);
+                } else if constexpr (std::is_same_v<T, Function::BindlessArrayBinding> ||
+                                     std::is_same_v<T, Function::AccelBinding>) {
+                    w.write(b.handle);
+                }
+            },
+            binding);
+    }
+
+    void _function(const detail::FunctionBuilder *f) noexcept {
+        if (_function_indices.contains(f)) { return; }
+        // callables are written before their callers
+        for (auto &&c : f->custom_callables()) { _function(c.get()); }
+        _expression_indices.clear();
+        _constant_indices.clear();
+        _expression_bytes.clear();
+        _expression_count = 0u;
+        for (auto i = 0u; i < f->constants().size(); i++) {
+            _constant_indices.emplace(f->constants()[i].hash(), i);
+        }
+        // body goes first so that the expression table is complete
+        luisa::vector<std::byte> body;
+        detail::SerializedBytesWriter bw{body};
+        _scope(bw, f->body());
+        luisa::vector<std::byte> bytes;
+        detail::SerializedBytesWriter w{bytes};
+        auto hash = f->hash();
+        w.write_raw(&hash, sizeof(hash));
+        w.write(luisa::to_underlying(f->tag()));
+        w.write(f->block_size().x);
+        w.write(f->block_size().y);
+        w.write(f->block_size().z);
+        w.write(_type(f->return_type()));
+        w.write(f->_variable_usages.size());
+        for (auto u : f->_variable_usages) { w.write(luisa::to_underlying(u)); }
+        auto write_variables = [&](luisa::span<const Variable> vars) noexcept {
+            w.write(vars.size());
+            for (auto v : vars) { _variable(w, v); }
+        };
+        write_variables(f->builtin_variables());
+        write_variables(f->local_variables());
+        write_variables(f->shared_variables());
+        write_variables(f->arguments());
+        w.write(f->bound_arguments().size());
+        for (auto &&b : f->bound_arguments()) { _binding(w, b); }
+        w.write(f->constants().size());
+        for (auto &&c : f->constants()) {
+            w.write(_type(c.type()));
+            w.write_raw(c.raw(), c.type()->size());
+        }
+        w.write(f->custom_callables().size());
+        for (auto &&c : f->custom_callables()) { w.write(_function_indices.at(c.get())); }
+        w.write(f->external_callables().size());
+        for (auto &&e : f->external_callables()) { w.write(_external(e.get())); }
+        _call_op_set(w, f->direct_builtin_callables());
+        _call_op_set(w, f->propagated_builtin_callables());
+        w.write(f->requires_atomic_float() ? 1u : 0u);
+        w.write(_expression_count);
+        w.write_raw(_expression_bytes.data(), _expression_bytes.size());
+        w.write_raw(body.data(), body.size());
+        _function_indices.emplace(f, static_cast<uint>(_functions.size()));
+        _functions.emplace_back(std::move(bytes));
+    }
+
+public:
+    [[nodiscard]] luisa::vector<std::byte> write(Function function) noexcept {
+        auto f = function.builder();
+        _function(f);
+        luisa::vector<std::byte> bytes;
+        detail::SerializedBytesWriter w{bytes};
+        auto m = magic;
+        auto hash = f->hash();
+        w.write_raw(&m, sizeof(m));
+        w.write(version);
+        w.write_raw(&hash, sizeof(hash));
+        w.write(_types.size());
+        for (auto t : _types) { w.write(t->description()); }
+        w.write(_externals.size());
+        for (auto e : _externals) {
+            w.write(e->name());
+            w.write(_type(e->return_type()));
+            w.write(e->argument_types().size());
+            for (auto t : e->argument_types()) { w.write(_type(t)); }
+            for (auto u : e->argument_usages()) { w.write(luisa::to_underlying(u)); }
+        }
+        w.write(_functions.size());
+        for (auto &&b : _functions) { w.write_raw(b.data(), b.size()); }
+        return bytes;
+    }
+};
+
+class FunctionSerializer::Reader {
+
+private:
+    detail::SerializedBytesReader _r;
+    const HandleRemap &_remap_handle;
+    luisa::vector<const Type *> _types;
+    luisa::vector<luisa::shared_ptr<const ExternalFunction>> _externals;
+    luisa::vector<luisa::shared_ptr<detail::FunctionBuilder>> _functions;
+
+    // per-function states
+    luisa::vector<const Expression *> _expressions;
+
+private:
+    [[nodiscard]] const Type *_type() noexcept {
+        auto index = _r.read();
+        if (index == 0u) { return nullptr; }
+        LUISA_ASSERT(index <= _types.size(), "Invalid type index {}.", index);
+        return _types[index - 1u];
+    }
+
+    [[nodiscard]] Variable _variable() noexcept {
+        auto type = _type();
+        auto tag = static_cast<Variable::Tag>(_r.read());
+        auto uid = static_cast<uint32_t>(_r.read());
+        return Variable{type, tag, uid};
+    }
+
+    [[nodiscard]] const Expression *_expression() noexcept {
+        auto index = _r.read();
+        LUISA_ASSERT(index < _expressions.size(), "Invalid expression index {}.", index);
+        return _expressions[index];
+    }
+
+    [[nodiscard]] CallOpSet _call_op_set() noexcept {
+        CallOpSet ops;
+        auto n = _r.read();
+        for (auto i = 0u; i < n; i++) {
+            ops.mark(static_cast<CallOp>(_r.read()));
+        }
+        return ops;
+    }
+
+    [[nodiscard]] uint64_t _handle() noexcept {
+        auto handle = _r.read();
+        return _remap_handle ? _remap_handle(handle) : handle;
+    }
+
+    [[nodiscard]] Function::Binding _binding() noexcept {
+        switch (_r.read()) {
+            case 0u: return luisa::monostate{};
+            case 1u: {
+                auto handle = _handle();
+                auto offset = _r.read();
+                auto size = _r.read();
+                return Function::BufferBinding{handle, offset, size};
+            }
+            case 2u: {
+                auto handle = _handle();
+                auto level = static_cast<uint32_t>(_r.read());
+                return Function::TextureBinding{handle, level};
+            }
+            case 3u: return Function::BindlessArrayBinding{_handle()};
+            case 4u: return Function::AccelBinding{_handle()};
+            default: break;
+        }
+        LUISA_ERROR_WITH_LOCATION("Invalid binding in serialized function.");
+    }
+
+    template<size_t i = 0u>
+    [[nodiscard]] LiteralExpr::Value _literal(size_t index) noexcept {
+        if constexpr (i < std::tuple_size_v<basic_types>) {
+            if (index == i) {
+                std::tuple_element_t<i, basic_types> v{};
+                _r.read_raw(&v, sizeof(v));
+                return v;
+            }
+            return _literal<i + 1u>(index);
+        } else {
+            LUISA_ERROR_WITH_LOCATION("Invalid literal in serialized function.");
+        }
+    }
+
+    void _read_expression(detail::FunctionBuilder *f) noexcept {
+        auto tag = static_cast<Expression::Tag>(_r.read());
+        auto type = _type();
+        const Expression *expr = nullptr;
+        switch (tag) {
+            case Expression::Tag::UNARY: {
+                auto op = static_cast<UnaryOp>(_r.read());
+                auto operand = _expression();
+                expr = f->_create_expression<UnaryExpr>(type, op, operand);
+                break;
+            }
+            case Expression::Tag::BINARY: {
+                auto op = static_cast<BinaryOp>(_r.read());
+                auto lhs = _expression();
+                auto rhs = _expression();
+                expr = f->_create_expression<BinaryExpr>(type, op, lhs, rhs);
+                break;
+            }
+            case Expression::Tag::MEMBER: {
+                auto self = _expression();
+                auto swizzle_size = static_cast<uint>(_r.read());
+                auto code = static_cast<uint>(_r.read());
+                expr = swizzle_size == 0u ?
+                           f->_create_expression<MemberExpr>(type, self, code) :
+                           f->_create_expression<MemberExpr>(type, self, swizzle_size, code);
+                break;
+            }
+            case Expression::Tag::ACCESS: {
+                auto range = _expression();
+                auto index = _expression();
+                expr = f->_create_expression<AccessExpr>(type, range, index);
+                break;
+            }
+            case Expression::Tag::LITERAL: {
+                auto value = _literal(_r.read());
+                expr = f->_create_expression<LiteralExpr>(type, value);
+                break;
+            }
+            case Expression::Tag::REF: {
+                expr = f->_create_expression<RefExpr>(_variable());
+                break;
+            }
+            case Expression::Tag::CONSTANT: {
+                auto index = _r.read();
+                LUISA_ASSERT(index < f->_captured_constants.size(),
+                             "Invalid constant index {}.", index);
+                expr = f->_create_expression<ConstantExpr>(f->_captured_constants[index]);
+                break;
+            }
+            case Expression::Tag::CALL: {
+                auto op = static_cast<CallOp>(_r.read());
+                auto callee = std::numeric_limits<uint64_t>::max();
+                if (op == CallOp::CUSTOM || op == CallOp::EXTERNAL) { callee = _r.read(); }
+                auto n = _r.read();
+                auto args = f->_arena.allocate_array<const Expression *>(n);
+                for (auto i = 0u; i < n; i++) { args[i] = _expression(); }
+                CallExpr::ArgumentList arg_list{args, n};
+                if (op == CallOp::CUSTOM) {
+                    LUISA_ASSERT(callee < _functions.size(), "Invalid callable index {}.", callee);
+                    expr = f->_create_expression<CallExpr>(type, _functions[callee]->function(), arg_list);
+                } else if (op == CallOp::EXTERNAL) {
+                    LUISA_ASSERT(callee < _externals.size(), "Invalid external function index {}.", callee);
+                    expr = f->_create_expression<CallExpr>(type, _externals[callee].get(), arg_list);
+                } else {
+                    expr = f->_create_expression<CallExpr>(type, op, arg_list);
+                }
+                break;
+            }
+            case Expression::Tag::CAST: {
+                auto op = static_cast<CastOp>(_r.read());
+                auto source = _expression();
+                expr = f->_create_expression<CastExpr>(type, op, source);
+                break;
+            }
+            default: LUISA_ERROR_WITH_LOCATION(
+                "Invalid expression tag {} in serialized function.",
+                luisa::to_underlying(tag));
+        }
+        _expressions.emplace_back(expr);
+    }
+
+    void _read_scope(detail::FunctionBuilder *f, ScopeStmt *scope) noexcept {
+        f->push_scope(scope);
+        auto n = _r.read();
+        for (auto i = 0u; i < n; i++) { _read_statement(f); }
+        f->pop_scope(scope);
+    }
+
+    void _read_statement(detail::FunctionBuilder *f) noexcept {
+        auto tag = static_cast<Statement::Tag>(_r.read());
+        switch (tag) {
+            case Statement::Tag::BREAK: f->break_(); break;
+            case Statement::Tag::CONTINUE: f->continue_(); break;
+            case Statement::Tag::RETURN: {
+                auto index = _r.read();
+                if (index == 0u) {
+                    f->_create_and_append_statement<ReturnStmt>(nullptr);
+                } else {
+                    LUISA_ASSERT(index <= _expressions.size(), "Invalid expression index {}.", index);
+                    f->_create_and_append_statement<ReturnStmt>(_expressions[index - 1u]);
+                }
+                break;
+            }
+            case Statement::Tag::SCOPE: {
+                auto s = f->_create_and_append_statement<ScopeStmt>();
+                _read_scope(f, s);
+                break;
+            }
+            case Statement::Tag::IF: {
+                auto s = f->_create_and_append_statement<IfStmt>(_expression());
+                _read_scope(f, s->true_branch());
+                _read_scope(f, s->false_branch());
+                break;
+            }
+            case Statement::Tag::LOOP: {
+                _read_scope(f, f->_create_and_append_statement<LoopStmt>()->body());
+                break;
+            }
+            case Statement::Tag::EXPR: {
+                f->_create_and_append_statement<ExprStmt>(_expression());
+                break;
+            }
+            case Statement::Tag::SWITCH: {
+                _read_scope(f, f->_create_and_append_statement<SwitchStmt>(_expression())->body());
+                break;
+            }
+            case Statement::Tag::SWITCH_CASE: {
+                _read_scope(f, f->_create_and_append_statement<SwitchCaseStmt>(_expression())->body());
+                break;
+            }
+            case Statement::Tag::SWITCH_DEFAULT: {
+                _read_scope(f, f->_create_and_append_statement<SwitchDefaultStmt>()->body());
+                break;
+            }
+            case Statement::Tag::ASSIGN: {
+                auto lhs = _expression();
+                auto rhs = _expression();
+                f->_create_and_append_statement<AssignStmt>(lhs, rhs);
+                break;
+            }
+            case Statement::Tag::FOR: {
+                auto var = _expression();
+                auto cond = _expression();
+                auto step = _expression();
+                _read_scope(f, f->_create_and_append_statement<ForStmt>(var, cond, step)->body());
+                break;
+            }
+            case Statement::Tag::COMMENT: {
+                f->comment_(_r.read_string());
+                break;
+            }
+            case Statement::Tag::RAY_QUERY: {
+                auto query = _expression();
+                LUISA_ASSERT(query->tag() == Expression::Tag::REF,
+                             "Ray query must be a reference expression.");
+                auto s = f->_create_and_append_statement<RayQueryStmt>(
+                    static_cast<const RefExpr *>(query));
+                _read_scope(f, s->on_triangle_candidate());
+                _read_scope(f, s->on_procedural_candidate());
+                break;
+            }
+            case Statement::Tag::AUTO_DIFF: {
+                _read_scope(f, f->_create_and_append_statement<AutoDiffStmt>()->body());
+                break;
+            }
+            default: LUISA_ERROR_WITH_LOCATION(
+                "Invalid statement tag {} in serialized function.",
+                luisa::to_underlying(tag));
+        }
+    }
+
+    void _read_function() noexcept {
+        uint64_t hash;
+        _r.read_raw(&hash, sizeof(hash));
+        auto tag = static_cast<Function::Tag>(_r.read());
+        auto f = luisa::make_shared<detail::FunctionBuilder>(tag);
+        f->_block_size.x = static_cast<uint>(_r.read());
+        f->_block_size.y = static_cast<uint>(_r.read());
+        f->_block_size.z = static_cast<uint>(_r.read());
+        if (auto ret = _type()) { f->_return_type.emplace(ret); }
+        luisa::vector<Usage> usages(_r.read());
+        for (auto &u : usages) { u = static_cast<Usage>(_r.read()); }
+        auto read_variables = [this](luisa::vector<Variable> &vars) noexcept {
+            vars.resize(_r.read());
+            for (auto &v : vars) { v = _variable(); }
+        };
+        read_variables(f->_builtin_variables);
+        read_variables(f->_local_variables);
+        read_variables(f->_shared_variables);
+        read_variables(f->_arguments);
+        f->_bound_arguments.resize(_r.read());
+        for (auto &b : f->_bound_arguments) { b = _binding(); }
+        auto constant_count = _r.read();
+        f->_captured_constants.reserve(constant_count);
+        for (auto i = 0u; i < constant_count; i++) {
+            auto type = _type();
+            LUISA_ASSERT(type != nullptr, "Invalid constant type.");
+            luisa::vector<std::byte> raw(type->size());
+            _r.read_raw(raw.data(), raw.size());
+            f->_captured_constants.emplace_back(
+                ConstantData::create(type, raw.data(), raw.size()));
+        }
+        auto callable_count = _r.read();
+        for (auto i = 0u; i < callable_count; i++) {
+            auto index = _r.read();
+            LUISA_ASSERT(index < _functions.size(), "Invalid callable index {}.", index);
+            f->_used_custom_callables.emplace_back(_functions[index]);
+        }
+        auto external_count = _r.read();
+        for (auto i = 0u; i < external_count; i++) {
+            auto index = _r.read();
+            LUISA_ASSERT(index < _externals.size(), "Invalid external function index {}.", index);
+            f->_used_external_functions.emplace_back(_externals[index]);
+        }
+        f->_direct_builtin_callables = _call_op_set();
+        f->_propagated_builtin_callables = _call_op_set();
+        f->_requires_atomic_float = _r.read() != 0u;
+        // the builder has to be current as expressions mark variable usages on construction
+        f->_variable_usages = usages;
+        detail::FunctionBuilder::_function_stack().emplace_back(f.get());
+        auto expression_count = _r.read();
+        _expressions.clear();
+        _expressions.reserve(expression_count);
+        for (auto i = 0u; i < expression_count; i++) { _read_expression(f.get()); }
+        _read_scope(f.get(), &f->_body);
+        LUISA_ASSERT(detail::FunctionBuilder::_function_stack().back() == f.get(),
+                     "Invalid function stack.");
+        detail::FunctionBuilder::_function_stack().pop_back();
+        // restore the recorded usages as-is, but recompute the hash from the rebuilt
+        // function so that corrupted data or a mismatched serializer are caught
+        f->_variable_usages = std::move(usages);
+        f->_compute_hash();
+        LUISA_ASSERT(f->_hash == hash,
+                     "Serialized function hash mismatch "
+                     "(expected {:016x} but got {:016x}).",
+                     hash, f->_hash);
+        _functions.emplace_back(std::move(f));
+    }
+
+public:
+    Reader(luisa::span<const std::byte> data, const HandleRemap &remap_handle) noexcept
+        : _r{data}, _remap_handle{remap_handle} {}
+
+    [[nodiscard]] uint64_t read_header() noexcept {
+        uint32_t m;
+        uint64_t hash;
+        if (!_r.valid(sizeof(m))) { return 0u; }
+        _r.read_raw(&m, sizeof(m));
+        if (m != magic) { return 0u; }
+        auto v = _r.try_read();
+        if (!v) { return 0u; }
+        if (*v != version) {
+            LUISA_WARNING_WITH_LOCATION(
+                "Serialized function version mismatch "
+                "(expected {} but got {}).",
+                version, *v);
+            return 0u;
+        }
+        if (!_r.valid(sizeof(hash))) { return 0u; }
+        _r.read_raw(&hash, sizeof(hash));
+        return hash;
+    }
+
+    [[nodiscard]] luisa::shared_ptr<const detail::FunctionBuilder> read() noexcept {
+        auto hash = read_header();
+        LUISA_ASSERT(hash != 0u, "Invalid serialized function.");
+        _types.resize(_r.read());
+        for (auto &t : _types) { t = Type::from(_r.read_string()); }
+        _externals.resize(_r.read());
+        for (auto &e : _externals) {
+            auto name = _r.read_string();
+            auto ret = _type();
+            luisa::vector<const Type *> arg_types(_r.read());
+            luisa::vector<Usage> arg_usages(arg_types.size());
+            for (auto &t : arg_types) { t = _type(); }
+            for (auto &u : arg_usages) { u = static_cast<Usage>(_r.read()); }
+            e = luisa::make_shared<ExternalFunction>(
+                std::move(name), ret, std::move(arg_types), std::move(arg_usages));
+        }
+        auto function_count = _r.read();
+        LUISA_ASSERT(function_count != 0u, "Empty serialized function.");
+        for (auto i = 0u; i < function_count; i++) { _read_function(); }
+        auto f = _functions.back();
+        LUISA_ASSERT(f->hash() == hash,
+                     "Serialized root function hash mismatch "
+                     "(expected {:016x} but got {:016x}).",
+                     hash, f->hash());
+        return luisa::const_pointer_cast<const detail::FunctionBuilder>(f);
+    }
+};
+
+luisa::vector<std::byte> FunctionSerializer::serialize(Function function) noexcept {
+    LUISA_ASSERT(function, "Cannot serialize an empty function.");
+    return Writer{}.write(function);
+}
+
+luisa::shared_ptr<const detail::FunctionBuilder>
+FunctionSerializer::deserialize(luisa::span<const std::byte> data, const HandleRemap &remap_handle) noexcept {
+    return Reader{data, remap_handle}.read();
+}
+
+uint64_t FunctionSerializer::peek_hash(luisa::span<const std::byte> data) noexcept {
+    HandleRemap no_remap;
+    return Reader{data, no_remap}.read_header();
+}
+
+}// namespace luisa::compute
@@ -0,0 +1,264 @@
+#include <cstdlib>
+#include <atomic>
+
+#include <luisa/core/logging.h>
+#include <luisa/core/stl/format.h>
+#include "device.h"
+
+namespace lc::capture {
+
+namespace detail {
+
+// devices created after the first one in the same process get numbered files
+[[nodiscard]] static auto capture_path() noexcept {
+    static std::atomic_uint device_count{0u};
+    auto env = std::getenv("LUISA_CAPTURE_FILE");
+    LUISA_ASSERT(env != nullptr && env[0] != '\0',
+                 "LUISA_CAPTURE_FILE is not set for the capture layer.");
+    luisa::filesystem::path path{env};
+    if (auto index = device_count.fetch_add(1u); index != 0u) {
+        auto file_name = luisa::format("{}-{}{}",
+                                       to_string(path.stem()), index,
+                                       to_string(path.extension()));
+        path.replace_filename(luisa::filesystem::path{file_name.c_str()});
+    }
+    return path;
+}
+
+}// namespace detail
+
+Device::Device(Context &&ctx, luisa::shared_ptr<DeviceInterface> &&native) noexcept
+    : DeviceInterface{std::move(ctx)},
+      _native{std::move(native)},
+      _writer{detail::capture_path()} {}
+
+void *Device::native_handle() const noexcept {
+    return _native->native_handle();
+}
+Usage Device::shader_argument_usage(uint64_t handle, size_t index) noexcept {
+    return _native->shader_argument_usage(handle, index);
+}
+
+// buffer
+BufferCreationInfo Device::create_buffer(const Type *element, size_t elem_count) noexcept {
+    auto buffer = _native->create_buffer(element, elem_count);
+    if (buffer.valid()) { _writer.record_buffer(buffer.handle, element, elem_count); }
+    return buffer;
+}
+BufferCreationInfo Device::create_buffer(const ir::CArc<ir::Type> *element, size_t elem_count) noexcept {
+    auto buffer = _native->create_buffer(element, elem_count);
+    if (buffer.valid()) {
+        // IR types cannot be recorded, so the buffer is replayed as words of the same size
+        if (buffer.element_stride % sizeof(uint) == 0u) {
+            auto word_count = buffer.element_stride / sizeof(uint);
+            _writer.record_buffer(buffer.handle, Type::array(Type::of<uint>(), word_count), elem_count);
+        } else {
+            LUISA_WARNING_WITH_LOCATION(
+                "Buffer #{} with element stride {} is not captured.",
+                buffer.handle, buffer.element_stride);
+        }
+    }
+    return buffer;
+}
+void Device::destroy_buffer(uint64_t handle) noexcept {
+    _writer.record(CaptureOp::DESTROY_BUFFER, handle);
+    _native->destroy_buffer(handle);
+}
+
+// texture
+ResourceCreationInfo Device::create_texture(
+    PixelFormat format, uint dimension,
+    uint width, uint height, uint depth,
+    uint mipmap_levels, bool simultaneous_access) noexcept {
+    auto tex = _native->create_texture(format, dimension, width, height, depth, mipmap_levels, simultaneous_access);
+    if (tex.valid()) {
+        _writer.record(CaptureOp::CREATE_TEXTURE, tex.handle, format, dimension,
+                       make_uint3(width, height, depth), mipmap_levels, simultaneous_access);
+    }
+    return tex;
+}
+void Device::destroy_texture(uint64_t handle) noexcept {
+    _writer.record(CaptureOp::DESTROY_TEXTURE, handle);
+    _native->destroy_texture(handle);
+}
+
+// bindless array
+ResourceCreationInfo Device::create_bindless_array(size_t size) noexcept {
+    auto array = _native->create_bindless_array(size);
+    if (array.valid()) { _writer.record(CaptureOp::CREATE_BINDLESS_ARRAY, array.handle, static_cast<uint64_t>(size)); }
+    return array;
+}
+void Device::destroy_bindless_array(uint64_t handle) noexcept {
+    _writer.record(CaptureOp::DESTROY_BINDLESS_ARRAY, handle);
+    _native->destroy_bindless_array(handle);
+}
+
+// stream
+ResourceCreationInfo Device::create_stream(StreamTag stream_tag) noexcept {
+    auto stream = _native->create_stream(stream_tag);
+    if (stream.valid()) { _writer.record(CaptureOp::CREATE_STREAM, stream.handle, stream_tag); }
+    return stream;
+}
+void Device::destroy_stream(uint64_t handle) noexcept {
+    _writer.record(CaptureOp::DESTROY_STREAM, handle);
+    _native->destroy_stream(handle);
+}
+void Device::synchronize_stream(uint64_t stream_handle) noexcept {
+    _writer.record(CaptureOp::SYNCHRONIZE_STREAM, stream_handle);
+    _writer.flush();
+    _native->synchronize_stream(stream_handle);
+}
+void Device::dispatch(uint64_t stream_handle, CommandList &&list) noexcept {
+    // recorded before dispatching, while the upload data is still alive
+    _writer.record_dispatch(stream_handle, list);
+    _native->dispatch(stream_handle, std::move(list));
+}
+
+// swap chain
+SwapchainCreationInfo Device::create_swapchain(
+    uint64_t window_handle, uint64_t stream_handle,
+    uint width, uint height, bool allow_hdr,
+    bool vsync, uint back_buffer_size) noexcept {
+    LUISA_WARNING_WITH_LOCATION("Swapchains are not captured.");
+    return _native->create_swapchain(window_handle, stream_handle, width, height, allow_hdr, vsync, back_buffer_size);
+}
+void Device::destroy_swap_chain(uint64_t handle) noexcept {
+    _native->destroy_swap_chain(handle);
+}
+void Device::present_display_in_stream(uint64_t stream_handle, uint64_t swapchain_handle, uint64_t image_handle) noexcept {
+    _native->present_display_in_stream(stream_handle, swapchain_handle, image_handle);
+}
+
+// kernel
+ShaderCreationInfo Device::create_shader(const ShaderOption &option, Function kernel) noexcept {
+    auto shader = _native->create_shader(option, kernel);
+    if (shader.valid()) { _writer.record_shader(shader.handle, option, kernel); }
+    return shader;
+}
+ShaderCreationInfo Device::create_shader(const ShaderOption &option, const ir::KernelModule *kernel) noexcept {
+    auto shader = _native->create_shader(option, kernel);
+    LUISA_WARNING_WITH_LOCATION("Shader #{} created from an IR module is not captured.", shader.handle);
+    return shader;
+}
+ShaderCreationInfo Device::load_shader(luisa::string_view name, luisa::span<const Type *const> arg_types) noexcept {
+    auto shader = _native->load_shader(name, arg_types);
+    if (shader.valid()) { _writer.record_shader(shader.handle, name, arg_types); }
+    return shader;
+}
+void Device::destroy_shader(uint64_t handle) noexcept {
+    _writer.record(CaptureOp::DESTROY_SHADER, handle);
+    _native->destroy_shader(handle);
+}
+
+// event
+ResourceCreationInfo Device::create_event() noexcept {
+    auto event = _native->create_event();
+    if (event.valid()) { _writer.record(CaptureOp::CREATE_EVENT, event.handle); }
+    return event;
+}
+void Device::destroy_event(uint64_t handle) noexcept {
+    _writer.record(CaptureOp::DESTROY_EVENT, handle);
+    _native->destroy_event(handle);
+}
+void Device::signal_event(uint64_t handle, uint64_t stream_handle, uint64_t fence) noexcept {
+    _writer.record(CaptureOp::SIGNAL_EVENT, handle, stream_handle, fence);
+    _native->signal_event(handle, stream_handle, fence);
+}
+void Device::wait_event(uint64_t handle, uint64_t stream_handle, uint64_t fence) noexcept {
+    _writer.record(CaptureOp::WAIT_EVENT, handle, stream_handle, fence);
+    _native->wait_event(handle, stream_handle, fence);
+}
+bool Device::is_event_completed(uint64_t handle, uint64_t fence) const noexcept {
+    return _native->is_event_completed(handle, fence);
+}
+void Device::synchronize_event(uint64_t handle, uint64_t fence) noexcept {
+    _writer.record(CaptureOp::SYNCHRONIZE_EVENT, handle, fence);
+    _writer.flush();
+    _native->synchronize_event(handle, fence);
+}
+
+// accel
+ResourceCreationInfo Device::create_mesh(const AccelOption &option) noexcept {
+    auto mesh = _native->create_mesh(option);
+    if (mesh.valid()) { _writer.record(CaptureOp::CREATE_MESH, mesh.handle, option); }
+    return mesh;
+}
+void Device::destroy_mesh(uint64_t handle) noexcept {
+    _writer.record(CaptureOp::DESTROY_MESH, handle);
+    _native->destroy_mesh(handle);
+}
+ResourceCreationInfo Device::create_procedural_primitive(const AccelOption &option) noexcept {
+    auto prim = _native->create_procedural_primitive(option);
+    if (prim.valid()) { _writer.record(CaptureOp::CREATE_PROCEDURAL_PRIMITIVE, prim.handle, option); }
+    return prim;
+}
+void Device::destroy_procedural_primitive(uint64_t handle) noexcept {
+    _writer.record(CaptureOp::DESTROY_PROCEDURAL_PRIMITIVE, handle);
+    _native->destroy_procedural_primitive(handle);
+}
+ResourceCreationInfo Device::create_accel(const AccelOption &option) noexcept {
+    auto accel = _native->create_accel(option);
+    if (accel.valid()) { _writer.record(CaptureOp::CREATE_ACCEL, accel.handle, option); }
+    return accel;
+}
+void Device::destroy_accel(uint64_t handle) noexcept {
+    _writer.record(CaptureOp::DESTROY_ACCEL, handle);
+    _native->destroy_accel(handle);
+}
+
+// query
+luisa::string Device::query(luisa::string_view property) noexcept {
+    return _native->query(property);
+}
+DeviceExtension *Device::extension(luisa::string_view name) noexcept {
+    return _native->extension(name);
+}
+void Device::set_name(luisa::compute::Resource::Tag resource_tag, uint64_t resource_handle, luisa::string_view name) noexcept {
+    _writer.record(CaptureOp::SET_NAME, resource_tag, resource_handle, name);
+    _native->set_name(resource_tag, resource_handle, name);
+}
+
+// sparse resources are forwarded without being captured
+SparseBufferCreationInfo Device::create_sparse_buffer(const Type *element, size_t elem_count) noexcept {
+    LUISA_WARNING_WITH_LOCATION("Sparse buffers are not captured.");
+    return _native->create_sparse_buffer(element, elem_count);
+}
+void Device::destroy_sparse_buffer(uint64_t handle) noexcept {
+    _native->destroy_sparse_buffer(handle);
+}
+SparseTextureCreationInfo Device::create_sparse_texture(
+    PixelFormat format, uint dimension,
+    uint width, uint height, uint depth,
+    uint mipmap_levels, bool simultaneous_access) noexcept {
+    LUISA_WARNING_WITH_LOCATION("Sparse textures are not captured.");
+    return _native->create_sparse_texture(format, dimension, width, height, depth, mipmap_levels, simultaneous_access);
+}
+void Device::destroy_sparse_texture(uint64_t handle) noexcept {
+    _native->destroy_sparse_texture(handle);
+}
+void Device::update_sparse_resources(
+    uint64_t stream_handle,
+    luisa::vector<SparseUpdateTile> &&update_cmds) noexcept {
+    _native->update_sparse_resources(stream_handle, std::move(update_cmds));
+}
+ResourceCreationInfo Device::allocate_sparse_buffer_heap(size_t byte_size) noexcept {
+    return _native->allocate_sparse_buffer_heap(byte_size);
+}
+void Device::deallocate_sparse_buffer_heap(uint64_t handle) noexcept {
+    _native->deallocate_sparse_buffer_heap(handle);
+}
+ResourceCreationInfo Device::allocate_sparse_texture_heap(size_t byte_size) noexcept {
+    return _native->allocate_sparse_texture_heap(byte_size);
+}
+void Device::deallocate_sparse_texture_heap(uint64_t handle) noexcept {
+    _native->deallocate_sparse_texture_heap(handle);
+}
+
+VSTL_EXPORT_C void destroy(DeviceInterface *d) {
+    delete d;
+}
+VSTL_EXPORT_C DeviceInterface *create(Context &&ctx, luisa::shared_ptr<DeviceInterface> &&native) {
+    return new Device{std::move(ctx), std::move(native)};
+}
+
+}// namespace lc::capture
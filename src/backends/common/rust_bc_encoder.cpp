@@ -0,0 +1,788 @@
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <luisa/core/logging.h>
+#include "rust_bc_encoder.h"
+
+namespace luisa::compute::rust {
+
+namespace detail {
+
+using BCQuality = TexCompressExt::Quality;
+
+static constexpr auto bc_max_error = std::numeric_limits<float>::max();
+
+class BCBitWriter {
+
+private:
+    std::byte *_block;
+    uint _offset{0u};
+
+public:
+    explicit BCBitWriter(std::byte *block) noexcept : _block{block} { std::memset(block, 0, 16u); }
+    void write(uint value, uint n) noexcept {
+        for (auto i = 0u; i < n; i++, _offset++) {
+            if ((value >> i) & 1u) { _block[_offset / 8u] |= static_cast<std::byte>(1u << (_offset % 8u)); }
+        }
+    }
+    [[nodiscard]] auto offset() const noexcept { return _offset; }
+};
+
+// subset of each texel in the 2-subset partitions, one bit per texel
+static constexpr uint16_t bc_partitions2[64] = {
+    0xccccu, 0x8888u, 0xeeeeu, 0xecc8u, 0xc880u, 0xfeecu, 0xfec8u, 0xec80u,
+    0xc800u, 0xffecu, 0xfe80u, 0xe800u, 0xffe8u, 0xff00u, 0xfff0u, 0xf000u,
+    0xf710u, 0x008eu, 0x7100u, 0x08ceu, 0x008cu, 0x7310u, 0x3100u, 0x8cceu,
+    0x088cu, 0x3110u, 0x6666u, 0x366cu, 0x17e8u, 0x0ff0u, 0x718eu, 0x399cu,
+    0xaaaau, 0xf0f0u, 0x5a5au, 0x33ccu, 0x3c3cu, 0x55aau, 0x9696u, 0xa55au,
+    0x73ceu, 0x13c8u, 0x324cu, 0x3bdcu, 0x6996u, 0xc33cu, 0x9966u, 0x0660u,
+    0x0272u, 0x04e4u, 0x4e40u, 0x2720u, 0xc936u, 0x936cu, 0x39c6u, 0x639cu,
+    0x9336u, 0x9cc6u, 0x817eu, 0xe718u, 0xccf0u, 0x0fccu, 0x7744u, 0xee22u,
+};
+
+// anchor texel of the second subset in the 2-subset partitions
+static constexpr uint8_t bc_anchors2[64] = {
+    15u, 15u, 15u, 15u, 15u, 15u, 15u, 15u, 15u, 15u, 15u, 15u, 15u, 15u, 15u, 15u,
+    15u, 2u, 8u, 2u, 2u, 8u, 8u, 15u, 2u, 8u, 2u, 2u, 8u, 8u, 2u, 2u,
+    15u, 15u, 6u, 8u, 2u, 8u, 15u, 15u, 2u, 8u, 2u, 2u, 2u, 15u, 15u, 6u,
+    6u, 2u, 6u, 8u, 15u, 15u, 2u, 2u, 15u, 15u, 15u, 15u, 15u, 2u, 2u, 15u,
+};
+
+static constexpr uint bc_weights2[4] = {0u, 21u, 43u, 64u};
+static constexpr uint bc_weights3[8] = {0u, 9u, 18u, 27u, 37u, 46u, 55u, 64u};
+static constexpr uint bc_weights4[16] = {0u, 4u, 9u, 13u, 17u, 21u, 26u, 30u,
+                                         34u, 38u, 43u, 47u, 51u, 55u, 60u, 64u};
+
+[[nodiscard]] static auto bc_weights(uint index_bits) noexcept {
+    return index_bits == 2u ? bc_weights2 :
+           index_bits == 3u ? bc_weights3 :
+                              bc_weights4;
+}
+
+[[nodiscard]] static auto bc_interpolate(uint e0, uint e1, uint w) noexcept {
+    return ((64u - w) * e0 + w * e1 + 32u) >> 6u;
+}
+
+// texels of one subset, kept as structure of arrays so the per-texel loops vectorize
+struct BCPoints {
+    uint count{0u};
+    uint texels[16]{};// index in the block
+    float v[4][16]{};
+};
+
+[[nodiscard]] static BCPoints bc_subset(const BCPoints &block, uint16_t mask, uint subset) noexcept {
+    BCPoints p;
+    for (auto i = 0u; i < 16u; i++) {
+        if (((mask >> i) & 1u) != subset) { continue; }
+        p.texels[p.count] = i;
+        for (auto c = 0u; c < 4u; c++) { p.v[c][p.count] = block.v[c][i]; }
+        p.count++;
+    }
+    return p;
+}
+
+struct BCChannels {
+    uint begin;
+    uint end;
+};
+
+struct BCLine {
+    float e[2][4]{};
+};
+
+// spans the points along their weighted principal axis
+[[nodiscard]] static BCLine bc_fit_line(const BCPoints &p, const float *weights, BCChannels channels) noexcept {
+    float scale[4]{};
+    float mean[4]{};
+    float lo[4]{};
+    float hi[4]{};
+    for (auto c = channels.begin; c < channels.end; c++) {
+        scale[c] = std::sqrt(std::max(weights[c], 1e-4f));
+        lo[c] = bc_max_error;
+        hi[c] = -bc_max_error;
+        for (auto i = 0u; i < p.count; i++) {
+            mean[c] += p.v[c][i];
+            lo[c] = std::min(lo[c], p.v[c][i]);
+            hi[c] = std::max(hi[c], p.v[c][i]);
+        }
+        mean[c] /= static_cast<float>(p.count);
+    }
+    // power iteration on the covariance of the weighted points
+    float cov[4][4]{};
+    for (auto r = channels.begin; r < channels.end; r++) {
+        for (auto c = channels.begin; c < channels.end; c++) {
+            for (auto i = 0u; i < p.count; i++) { cov[r][c] += (p.v[r][i] - mean[r]) * (p.v[c][i] - mean[c]); }
+            cov[r][c] *= scale[r] * scale[c];
+        }
+    }
+    float axis[4]{};
+    for (auto c = channels.begin; c < channels.end; c++) { axis[c] = (hi[c] - lo[c]) * scale[c]; }
+    for (auto iteration = 0u; iteration < 8u; iteration++) {
+        float next[4]{};
+        auto norm = 0.f;
+        for (auto r = channels.begin; r < channels.end; r++) {
+            for (auto c = channels.begin; c < channels.end; c++) { next[r] += cov[r][c] * axis[c]; }
+            norm = std::max(norm, std::abs(next[r]));
+        }
+        if (norm < 1e-6f) { break; }
+        for (auto c = channels.begin; c < channels.end; c++) { axis[c] = next[c] / norm; }
+    }
+    auto length = 0.f;
+    for (auto c = channels.begin; c < channels.end; c++) { length += axis[c] * axis[c]; }
+    BCLine line;
+    if (length < 1e-12f) {// all points coincide
+        for (auto c = channels.begin; c < channels.end; c++) { line.e[0][c] = line.e[1][c] = mean[c]; }
+        return line;
+    }
+    for (auto c = channels.begin; c < channels.end; c++) { axis[c] /= std::sqrt(length); }
+    auto t_min = bc_max_error;
+    auto t_max = -bc_max_error;
+    for (auto i = 0u; i < p.count; i++) {
+        auto t = 0.f;
+        for (auto c = channels.begin; c < channels.end; c++) { t += (p.v[c][i] - mean[c]) * scale[c] * axis[c]; }
+        t_min = std::min(t_min, t);
+        t_max = std::max(t_max, t);
+    }
+    for (auto c = channels.begin; c < channels.end; c++) {
+        line.e[0][c] = mean[c] + t_min * axis[c] / scale[c];
+        line.e[1][c] = mean[c] + t_max * axis[c] / scale[c];
+    }
+    return line;
+}
+
+// least-squares endpoints for the points given their interpolation weights, false if degenerate
+[[nodiscard]] static bool bc_refine_line(const BCPoints &p, const uint *point_weights,
+                                         BCChannels channels, BCLine &line) noexcept {
+    auto aa = 0.f;
+    auto ab = 0.f;
+    auto bb = 0.f;
+    float ax[4]{};
+    float bx[4]{};
+    for (auto i = 0u; i < p.count; i++) {
+        auto b = static_cast<float>(point_weights[i]) / 64.f;
+        auto a = 1.f - b;
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        for (auto c = channels.begin; c < channels.end; c++) {
+            ax[c] += a * p.v[c][i];
+            bx[c] += b * p.v[c][i];
+        }
+    }
+    auto det = aa * bb - ab * ab;
+    if (std::abs(det) < 1e-6f) { return false; }
+    for (auto c = channels.begin; c < channels.end; c++) {
+        line.e[0][c] = (bb * ax[c] - ab * bx[c]) / det;
+        line.e[1][c] = (aa * bx[c] - ab * ax[c]) / det;
+    }
+    return true;
+}
+
+// squared distance of points with the given moments to their principal axis
+[[nodiscard]] static float bc_axis_residual(const float *sum, const float (*sum_sq)[4],
+                                            float count, BCChannels channels) noexcept {
+    if (count == 0.f) { return 0.f; }
+    float cov[4][4]{};
+    auto trace = 0.f;
+    auto start = channels.begin;
+    for (auto r = channels.begin; r < channels.end; r++) {
+        for (auto c = channels.begin; c < channels.end; c++) { cov[r][c] = sum_sq[r][c] - sum[r] * sum[c] / count; }
+        trace += cov[r][r];
+        if (cov[r][r] > cov[start][start]) { start = r; }
+    }
+    float axis[4]{};
+    for (auto c = channels.begin; c < channels.end; c++) { axis[c] = cov[start][c]; }
+    auto lambda = 0.f;
+    for (auto iteration = 0u; iteration < 4u; iteration++) {
+        float next[4]{};
+        auto axis_sq = 0.f;
+        auto projected = 0.f;
+        for (auto r = channels.begin; r < channels.end; r++) {
+            for (auto c = channels.begin; c < channels.end; c++) { next[r] += cov[r][c] * axis[c]; }
+            axis_sq += axis[r] * axis[r];
+            projected += axis[r] * next[r];
+        }
+        if (axis_sq < 1e-12f) { break; }
+        lambda = projected / axis_sq;// Rayleigh quotient
+        auto norm = 0.f;
+        for (auto c = channels.begin; c < channels.end; c++) { norm = std::max(norm, std::abs(next[c])); }
+        if (norm < 1e-12f) { break; }
+        for (auto c = channels.begin; c < channels.end; c++) { axis[c] = next[c] / norm; }
+    }
+    return std::max(trace - lambda, 0.f);
+}
+
+// the count partitions whose subsets lie closest to lines, from the moments of the subsets
+static void bc_rank_partitions(const BCPoints &block, const float *weights, BCChannels channels,
+                               uint partition_count, uint count, uint *partitions) noexcept {
+    float scaled[4][16]{};
+    float total[4]{};
+    float total_sq[4][4]{};
+    for (auto c = channels.begin; c < channels.end; c++) {
+        auto scale = std::sqrt(weights[c]);
+        for (auto i = 0u; i < 16u; i++) {
+            scaled[c][i] = block.v[c][i] * scale;
+            total[c] += scaled[c][i];
+        }
+    }
+    for (auto r = channels.begin; r < channels.end; r++) {
+        for (auto c = channels.begin; c < channels.end; c++) {
+            for (auto i = 0u; i < 16u; i++) { total_sq[r][c] += scaled[r][i] * scaled[c][i]; }
+        }
+    }
+    float errors[64];
+    uint order[64];
+    for (auto p = 0u; p < partition_count; p++) {
+        auto mask = bc_partitions2[p];
+        float sum[2][4]{};
+        float sum_sq[2][4][4]{};
+        auto n = 0.f;
+        for (auto i = 0u; i < 16u; i++) {
+            if (((mask >> i) & 1u) == 0u) { continue; }
+            n += 1.f;
+            for (auto r = channels.begin; r < channels.end; r++) {
+                sum[1][r] += scaled[r][i];
+                for (auto c = channels.begin; c < channels.end; c++) { sum_sq[1][r][c] += scaled[r][i] * scaled[c][i]; }
+            }
+        }
+        for (auto r = channels.begin; r < channels.end; r++) {
+            sum[0][r] = total[r] - sum[1][r];
+            for (auto c = channels.begin; c < channels.end; c++) { sum_sq[0][r][c] = total_sq[r][c] - sum_sq[1][r][c]; }
+        }
+        errors[p] = bc_axis_residual(sum[0], sum_sq[0], 16.f - n, channels) +
+                    bc_axis_residual(sum[1], sum_sq[1], n, channels);
+        order[p] = p;
+    }
+    count = std::min(count, partition_count);
+    std::partial_sort(order, order + count, order + partition_count,
+                      [&errors](auto a, auto b) noexcept { return errors[a] < errors[b]; });
+    std::copy_n(order, count, partitions);
+}
+
+// flips a subset so that its anchor index has a zero most significant bit, which the format
+// leaves implicit; the weights are symmetric, so the decoded texels stay the same
+template<typename Endpoint>
+static void bc_fix_anchor(Endpoint (&endpoints)[2], uint *indices, uint count,
+                          uint anchor, uint index_bits) noexcept {
+    auto max_index = (1u << index_bits) - 1u;
+    if ((indices[anchor] >> (index_bits - 1u)) == 0u) { return; }
+    std::swap(endpoints[0], endpoints[1]);
+    for (auto i = 0u; i < count; i++) { indices[i] = max_index - indices[i]; }
+}
+
+// BC7
+
+struct BC7PartSpec {
+    BCChannels channels;
+    uint bits;// per endpoint channel, including the p-bit
+    uint pbits;// 0: none, 1: one shared by both endpoints, 2: one per endpoint
+    uint index_bits;
+};
+
+// one subset, or the color or alpha part of a mode 5 block
+struct BC7Part {
+    uint endpoints[2][4]{};// quantized, including the p-bit
+    uint indices[16]{};
+    float error{bc_max_error};
+};
+
+[[nodiscard]] static auto bc7_expand(uint x, uint bits) noexcept {
+    x <<= 8u - bits;
+    return x | (x >> bits);
+}
+
+// the value of the given bits closest to v, with its lowest bit equal to pbit unless pbit is ~0u
+[[nodiscard]] static auto bc7_quantize(float v, uint bits, uint pbit) noexcept {
+    auto max_value = static_cast<int>((1u << bits) - 1u);
+    auto x0 = static_cast<int>(std::round(std::clamp(v, 0.f, 255.f) / 255.f * static_cast<float>(max_value)));
+    auto best = 0u;
+    auto best_error = bc_max_error;
+    for (auto x = x0 - 1; x <= x0 + 1; x++) {
+        if (x < 0 || x > max_value || (pbit != ~0u && static_cast<uint>(x & 1) != pbit)) { continue; }
+        if (auto e = std::abs(static_cast<float>(bc7_expand(x, bits)) - v); e < best_error) {
+            best = static_cast<uint>(x);
+            best_error = e;
+        }
+    }
+    return best;
+}
+
+[[nodiscard]] static float bc7_assign(const BCPoints &p, const float *weights,
+                                      const BC7PartSpec &spec, BC7Part &part) noexcept {
+    auto n = 1u << spec.index_bits;
+    auto w = bc_weights(spec.index_bits);
+    float palette[4][16]{};
+    for (auto c = spec.channels.begin; c < spec.channels.end; c++) {
+        auto e0 = bc7_expand(part.endpoints[0][c], spec.bits);
+        auto e1 = bc7_expand(part.endpoints[1][c], spec.bits);
+        for (auto k = 0u; k < n; k++) { palette[c][k] = static_cast<float>(bc_interpolate(e0, e1, w[k])); }
+    }
+    auto total = 0.f;
+    for (auto i = 0u; i < p.count; i++) {
+        auto best = bc_max_error;
+        auto best_index = 0u;
+        for (auto k = 0u; k < n; k++) {
+            auto d = 0.f;
+            for (auto c = spec.channels.begin; c < spec.channels.end; c++) {
+                auto diff = p.v[c][i] - palette[c][k];
+                d += weights[c] * diff * diff;
+            }
+            if (d < best) {
+                best = d;
+                best_index = k;
+            }
+        }
+        part.indices[i] = best_index;
+        total += best;
+    }
+    return total;
+}
+
+[[nodiscard]] static BC7Part bc7_fit_part(const BCPoints &p, const float *weights,
+                                          const BC7PartSpec &spec, uint iterations) noexcept {
+    auto line = bc_fit_line(p, weights, spec.channels);
+    auto pbit_choices = spec.pbits == 0u ? 1u : spec.pbits == 1u ? 2u : 4u;
+    BC7Part best;
+    for (auto iteration = 0u;; iteration++) {
+        for (auto choice = 0u; choice < pbit_choices; choice++) {
+            auto pbit0 = spec.pbits == 0u ? ~0u : choice & 1u;
+            auto pbit1 = spec.pbits == 2u ? choice >> 1u : pbit0;
+            BC7Part part;
+            for (auto c = spec.channels.begin; c < spec.channels.end; c++) {
+                part.endpoints[0][c] = bc7_quantize(line.e[0][c], spec.bits, pbit0);
+                part.endpoints[1][c] = bc7_quantize(line.e[1][c], spec.bits, pbit1);
+            }
+            part.error = bc7_assign(p, weights, spec, part);
+            if (part.error < best.error) { best = part; }
+        }
+        if (iteration == iterations || best.error == 0.f) { break; }
+        uint point_weights[16];
+        for (auto i = 0u; i < p.count; i++) { point_weights[i] = bc_weights(spec.index_bits)[best.indices[i]]; }
+        if (!bc_refine_line(p, point_weights, spec.channels, line)) { break; }
+    }
+    return best;
+}
+
+struct BC7Block {
+    uint mode{0u};
+    uint partition{0u};
+    uint endpoints[4][4]{};// per subset endpoint, or color then alpha endpoints in mode 5
+    uint indices[16]{};
+    uint alpha_indices[16]{};
+    float error{bc_max_error};
+};
+
+// modes 1 and 3, two subsets without alpha
+[[nodiscard]] static BC7Block bc7_encode_partitioned(const BCPoints &block, const float *weights,
+                                                     uint mode, uint partition, uint iterations) noexcept {
+    auto spec = mode == 1u ? BC7PartSpec{{0u, 3u}, 7u, 1u, 3u} :
+                             BC7PartSpec{{0u, 3u}, 8u, 2u, 2u};
+    BC7Block b{.mode = mode, .partition = partition, .error = 0.f};
+    for (auto s = 0u; s < 2u; s++) {
+        auto p = bc_subset(block, bc_partitions2[partition], s);
+        auto part = bc7_fit_part(p, weights, spec, iterations);
+        auto anchor = 0u;
+        if (s == 1u) {
+            while (p.texels[anchor] != bc_anchors2[partition]) { anchor++; }
+        }
+        bc_fix_anchor(part.endpoints, part.indices, p.count, anchor, spec.index_bits);
+        std::copy_n(part.endpoints[0], 4u, b.endpoints[s * 2u]);
+        std::copy_n(part.endpoints[1], 4u, b.endpoints[s * 2u + 1u]);
+        for (auto i = 0u; i < p.count; i++) { b.indices[p.texels[i]] = part.indices[i]; }
+        b.error += part.error;
+    }
+    for (auto i = 0u; i < 16u; i++) {// decoded alpha is opaque
+        auto diff = 255.f - block.v[3][i];
+        b.error += weights[3] * diff * diff;
+    }
+    return b;
+}
+
+// mode 6, one subset with alpha and shared indices
+[[nodiscard]] static BC7Block bc7_encode_mode6(const BCPoints &block, const float *weights, uint iterations) noexcept {
+    auto spec = BC7PartSpec{{0u, 4u}, 8u, 2u, 4u};
+    auto part = bc7_fit_part(block, weights, spec, iterations);
+    bc_fix_anchor(part.endpoints, part.indices, 16u, 0u, spec.index_bits);
+    BC7Block b{.mode = 6u, .error = part.error};
+    std::copy_n(part.endpoints[0], 4u, b.endpoints[0]);
+    std::copy_n(part.endpoints[1], 4u, b.endpoints[1]);
+    std::copy_n(part.indices, 16u, b.indices);
+    return b;
+}
+
+// mode 5, one subset with separately indexed alpha
+[[nodiscard]] static BC7Block bc7_encode_mode5(const BCPoints &block, const float *weights, uint iterations) noexcept {
+    auto color_spec = BC7PartSpec{{0u, 3u}, 7u, 0u, 2u};
+    auto alpha_spec = BC7PartSpec{{3u, 4u}, 8u, 0u, 2u};
+    auto color = bc7_fit_part(block, weights, color_spec, iterations);
+    auto alpha = bc7_fit_part(block, weights, alpha_spec, iterations);
+    bc_fix_anchor(color.endpoints, color.indices, 16u, 0u, color_spec.index_bits);
+    bc_fix_anchor(alpha.endpoints, alpha.indices, 16u, 0u, alpha_spec.index_bits);
+    BC7Block b{.mode = 5u, .error = color.error + alpha.error};
+    std::copy_n(color.endpoints[0], 4u, b.endpoints[0]);
+    std::copy_n(color.endpoints[1], 4u, b.endpoints[1]);
+    std::copy_n(alpha.endpoints[0], 4u, b.endpoints[2]);
+    std::copy_n(alpha.endpoints[1], 4u, b.endpoints[3]);
+    std::copy_n(color.indices, 16u, b.indices);
+    std::copy_n(alpha.indices, 16u, b.alpha_indices);
+    return b;
+}
+
+static void bc7_pack(const BC7Block &b, std::byte *block) noexcept {
+    BCBitWriter writer{block};
+    writer.write(1u << b.mode, b.mode + 1u);
+    switch (b.mode) {
+        case 1u:
+        case 3u: {
+            auto bits = b.mode == 1u ? 6u : 7u;
+            writer.write(b.partition, 6u);
+            for (auto c = 0u; c < 3u; c++) {
+                for (auto e = 0u; e < 4u; e++) { writer.write(b.endpoints[e][c] >> 1u, bits); }
+            }
+            if (b.mode == 1u) {
+                for (auto s = 0u; s < 2u; s++) { writer.write(b.endpoints[s * 2u][0] & 1u, 1u); }
+            } else {
+                for (auto e = 0u; e < 4u; e++) { writer.write(b.endpoints[e][0] & 1u, 1u); }
+            }
+            auto index_bits = b.mode == 1u ? 3u : 2u;
+            for (auto i = 0u; i < 16u; i++) {
+                auto anchor = i == 0u || i == bc_anchors2[b.partition];
+                writer.write(b.indices[i], index_bits - (anchor ? 1u : 0u));
+            }
+            break;
+        }
+        case 5u: {
+            writer.write(0u, 2u);// no rotation
+            for (auto c = 0u; c < 3u; c++) {
+                for (auto e = 0u; e < 2u; e++) { writer.write(b.endpoints[e][c], 7u); }
+            }
+            for (auto e = 2u; e < 4u; e++) { writer.write(b.endpoints[e][3], 8u); }
+            for (auto i = 0u; i < 16u; i++) { writer.write(b.indices[i], i == 0u ? 1u : 2u); }
+            for (auto i = 0u; i < 16u; i++) { writer.write(b.alpha_indices[i], i == 0u ? 1u : 2u); }
+            break;
+        }
+        case 6u: {
+            for (auto c = 0u; c < 4u; c++) {
+                for (auto e = 0u; e < 2u; e++) { writer.write(b.endpoints[e][c] >> 1u, 7u); }
+            }
+            for (auto e = 0u; e < 2u; e++) { writer.write(b.endpoints[e][0] & 1u, 1u); }
+            for (auto i = 0u; i < 16u; i++) { writer.write(b.indices[i], i == 0u ? 3u : 4u); }
+            break;
+        }
+        default: LUISA_ERROR_WITH_LOCATION("Unsupported BC7 mode {}.", b.mode);
+    }
+    LUISA_ASSERT(writer.offset() == 128u, "Invalid BC7 block size {}.", writer.offset());
+}
+
+// BC6H
+
+// a run of endpoint bits, in the order they are stored in the block
+struct BC6HSegment {
+    uint8_t field;// endpoint * 3 + channel
+    uint8_t lsb;
+    uint8_t count;
+    bool reversed;
+};
+
+struct BC6HModeInfo {
+    uint8_t mode_field;
+    bool partitioned;
+    bool transformed;
+    uint8_t endpoint_bits;
+    uint8_t delta_bits[3];
+    BC6HSegment segments[24];
+};
+
+enum BC6HField : uint8_t { rw, gw, bw, rx, gx, bx, ry, gy, by, rz, gz, bz };
+
+// modes 1 to 14 of the format
+static constexpr BC6HModeInfo bc6h_modes[14] = {
+    {0x00u, true, true, 10u, {5u, 5u, 5u}, {{gy, 4, 1}, {by, 4, 1}, {bz, 4, 1}, {rw, 0, 10}, {gw, 0, 10}, {bw, 0, 10}, {rx, 0, 5}, {gz, 4, 1}, {gy, 0, 4}, {gx, 0, 5}, {bz, 0, 1}, {gz, 0, 4}, {bx, 0, 5}, {bz, 1, 1}, {by, 0, 4}, {ry, 0, 5}, {bz, 2, 1}, {rz, 0, 5}, {bz, 3, 1}}},
+    {0x01u, true, true, 7u, {6u, 6u, 6u}, {{gy, 5, 1}, {gz, 4, 1}, {gz, 5, 1}, {rw, 0, 7}, {bz, 0, 1}, {bz, 1, 1}, {by, 4, 1}, {gw, 0, 7}, {by, 5, 1}, {bz, 2, 1}, {gy, 4, 1}, {bw, 0, 7}, {bz, 3, 1}, {bz, 5, 1}, {bz, 4, 1}, {rx, 0, 6}, {gy, 0, 4}, {gx, 0, 6}, {gz, 0, 4}, {bx, 0, 6}, {by, 0, 4}, {ry, 0, 6}, {rz, 0, 6}}},
+    {0x02u, true, true, 11u, {5u, 4u, 4u}, {{rw, 0, 10}, {gw, 0, 10}, {bw, 0, 10}, {rx, 0, 5}, {rw, 10, 1}, {gy, 0, 4}, {gx, 0, 4}, {gw, 10, 1}, {bz, 0, 1}, {gz, 0, 4}, {bx, 0, 4}, {bw, 10, 1}, {bz, 1, 1}, {by, 0, 4}, {ry, 0, 5}, {bz, 2, 1}, {rz, 0, 5}, {bz, 3, 1}}},
+    {0x06u, true, true, 11u, {4u, 5u, 4u}, {{rw, 0, 10}, {gw, 0, 10}, {bw, 0, 10}, {rx, 0, 4}, {rw, 10, 1}, {gz, 4, 1}, {gy, 0, 4}, {gx, 0, 5}, {gw, 10, 1}, {gz, 0, 4}, {bx, 0, 4}, {bw, 10, 1}, {bz, 1, 1}, {by, 0, 4}, {ry, 0, 4}, {bz, 0, 1}, {bz, 2, 1}, {rz, 0, 4}, {gy, 4, 1}, {bz, 3, 1}}},
+    {0x0au, true, true, 11u, {4u, 4u, 5u}, {{rw, 0, 10}, {gw, 0, 10}, {bw, 0, 10}, {rx, 0, 4}, {rw, 10, 1}, {by, 4, 1}, {gy, 0, 4}, {gx, 0, 4}, {gw, 10, 1}, {bz, 0, 1}, {gz, 0, 4}, {bx, 0, 5}, {bw, 10, 1}, {by, 0, 4}, {ry, 0, 4}, {bz, 1, 1}, {bz, 2, 1}, {rz, 0, 4}, {bz, 4, 1}, {bz, 3, 1}}},
+    {0x0eu, true, true, 9u, {5u, 5u, 5u}, {{rw, 0, 9}, {by, 4, 1}, {gw, 0, 9}, {gy, 4, 1}, {bw, 0, 9}, {bz, 4, 1}, {rx, 0, 5}, {gz, 4, 1}, {gy, 0, 4}, {gx, 0, 5}, {bz, 0, 1}, {gz, 0, 4}, {bx, 0, 5}, {bz, 1, 1}, {by, 0, 4}, {ry, 0, 5}, {bz, 2, 1}, {rz, 0, 5}, {bz, 3, 1}}},
+    {0x12u, true, true, 8u, {6u, 5u, 5u}, {{rw, 0, 8}, {gz, 4, 1}, {by, 4, 1}, {gw, 0, 8}, {bz, 2, 1}, {gy, 4, 1}, {bw, 0, 8}, {bz, 3, 1}, {bz, 4, 1}, {rx, 0, 6}, {gy, 0, 4}, {gx, 0, 5}, {bz, 0, 1}, {gz, 0, 4}, {bx, 0, 5}, {bz, 1, 1}, {by, 0, 4}, {ry, 0, 6}, {rz, 0, 6}}},
+    {0x16u, true, true, 8u, {5u, 6u, 5u}, {{rw, 0, 8}, {bz, 0, 1}, {by, 4, 1}, {gw, 0, 8}, {gy, 5, 1}, {gy, 4, 1}, {bw, 0, 8}, {gz, 5, 1}, {bz, 4, 1}, {rx, 0, 5}, {gz, 4, 1}, {gy, 0, 4}, {gx, 0, 6}, {gz, 0, 4}, {bx, 0, 5}, {bz, 1, 1}, {by, 0, 4}, {ry, 0, 5}, {bz, 2, 1}, {rz, 0, 5}, {bz, 3, 1}}},
+    {0x1au, true, true, 8u, {5u, 5u, 6u}, {{rw, 0, 8}, {bz, 1, 1}, {by, 4, 1}, {gw, 0, 8}, {by, 5, 1}, {gy, 4, 1}, {bw, 0, 8}, {bz, 5, 1}, {bz, 4, 1}, {rx, 0, 5}, {gz, 4, 1}, {gy, 0, 4}, {gx, 0, 5}, {bz, 0, 1}, {gz, 0, 4}, {bx, 0, 6}, {by, 0, 4}, {ry, 0, 5}, {bz, 2, 1}, {rz, 0, 5}, {bz, 3, 1}}},
+    {0x1eu, true, false, 6u, {6u, 6u, 6u}, {{rw, 0, 6}, {gz, 4, 1}, {bz, 0, 1}, {bz, 1, 1}, {by, 4, 1}, {gw, 0, 6}, {gy, 5, 1}, {by, 5, 1}, {bz, 2, 1}, {gy, 4, 1}, {bw, 0, 6}, {gz, 5, 1}, {bz, 3, 1}, {bz, 5, 1}, {bz, 4, 1}, {rx, 0, 6}, {gy, 0, 4}, {gx, 0, 6}, {gz, 0, 4}, {bx, 0, 6}, {by, 0, 4}, {ry, 0, 6}, {rz, 0, 6}}},
+    {0x03u, false, false, 10u, {10u, 10u, 10u}, {{rw, 0, 10}, {gw, 0, 10}, {bw, 0, 10}, {rx, 0, 10}, {gx, 0, 10}, {bx, 0, 10}}},
+    {0x07u, false, true, 11u, {9u, 9u, 9u}, {{rw, 0, 10}, {gw, 0, 10}, {bw, 0, 10}, {rx, 0, 9}, {rw, 10, 1}, {gx, 0, 9}, {gw, 10, 1}, {bx, 0, 9}, {bw, 10, 1}}},
+    {0x0bu, false, true, 12u, {8u, 8u, 8u}, {{rw, 0, 10}, {gw, 0, 10}, {bw, 0, 10}, {rx, 0, 8}, {rw, 10, 2, true}, {gx, 0, 8}, {gw, 10, 2, true}, {bx, 0, 8}, {bw, 10, 2, true}}},
+    {0x0fu, false, true, 16u, {4u, 4u, 4u}, {{rw, 0, 10}, {gw, 0, 10}, {bw, 0, 10}, {rx, 0, 4}, {rw, 10, 6, true}, {gx, 0, 4}, {gw, 10, 6, true}, {bx, 0, 4}, {bw, 10, 6, true}}},
+};
+
+static constexpr auto bc6h_first_single_subset_mode = 10u;
+
+[[nodiscard]] static auto bc6h_unquantize(uint v, uint bits) noexcept {
+    if (bits >= 15u) { return v; }
+    if (v == 0u) { return 0u; }
+    if (v == (1u << bits) - 1u) { return 0xffffu; }
+    return ((v << 16u) + 0x8000u) >> bits;
+}
+
+[[nodiscard]] static auto bc6h_quantize(float u, uint bits) noexcept {
+    auto max_value = static_cast<int>((1u << bits) - 1u);
+    auto x0 = static_cast<int>(std::round(std::clamp(u, 0.f, 65535.f) / 65535.f * static_cast<float>(max_value)));
+    auto best = 0u;
+    auto best_error = bc_max_error;
+    for (auto x = std::max(x0 - 1, 0); x <= std::min(x0 + 1, max_value); x++) {
+        auto e = std::abs(static_cast<float>(bc6h_unquantize(static_cast<uint>(x), bits)) - u);
+        if (e < best_error) {
+            best = static_cast<uint>(x);
+            best_error = e;
+        }
+    }
+    return best;
+}
+
+// the points hold the unquantized endpoint domain, in which decoded half bits are u * 31 / 64
+struct BC6HPart {
+    uint endpoints[2][3]{};
+    uint indices[16]{};
+    float error{bc_max_error};
+};
+
+[[nodiscard]] static float bc6h_assign(const BCPoints &p, uint bits, uint index_bits, BC6HPart &part) noexcept {
+    auto n = 1u << index_bits;
+    auto w = bc_weights(index_bits);
+    float palette[3][16]{};
+    for (auto c = 0u; c < 3u; c++) {
+        auto u0 = bc6h_unquantize(part.endpoints[0][c], bits);
+        auto u1 = bc6h_unquantize(part.endpoints[1][c], bits);
+        for (auto k = 0u; k < n; k++) { palette[c][k] = static_cast<float>((bc_interpolate(u0, u1, w[k]) * 31u) >> 6u); }
+    }
+    auto total = 0.f;
+    for (auto i = 0u; i < p.count; i++) {
+        auto best = bc_max_error;
+        auto best_index = 0u;
+        for (auto k = 0u; k < n; k++) {
+            auto d = 0.f;
+            for (auto c = 0u; c < 3u; c++) {
+                auto diff = p.v[c][i] * (31.f / 64.f) - palette[c][k];
+                d += diff * diff;
+            }
+            if (d < best) {
+                best = d;
+                best_index = k;
+            }
+        }
+        part.indices[i] = best_index;
+        total += best;
+    }
+    return total;
+}
+
+[[nodiscard]] static BC6HPart bc6h_fit_part(const BCPoints &p, BCLine line, uint bits,
+                                            uint index_bits, uint iterations) noexcept {
+    BC6HPart best;
+    for (auto iteration = 0u;; iteration++) {
+        BC6HPart part;
+        for (auto c = 0u; c < 3u; c++) {
+            part.endpoints[0][c] = bc6h_quantize(line.e[0][c], bits);
+            part.endpoints[1][c] = bc6h_quantize(line.e[1][c], bits);
+        }
+        part.error = bc6h_assign(p, bits, index_bits, part);
+        if (part.error < best.error) { best = part; }
+        if (iteration == iterations || best.error == 0.f) { break; }
+        uint point_weights[16];
+        for (auto i = 0u; i < p.count; i++) { point_weights[i] = bc_weights(index_bits)[best.indices[i]]; }
+        if (!bc_refine_line(p, point_weights, {0u, 3u}, line)) { break; }
+    }
+    return best;
+}
+
+struct BC6HBlock {
+    uint mode{0u};// index into bc6h_modes
+    uint partition{0u};
+    uint endpoints[4][3]{};
+    uint indices[16]{};
+    float error{bc_max_error};
+};
+
+[[nodiscard]] static bool bc6h_deltas_fit(const BC6HModeInfo &m, const BC6HBlock &b) noexcept {
+    if (!m.transformed) { return true; }
+    auto endpoint_count = m.partitioned ? 4u : 2u;
+    for (auto e = 1u; e < endpoint_count; e++) {
+        for (auto c = 0u; c < 3u; c++) {
+            auto d = static_cast<int>(b.endpoints[e][c]) - static_cast<int>(b.endpoints[0][c]);
+            auto limit = 1 << (m.delta_bits[c] - 1u);
+            if (d < -limit || d >= limit) { return false; }
+        }
+    }
+    return true;
+}
+
+// tries a mode with the subsets already fitted to lines
+[[nodiscard]] static BC6HBlock bc6h_encode_mode(const BCPoints *subsets, const BCLine *lines,
+                                                uint mode, uint partition, uint iterations) noexcept {
+    auto &&m = bc6h_modes[mode];
+    auto subset_count = m.partitioned ? 2u : 1u;
+    auto index_bits = m.partitioned ? 3u : 4u;
+    BC6HBlock b{.mode = mode, .partition = partition, .error = 0.f};
+    // skip the fitting when the lines span more than the deltas can reach from any base endpoint
+    if (m.transformed) {
+        for (auto c = 0u; c < 3u; c++) {
+            auto lo = ~0u;
+            auto hi = 0u;
+            for (auto s = 0u; s < subset_count; s++) {
+                for (auto e = 0u; e < 2u; e++) {
+                    auto v = bc6h_quantize(lines[s].e[e][c], m.endpoint_bits);
+                    lo = std::min(lo, v);
+                    hi = std::max(hi, v);
+                }
+            }
+            if (hi - lo >= (1u << m.delta_bits[c])) { return {}; }
+        }
+    }
+    for (auto s = 0u; s < subset_count; s++) {
+        auto &&p = subsets[s];
+        auto part = bc6h_fit_part(p, lines[s], m.endpoint_bits, index_bits, iterations);
+        auto anchor = 0u;
+        if (s == 1u) {
+            while (p.texels[anchor] != bc_anchors2[partition]) { anchor++; }
+        }
+        bc_fix_anchor(part.endpoints, part.indices, p.count, anchor, index_bits);
+        std::copy_n(part.endpoints[0], 3u, b.endpoints[s * 2u]);
+        std::copy_n(part.endpoints[1], 3u, b.endpoints[s * 2u + 1u]);
+        for (auto i = 0u; i < p.count; i++) { b.indices[p.texels[i]] = part.indices[i]; }
+        b.error += part.error;
+    }
+    if (!bc6h_deltas_fit(m, b)) { b.error = bc_max_error; }
+    return b;
+}
+
+static void bc6h_pack(const BC6HBlock &b, std::byte *block) noexcept {
+    auto &&m = bc6h_modes[b.mode];
+    BCBitWriter writer{block};
+    writer.write(m.mode_field, b.mode < 2u ? 2u : 5u);
+    uint fields[12]{};
+    auto endpoint_count = m.partitioned ? 4u : 2u;
+    for (auto e = 0u; e < endpoint_count; e++) {
+        for (auto c = 0u; c < 3u; c++) {
+            auto v = b.endpoints[e][c];
+            if (m.transformed && e != 0u) { v = (v - b.endpoints[0][c]) & ((1u << m.delta_bits[c]) - 1u); }
+            fields[e * 3u + c] = v;
+        }
+    }
+    for (auto &&s : m.segments) {
+        if (s.count == 0u) { break; }
+        auto v = (fields[s.field] >> s.lsb) & ((1u << s.count) - 1u);
+        if (s.reversed) {
+            auto r = 0u;
+            for (auto i = 0u; i < s.count; i++) { r |= ((v >> i) & 1u) << (s.count - 1u - i); }
+            v = r;
+        }
+        writer.write(v, s.count);
+    }
+    if (m.partitioned) { writer.write(b.partition, 5u); }
+    auto index_bits = m.partitioned ? 3u : 4u;
+    for (auto i = 0u; i < 16u; i++) {
+        auto anchor = i == 0u || (m.partitioned && i == bc_anchors2[b.partition]);
+        writer.write(b.indices[i], index_bits - (anchor ? 1u : 0u));
+    }
+    LUISA_ASSERT(writer.offset() == 128u, "Invalid BC6H block size {}.", writer.offset());
+}
+
+[[nodiscard]] static auto bc_refinement_iterations(BCQuality quality) noexcept {
+    switch (quality) {
+        case BCQuality::Fastest: return 0u;
+        case BCQuality::Default: return 1u;
+        case BCQuality::Best: return 2u;
+    }
+    return 1u;
+}
+
+// partitioned modes are searched for this many of the best ranked partitions
+[[nodiscard]] static auto bc_partition_candidates(BCQuality quality) noexcept {
+    switch (quality) {
+        case BCQuality::Fastest: return 0u;
+        case BCQuality::Default: return 2u;
+        case BCQuality::Best: return 8u;
+    }
+    return 2u;
+}
+
+}// namespace detail
+
+void rust_bc6h_encode_block(const float4 *texels, TexCompressExt::Quality quality,
+                            std::byte *block) noexcept {
+    using namespace detail;
+    BCPoints points{.count = 16u};
+    for (auto i = 0u; i < 16u; i++) {
+        points.texels[i] = i;
+        for (auto c = 0u; c < 3u; c++) {
+            auto v = texels[i][c];
+            v = std::isnan(v) ? 0.f : std::clamp(v, 0.f, 65504.f);
+            auto bits = luisa::bit_cast<uint16_t>(static_cast<half>(v));
+            points.v[c][i] = static_cast<float>(bits) * (64.f / 31.f);
+        }
+    }
+    static constexpr float weights[4] = {1.f, 1.f, 1.f, 1.f};
+    auto iterations = bc_refinement_iterations(quality);
+    auto line = bc_fit_line(points, weights, {0u, 3u});
+    BC6HBlock best;
+    // single subset modes, only the untransformed one when fastest
+    auto last_single_mode = quality == BCQuality::Fastest ? bc6h_first_single_subset_mode + 1u : 14u;
+    for (auto mode = bc6h_first_single_subset_mode; mode < last_single_mode; mode++) {
+        auto b = bc6h_encode_mode(&points, &line, mode, 0u, iterations);
+        if (b.error < best.error) { best = b; }
+    }
+    uint partitions[64];
+    auto partition_count = bc_partition_candidates(quality);
+    if (best.error > 0.f && partition_count != 0u) {
+        bc_rank_partitions(points, weights, {0u, 3u}, 32u, partition_count, partitions);
+        for (auto i = 0u; i < partition_count; i++) {
+            auto mask = bc_partitions2[partitions[i]];
+            BCPoints subsets[2] = {bc_subset(points, mask, 0u), bc_subset(points, mask, 1u)};
+            BCLine lines[2] = {bc_fit_line(subsets[0], weights, {0u, 3u}),
+                               bc_fit_line(subsets[1], weights, {0u, 3u})};
+            for (auto mode = 0u; mode < bc6h_first_single_subset_mode; mode++) {
+                auto b = bc6h_encode_mode(subsets, lines, mode, partitions[i], iterations);
+                if (b.error < best.error) { best = b; }
+            }
+        }
+    }
+    bc6h_pack(best, block);
+}
+
+void rust_bc7_encode_block(const float4 *texels, TexCompressExt::Quality quality,
+                           float alpha_importance, std::byte *block) noexcept {
+    using namespace detail;
+    auto ignore_alpha = !(alpha_importance > 0.f);
+    BCPoints points{.count = 16u};
+    auto opaque = true;
+    for (auto i = 0u; i < 16u; i++) {
+        points.texels[i] = i;
+        for (auto c = 0u; c < 4u; c++) {
+            auto v = texels[i][c];
+            points.v[c][i] = std::isnan(v) ? 0.f : std::clamp(v, 0.f, 1.f) * 255.f;
+        }
+        if (ignore_alpha) { points.v[3][i] = 255.f; }
+        opaque &= points.v[3][i] >= 254.5f;
+    }
+    float weights[4] = {1.f, 1.f, 1.f, ignore_alpha ? 1.f : alpha_importance};
+    auto iterations = bc_refinement_iterations(quality);
+    auto best = bc7_encode_mode6(points, weights, iterations);
+    if (best.error > 0.f && quality != BCQuality::Fastest) {
+        if (!opaque) {
+            if (auto b = bc7_encode_mode5(points, weights, iterations); b.error < best.error) { best = b; }
+        } else {
+            uint partitions[64];
+            auto partition_count = bc_partition_candidates(quality);
+            bc_rank_partitions(points, weights, {0u, 3u}, 64u, partition_count, partitions);
+            for (auto i = 0u; i < partition_count; i++) {
+                for (auto mode : {1u, 3u}) {
+                    auto b = bc7_encode_partitioned(points, weights, mode, partitions[i], iterations);
+                    if (b.error < best.error) { best = b; }
+                }
+            }
+        }
+    }
+    bc7_pack(best, block);
+}
+
+}// namespace luisa::compute::rust
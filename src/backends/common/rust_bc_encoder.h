@@ -0,0 +1,19 @@
+#pragma once
+
+#include <luisa/core/basic_types.h>
+#include <luisa/backends/ext/tex_compress_ext.h>
+
+namespace luisa::compute::rust {
+
+// Block encoders behind RustTexCompressExt. Each one takes the 16 texels
+// of a 4x4 block in row-major order and writes a 16-byte block.
+
+// texels are linear HDR colors, negative values are clamped to zero
+void rust_bc6h_encode_block(const float4 *texels, TexCompressExt::Quality quality,
+                            std::byte *block) noexcept;
+
+// texels are in [0, 1], alpha is encoded as opaque if alpha_importance is zero
+void rust_bc7_encode_block(const float4 *texels, TexCompressExt::Quality quality,
+                           float alpha_importance, std::byte *block) noexcept;
+
+}// namespace luisa::compute::rust
@@ -10,10 +10,13 @@ using luisa::compute::ir::Type;
 
 #include <luisa/core/dynamic_module.h>
 #include <luisa/core/logging.h>
+#include <luisa/core/compile_report.h>
 #include <luisa/runtime/context.h>
 #include <luisa/runtime/rtx/triangle.h>
 #include <luisa/ir/ast2ir.h>
 #include "rust_device_common.h"
+#include "rust_dstorage.h"
+#include "rust_tex_compress.h"
 
 // must go last to avoid name conflicts
 #include <luisa/runtime/rhi/resource.h>
@@ -73,6 +76,15 @@ private:
                    api::AccelBuildRequest::FORCE_BUILD;
     }
 
+    [[nodiscard]] static auto _convert_mesh_vertex_format(MeshVertexFormat f) noexcept {
+        switch (f) {
+            case MeshVertexFormat::FLOAT3: return api::MeshVertexFormat::FLOAT3;
+            case MeshVertexFormat::HALF3: return api::MeshVertexFormat::HALF3;
+            case MeshVertexFormat::SNORM16_3: return api::MeshVertexFormat::SNORM16X3;
+        }
+        LUISA_ERROR_WITH_LOCATION("Invalid mesh vertex format.");
+    }
+
 public:
     void dispatch(api::DeviceInterface device, api::Stream stream,
                   CommandList &&list) noexcept {
@@ -292,10 +304,11 @@ public:
             .vertex_buffer_offset = command->vertex_buffer_offset(),
             .vertex_buffer_size = command->vertex_buffer_size(),
             .vertex_stride = command->vertex_stride(),
+            .vertex_format = _convert_mesh_vertex_format(command->vertex_format()),
             .index_buffer = {command->triangle_buffer()},
             .index_buffer_offset = command->triangle_buffer_offset(),
             .index_buffer_size = command->triangle_buffer_size(),
-            .index_stride = sizeof(Triangle)};
+            .index_stride = command->triangle_stride()};
         _converted.emplace_back(converted);
     }
     void visit(const ProceduralPrimitiveBuildCommand *command) noexcept override {
@@ -359,7 +372,7 @@ public:
 };
 
 // @Mike-Leo-Smith: fill-in the blanks pls
-class RustDevice final : public DeviceInterface {
+class RustDevice final : public DeviceInterface, public RustDStorageHost, public RustTexCompressHost {
     api::DeviceInterface device{};
     api::LibInterface lib{};
     luisa::filesystem::path runtime_path;
@@ -369,8 +382,37 @@ class RustDevice final : public DeviceInterface {
 
     api::Context api_ctx{};
 
+    // resources looked up by the DStorage and texture compression extensions
+    mutable std::mutex resource_mutex;
+    luisa::unordered_map<uint64_t, std::byte *> buffer_addresses;
+    luisa::unordered_map<uint64_t, PixelStorage> texture_storages;
+    std::once_flag dstorage_once;
+    luisa::unique_ptr<RustDStorageExt> dstorage;
+    std::atomic<RustDStorageExt *> dstorage_ptr{nullptr};
+    std::once_flag tex_compress_once;
+    luisa::unique_ptr<RustTexCompressExt> tex_compress;
+    std::once_flag host_stream_once;
+    api::Stream host_stream{};
+
+    [[nodiscard]] RustDStorageStream *dstorage_stream(uint64_t handle) const noexcept {
+        auto ext = dstorage_ptr.load(std::memory_order_acquire);
+        return ext == nullptr ? nullptr : ext->stream(handle);
+    }
+
+    // internal stream for the work the extensions hand back to the device
+    [[nodiscard]] api::Stream get_host_stream() noexcept {
+        std::call_once(host_stream_once, [this] {
+            auto stream = device.create_stream(device.device, api::StreamTag::COPY);
+            host_stream = api::Stream{stream.handle};
+        });
+        return host_stream;
+    }
+
 public:
     ~RustDevice() noexcept override {
+        dstorage = nullptr;
+        tex_compress = nullptr;
+        if (host_stream._0 != 0u) { device.destroy_stream(device.device, host_stream); }
         device.destroy_device(device);
         lib.destroy_context(api_ctx);
     }
@@ -397,6 +439,16 @@ public:
                 LUISA_VERBOSE("[{}] {}", target, body);
             }
         });
+        // compile events are reported on the compiling thread, so they go into its open compile report
+        lib.set_compile_event_callback([](api::CompileEvent event) {
+            luisa::string_view name(event.name);
+            switch (event.kind) {
+                case api::CompileEventKind::PHASE: CompileProfiler::phase(name, event.milliseconds); break;
+                case api::CompileEventKind::COUNTER: CompileProfiler::counter(name, event.value); break;
+                case api::CompileEventKind::CACHE_HIT: CompileProfiler::cache(name, true); break;
+                case api::CompileEventKind::CACHE_MISS: CompileProfiler::cache(name, false); break;
+            }
+        });
     }
 
     void *native_handle() const noexcept override {
@@ -415,10 +467,16 @@ public:
         info.total_size_bytes = buffer.total_size_bytes;
         info.handle = buffer.resource.handle;
         info.native_handle = buffer.resource.native_handle;
+        std::scoped_lock lock{resource_mutex};
+        buffer_addresses.emplace(info.handle, static_cast<std::byte *>(info.native_handle));
         return info;
     }
 
     void destroy_buffer(uint64_t handle) noexcept override {
+        {
+            std::scoped_lock lock{resource_mutex};
+            buffer_addresses.erase(handle);
+        }
         device.destroy_buffer(device.device, api::Buffer{handle});
     }
 
@@ -430,10 +488,16 @@ public:
         ResourceCreationInfo info{};
         info.handle = texture.handle;
         info.native_handle = texture.native_handle;
+        std::scoped_lock lock{resource_mutex};
+        texture_storages.emplace(info.handle, pixel_format_to_storage(format));
         return info;
     }
 
     void destroy_texture(uint64_t handle) noexcept override {
+        {
+            std::scoped_lock lock{resource_mutex};
+            texture_storages.erase(handle);
+        }
         device.destroy_texture(device.device, api::Texture{handle});
     }
 
@@ -458,14 +522,26 @@ public:
     }
 
     void destroy_stream(uint64_t handle) noexcept override {
+        if (dstorage_stream(handle) != nullptr) {
+            dstorage->destroy_stream(handle);
+            return;
+        }
         device.destroy_stream(device.device, api::Stream{handle});
     }
 
     void synchronize_stream(uint64_t stream_handle) noexcept override {
+        if (auto s = dstorage_stream(stream_handle)) {
+            s->synchronize();
+            return;
+        }
         device.synchronize_stream(device.device, api::Stream{stream_handle});
     }
 
     void dispatch(uint64_t stream_handle, CommandList &&list) noexcept override {
+        if (auto s = dstorage_stream(stream_handle)) {
+            s->dispatch(std::move(list));
+            return;
+        }
         APICommandConverter converter;
         converter.dispatch(device, api::Stream{stream_handle}, std::move(list));
     }
@@ -494,7 +570,10 @@ public:
     }
 
     ShaderCreationInfo create_shader(const ShaderOption &option, Function kernel) noexcept override {
-        auto shader = AST2IR::build_kernel(kernel);
+        auto shader = [&] {
+            CompileProfiler::Phase phase{"ast2ir"};
+            return AST2IR::build_kernel(kernel);
+        }();
         return create_shader(option, shader->get());
     }
 
@@ -505,6 +584,7 @@ public:
         option.enable_cache = option_.enable_cache;
         option.enable_debug_info = option_.enable_debug_info;
         option.enable_fast_math = option_.enable_fast_math;
+        // the backend reports its codegen, compilation and loading phases through the compile event callback
         auto shader = device.create_shader(device.device, api::KernelModule{(uint64_t)kernel}, &option);
         ShaderCreationInfo info{};
         info.block_size[0] = shader.block_size[0];
@@ -541,10 +621,18 @@ public:
     }
 
     void signal_event(uint64_t handle, uint64_t stream_handle, uint64_t value) noexcept override {
+        if (auto s = dstorage_stream(stream_handle)) {
+            s->signal(handle, value);
+            return;
+        }
         device.signal_event(device.device, api::Event{handle}, api::Stream{stream_handle}, value);
     }
 
     void wait_event(uint64_t handle, uint64_t stream_handle, uint64_t value) noexcept override {
+        if (auto s = dstorage_stream(stream_handle)) {
+            s->wait(handle, value);
+            return;
+        }
         device.wait_event(device.device, api::Event{handle}, api::Stream{stream_handle}, value);
     }
 
@@ -599,6 +687,76 @@ public:
     void set_name(luisa::compute::Resource::Tag resource_tag, uint64_t resource_handle,
                   luisa::string_view name) noexcept override {
     }
+
+    DeviceExtension *extension(luisa::string_view name) noexcept override {
+        if (name == DStorageExt::name) {
+            std::call_once(dstorage_once, [this] {
+                dstorage = luisa::make_unique<RustDStorageExt>(this, this);
+                dstorage_ptr.store(dstorage.get(), std::memory_order_release);
+            });
+            return dstorage.get();
+        }
+        if (name == TexCompressExt::name) {
+            std::call_once(tex_compress_once, [this] {
+                tex_compress = luisa::make_unique<RustTexCompressExt>(this);
+            });
+            return tex_compress.get();
+        }
+        return nullptr;
+    }
+
+    // RustDStorageHost and RustTexCompressHost
+    [[nodiscard]] std::byte *buffer_address(uint64_t handle) const noexcept override {
+        std::scoped_lock lock{resource_mutex};
+        auto iter = buffer_addresses.find(handle);
+        LUISA_ASSERT(iter != buffer_addresses.end(), "Invalid buffer handle {}.", handle);
+        return iter->second;
+    }
+
+    [[nodiscard]] PixelStorage texture_storage(uint64_t handle) const noexcept override {
+        std::scoped_lock lock{resource_mutex};
+        auto iter = texture_storages.find(handle);
+        LUISA_ASSERT(iter != texture_storages.end(), "Invalid texture handle {}.", handle);
+        return iter->second;
+    }
+
+    void upload_texture(uint64_t handle, uint level, uint3 size, const void *data) noexcept override {
+        api::Command command{.tag = api::Command::Tag::TEXTURE_UPLOAD};
+        command.TEXTURE_UPLOAD._0 = api::TextureUploadCommand{
+            .texture = {handle},
+            .storage = static_cast<api::PixelStorage>(texture_storage(handle)),
+            .level = level,
+            .size = {size.x, size.y, size.z},
+            .data = static_cast<const uint8_t *>(data)};
+        api::CommandList list{.commands = &command, .commands_count = 1u};
+        auto stream = get_host_stream();
+        device.dispatch(device.device, stream, list, [](uint8_t *) noexcept {}, nullptr);
+        device.synchronize_stream(device.device, stream);
+    }
+
+    // RustTexCompressHost
+    void download_texture(uint64_t handle, PixelStorage storage,
+                          uint level, uint3 size, void *data) noexcept override {
+        api::Command command{.tag = api::Command::Tag::TEXTURE_DOWNLOAD};
+        command.TEXTURE_DOWNLOAD._0 = api::TextureDownloadCommand{
+            .texture = {handle},
+            .storage = static_cast<api::PixelStorage>(storage),
+            .level = level,
+            .size = {size.x, size.y, size.z},
+            .data = static_cast<uint8_t *>(data)};
+        api::CommandList list{.commands = &command, .commands_count = 1u};
+        auto stream = get_host_stream();
+        device.dispatch(device.device, stream, list, [](uint8_t *) noexcept {}, nullptr);
+        device.synchronize_stream(device.device, stream);
+    }
+
+    void signal_event_from_host(uint64_t handle, uint64_t value) noexcept override {
+        device.signal_event(device.device, api::Event{handle}, get_host_stream(), value);
+    }
+
+    void wait_event_from_host(uint64_t handle, uint64_t value) noexcept override {
+        device.synchronize_event(device.device, api::Event{handle}, value);
+    }
 };
 
 luisa::compute::DeviceInterface *create(luisa::compute::Context &&ctx,
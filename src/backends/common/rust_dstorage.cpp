@@ -0,0 +1,618 @@
+#include <future>
+#include <cstring>
+
+#ifdef LUISA_PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#define LUISA_COMPUTE_RUST_DSTORAGE_IO_URING
+#endif
+
+#include <luisa/core/clock.h>
+#include <luisa/core/logging.h>
+#include <luisa/core/magic_enum.h>
+#include <luisa/backends/ext/dstorage_cmd.h>
+#include "rust_dstorage.h"
+#include "rust_dstorage_compression.h"
+
+namespace luisa::compute::rust {
+
+RustDStorageFile::RustDStorageFile(luisa::string_view path) noexcept {
+    luisa::string path_string{path};
+#ifdef LUISA_PLATFORM_WINDOWS
+    auto handle = CreateFileA(path_string.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        LUISA_WARNING_WITH_LOCATION("Failed to open file '{}' (error = {}).", path, GetLastError());
+        return;
+    }
+    LARGE_INTEGER size{};
+    GetFileSizeEx(handle, &size);
+    _handle = reinterpret_cast<uint64_t>(handle);
+    _size_bytes = static_cast<size_t>(size.QuadPart);
+#else
+    auto fd = ::open(path_string.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LUISA_WARNING_WITH_LOCATION("Failed to open file '{}': {}.", path, std::strerror(errno));
+        return;
+    }
+    struct stat st {};
+    ::fstat(fd, &st);
+    _handle = static_cast<uint64_t>(fd);
+    _size_bytes = static_cast<size_t>(st.st_size);
+#ifdef O_DIRECT
+    // not every file system supports O_DIRECT (e.g., tmpfs), in which case all reads are buffered
+    if (auto direct_fd = ::open(path_string.c_str(), O_RDONLY | O_CLOEXEC | O_DIRECT); direct_fd >= 0) {
+        _direct_handle = static_cast<uint64_t>(direct_fd);
+    }
+#endif
+#endif
+}
+
+RustDStorageFile::~RustDStorageFile() noexcept {
+#ifdef LUISA_PLATFORM_WINDOWS
+    if (valid()) { CloseHandle(reinterpret_cast<HANDLE>(_handle)); }
+#else
+    if (valid()) { ::close(static_cast<int>(_handle)); }
+    if (has_direct_handle()) { ::close(static_cast<int>(_direct_handle)); }
+#endif
+}
+
+void RustDStorageFile::read(size_t offset, size_t size, std::byte *data, bool direct) const noexcept {
+    while (size != 0u) {
+#ifdef LUISA_PLATFORM_WINDOWS
+        OVERLAPPED overlapped{};
+        overlapped.Offset = static_cast<DWORD>(offset);
+        overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32u);
+        DWORD n = 0u;
+        if (!ReadFile(reinterpret_cast<HANDLE>(_handle), data,
+                      static_cast<DWORD>(std::min<size_t>(size, 1024_M)),
+                      &n, &overlapped) ||
+            n == 0u) [[unlikely]] {
+            LUISA_ERROR_WITH_LOCATION(
+                "Failed to read {} bytes at offset {} (error = {}).",
+                size, offset, GetLastError());
+        }
+#else
+        auto n = ::pread(static_cast<int>(native_handle(direct)), data,
+                         size, static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR) { continue; }
+        if (n <= 0) [[unlikely]] {
+            LUISA_ERROR_WITH_LOCATION(
+                "Failed to read {} bytes at offset {}: {}.", size, offset,
+                n == 0 ? "unexpected end of file" : std::strerror(errno));
+        }
+#endif
+        offset += n;
+        data += n;
+        size -= n;
+        // a short read leaves the rest unaligned for O_DIRECT
+        direct = direct && offset % direct_alignment == 0u &&
+                 reinterpret_cast<size_t>(data) % direct_alignment == 0u &&
+                 size % direct_alignment == 0u;
+    }
+}
+
+#ifdef LUISA_COMPUTE_RUST_DSTORAGE_IO_URING
+
+// A minimal io_uring wrapper over the raw system calls, so that we do not depend on liburing
+class RustIORing {
+
+private:
+    int _fd{-1};
+    uint _entries{0u};
+    void *_sq_ring{nullptr};
+    size_t _sq_ring_size{0u};
+    void *_cq_ring{nullptr};
+    size_t _cq_ring_size{0u};
+    io_uring_sqe *_sqes{nullptr};
+    uint *_sq_head{nullptr};
+    uint *_sq_tail{nullptr};
+    uint *_sq_mask{nullptr};
+    uint *_sq_array{nullptr};
+    uint *_cq_head{nullptr};
+    uint *_cq_tail{nullptr};
+    uint *_cq_mask{nullptr};
+    io_uring_cqe *_cqes{nullptr};
+
+private:
+    RustIORing() noexcept = default;
+
+public:
+    ~RustIORing() noexcept {
+        if (_sqes != nullptr) { ::munmap(_sqes, _entries * sizeof(io_uring_sqe)); }
+        if (_cq_ring != nullptr && _cq_ring != _sq_ring) { ::munmap(_cq_ring, _cq_ring_size); }
+        if (_sq_ring != nullptr) { ::munmap(_sq_ring, _sq_ring_size); }
+        if (_fd >= 0) { ::close(_fd); }
+    }
+
+    // nullptr if io_uring is unavailable (old kernels, or disabled by seccomp in containers)
+    [[nodiscard]] static luisa::unique_ptr<RustIORing> create(uint entries) noexcept {
+        io_uring_params params{};
+        auto fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0) { return nullptr; }
+        luisa::unique_ptr<RustIORing> ring{new RustIORing};
+        ring->_fd = fd;
+        // IORING_OP_READ arrived together with IORING_FEAT_RW_CUR_POS in Linux 5.6
+        if (!(params.features & IORING_FEAT_RW_CUR_POS)) { return nullptr; }
+        ring->_entries = params.sq_entries;
+        ring->_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(uint);
+        ring->_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        auto single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0u;
+        if (single_mmap) {
+            ring->_sq_ring_size = std::max(ring->_sq_ring_size, ring->_cq_ring_size);
+            ring->_cq_ring_size = ring->_sq_ring_size;
+        }
+        auto map = [fd](size_t size, off_t offset) noexcept -> void * {
+            auto p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, fd, offset);
+            return p == MAP_FAILED ? nullptr : p;
+        };
+        ring->_sq_ring = map(ring->_sq_ring_size, IORING_OFF_SQ_RING);
+        if (ring->_sq_ring == nullptr) { return nullptr; }
+        ring->_cq_ring = single_mmap ? ring->_sq_ring : map(ring->_cq_ring_size, IORING_OFF_CQ_RING);
+        if (ring->_cq_ring == nullptr) { return nullptr; }
+        ring->_sqes = static_cast<io_uring_sqe *>(map(params.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES));
+        if (ring->_sqes == nullptr) { return nullptr; }
+        auto at = [](void *base, uint offset) noexcept {
+            return reinterpret_cast<uint *>(static_cast<std::byte *>(base) + offset);
+        };
+        ring->_sq_head = at(ring->_sq_ring, params.sq_off.head);
+        ring->_sq_tail = at(ring->_sq_ring, params.sq_off.tail);
+        ring->_sq_mask = at(ring->_sq_ring, params.sq_off.ring_mask);
+        ring->_sq_array = at(ring->_sq_ring, params.sq_off.array);
+        ring->_cq_head = at(ring->_cq_ring, params.cq_off.head);
+        ring->_cq_tail = at(ring->_cq_ring, params.cq_off.tail);
+        ring->_cq_mask = at(ring->_cq_ring, params.cq_off.ring_mask);
+        ring->_cqes = reinterpret_cast<io_uring_cqe *>(at(ring->_cq_ring, params.cq_off.cqes));
+        return ring;
+    }
+
+    void read(luisa::span<const RustDStorageRead> reads) noexcept {
+        // remaining part of each read, advanced on short reads
+        luisa::vector<RustDStorageRead> remaining{reads.begin(), reads.end()};
+        luisa::vector<uint> ready(reads.size());
+        for (auto i = 0u; i < ready.size(); i++) { ready[i] = static_cast<uint>(ready.size() - 1u - i); }
+        auto in_flight = 0u;
+        while (!ready.empty() || in_flight != 0u) {
+            auto tail = *_sq_tail;
+            while (!ready.empty() && in_flight < _entries) {
+                auto index = ready.back();
+                ready.pop_back();
+                auto &&r = remaining[index];
+                auto slot = tail & *_sq_mask;
+                auto &&sqe = _sqes[slot];
+                std::memset(&sqe, 0, sizeof(sqe));
+                sqe.opcode = IORING_OP_READ;
+                sqe.fd = static_cast<int>(r.file->native_handle(r.direct));
+                sqe.addr = reinterpret_cast<uint64_t>(r.data);
+                sqe.len = static_cast<uint>(r.size);
+                sqe.off = r.offset;
+                sqe.user_data = index;
+                _sq_array[slot] = slot;
+                tail++;
+                in_flight++;
+            }
+            __atomic_store_n(_sq_tail, tail, __ATOMIC_RELEASE);
+            for (;;) {
+                auto to_submit = tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+                if (::syscall(__NR_io_uring_enter, _fd, to_submit, 1u,
+                              IORING_ENTER_GETEVENTS, nullptr, 0u) >= 0) { break; }
+                if (errno != EINTR && errno != EAGAIN && errno != EBUSY) [[unlikely]] {
+                    LUISA_ERROR_WITH_LOCATION("io_uring_enter failed: {}.", std::strerror(errno));
+                }
+            }
+            auto head = *_cq_head;
+            auto cq_tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+            for (; head != cq_tail; head++) {
+                auto &&cqe = _cqes[head & *_cq_mask];
+                auto index = static_cast<uint>(cqe.user_data);
+                auto &&r = remaining[index];
+                in_flight--;
+                if (cqe.res < 0) {
+                    // e.g., O_DIRECT rejected by the file system; retry with a blocking buffered read
+                    r.file->read(r.offset, r.size, r.data, false);
+                } else if (cqe.res == 0) [[unlikely]] {
+                    LUISA_ERROR_WITH_LOCATION(
+                        "Failed to read {} bytes at offset {}: "
+                        "unexpected end of file.",
+                        r.size, r.offset);
+                } else if (auto n = static_cast<size_t>(cqe.res); n < r.size) {
+                    r.offset += n;
+                    r.data += n;
+                    r.size -= n;
+                    r.direct = r.direct && n % RustDStorageFile::direct_alignment == 0u;
+                    ready.emplace_back(index);
+                }
+            }
+            __atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+        }
+    }
+};
+
+#else
+
+// placeholder so that luisa::unique_ptr<RustIORing> is complete; never created
+class RustIORing {
+public:
+    void read(luisa::span<const RustDStorageRead>) noexcept {}
+};
+
+#endif
+
+RustDStorageStream::RustDStorageStream(RustDStorageExt *ext) noexcept
+    : _ext{ext} {
+#ifdef LUISA_COMPUTE_RUST_DSTORAGE_IO_URING
+    _ring = RustIORing::create(64u);
+#endif
+    if (_ring == nullptr) {
+        LUISA_VERBOSE_WITH_LOCATION(
+            "io_uring is unavailable. DStorage reads "
+            "fall back to the thread pool.");
+    }
+    _thread = std::thread{[this] {
+        for (;;) {
+            luisa::move_only_function<void()> work;
+            {
+                std::unique_lock lock{_mutex};
+                _cv.wait(lock, [this] { return _stop || !_work.empty(); });
+                if (_work.empty()) { break; }
+                work = std::move(_work.front());
+                _work.pop();
+            }
+            work();
+            {
+                std::scoped_lock lock{_mutex};
+                _pending--;
+            }
+            _cv.notify_all();
+        }
+    }};
+}
+
+RustDStorageStream::~RustDStorageStream() noexcept {
+    synchronize();
+    {
+        std::scoped_lock lock{_mutex};
+        _stop = true;
+    }
+    _cv.notify_all();
+    _thread.join();
+}
+
+void RustDStorageStream::_enqueue(luisa::move_only_function<void()> &&work) noexcept {
+    {
+        std::scoped_lock lock{_mutex};
+        _work.push(std::move(work));
+        _pending++;
+    }
+    _cv.notify_all();
+}
+
+void RustDStorageStream::dispatch(CommandList &&list) noexcept {
+    _enqueue([this, list = std::move(list)]() mutable noexcept {
+        _ext->execute(*this, list);
+        for (auto &&callback : list.callbacks()) { callback(); }
+    });
+}
+
+void RustDStorageStream::signal(uint64_t event, uint64_t value) noexcept {
+    _enqueue([this, event, value] { _ext->host()->signal_event_from_host(event, value); });
+}
+
+void RustDStorageStream::wait(uint64_t event, uint64_t value) noexcept {
+    _enqueue([this, event, value] { _ext->host()->wait_event_from_host(event, value); });
+}
+
+void RustDStorageStream::synchronize() noexcept {
+    std::unique_lock lock{_mutex};
+    _cv.wait(lock, [this] { return _pending == 0u; });
+}
+
+void RustDStorageStream::read(luisa::span<const RustDStorageRead> reads) noexcept {
+    if (reads.empty()) { return; }
+    if (_ring != nullptr) {
+        _ring->read(reads);
+        return;
+    }
+    _ext->parallel(static_cast<uint>(reads.size()), [reads](uint i) noexcept {
+        auto &&r = reads[i];
+        r.file->read(r.offset, r.size, r.data, r.direct);
+    });
+}
+
+RustDStorageExt::RustDStorageExt(DeviceInterface *device, RustDStorageHost *host) noexcept
+    : _device{device}, _host{host} {}
+
+RustDStorageExt::~RustDStorageExt() noexcept = default;
+
+ThreadPool &RustDStorageExt::pool() noexcept {
+    std::call_once(_pool_once, [this] {
+        _pool = luisa::make_unique<ThreadPool>(std::thread::hardware_concurrency());
+    });
+    return *_pool;
+}
+
+void RustDStorageExt::parallel(uint n, const luisa::function<void(uint)> &f) noexcept {
+    if (n == 0u) { return; }
+    if (n == 1u) {
+        f(0u);
+        return;
+    }
+    std::atomic_uint remaining{n};
+    std::promise<void> done;
+    auto future = done.get_future();
+    pool().parallel(n, [&](uint i) noexcept {
+        f(i);
+        if (remaining.fetch_sub(1u) == 1u) { done.set_value(); }
+    });
+    future.wait();
+}
+
+ResourceCreationInfo RustDStorageExt::create_stream_handle(const DStorageStreamOption &option) noexcept {
+    auto stream = luisa::make_unique<RustDStorageStream>(this);
+    ResourceCreationInfo info{};
+    info.handle = reinterpret_cast<uint64_t>(stream.get());
+    info.native_handle = stream.get();
+    std::scoped_lock lock{_mutex};
+    _streams.emplace(info.handle, std::move(stream));
+    return info;
+}
+
+RustDStorageStream *RustDStorageExt::stream(uint64_t handle) const noexcept {
+    std::scoped_lock lock{_mutex};
+    auto iter = _streams.find(handle);
+    return iter == _streams.end() ? nullptr : iter->second.get();
+}
+
+void RustDStorageExt::destroy_stream(uint64_t handle) noexcept {
+    luisa::unique_ptr<RustDStorageStream> stream;
+    {
+        std::scoped_lock lock{_mutex};
+        if (auto iter = _streams.find(handle); iter != _streams.end()) {
+            stream = std::move(iter->second);
+            _streams.erase(iter);
+        }
+    }
+    // joins the stream thread outside the lock
+    stream = nullptr;
+}
+
+DStorageExt::FileCreationInfo RustDStorageExt::open_file_handle(luisa::string_view path) noexcept {
+    auto file = luisa::new_with_allocator<RustDStorageFile>(path);
+    if (!file->valid()) {
+        luisa::delete_with_allocator(file);
+        return FileCreationInfo::make_invalid();
+    }
+    FileCreationInfo info{};
+    info.handle = reinterpret_cast<uint64_t>(file);
+    info.native_handle = file;
+    info.size_bytes = file->size_bytes();
+    return info;
+}
+
+void RustDStorageExt::close_file_handle(uint64_t handle) noexcept {
+    luisa::delete_with_allocator(reinterpret_cast<RustDStorageFile *>(handle));
+}
+
+// host memory is directly accessible to the CPU device, so pinning is a no-op
+DStorageExt::PinnedMemoryInfo RustDStorageExt::pin_host_memory(void *ptr, size_t size_bytes) noexcept {
+    PinnedMemoryInfo info{};
+    info.handle = reinterpret_cast<uint64_t>(ptr);
+    info.native_handle = ptr;
+    info.size_bytes = size_bytes;
+    return info;
+}
+
+void RustDStorageExt::unpin_host_memory(uint64_t handle) noexcept {}
+
+namespace detail {
+
+// chunks are multiples of the O_DIRECT alignment so that aligned reads stay aligned
+static constexpr size_t rust_dstorage_read_chunk_size = 2_M;
+
+static void rust_dstorage_append_reads(luisa::vector<RustDStorageRead> &reads,
+                                       const RustDStorageFile *file,
+                                       size_t offset, size_t size, std::byte *data) noexcept {
+    auto append = [&](size_t begin, size_t end, bool direct) noexcept {
+        for (auto p = begin; p < end; p += rust_dstorage_read_chunk_size) {
+            reads.emplace_back(RustDStorageRead{
+                .file = file,
+                .offset = offset + p,
+                .size = std::min(end - p, rust_dstorage_read_chunk_size),
+                .data = data + p,
+                .direct = direct});
+        }
+    };
+    constexpr auto alignment = RustDStorageFile::direct_alignment;
+    // O_DIRECT is only possible when the file offset and the address are equally misaligned
+    if (!file->has_direct_handle() ||
+        offset % alignment != reinterpret_cast<size_t>(data) % alignment) {
+        append(0u, size, false);
+        return;
+    }
+    auto head = std::min((alignment - offset % alignment) % alignment, size);
+    auto body = (size - head) / alignment * alignment;
+    append(0u, head, false);
+    append(head, head + body, true);
+    append(head + body, size, false);
+}
+
+}// namespace detail
+
+void RustDStorageExt::execute(RustDStorageStream &stream, const CommandList &list) noexcept {
+    struct TextureUpload {
+        uint64_t handle;
+        uint level;
+        uint3 size;
+        const std::byte *data;
+    };
+    struct Decompression {
+        DStorageCompression algorithm;
+        const std::byte *src;
+        size_t src_size;
+        std::byte *dst;
+        size_t dst_size;
+    };
+    luisa::vector<RustDStorageRead> reads;
+    luisa::vector<TextureUpload> uploads;
+    luisa::vector<Decompression> decompressions;
+    luisa::vector<luisa::vector<std::byte>> staging;
+    for (auto &&command : list.commands()) {
+        if (command->tag() != Command::Tag::ECustomCommand ||
+            static_cast<const CustomCommand *>(command.get())->uuid() !=
+                to_underlying(CustomCommandUUID::DSTORAGE_READ)) [[unlikely]] {
+            LUISA_ERROR_WITH_LOCATION("Only DStorage commands are allowed in DStorage streams.");
+        }
+        auto cmd = static_cast<const DStorageReadCommand *>(command.get());
+        auto compression = cmd->compression();
+        if (compression != DStorageCompression::None &&
+            !rust_dstorage_compression_supported(compression)) [[unlikely]] {
+            LUISA_ERROR_WITH_LOCATION(
+                "DStorage compression '{}' is not supported on the CPU backend.",
+                to_string(compression));
+        }
+        // resolve the destination
+        auto [dst, dst_size, texture] = luisa::visit(
+            [this]<typename T>(const T &r) noexcept -> std::tuple<std::byte *, size_t, luisa::optional<TextureUpload>> {
+                if constexpr (std::is_same_v<T, DStorageReadCommand::BufferRequest>) {
+                    return {_host->buffer_address(r.handle) + r.offset_bytes, r.size_bytes, luisa::nullopt};
+                } else if constexpr (std::is_same_v<T, DStorageReadCommand::MemoryRequest>) {
+                    return {static_cast<std::byte *>(r.data), r.size_bytes, luisa::nullopt};
+                } else {
+                    LUISA_ASSERT(r.offset[0] == 0u && r.offset[1] == 0u && r.offset[2] == 0u,
+                                 "Partial texture reads are not supported on the CPU backend.");
+                    auto size = make_uint3(r.size[0], r.size[1], r.size[2]);
+                    auto size_bytes = pixel_storage_size(_host->texture_storage(r.handle), size);
+                    return {nullptr, size_bytes, TextureUpload{r.handle, r.level, size, nullptr}};
+                }
+            },
+            cmd->request());
+        // resolve the source
+        auto [file, src_offset, src_size] = luisa::visit(
+            []<typename T>(const T &s) noexcept {
+                return std::make_tuple(
+                    std::is_same_v<T, DStorageReadCommand::FileSource> ?
+                        reinterpret_cast<const RustDStorageFile *>(s.handle) :
+                        nullptr,
+                    s.offset_bytes, s.size_bytes);
+            },
+            cmd->source());
+        auto src_memory = file == nullptr ?
+                              reinterpret_cast<const std::byte *>(luisa::get<DStorageReadCommand::MemorySource>(cmd->source()).handle) + src_offset :
+                              nullptr;
+        // compressed data is read as a whole and decoded chunk by chunk into the destination
+        if (compression != DStorageCompression::None) {
+            if (file != nullptr) {
+                auto &&s = staging.emplace_back(src_size);
+                detail::rust_dstorage_append_reads(reads, file, src_offset, src_size, s.data());
+                src_memory = s.data();
+            }
+            if (texture) {
+                dst = staging.emplace_back(dst_size).data();
+                texture->data = dst;
+                uploads.emplace_back(*texture);
+            }
+            decompressions.emplace_back(Decompression{
+                compression, src_memory, src_size, dst, dst_size});
+            continue;
+        }
+        if (texture) {
+            LUISA_ASSERT(src_size >= dst_size,
+                         "DStorage source ({} bytes) is smaller "
+                         "than the texture level ({} bytes).",
+                         src_size, dst_size);
+            if (file == nullptr) {
+                texture->data = src_memory;
+            } else {
+                auto &&s = staging.emplace_back(dst_size);
+                detail::rust_dstorage_append_reads(reads, file, src_offset, dst_size, s.data());
+                texture->data = s.data();
+            }
+            uploads.emplace_back(*texture);
+            continue;
+        }
+        if (dst_size != src_size) {
+            LUISA_WARNING_WITH_LOCATION(
+                "DStorageReadCommand size mismatch: "
+                "input size = {}, output size = {}.",
+                src_size, dst_size);
+        }
+        auto size = std::min(dst_size, src_size);
+        if (file == nullptr) {
+            std::memcpy(dst, src_memory, size);
+        } else {
+            detail::rust_dstorage_append_reads(reads, file, src_offset, size, dst);
+        }
+    }
+    stream.read(reads);
+    if (!decompressions.empty()) {
+        // chunks of all commands in the list are decoded together
+        struct Chunk {
+            const RustCompressionFileHeader *header;
+            size_t index;
+            std::byte *dst;
+        };
+        luisa::vector<Chunk> chunks;
+        for (auto &&d : decompressions) {
+            // corrupted data leaves a zero-filled destination instead of aborting
+            auto header = rust_dstorage_compressed_header(d.src, d.src_size, d.algorithm);
+            if (header == nullptr) {
+                std::memset(d.dst, 0, d.dst_size);
+                continue;
+            }
+            if (header->uncompressed_size > d.dst_size) {
+                LUISA_WARNING_WITH_LOCATION(
+                    "Decompressed size ({} bytes) exceeds "
+                    "the destination ({} bytes).",
+                    header->uncompressed_size, d.dst_size);
+                std::memset(d.dst, 0, d.dst_size);
+                continue;
+            }
+            if (header->uncompressed_size != d.dst_size) {
+                LUISA_WARNING_WITH_LOCATION(
+                    "DStorageReadCommand size mismatch: "
+                    "decompressed size = {}, output size = {}.",
+                    header->uncompressed_size, d.dst_size);
+            }
+            for (auto i = 0u; i < header->chunk_count; i++) {
+                chunks.emplace_back(Chunk{header, i, d.dst});
+            }
+        }
+        parallel(static_cast<uint>(chunks.size()), [&chunks](uint i) noexcept {
+            auto &&c = chunks[i];
+            rust_dstorage_decompress_chunk(c.header, c.index, c.dst);
+        });
+    }
+    for (auto &&u : uploads) {
+        _host->upload_texture(u.handle, u.level, u.size, u.data);
+    }
+}
+
+void RustDStorageExt::compress(const void *data, size_t size_bytes,
+                               Compression algorithm, CompressionQuality quality,
+                               luisa::vector<std::byte> &result) noexcept {
+    if (algorithm == DStorageCompression::None) {
+        result.resize(size_bytes);
+        std::memcpy(result.data(), data, size_bytes);
+        return;
+    }
+    if (!rust_dstorage_compression_supported(algorithm)) {
+        LUISA_WARNING_WITH_LOCATION(
+            "DStorage compression '{}' is not supported on the CPU backend.",
+            to_string(algorithm));
+        result.clear();
+        return;
+    }
+    rust_dstorage_compress(*this, data, size_bytes, algorithm, quality, result);
+}
+
+}// namespace luisa::compute::rust
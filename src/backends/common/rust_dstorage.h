@@ -0,0 +1,148 @@
+#pragma once
+
+#include <thread>
+#include <condition_variable>
+
+#include <luisa/core/thread_pool.h>
+#include <luisa/core/stl/queue.h>
+#include <luisa/core/stl/functional.h>
+#include <luisa/core/stl/unordered_map.h>
+#include <luisa/runtime/rhi/pixel.h>
+#include <luisa/runtime/command_list.h>
+#include <luisa/backends/ext/dstorage_ext_interface.h>
+
+namespace luisa::compute::rust {
+
+// Services of the Rust device that the DStorage extension builds on
+class RustDStorageHost {
+
+protected:
+    ~RustDStorageHost() noexcept = default;
+
+public:
+    [[nodiscard]] virtual std::byte *buffer_address(uint64_t handle) const noexcept = 0;
+    [[nodiscard]] virtual PixelStorage texture_storage(uint64_t handle) const noexcept = 0;
+    // returns after the level has been written
+    virtual void upload_texture(uint64_t handle, uint level, uint3 size, const void *data) noexcept = 0;
+    virtual void signal_event_from_host(uint64_t handle, uint64_t value) noexcept = 0;
+    virtual void wait_event_from_host(uint64_t handle, uint64_t value) noexcept = 0;
+};
+
+class RustDStorageFile {
+
+public:
+    // O_DIRECT transfers need the file offset, size and address aligned to this
+    static constexpr size_t direct_alignment = 4_k;
+
+private:
+    uint64_t _handle{~0ull};
+    uint64_t _direct_handle{~0ull};// opened with O_DIRECT, Linux only
+    size_t _size_bytes{0u};
+
+public:
+    explicit RustDStorageFile(luisa::string_view path) noexcept;
+    ~RustDStorageFile() noexcept;
+    RustDStorageFile(RustDStorageFile &&) noexcept = delete;
+    RustDStorageFile(const RustDStorageFile &) noexcept = delete;
+    RustDStorageFile &operator=(RustDStorageFile &&) noexcept = delete;
+    RustDStorageFile &operator=(const RustDStorageFile &) noexcept = delete;
+    [[nodiscard]] auto valid() const noexcept { return _handle != ~0ull; }
+    [[nodiscard]] auto has_direct_handle() const noexcept { return _direct_handle != ~0ull; }
+    [[nodiscard]] auto native_handle(bool direct) const noexcept { return direct ? _direct_handle : _handle; }
+    [[nodiscard]] auto size_bytes() const noexcept { return _size_bytes; }
+    // blocking positional read of the whole range
+    void read(size_t offset, size_t size, std::byte *data, bool direct) const noexcept;
+};
+
+struct RustDStorageRead {
+    const RustDStorageFile *file;
+    size_t offset;
+    size_t size;
+    std::byte *data;
+    bool direct;
+};
+
+class RustIORing;
+class RustDStorageExt;
+
+class RustDStorageStream {
+
+private:
+    RustDStorageExt *_ext;
+    luisa::unique_ptr<RustIORing> _ring;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    luisa::queue<luisa::move_only_function<void()>> _work;
+    size_t _pending{0u};
+    bool _stop{false};
+    std::thread _thread;
+
+private:
+    void _enqueue(luisa::move_only_function<void()> &&work) noexcept;
+
+public:
+    explicit RustDStorageStream(RustDStorageExt *ext) noexcept;
+    ~RustDStorageStream() noexcept;
+    RustDStorageStream(RustDStorageStream &&) noexcept = delete;
+    RustDStorageStream(const RustDStorageStream &) noexcept = delete;
+    RustDStorageStream &operator=(RustDStorageStream &&) noexcept = delete;
+    RustDStorageStream &operator=(const RustDStorageStream &) noexcept = delete;
+    [[nodiscard]] auto uses_io_uring() const noexcept { return _ring != nullptr; }
+    void dispatch(CommandList &&list) noexcept;
+    void signal(uint64_t event, uint64_t value) noexcept;
+    void wait(uint64_t event, uint64_t value) noexcept;
+    void synchronize() noexcept;
+    // runs on the stream thread
+    void read(luisa::span<const RustDStorageRead> reads) noexcept;
+};
+
+/**
+ * @brief DStorageExt for the CPU backend.
+ *
+ * Each DStorage stream owns a worker thread that executes its command lists
+ * in order. File reads are split into chunks and issued through io_uring on
+ * Linux, falling back to positional reads on a thread pool where io_uring
+ * is unavailable. Ranges whose offset and destination are suitably aligned
+ * are read with O_DIRECT straight into buffer or host memory; textures are
+ * staged and written through the device's texture upload. LZ4 data produced
+ * by compress() is split into independent chunks that are decoded in
+ * parallel into the destination; GDeflate is not supported, and corrupted
+ * data leaves the destination zero-filled. Events signalled on a DStorage
+ * stream complete once the preceding reads have landed.
+ */
+class RustDStorageExt final : public DStorageExt {
+
+private:
+    DeviceInterface *_device;
+    RustDStorageHost *_host;
+    luisa::unique_ptr<ThreadPool> _pool;
+    std::once_flag _pool_once;
+    mutable std::mutex _mutex;
+    luisa::unordered_map<uint64_t, luisa::unique_ptr<RustDStorageStream>> _streams;
+
+protected:
+    [[nodiscard]] DeviceInterface *device() const noexcept override { return _device; }
+    [[nodiscard]] ResourceCreationInfo create_stream_handle(const DStorageStreamOption &option) noexcept override;
+    [[nodiscard]] FileCreationInfo open_file_handle(luisa::string_view path) noexcept override;
+    void close_file_handle(uint64_t handle) noexcept override;
+    [[nodiscard]] PinnedMemoryInfo pin_host_memory(void *ptr, size_t size_bytes) noexcept override;
+    void unpin_host_memory(uint64_t handle) noexcept override;
+
+public:
+    RustDStorageExt(DeviceInterface *device, RustDStorageHost *host) noexcept;
+    ~RustDStorageExt() noexcept;
+    [[nodiscard]] auto host() const noexcept { return _host; }
+    [[nodiscard]] ThreadPool &pool() noexcept;
+    // runs f(i) for i in [0, n) on the pool and waits for completion
+    void parallel(uint n, const luisa::function<void(uint)> &f) noexcept;
+    // nullptr if the handle is not a DStorage stream
+    [[nodiscard]] RustDStorageStream *stream(uint64_t handle) const noexcept;
+    void destroy_stream(uint64_t handle) noexcept;
+    // runs on the stream thread
+    void execute(RustDStorageStream &stream, const CommandList &list) noexcept;
+    void compress(const void *data, size_t size_bytes,
+                  Compression algorithm, CompressionQuality quality,
+                  luisa::vector<std::byte> &result) noexcept override;
+};
+
+}// namespace luisa::compute::rust
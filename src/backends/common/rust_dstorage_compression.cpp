@@ -0,0 +1,216 @@
+#include <cstring>
+
+#include <luisa/core/clock.h>
+#include <luisa/core/logging.h>
+#include <luisa/core/magic_enum.h>
+#include <luisa/core/stl/optional.h>
+#include "rust_dstorage.h"
+#include "rust_dstorage_compression.h"
+
+namespace luisa::compute::rust {
+
+namespace detail {
+
+static constexpr size_t rust_compression_chunk_size = 256_k;
+
+[[nodiscard]] static auto lz4_read32(const std::byte *p) noexcept {
+    uint v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// LZ4 block format, see https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+static void lz4_compress(const std::byte *input, size_t size, luisa::vector<std::byte> &output) noexcept {
+    static constexpr auto min_match = 4u;
+    static constexpr auto last_literals = 5u;
+    static constexpr auto match_limit = 12u;// no match may start within the last 12 bytes
+    static constexpr auto hash_bits = 14u;
+    output.clear();
+    output.reserve(size + size / 255u + 16u);
+    auto emit_length = [&output](size_t n) noexcept {
+        for (; n >= 255u; n -= 255u) { output.emplace_back(std::byte{255u}); }
+        output.emplace_back(static_cast<std::byte>(n));
+    };
+    auto emit_sequence = [&](size_t literal_begin, size_t literal_end, size_t offset, size_t match_length) noexcept {
+        auto literal_length = literal_end - literal_begin;
+        auto token = static_cast<uint>(std::min<size_t>(literal_length, 15u) << 4u);
+        if (match_length != 0u) { token |= static_cast<uint>(std::min<size_t>(match_length - min_match, 15u)); }
+        output.emplace_back(static_cast<std::byte>(token));
+        if (literal_length >= 15u) { emit_length(literal_length - 15u); }
+        output.insert(output.end(), input + literal_begin, input + literal_end);
+        if (match_length != 0u) {
+            output.emplace_back(static_cast<std::byte>(offset & 0xffu));
+            output.emplace_back(static_cast<std::byte>(offset >> 8u));
+            if (match_length - min_match >= 15u) { emit_length(match_length - min_match - 15u); }
+        }
+    };
+    luisa::vector<uint> table(1u << hash_bits, 0u);// position + 1, 0 if empty
+    auto anchor = static_cast<size_t>(0u);
+    if (size > match_limit) {
+        for (auto p = static_cast<size_t>(0u); p < size - match_limit;) {
+            auto sequence = lz4_read32(input + p);
+            auto hash = (sequence * 2654435761u) >> (32u - hash_bits);
+            auto candidate = static_cast<size_t>(table[hash]);
+            table[hash] = static_cast<uint>(p + 1u);
+            if (candidate == 0u || p - (candidate - 1u) > 65535u ||
+                lz4_read32(input + candidate - 1u) != sequence) {
+                p++;
+                continue;
+            }
+            auto match = candidate - 1u;
+            auto length = static_cast<size_t>(min_match);
+            while (p + length < size - last_literals && input[match + length] == input[p + length]) { length++; }
+            emit_sequence(anchor, p, p - match, length);
+            p += length;
+            anchor = p;
+        }
+    }
+    emit_sequence(anchor, size, 0u, 0u);
+}
+
+[[nodiscard]] static auto lz4_decompress(const std::byte *input, size_t input_size,
+                                         std::byte *output, size_t output_size) noexcept {
+    auto ip = input;
+    auto input_end = input + input_size;
+    auto op = output;
+    auto output_end = output + output_size;
+    auto read_length = [&ip, input_end](size_t n) noexcept -> luisa::optional<size_t> {
+        for (auto b = 255u; b == 255u; n += b) {
+            if (ip == input_end) { return luisa::nullopt; }
+            b = static_cast<uint>(*ip++);
+        }
+        return n;
+    };
+    while (ip < input_end) {
+        auto token = static_cast<uint>(*ip++);
+        auto literal_length = luisa::optional<size_t>{token >> 4u};
+        if (*literal_length == 15u) { literal_length = read_length(15u); }
+        if (!literal_length ||
+            *literal_length > static_cast<size_t>(input_end - ip) ||
+            *literal_length > static_cast<size_t>(output_end - op)) { return false; }
+        std::memcpy(op, ip, *literal_length);
+        ip += *literal_length;
+        op += *literal_length;
+        if (ip == input_end) { break; }// the last sequence has no match
+        if (input_end - ip < 2) { return false; }
+        auto offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8u);
+        ip += 2;
+        auto match_length = luisa::optional<size_t>{token & 15u};
+        if (*match_length == 15u) { match_length = read_length(15u); }
+        if (!match_length || offset == 0u || offset > static_cast<size_t>(op - output)) { return false; }
+        auto length = *match_length + 4u;
+        if (length > static_cast<size_t>(output_end - op)) { return false; }
+        auto match = op - offset;
+        if (offset >= length) {
+            std::memcpy(op, match, length);
+            op += length;
+        } else {// overlapping copy repeats the last `offset` bytes
+            for (auto i = 0u; i < length; i++) { *op++ = *match++; }
+        }
+    }
+    return op == output_end;
+}
+
+}// namespace detail
+
+bool rust_dstorage_compression_supported(DStorageCompression algorithm) noexcept {
+    // GDeflate assets are only produced and consumed by the GPU backends
+    return algorithm == DStorageCompression::LZ4;
+}
+
+void rust_dstorage_compress(RustDStorageExt &ext, const void *data, size_t size_bytes,
+                            DStorageCompression algorithm, DStorageCompressionQuality /* quality */,
+                            luisa::vector<std::byte> &result) noexcept {
+    LUISA_ASSERT(rust_dstorage_compression_supported(algorithm),
+                 "DStorage compression '{}' is not supported on the CPU backend.",
+                 to_string(algorithm));
+    Clock clk;
+    auto input = static_cast<const std::byte *>(data);
+    auto chunk_size = detail::rust_compression_chunk_size;
+    auto chunk_count = (size_bytes + chunk_size - 1u) / chunk_size;
+    luisa::vector<luisa::vector<std::byte>> chunks(chunk_count);
+    ext.parallel(static_cast<uint>(chunk_count), [&](uint i) noexcept {
+        auto chunk_data = input + i * chunk_size;
+        auto chunk_bytes = std::min(chunk_size, size_bytes - i * chunk_size);
+        auto &&chunk = chunks[i];
+        detail::lz4_compress(chunk_data, chunk_bytes, chunk);
+        // store incompressible chunks as-is
+        if (chunk.size() >= chunk_bytes) { chunk.assign(chunk_data, chunk_data + chunk_bytes); }
+    });
+    auto header_size = sizeof(RustCompressionFileHeader) +
+                       sizeof(RustCompressionChunkMetadata) * chunk_count;
+    auto total_size = header_size;
+    for (auto &&chunk : chunks) { total_size += chunk.size(); }
+    result.resize(total_size);
+    auto header = reinterpret_cast<RustCompressionFileHeader *>(result.data());
+    header->magic = RustCompressionFileHeader::rust_compression_magic;
+    header->algorithm = to_underlying(algorithm);
+    header->uncompressed_size = size_bytes;
+    header->chunk_size = chunk_size;
+    header->chunk_count = chunk_count;
+    auto metadata = header->chunk_metadata();
+    auto offset = header_size;
+    for (auto i = 0u; i < chunk_count; i++) {
+        metadata[i] = {.file_offset = offset,
+                       .compressed_size = chunks[i].size()};
+        std::memcpy(result.data() + offset, chunks[i].data(), chunks[i].size());
+        offset += chunks[i].size();
+    }
+    auto ratio = static_cast<double>(result.size()) / static_cast<double>(std::max<size_t>(size_bytes, 1u));
+    LUISA_VERBOSE("Compressed {} bytes to {} bytes (ratio = {}) with {} in {} ms.",
+                  size_bytes, result.size(), ratio, to_string(algorithm), clk.toc());
+}
+
+const RustCompressionFileHeader *rust_dstorage_compressed_header(
+    const std::byte *data, size_t size_bytes, DStorageCompression algorithm) noexcept {
+    auto header = reinterpret_cast<const RustCompressionFileHeader *>(data);
+    if (size_bytes < sizeof(RustCompressionFileHeader) ||
+        header->magic != RustCompressionFileHeader::rust_compression_magic) {
+        LUISA_WARNING_WITH_LOCATION("Invalid compressed data for the CPU backend.");
+        return nullptr;
+    }
+    if (header->algorithm != to_underlying(algorithm)) {
+        LUISA_WARNING_WITH_LOCATION("Compressed data uses {}, but {} is requested.",
+                                    to_string(static_cast<DStorageCompression>(header->algorithm)),
+                                    to_string(algorithm));
+        return nullptr;
+    }
+    if (header->chunk_size == 0u ||
+        header->chunk_count != (header->uncompressed_size + header->chunk_size - 1u) / header->chunk_size ||
+        header->chunk_count > (size_bytes - sizeof(RustCompressionFileHeader)) /
+                                  sizeof(RustCompressionChunkMetadata)) {
+        LUISA_WARNING_WITH_LOCATION("Corrupted compressed data header.");
+        return nullptr;
+    }
+    auto metadata = header->chunk_metadata();
+    for (auto i = 0u; i < header->chunk_count; i++) {
+        auto &&m = metadata[i];
+        if (m.file_offset > size_bytes ||
+            m.compressed_size > size_bytes - m.file_offset ||
+            m.compressed_size > header->chunk_uncompressed_size(i)) {
+            LUISA_WARNING_WITH_LOCATION("Corrupted metadata of compressed chunk {}.", i);
+            return nullptr;
+        }
+    }
+    return header;
+}
+
+bool rust_dstorage_decompress_chunk(const RustCompressionFileHeader *header,
+                                    size_t chunk, std::byte *output) noexcept {
+    auto &&m = header->chunk_metadata()[chunk];
+    auto input = reinterpret_cast<const std::byte *>(header) + m.file_offset;
+    auto output_size = header->chunk_uncompressed_size(chunk);
+    auto dst = output + chunk * header->chunk_size;
+    if (m.compressed_size == output_size) {// stored
+        std::memcpy(dst, input, output_size);
+        return true;
+    }
+    if (!detail::lz4_decompress(input, m.compressed_size, dst, output_size)) {
+        LUISA_WARNING_WITH_LOCATION("Failed to decompress chunk {}.", chunk);
+        std::memset(dst, 0, output_size);
+        return false;
+    }
+    return true;
+}
+
+}// namespace luisa::compute::rust
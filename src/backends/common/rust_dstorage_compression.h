@@ -0,0 +1,61 @@
+#pragma once
+
+#include <luisa/backends/ext/dstorage_ext_interface.h>
+
+namespace luisa::compute::rust {
+
+class RustDStorageExt;
+
+struct RustCompressionChunkMetadata {
+    size_t file_offset;
+    size_t compressed_size;// equal to the chunk size if the chunk is stored uncompressed
+};
+
+/**
+ * @brief Header of the data produced by RustDStorageExt::compress().
+ *
+ * The input is split into chunks of chunk_size bytes (the last one may be
+ * shorter) that are compressed independently as LZ4 blocks, so that they
+ * can be decoded in parallel straight into the destination. The chunk
+ * table follows the header.
+ */
+struct RustCompressionFileHeader {
+
+    static constexpr auto rust_compression_magic = 0x5a434c4cu;// "LLCZ"
+    using ChunkMetadata = RustCompressionChunkMetadata;
+
+    uint magic;
+    uint algorithm;
+    size_t uncompressed_size;
+    size_t chunk_size;
+    size_t chunk_count;
+
+    [[nodiscard]] auto chunk_metadata() noexcept {
+        return reinterpret_cast<ChunkMetadata *>(reinterpret_cast<std::byte *>(this) + sizeof(*this));
+    }
+    [[nodiscard]] auto chunk_metadata() const noexcept {
+        return reinterpret_cast<const ChunkMetadata *>(reinterpret_cast<const std::byte *>(this) + sizeof(*this));
+    }
+    [[nodiscard]] auto chunk_uncompressed_size(size_t i) const noexcept {
+        return std::min(chunk_size, uncompressed_size - i * chunk_size);
+    }
+};
+
+static_assert(sizeof(RustCompressionFileHeader) == 32u);
+
+[[nodiscard]] bool rust_dstorage_compression_supported(DStorageCompression algorithm) noexcept;
+
+void rust_dstorage_compress(RustDStorageExt &ext, const void *data, size_t size_bytes,
+                            DStorageCompression algorithm, DStorageCompressionQuality quality,
+                            luisa::vector<std::byte> &result) noexcept;
+
+// validates the header and the chunk table against the size of the compressed data,
+// returns nullptr (with a warning) if the data is corrupted
+[[nodiscard]] const RustCompressionFileHeader *rust_dstorage_compressed_header(
+    const std::byte *data, size_t size_bytes, DStorageCompression algorithm) noexcept;
+
+// a chunk that fails to decode is zero-filled and false is returned
+bool rust_dstorage_decompress_chunk(const RustCompressionFileHeader *header,
+                                    size_t chunk, std::byte *output) noexcept;
+
+}// namespace luisa::compute::rust
@@ -0,0 +1,171 @@
+#include <future>
+#include <cstring>
+
+#include <luisa/core/clock.h>
+#include <luisa/core/logging.h>
+#include <luisa/core/magic_enum.h>
+#include <luisa/runtime/image.h>
+#include <luisa/runtime/buffer.h>
+#include <luisa/runtime/stream.h>
+#include "rust_bc_encoder.h"
+#include "rust_tex_compress.h"
+
+namespace luisa::compute::rust {
+
+namespace detail {
+
+static constexpr auto bc_block_size_bytes = 16u;
+
+// storages that Image<float> can read, with missing channels filled with (0, 0, 0, 1)
+[[nodiscard]] static bool tex_compress_source_supported(PixelStorage storage) noexcept {
+    switch (storage) {
+        case PixelStorage::BYTE1:
+        case PixelStorage::BYTE2:
+        case PixelStorage::BYTE4:
+        case PixelStorage::SHORT1:
+        case PixelStorage::SHORT2:
+        case PixelStorage::SHORT4:
+        case PixelStorage::HALF1:
+        case PixelStorage::HALF2:
+        case PixelStorage::HALF4:
+        case PixelStorage::FLOAT1:
+        case PixelStorage::FLOAT2:
+        case PixelStorage::FLOAT4: return true;
+        default: break;
+    }
+    return false;
+}
+
+template<typename T>
+[[nodiscard]] static float tex_compress_channel(const std::byte *p) noexcept {
+    T x;
+    std::memcpy(&x, p, sizeof(T));
+    if constexpr (std::is_same_v<T, uint8_t>) {
+        return static_cast<float>(x) / 255.f;
+    } else if constexpr (std::is_same_v<T, uint16_t>) {
+        return static_cast<float>(x) / 65535.f;
+    } else {
+        return static_cast<float>(x);
+    }
+}
+
+template<typename T>
+static void tex_compress_convert(const std::byte *data, uint channels, size_t count, float4 *pixels) noexcept {
+    for (auto i = 0u; i < count; i++) {
+        auto p = data + i * channels * sizeof(T);
+        auto pixel = make_float4(0.f, 0.f, 0.f, 1.f);
+        for (auto c = 0u; c < channels; c++) { pixel[c] = tex_compress_channel<T>(p + c * sizeof(T)); }
+        pixels[i] = pixel;
+    }
+}
+
+static void tex_compress_convert(PixelStorage storage, const std::byte *data, size_t count, float4 *pixels) noexcept {
+    auto channels = pixel_storage_channel_count(storage);
+    switch (storage) {
+        case PixelStorage::BYTE1:
+        case PixelStorage::BYTE2:
+        case PixelStorage::BYTE4: tex_compress_convert<uint8_t>(data, channels, count, pixels); break;
+        case PixelStorage::SHORT1:
+        case PixelStorage::SHORT2:
+        case PixelStorage::SHORT4: tex_compress_convert<uint16_t>(data, channels, count, pixels); break;
+        case PixelStorage::HALF1:
+        case PixelStorage::HALF2:
+        case PixelStorage::HALF4: tex_compress_convert<half>(data, channels, count, pixels); break;
+        case PixelStorage::FLOAT1:
+        case PixelStorage::FLOAT2:
+        case PixelStorage::FLOAT4: tex_compress_convert<float>(data, channels, count, pixels); break;
+        default: LUISA_ERROR_WITH_LOCATION("Unsupported storage for texture compression.");
+    }
+}
+
+}// namespace detail
+
+RustTexCompressExt::RustTexCompressExt(RustTexCompressHost *host) noexcept
+    : _host{host} {}
+
+RustTexCompressExt::~RustTexCompressExt() noexcept = default;
+
+ThreadPool &RustTexCompressExt::_thread_pool() noexcept {
+    std::call_once(_pool_once, [this] {
+        _pool = luisa::make_unique<ThreadPool>(std::thread::hardware_concurrency());
+    });
+    return *_pool;
+}
+
+TexCompressExt::Result RustTexCompressExt::set_quality(Quality quality) noexcept {
+    _quality.store(quality, std::memory_order_relaxed);
+    return Result::Success;
+}
+
+TexCompressExt::Result RustTexCompressExt::_compress(Stream &stream, const Image<float> &src,
+                                                     const BufferView<uint> &result, bool bc6h,
+                                                     float alpha_importance) noexcept {
+    auto storage = src.storage();
+    if (!detail::tex_compress_source_supported(storage)) {
+        LUISA_WARNING_WITH_LOCATION("Cannot compress images of storage {} on the CPU backend.",
+                                    to_string(storage));
+        return Result::Failed;
+    }
+    auto size = src.size();
+    if (any(size == 0u)) { return Result::Success; }
+    auto grid = (size + 3u) / 4u;
+    auto size_bytes = static_cast<size_t>(grid.x) * grid.y * detail::bc_block_size_bytes;
+    if (result.size_bytes() < size_bytes) {
+        LUISA_WARNING_WITH_LOCATION("Result buffer of {} bytes is too small for {} compressed bytes.",
+                                    result.size_bytes(), size_bytes);
+        return Result::Failed;
+    }
+    CommandList list;
+    list.add_callback([this, image = src.handle(), storage, size, grid,
+                       buffer = result.handle(), offset = result.offset_bytes(),
+                       bc6h, alpha_importance, quality = _quality.load(std::memory_order_relaxed)] {
+        Clock clk;
+        luisa::vector<std::byte> data(pixel_storage_size(storage, make_uint3(size, 1u)));
+        _host->download_texture(image, storage, 0u, make_uint3(size, 1u), data.data());
+        luisa::vector<float4> pixels(static_cast<size_t>(size.x) * size.y);
+        detail::tex_compress_convert(storage, data.data(), pixels.size(), pixels.data());
+        auto output = _host->buffer_address(buffer) + offset;
+        // each task encodes a row of blocks, texels past the edges repeat the last row or column
+        auto encode_row = [&](uint y) noexcept {
+            for (auto x = 0u; x < grid.x; x++) {
+                float4 texels[16];
+                for (auto i = 0u; i < 16u; i++) {
+                    auto px = std::min(x * 4u + i % 4u, size.x - 1u);
+                    auto py = std::min(y * 4u + i / 4u, size.y - 1u);
+                    texels[i] = pixels[static_cast<size_t>(py) * size.x + px];
+                }
+                auto block = output + (static_cast<size_t>(y) * grid.x + x) * detail::bc_block_size_bytes;
+                if (bc6h) {
+                    rust_bc6h_encode_block(texels, quality, block);
+                } else {
+                    rust_bc7_encode_block(texels, quality, alpha_importance, block);
+                }
+            }
+        };
+        std::atomic_uint remaining{grid.y};
+        std::promise<void> done;
+        auto future = done.get_future();
+        _thread_pool().parallel(grid.y, [&](uint y) noexcept {
+            encode_row(y);
+            if (remaining.fetch_sub(1u) == 1u) { done.set_value(); }
+        });
+        future.wait();
+        LUISA_VERBOSE("Compressed {}x{} image to {} in {} ms.",
+                      size.x, size.y, bc6h ? "BC6H" : "BC7", clk.toc());
+    });
+    stream << list.commit();
+    return Result::Success;
+}
+
+TexCompressExt::Result RustTexCompressExt::compress_bc6h(Stream &stream, const Image<float> &src,
+                                                         const BufferView<uint> &result) noexcept {
+    return _compress(stream, src, result, true, 0.f);
+}
+
+TexCompressExt::Result RustTexCompressExt::compress_bc7(Stream &stream, const Image<float> &src,
+                                                        const BufferView<uint> &result,
+                                                        float alpha_importance) noexcept {
+    return _compress(stream, src, result, false, alpha_importance);
+}
+
+}// namespace luisa::compute::rust
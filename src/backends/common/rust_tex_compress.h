@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+
+#include <luisa/core/thread_pool.h>
+#include <luisa/core/stl/functional.h>
+#include <luisa/runtime/rhi/pixel.h>
+#include <luisa/backends/ext/tex_compress_ext.h>
+
+namespace luisa::compute::rust {
+
+// Services of the Rust device that the texture compression extension builds on
+class RustTexCompressHost {
+
+protected:
+    ~RustTexCompressHost() noexcept = default;
+
+public:
+    [[nodiscard]] virtual std::byte *buffer_address(uint64_t handle) const noexcept = 0;
+    // returns after the level has been read
+    virtual void download_texture(uint64_t handle, PixelStorage storage,
+                                  uint level, uint3 size, void *data) noexcept = 0;
+};
+
+/**
+ * @brief TexCompressExt for the CPU backend.
+ *
+ * Compression is recorded as a callback on the given stream, so it sees the
+ * commands issued before it and finishes before the ones issued after it.
+ * The source image is read back, and rows of 4x4 blocks are encoded in
+ * parallel on a thread pool straight into the result buffer. The quality
+ * preset trades encoding time for the number of modes and partitions tried.
+ */
+class RustTexCompressExt final : public TexCompressExt {
+
+private:
+    RustTexCompressHost *_host;
+    luisa::unique_ptr<ThreadPool> _pool;
+    std::once_flag _pool_once;
+    // set from any thread, sampled once when a compression is recorded
+    std::atomic<Quality> _quality{Quality::Default};
+
+private:
+    [[nodiscard]] ThreadPool &_thread_pool() noexcept;
+    [[nodiscard]] Result _compress(Stream &stream, const Image<float> &src,
+                                   const BufferView<uint> &result, bool bc6h,
+                                   float alpha_importance) noexcept;
+
+public:
+    explicit RustTexCompressExt(RustTexCompressHost *host) noexcept;
+    ~RustTexCompressExt() noexcept;
+    Result compress_bc6h(Stream &stream, const Image<float> &src,
+                         const BufferView<uint> &result) noexcept override;
+    Result compress_bc7(Stream &stream, const Image<float> &src,
+                        const BufferView<uint> &result, float alpha_importance) noexcept override;
+    // the encoders are built in, there are no shaders to check
+    Result check_builtin_shader() noexcept override { return Result::Success; }
+    Result set_quality(Quality quality) noexcept override;
+};
+
+}// namespace luisa::compute::rust
@@ -2101,6 +2101,207 @@ __device__ inline void lc_synchronize_block() noexcept {
 
 #endif
 
+// warp-level operations over the currently active lanes
+[[nodiscard]] __device__ inline auto lc_warp_size() noexcept {
+    return static_cast<lc_uint>(warpSize);
+}
+
+[[nodiscard]] __device__ inline auto lc_warp_lane_id() noexcept {
+    lc_uint id;
+    asm("mov.u32 %0, %%laneid;" : "=r"(id));
+    return id;
+}
+
+[[nodiscard]] __device__ inline auto lc_warp_first_active_lane() noexcept {
+    return static_cast<lc_uint>(__ffs(__activemask()) - 1);
+}
+
+[[nodiscard]] __device__ inline auto lc_warp_is_first_active_lane() noexcept {
+    return lc_warp_first_active_lane() == lc_warp_lane_id();
+}
+
+// shuffles a value component by component with f: word -> word
+#define LC_WARP_SHUFFLE_SCALAR(T, W)                                                                 \
+    template<typename F>                                                                             \
+    [[nodiscard]] __device__ inline auto lc_warp_shuffle(T x, F &&f) noexcept {                      \
+        return static_cast<T>(f(static_cast<W>(x)));                                                 \
+    }
+#define LC_WARP_SHUFFLE_VECTOR(T)                                                                    \
+    template<typename F>                                                                             \
+    [[nodiscard]] __device__ inline auto lc_warp_shuffle(lc_##T##2 v, F &&f) noexcept {              \
+        return lc_make_##T##2(lc_warp_shuffle(v.x, f), lc_warp_shuffle(v.y, f));                     \
+    }                                                                                                \
+    template<typename F>                                                                             \
+    [[nodiscard]] __device__ inline auto lc_warp_shuffle(lc_##T##3 v, F &&f) noexcept {              \
+        return lc_make_##T##3(lc_warp_shuffle(v.x, f), lc_warp_shuffle(v.y, f),                      \
+                              lc_warp_shuffle(v.z, f));                                              \
+    }                                                                                                \
+    template<typename F>                                                                             \
+    [[nodiscard]] __device__ inline auto lc_warp_shuffle(lc_##T##4 v, F &&f) noexcept {              \
+        return lc_make_##T##4(lc_warp_shuffle(v.x, f), lc_warp_shuffle(v.y, f),                      \
+                              lc_warp_shuffle(v.z, f), lc_warp_shuffle(v.w, f));                     \
+    }
+LC_WARP_SHUFFLE_SCALAR(lc_bool, lc_int)
+LC_WARP_SHUFFLE_SCALAR(lc_short, lc_int)
+LC_WARP_SHUFFLE_SCALAR(lc_ushort, lc_uint)
+LC_WARP_SHUFFLE_SCALAR(lc_int, lc_int)
+LC_WARP_SHUFFLE_SCALAR(lc_uint, lc_uint)
+LC_WARP_SHUFFLE_SCALAR(lc_long, lc_long)
+LC_WARP_SHUFFLE_SCALAR(lc_ulong, lc_ulong)
+LC_WARP_SHUFFLE_SCALAR(lc_float, lc_float)
+LC_WARP_SHUFFLE_VECTOR(bool)
+LC_WARP_SHUFFLE_VECTOR(short)
+LC_WARP_SHUFFLE_VECTOR(ushort)
+LC_WARP_SHUFFLE_VECTOR(int)
+LC_WARP_SHUFFLE_VECTOR(uint)
+LC_WARP_SHUFFLE_VECTOR(long)
+LC_WARP_SHUFFLE_VECTOR(ulong)
+LC_WARP_SHUFFLE_VECTOR(float)
+#undef LC_WARP_SHUFFLE_SCALAR
+#undef LC_WARP_SHUFFLE_VECTOR
+
+template<typename F>
+[[nodiscard]] __device__ inline auto lc_warp_shuffle(lc_float2x2 m, F &&f) noexcept {
+    return lc_float2x2{lc_warp_shuffle(m[0], f), lc_warp_shuffle(m[1], f)};
+}
+
+template<typename F>
+[[nodiscard]] __device__ inline auto lc_warp_shuffle(lc_float3x3 m, F &&f) noexcept {
+    return lc_float3x3{lc_warp_shuffle(m[0], f), lc_warp_shuffle(m[1], f), lc_warp_shuffle(m[2], f)};
+}
+
+template<typename F>
+[[nodiscard]] __device__ inline auto lc_warp_shuffle(lc_float4x4 m, F &&f) noexcept {
+    return lc_float4x4{lc_warp_shuffle(m[0], f), lc_warp_shuffle(m[1], f),
+                       lc_warp_shuffle(m[2], f), lc_warp_shuffle(m[3], f)};
+}
+
+template<typename T>
+[[nodiscard]] __device__ inline auto lc_warp_read_lane(T x, lc_uint lane) noexcept {
+    auto mask = __activemask();
+    return lc_warp_shuffle(x, [mask, lane](auto w) noexcept { return __shfl_sync(mask, w, lane); });
+}
+
+template<typename T>
+[[nodiscard]] __device__ inline auto lc_warp_read_first_active_lane(T x) noexcept {
+    return lc_warp_read_lane(x, lc_warp_first_active_lane());
+}
+
+template<typename T, typename Op>
+[[nodiscard]] __device__ inline auto lc_warp_active_reduce(T x, Op op) noexcept {
+    auto mask = __activemask();
+    if (mask == 0xffffffffu) {// converged warp: butterfly, all lanes end with the same result
+#pragma unroll
+        for (auto offset = 16u; offset != 0u; offset >>= 1u) {
+            x = op(x, lc_warp_shuffle(x, [offset](auto w) noexcept { return __shfl_xor_sync(0xffffffffu, w, offset); }));
+        }
+        return x;
+    }
+    // diverged warp: fold the active lanes in order
+    auto first = __ffs(mask) - 1;
+    auto r = lc_warp_shuffle(x, [mask, first](auto w) noexcept { return __shfl_sync(mask, w, first); });
+    for (auto m = mask & (mask - 1u); m != 0u; m &= m - 1u) {
+        auto l = __ffs(m) - 1;
+        r = op(r, lc_warp_shuffle(x, [mask, l](auto w) noexcept { return __shfl_sync(mask, w, l); }));
+    }
+    return r;
+}
+
+template<typename T, typename Op>
+[[nodiscard]] __device__ inline auto lc_warp_prefix_scan(T x, T identity, Op op) noexcept {
+    auto mask = __activemask();
+    auto lane = lc_warp_lane_id();
+    if (mask == 0xffffffffu) {// converged warp: inclusive Kogge-Stone scan, then shift by one lane
+#pragma unroll
+        for (auto offset = 1u; offset != 32u; offset <<= 1u) {
+            auto y = lc_warp_shuffle(x, [offset](auto w) noexcept { return __shfl_up_sync(0xffffffffu, w, offset); });
+            if (lane >= offset) { x = op(y, x); }
+        }
+        auto e = lc_warp_shuffle(x, [](auto w) noexcept { return __shfl_up_sync(0xffffffffu, w, 1u); });
+        return lane == 0u ? identity : e;
+    }
+    // diverged warp: fold the preceding active lanes in order
+    auto r = identity;
+    for (auto m = mask; m != 0u; m &= m - 1u) {
+        auto l = static_cast<lc_uint>(__ffs(m) - 1);
+        auto y = lc_warp_shuffle(x, [mask, l](auto w) noexcept { return __shfl_sync(mask, w, l); });
+        if (l < lane) { r = op(r, y); }
+    }
+    return r;
+}
+
+template<typename T>
+[[nodiscard]] __device__ inline auto lc_warp_active_all_equal(T x) noexcept {
+    return lc_warp_active_reduce(x == lc_warp_read_first_active_lane(x),
+                                 [](auto a, auto b) noexcept { return a && b; });
+}
+
+template<typename T>
+[[nodiscard]] __device__ inline auto lc_warp_active_bit_and(T x) noexcept {
+    return lc_warp_active_reduce(x, [](auto a, auto b) noexcept { return a & b; });
+}
+
+template<typename T>
+[[nodiscard]] __device__ inline auto lc_warp_active_bit_or(T x) noexcept {
+    return lc_warp_active_reduce(x, [](auto a, auto b) noexcept { return a | b; });
+}
+
+template<typename T>
+[[nodiscard]] __device__ inline auto lc_warp_active_bit_xor(T x) noexcept {
+    return lc_warp_active_reduce(x, [](auto a, auto b) noexcept { return a ^ b; });
+}
+
+template<typename T>
+[[nodiscard]] __device__ inline auto lc_warp_active_max(T x) noexcept {
+    return lc_warp_active_reduce(x, [](auto a, auto b) noexcept { return lc_max(a, b); });
+}
+
+template<typename T>
+[[nodiscard]] __device__ inline auto lc_warp_active_min(T x) noexcept {
+    return lc_warp_active_reduce(x, [](auto a, auto b) noexcept { return lc_min(a, b); });
+}
+
+template<typename T>
+[[nodiscard]] __device__ inline auto lc_warp_active_product(T x) noexcept {
+    return lc_warp_active_reduce(x, [](auto a, auto b) noexcept { return a * b; });
+}
+
+template<typename T>
+[[nodiscard]] __device__ inline auto lc_warp_active_sum(T x) noexcept {
+    return lc_warp_active_reduce(x, [](auto a, auto b) noexcept { return a + b; });
+}
+
+template<typename T>
+[[nodiscard]] __device__ inline auto lc_warp_prefix_sum(T x) noexcept {
+    return lc_warp_prefix_scan(x, lc_zero<T>(), [](auto a, auto b) noexcept { return a + b; });
+}
+
+template<typename T>
+[[nodiscard]] __device__ inline auto lc_warp_prefix_product(T x) noexcept {
+    return lc_warp_prefix_scan(x, lc_one<T>(), [](auto a, auto b) noexcept { return a * b; });
+}
+
+[[nodiscard]] __device__ inline auto lc_warp_active_all(lc_bool p) noexcept {
+    return static_cast<lc_bool>(__all_sync(__activemask(), p));
+}
+
+[[nodiscard]] __device__ inline auto lc_warp_active_any(lc_bool p) noexcept {
+    return static_cast<lc_bool>(__any_sync(__activemask(), p));
+}
+
+[[nodiscard]] __device__ inline auto lc_warp_active_bit_mask(lc_bool p) noexcept {
+    return lc_make_uint4(__ballot_sync(__activemask(), p), 0u, 0u, 0u);
+}
+
+[[nodiscard]] __device__ inline auto lc_warp_active_count_bits(lc_bool p) noexcept {
+    return static_cast<lc_uint>(__popc(__ballot_sync(__activemask(), p)));
+}
+
+[[nodiscard]] __device__ inline auto lc_warp_prefix_count_bits(lc_bool p) noexcept {
+    auto lanes_before = (1u << lc_warp_lane_id()) - 1u;
+    return static_cast<lc_uint>(__popc(__ballot_sync(__activemask(), p) & lanes_before));
+}
+
 // autodiff
 #define LC_GRAD_SHADOW_VARIABLE(x) auto x##_grad = lc_zero<decltype(x)>()
 #define LC_MARK_GRAD(x, dx) x##_grad = dx
@@ -2,4 +2,4 @@
 
 extern "C" const char luisa_cuda_builtin_cuda_builtin_kernels[5490];
 extern "C" const char luisa_cuda_builtin_cuda_device_math[420368];
-extern "C" const char luisa_cuda_builtin_cuda_device_resource[81648];
+extern "C" const char luisa_cuda_builtin_cuda_device_resource[90948];
@@ -11,6 +11,7 @@
 #include <nvtx3/nvToolsExtCuda.h>
 
 #include <luisa/core/clock.h>
+#include <luisa/core/compile_report.h>
 #include <luisa/core/binary_io.h>
 #include <luisa/runtime/rhi/sampler.h>
 #include <luisa/runtime/bindless_array.h>
@@ -448,6 +449,7 @@ ShaderCreationInfo CUDADevice::_create_shader(luisa::string name,
     auto metadata_name = luisa::format("{}.metadata", name);
 
     // try disk cache
+    Clock cache_clock;
     auto ptx = [&] {
         luisa::unique_ptr<BinaryStream> ptx_stream;
         luisa::unique_ptr<BinaryStream> metadata_stream;
@@ -462,9 +464,12 @@ ShaderCreationInfo CUDADevice::_create_shader(luisa::string name,
             metadata_stream.get(), ptx_stream.get(),
             name, false, expected_metadata);
     }();
+    CompileProfiler::phase("cache_lookup", cache_clock.toc());
+    CompileProfiler::cache("disk", !ptx.empty());
 
     // compile if not found in cache
     if (ptx.empty()) {
+        CompileProfiler::Phase compile_phase{"compile"};
         luisa::filesystem::path src_dump_path;
         if (option.enable_debug_info || LUISA_CUDA_DUMP_SOURCE) {
             luisa::span src_data{reinterpret_cast<const std::byte *>(source.data()), source.size()};
@@ -491,11 +496,14 @@ ShaderCreationInfo CUDADevice::_create_shader(luisa::string name,
         }
     }
 
+    CompileProfiler::counter("binary.bytes", ptx.size());
+
     if (option.compile_only) {// no shader object should be created
         return ShaderCreationInfo::make_invalid();
     }
 
     // create the shader object
+    CompileProfiler::Phase load_phase{"load"};
     auto p = with_handle([&]() noexcept -> CUDAShader * {
         if (expected_metadata.kind == CUDAShaderMetadata::Kind::RAY_TRACING) {
             return new_with_allocator<CUDAShaderOptiX>(
@@ -525,7 +533,10 @@ ShaderCreationInfo CUDADevice::create_shader(const ShaderOption &option, Functio
     StringScratch scratch;
     CUDACodegenAST codegen{scratch, !_cudadevrt_library.empty()};
     codegen.emit(kernel, _compiler->device_library(), option.native_include);
-    LUISA_INFO("Generated CUDA source in {} ms.", clk.toc());
+    auto codegen_ms = clk.toc();
+    LUISA_INFO("Generated CUDA source in {} ms.", codegen_ms);
+    CompileProfiler::phase("codegen", codegen_ms);
+    CompileProfiler::counter("source.bytes", scratch.string().size());
 
     // process bound arguments
     luisa::vector<ShaderDispatchCommand::Argument> bound_arguments;
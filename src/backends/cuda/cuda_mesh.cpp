@@ -16,19 +16,31 @@ namespace luisa::compute::cuda {
 CUDAMesh::CUDAMesh(const AccelOption &option) noexcept
     : CUDAPrimitive{Tag::MESH, option} {}
 
+[[nodiscard]] inline auto optix_vertex_format(MeshVertexFormat format) noexcept {
+    switch (format) {
+        case MeshVertexFormat::FLOAT3: return optix::VERTEX_FORMAT_FLOAT3;
+        case MeshVertexFormat::HALF3: return optix::VERTEX_FORMAT_HALF3;
+        case MeshVertexFormat::SNORM16_3: return optix::VERTEX_FORMAT_SNORM16_3;
+    }
+    LUISA_ERROR_WITH_LOCATION("Invalid mesh vertex format.");
+}
+
 inline optix::BuildInput CUDAMesh::_make_build_input() const noexcept {
     optix::BuildInput build_input{};
     static const auto geometry_flag = static_cast<uint32_t>(optix::GEOMETRY_FLAG_DISABLE_ANYHIT);
+    auto triangle_stride = _index_format == MeshIndexFormat::UINT16 ? sizeof(Triangle16) : sizeof(Triangle);
     build_input.type = optix::BUILD_INPUT_TYPE_TRIANGLES;
     build_input.triangleArray.flags = &geometry_flag;
-    build_input.triangleArray.vertexFormat = optix::VERTEX_FORMAT_FLOAT3;
+    build_input.triangleArray.vertexFormat = optix_vertex_format(_vertex_format);
     build_input.triangleArray.vertexBuffers = &_vertex_buffer;
     build_input.triangleArray.vertexStrideInBytes = _vertex_stride;
     build_input.triangleArray.numVertices = _vertex_buffer_size / _vertex_stride;
     build_input.triangleArray.indexBuffer = _triangle_buffer;
-    build_input.triangleArray.indexFormat = optix::INDICES_FORMAT_UNSIGNED_INT3;
-    build_input.triangleArray.indexStrideInBytes = sizeof(Triangle);
-    build_input.triangleArray.numIndexTriplets = _triangle_buffer_size / sizeof(Triangle);
+    build_input.triangleArray.indexFormat = _index_format == MeshIndexFormat::UINT16 ?
+                                                optix::INDICES_FORMAT_UNSIGNED_SHORT3 :
+                                                optix::INDICES_FORMAT_UNSIGNED_INT3;
+    build_input.triangleArray.indexStrideInBytes = triangle_stride;
+    build_input.triangleArray.numIndexTriplets = _triangle_buffer_size / triangle_stride;
     build_input.triangleArray.numSbtRecords = 1u;
     return build_input;
 }
@@ -55,8 +67,10 @@ void CUDAMesh::build(CUDACommandEncoder &encoder, MeshBuildCommand *command) noe
         vertex_buffer->handle() + command->vertex_buffer_offset() != _vertex_buffer ||
         command->vertex_buffer_size() != _vertex_buffer_size ||
         command->vertex_stride() != _vertex_stride ||
+        command->vertex_format() != _vertex_format ||
         triangle_buffer->handle() + command->triangle_buffer_offset() != _triangle_buffer ||
-        command->triangle_buffer_size() != _triangle_buffer_size;
+        command->triangle_buffer_size() != _triangle_buffer_size ||
+        command->index_format() != _index_format;
 
     // update buffers
     _vertex_buffer = vertex_buffer->handle() + command->vertex_buffer_offset();
@@ -64,6 +78,8 @@ void CUDAMesh::build(CUDACommandEncoder &encoder, MeshBuildCommand *command) noe
     _vertex_stride = command->vertex_stride();
     _triangle_buffer = triangle_buffer->handle() + command->triangle_buffer_offset();
     _triangle_buffer_size = command->triangle_buffer_size();
+    _vertex_format = command->vertex_format();
+    _index_format = command->index_format();
 
     // build or update
     if (requires_build) {
@@ -28,6 +28,8 @@ private:
     size_t _vertex_stride{};
     CUdeviceptr _triangle_buffer{};
     size_t _triangle_buffer_size{};
+    MeshVertexFormat _vertex_format{};
+    MeshIndexFormat _index_format{};
 
 private:
     [[nodiscard]] optix::BuildInput _make_build_input() const noexcept override;
@@ -282,7 +282,9 @@ public:
             .vSize = cmd->vertex_buffer_size(),
             .iHandle = reinterpret_cast<Buffer const *>(cmd->triangle_buffer()),
             .iOffset = cmd->triangle_buffer_offset(),
-            .iSize = cmd->triangle_buffer_size()};
+            .iSize = cmd->triangle_buffer_size(),
+            .vFormat = cmd->vertex_format(),
+            .iFormat = cmd->index_format()};
         AddBuildAccel(
             accel->PreProcessStates(
                 *bd,
@@ -19,6 +19,7 @@
 #include <luisa/ast/function_builder.h>
 #include <Resource/DepthBuffer.h>
 #include <luisa/core/clock.h>
+#include <luisa/core/compile_report.h>
 #include <luisa/core/stl/filesystem.h>
 #include <Resource/ExternalBuffer.h>
 #include <luisa/runtime/dispatch_buffer.h>
@@ -240,9 +241,11 @@ ShaderCreationInfo LCDevice::create_shader(const ShaderOption &option, Function
     if (option.enable_debug_info) {
         mask |= 2;
     }
-    // Clock clk;
+    Clock clk;
     auto code = hlsl::CodegenUtility{}.Codegen(kernel, nativeDevice.fileIo, option.native_include, mask, false);
     // LUISA_INFO("HLSL Codegen: {} ms", clk.toc());
+    CompileProfiler::phase("codegen", clk.toc());
+    CompileProfiler::counter("source.bytes", code.result.size());
     if (option.compile_only) {
         assert(!option.name.empty());
         ComputeShader::SaveCompute(
@@ -27,18 +27,27 @@ void AABBPreprocess(
         aabbHandle,
         tracker.ReadState(ResourceReadUsage::AccelBuildSrc));
 }
+GFXFormat GetVertexFormat(MeshVertexFormat format) {
+    // 16-bit formats are four components wide, the fourth one is ignored
+    switch (format) {
+        case MeshVertexFormat::FLOAT3: return GFXFormat_R32G32B32_Float;
+        case MeshVertexFormat::HALF3: return GFXFormat_R16G16B16A16_Float;
+        case MeshVertexFormat::SNORM16_3: return GFXFormat_R16G16B16A16_SNorm;
+    }
+    LUISA_ERROR("Invalid mesh vertex format.");
+}
 void GetStaticTriangleGeometryDesc(
     D3D12_RAYTRACING_GEOMETRY_DESC &geometryDesc,
-    Buffer const *vHandle, size_t vOffset, size_t vStride, size_t vSize,
-    Buffer const *iHandle, size_t iOffset, size_t iSize) {
+    Buffer const *vHandle, size_t vOffset, size_t vStride, size_t vSize, MeshVertexFormat vFormat,
+    Buffer const *iHandle, size_t iOffset, size_t iSize, MeshIndexFormat iFormat) {
     geometryDesc.Type = D3D12_RAYTRACING_GEOMETRY_TYPE_TRIANGLES;
     geometryDesc.Flags = D3D12_RAYTRACING_GEOMETRY_FLAG_OPAQUE;
-    geometryDesc.Triangles.IndexFormat = (DXGI_FORMAT)GFXFormat_R32_UInt;
+    geometryDesc.Triangles.IndexFormat = (DXGI_FORMAT)(iFormat == MeshIndexFormat::UINT16 ? GFXFormat_R16_UInt : GFXFormat_R32_UInt);
     geometryDesc.Triangles.Transform3x4 = 0;
-    geometryDesc.Triangles.VertexFormat = (DXGI_FORMAT)GFXFormat_R32G32B32_Float;
+    geometryDesc.Triangles.VertexFormat = (DXGI_FORMAT)GetVertexFormat(vFormat);
     geometryDesc.Triangles.VertexBuffer.StrideInBytes = vStride;
     geometryDesc.Triangles.IndexBuffer = iHandle->GetAddress() + iOffset;
-    geometryDesc.Triangles.IndexCount = iSize / sizeof(uint);
+    geometryDesc.Triangles.IndexCount = iSize / (iFormat == MeshIndexFormat::UINT16 ? sizeof(uint16_t) : sizeof(uint));
     geometryDesc.Triangles.VertexBuffer.StartAddress = vHandle->GetAddress() + vOffset;
     geometryDesc.Triangles.VertexCount = vSize / vStride;
 }
@@ -112,7 +121,8 @@ size_t BottomAccel::PreProcessStates(
         detail::MeshPreprocess(meshOption.vHandle, meshOption.iHandle, tracker);
         detail::GetStaticTriangleGeometryDesc(
             geometryDesc,
-            meshOption.vHandle, meshOption.vOffset, meshOption.vStride, meshOption.vSize, meshOption.iHandle, meshOption.iOffset, meshOption.iSize);
+            meshOption.vHandle, meshOption.vOffset, meshOption.vStride, meshOption.vSize, meshOption.vFormat,
+            meshOption.iHandle, meshOption.iOffset, meshOption.iSize, meshOption.iFormat);
     } else {
         auto &aabbOption = options.get<1>();
         detail::AABBPreprocess(aabbOption.aabbBuffer, tracker);
@@ -52,6 +52,8 @@ public:
         Buffer const *iHandle;
         size_t iOffset;
         size_t iSize;
+        luisa::compute::MeshVertexFormat vFormat;
+        luisa::compute::MeshIndexFormat iFormat;
     };
     struct AABBOptions {
         Buffer const *aabbBuffer;
@@ -2,7 +2,9 @@
 #include <Shader/ShaderSerializer.h>
 #include "../../common/hlsl/hlsl_codegen.h"
 #include "../../common/hlsl/shader_compiler.h"
+#include <luisa/core/clock.h>
 #include <luisa/core/logging.h>
+#include <luisa/core/compile_report.h>
 #include <luisa/vstl/md5.h>
 namespace lc::dx {
 namespace ComputeShaderDetail {
@@ -68,12 +70,15 @@ ComputeShader *ComputeShader::CompileCompute(
             fwrite(str.result.data(), str.result.size(), 1, f);
             fclose(f);
         }
+        Clock compileClock;
         auto compResult = Device::Compiler()->compile_compute(
             str.result.view(),
             true,
             shaderModel,
             enableUnsafeMath,
             false);
+        CompileProfiler::phase("compile", compileClock.toc());
+        CompileProfiler::Phase loadPhase{"load"};
         return compResult.multi_visit_or(
             vstd::UndefEval<ComputeShader *>{},
             [&](vstd::unique_ptr<hlsl::DxcByteBlob> const &buffer) {
@@ -123,6 +128,7 @@ ComputeShader *ComputeShader::CompileCompute(
         bool oldDeleted = false;
         vstd::MD5 typeMD5;
         //Cached
+        Clock cacheClock;
         auto result = ShaderSerializer::DeSerialize(
             fileName,
             psoName,
@@ -133,6 +139,8 @@ ComputeShader *ComputeShader::CompileCompute(
             typeMD5,
             std::move(bindings),
             oldDeleted);
+        CompileProfiler::phase("cache_lookup", cacheClock.toc());
+        CompileProfiler::cache("disk", result != nullptr);
         if (result) {
             if (oldDeleted) {
                 result->SavePSO(result->Pso(), psoName, fileIo, device);
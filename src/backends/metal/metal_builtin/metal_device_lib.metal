@@ -265,6 +265,80 @@ LC_AS_ATOMIC(threadgroup, uint)
 LC_AS_ATOMIC(threadgroup, float)
 #undef LC_AS_ATOMIC
 
+// SIMD-group (warp) operations over the currently active threads
+[[gnu::always_inline, nodiscard]] inline auto lc_warp_active_lane_mask(bool p) {
+    return static_cast<ulong>(static_cast<simd_vote::vote_t>(simd_ballot(p)));
+}
+
+[[gnu::always_inline, nodiscard]] inline auto lc_warp_is_first_active_lane() {
+    return simd_is_first();
+}
+
+[[gnu::always_inline, nodiscard]] inline auto lc_warp_first_active_lane() {
+    auto m = lc_warp_active_lane_mask(true);
+    auto lo = static_cast<uint>(m);
+    return lo != 0u ? ctz(lo) : 32u + ctz(static_cast<uint>(m >> 32u));
+}
+
+[[gnu::always_inline, nodiscard]] inline auto lc_warp_active_bit_mask(bool p) {
+    auto m = lc_warp_active_lane_mask(p);
+    return uint4(static_cast<uint>(m), static_cast<uint>(m >> 32u), 0u, 0u);
+}
+
+[[gnu::always_inline, nodiscard]] inline auto lc_warp_active_count_bits(bool p) {
+    auto m = lc_warp_active_lane_mask(p);
+    return popcount(static_cast<uint>(m)) + popcount(static_cast<uint>(m >> 32u));
+}
+
+[[gnu::always_inline, nodiscard]] inline auto lc_warp_prefix_count_bits(bool p) {
+    return simd_prefix_exclusive_sum(p ? 1u : 0u);
+}
+
+// bool is not supported by the simd_* functions, so go through uint
+[[gnu::always_inline, nodiscard]] inline auto lc_warp_read_lane(bool x, uint lane) {
+    return simd_shuffle(static_cast<uint>(x), static_cast<ushort>(lane)) != 0u;
+}
+
+template<typename T>
+[[gnu::always_inline, nodiscard]] inline auto lc_warp_read_lane(T x, uint lane) {
+    return simd_shuffle(x, static_cast<ushort>(lane));
+}
+
+template<typename T>
+[[gnu::always_inline, nodiscard]] inline auto lc_warp_read_first_active_lane(T x) {
+    return simd_broadcast_first(x);
+}
+
+[[gnu::always_inline, nodiscard]] inline auto lc_warp_read_first_active_lane(bool x) {
+    return simd_broadcast_first(static_cast<uint>(x)) != 0u;
+}
+
+#define LC_WARP_ACTIVE_ALL_EQUAL(T)                                                              \
+    [[gnu::always_inline, nodiscard]] inline auto lc_warp_active_all_equal(T x) {                \
+        return simd_all(x == simd_broadcast_first(x));                                           \
+    }                                                                                            \
+    [[gnu::always_inline, nodiscard]] inline auto lc_warp_active_all_equal(T##2 x) {             \
+        return simd_and(uint2(x == simd_broadcast_first(x))) != 0u;                              \
+    }                                                                                            \
+    [[gnu::always_inline, nodiscard]] inline auto lc_warp_active_all_equal(T##3 x) {             \
+        return simd_and(uint3(x == simd_broadcast_first(x))) != 0u;                              \
+    }                                                                                            \
+    [[gnu::always_inline, nodiscard]] inline auto lc_warp_active_all_equal(T##4 x) {             \
+        return simd_and(uint4(x == simd_broadcast_first(x))) != 0u;                              \
+    }
+LC_WARP_ACTIVE_ALL_EQUAL(short)
+LC_WARP_ACTIVE_ALL_EQUAL(ushort)
+LC_WARP_ACTIVE_ALL_EQUAL(int)
+LC_WARP_ACTIVE_ALL_EQUAL(uint)
+LC_WARP_ACTIVE_ALL_EQUAL(float)
+LC_WARP_ACTIVE_ALL_EQUAL(half)
+#undef LC_WARP_ACTIVE_ALL_EQUAL
+
+[[gnu::always_inline, nodiscard]] inline auto lc_warp_active_all_equal(bool x) { return simd_and(uint(x)) == simd_or(uint(x)); }
+[[gnu::always_inline, nodiscard]] inline auto lc_warp_active_all_equal(bool2 x) { return simd_and(uint2(x)) == simd_or(uint2(x)); }
+[[gnu::always_inline, nodiscard]] inline auto lc_warp_active_all_equal(bool3 x) { return simd_and(uint3(x)) == simd_or(uint3(x)); }
+[[gnu::always_inline, nodiscard]] inline auto lc_warp_active_all_equal(bool4 x) { return simd_and(uint4(x)) == simd_or(uint4(x)); }
+
 template<typename A, typename T>
 [[gnu::always_inline]] inline auto atomic_compare_exchange_explicit(A a, T expected, T desired, memory_order) {
     atomic_compare_exchange_weak_explicit(a, &expected, desired, memory_order_relaxed, memory_order_relaxed);
@@ -379,7 +379,8 @@ void MetalCodegenAST::_emit_function() noexcept {
         _scratch << "void kernel_main_impl(\n"
                  << "    constant Arguments &args,\n"
                  << "    uint3 tid, uint3 bid, uint3 did,\n"
-                 << "    uint3 bs, uint3 ds, uint kid";
+                 << "    uint3 bs, uint3 ds, uint kid,\n"
+                 << "    uint ls, uint ws";
         for (auto s : _function.shared_variables()) {
             _scratch << ", threadgroup ";
             _emit_type_name(s.type());
@@ -511,10 +512,12 @@ void MetalCodegenAST::_emit_function() noexcept {
                  << "    uint3 tid [[thread_position_in_threadgroup]],\n"
                  << "    uint3 bid [[threadgroup_position_in_grid]],\n"
                  << "    uint3 did [[thread_position_in_grid]],\n"
-                 << "    uint3 bs [[threads_per_threadgroup]]) {\n"
+                 << "    uint3 bs [[threads_per_threadgroup]],\n"
+                 << "    uint ls [[thread_index_in_simdgroup]],\n"
+                 << "    uint ws [[threads_per_simdgroup]]) {\n"
                  << "  auto ds = args.dispatch_size;\n";
         emit_shared_variable_decls();
-        _scratch << "  kernel_main_impl(args.args, tid, bid, did, bs, ds, 0u";
+        _scratch << "  kernel_main_impl(args.args, tid, bid, did, bs, ds, 0u, ls, ws";
         for (auto s : _function.shared_variables()) {
             _scratch << ", ";
             _emit_variable_name(s);
@@ -529,9 +532,11 @@ void MetalCodegenAST::_emit_function() noexcept {
                  << "    uint3 tid [[thread_position_in_threadgroup]],\n"
                  << "    uint3 bid [[threadgroup_position_in_grid]],\n"
                  << "    uint3 did [[thread_position_in_grid]],\n"
-                 << "    uint3 bs [[threads_per_threadgroup]]) {\n";
+                 << "    uint3 bs [[threads_per_threadgroup]],\n"
+                 << "    uint ls [[thread_index_in_simdgroup]],\n"
+                 << "    uint ws [[threads_per_simdgroup]]) {\n";
         emit_shared_variable_decls();
-        _scratch << "  kernel_main_impl(args, tid, bid, did, bs, ds_kid.xyz, ds_kid.w";
+        _scratch << "  kernel_main_impl(args, tid, bid, did, bs, ds_kid.xyz, ds_kid.w, ls, ws";
         for (auto s : _function.shared_variables()) {
             _scratch << ", ";
             _emit_variable_name(s);
@@ -1005,6 +1010,33 @@ void MetalCodegenAST::visit(const CallExpr *expr) noexcept {
         case CallOp::INDIRECT_EMPLACE_DISPATCH_KERNEL: _scratch << "lc_indirect_dispatch_emplace"; break;
         case CallOp::DDX: LUISA_ERROR_WITH_LOCATION("Not implemented."); break;
         case CallOp::DDY: LUISA_ERROR_WITH_LOCATION("Not implemented."); break;
+        case CallOp::WARP_SIZE: [[fallthrough]];
+        case CallOp::WARP_LANE_ID: {
+            // only available as kernel entry attributes
+            LUISA_ASSERT(_function.tag() == Function::Tag::KERNEL,
+                         "Warp size and lane index are only supported in kernels on Metal.");
+            _scratch << (expr->op() == CallOp::WARP_SIZE ? "ws" : "ls");
+            return;
+        }
+        case CallOp::WARP_IS_FIRST_ACTIVE_LANE: _scratch << "lc_warp_is_first_active_lane"; break;
+        case CallOp::WARP_FIRST_ACTIVE_LANE: _scratch << "lc_warp_first_active_lane"; break;
+        case CallOp::WARP_ACTIVE_ALL_EQUAL: _scratch << "lc_warp_active_all_equal"; break;
+        case CallOp::WARP_ACTIVE_BIT_AND: _scratch << "simd_and"; break;
+        case CallOp::WARP_ACTIVE_BIT_OR: _scratch << "simd_or"; break;
+        case CallOp::WARP_ACTIVE_BIT_XOR: _scratch << "simd_xor"; break;
+        case CallOp::WARP_ACTIVE_COUNT_BITS: _scratch << "lc_warp_active_count_bits"; break;
+        case CallOp::WARP_ACTIVE_MAX: _scratch << "simd_max"; break;
+        case CallOp::WARP_ACTIVE_MIN: _scratch << "simd_min"; break;
+        case CallOp::WARP_ACTIVE_PRODUCT: _scratch << "simd_product"; break;
+        case CallOp::WARP_ACTIVE_SUM: _scratch << "simd_sum"; break;
+        case CallOp::WARP_ACTIVE_ALL: _scratch << "simd_all"; break;
+        case CallOp::WARP_ACTIVE_ANY: _scratch << "simd_any"; break;
+        case CallOp::WARP_ACTIVE_BIT_MASK: _scratch << "lc_warp_active_bit_mask"; break;
+        case CallOp::WARP_PREFIX_COUNT_BITS: _scratch << "lc_warp_prefix_count_bits"; break;
+        case CallOp::WARP_PREFIX_SUM: _scratch << "simd_prefix_exclusive_sum"; break;
+        case CallOp::WARP_PREFIX_PRODUCT: _scratch << "simd_prefix_exclusive_product"; break;
+        case CallOp::WARP_READ_LANE: _scratch << "lc_warp_read_lane"; break;
+        case CallOp::WARP_READ_FIRST_ACTIVE_LANE: _scratch << "lc_warp_read_first_active_lane"; break;
     }
     _scratch << "(";
     if (auto op = expr->op(); is_atomic_operation(op)) {
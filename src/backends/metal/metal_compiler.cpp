@@ -6,6 +6,7 @@
 
 #include <luisa/core/clock.h>
 #include <luisa/core/logging.h>
+#include <luisa/core/compile_report.h>
 #include "metal_device.h"
 #include "metal_compiler.h"
 
@@ -324,7 +325,11 @@ MetalShaderHandle MetalCompiler::compile(luisa::string_view src,
         metadata.checksum = hash;
 
         // try memory cache
-        if (auto pso = _cache.fetch(hash)) { return *pso; }
+        if (auto pso = _cache.fetch(hash)) {
+            CompileProfiler::cache("memory", true);
+            return *pso;
+        }
+        CompileProfiler::cache("memory", false);
 
         // name
         auto name = option.name.empty() ?
@@ -342,8 +347,11 @@ MetalShaderHandle MetalCompiler::compile(luisa::string_view src,
                     "The disk cache will not be loaded.",
                     name);
             } else {
-                if (auto pso = _load_disk_archive(name, is_aot, metadata);
-                    pso.entry && pso.indirect_entry) {
+                Clock cache_clock;
+                auto pso = _load_disk_archive(name, is_aot, metadata);
+                CompileProfiler::phase("cache_lookup", cache_clock.toc());
+                CompileProfiler::cache("disk", pso.entry && pso.indirect_entry);
+                if (pso.entry && pso.indirect_entry) {
                     _cache.update(hash, pso);
                     return pso;
                 }
@@ -386,7 +394,9 @@ MetalShaderHandle MetalCompiler::compile(luisa::string_view src,
         }
 
         NS::Error *error;
+        Clock compile_clock;
         auto library = NS::TransferPtr(_device->handle()->newLibrary(source, options, &error));
+        CompileProfiler::phase("compile", compile_clock.toc());
         library->setLabel(NS::String::string(name.c_str(), NS::UTF8StringEncoding));
         source->release();
         options->release();
@@ -397,8 +407,10 @@ MetalShaderHandle MetalCompiler::compile(luisa::string_view src,
         }
         LUISA_ASSERT(library, "Failed to compile Metal shader '{}'.", name);
 
-        auto [pso_desc, pso] = _load_kernels_from_library(
-            library.get(), metadata.block_size);
+        auto [pso_desc, pso] = [&] {
+            CompileProfiler::Phase load_phase{"load"};
+            return _load_kernels_from_library(library.get(), metadata.block_size);
+        }();
 
         // create pso
         LUISA_ASSERT(pso.entry && pso.indirect_entry,
@@ -4,6 +4,7 @@
 
 #include <luisa/core/clock.h>
 #include <luisa/core/logging.h>
+#include <luisa/core/compile_report.h>
 
 #ifdef LUISA_ENABLE_IR
 #include "metal_codegen_ir.h"
@@ -376,9 +377,12 @@ ShaderCreationInfo MetalDevice::create_shader(const ShaderOption &option, Functi
         }
 
         // codegen
+        Clock clk;
         StringScratch scratch;
         MetalCodegenAST codegen{scratch};
         codegen.emit(kernel, option.native_include);
+        CompileProfiler::phase("codegen", clk.toc());
+        CompileProfiler::counter("source.bytes", scratch.string_view().size());
 
         // create shader
         auto pipeline = _compiler->compile(scratch.string_view(), option, metadata);
@@ -39,14 +39,27 @@ void MetalMesh::build(MetalCommandEncoder &encoder, MeshBuildCommand *command) n
     auto triangle_buffer_handle = triangle_buffer->handle();
     auto triangle_buffer_offset = command->triangle_buffer_offset();
     auto triangle_buffer_size = command->triangle_buffer_size();
-    constexpr auto triangle_stride = sizeof(Triangle);
+    auto triangle_stride = command->triangle_stride();
     LUISA_ASSERT(triangle_buffer_size % triangle_stride == 0u, "Invalid triangle buffer size.");
+    auto vertex_format = [format = command->vertex_format()] {
+        switch (format) {
+            case MeshVertexFormat::FLOAT3: return MTL::AttributeFormatFloat3;
+            case MeshVertexFormat::HALF3: return MTL::AttributeFormatHalf3;
+            case MeshVertexFormat::SNORM16_3: return MTL::AttributeFormatShort3Normalized;
+        }
+        LUISA_ERROR_WITH_LOCATION("Invalid mesh vertex format.");
+    }();
+    auto index_type = command->index_format() == MeshIndexFormat::UINT16 ?
+                          MTL::IndexTypeUInt16 :
+                          MTL::IndexTypeUInt32;
 
     auto geometry_buffers_changed = [&](auto desc) noexcept {
         return desc->vertexBuffer() != vertex_buffer_handle ||
                desc->vertexBufferOffset() != vertex_buffer_offset ||
                desc->vertexStride() != vertex_stride ||
+               desc->vertexFormat() != vertex_format ||
                desc->indexBuffer() != triangle_buffer_handle ||
+               desc->indexType() != index_type ||
                desc->indexBufferOffset() != triangle_buffer_offset ||
                desc->triangleCount() * triangle_stride != triangle_buffer_size;
     };
@@ -66,10 +79,10 @@ void MetalMesh::build(MetalCommandEncoder &encoder, MeshBuildCommand *command) n
         geom_desc->setVertexBuffer(vertex_buffer_handle);
         geom_desc->setVertexBufferOffset(vertex_buffer_offset);
         geom_desc->setVertexStride(vertex_stride);
-        geom_desc->setVertexFormat(MTL::AttributeFormatFloat3);
+        geom_desc->setVertexFormat(vertex_format);
         geom_desc->setIndexBuffer(triangle_buffer_handle);
         geom_desc->setIndexBufferOffset(triangle_buffer_offset);
-        geom_desc->setIndexType(MTL::IndexTypeUInt32);
+        geom_desc->setIndexType(index_type);
         geom_desc->setTriangleCount(triangle_buffer_size / triangle_stride);
         geom_desc->setOpaque(true);
         geom_desc->setAllowDuplicateIntersectionFunctionInvocation(true);
@@ -0,0 +1,248 @@
+#include <luisa/core/logging.h>
+#include <luisa/core/mathematics.h>
+#include <luisa/runtime/rhi/command.h>
+#include <luisa/runtime/command_list.h>
+#include "device.h"
+
+namespace lc::profiling {
+
+Device::Device(Context &&ctx, luisa::shared_ptr<DeviceInterface> &&native) noexcept
+    : DeviceInterface{std::move(ctx)},
+      _native{std::move(native)} {}
+
+void *Device::native_handle() const noexcept {
+    return _native->native_handle();
+}
+Usage Device::shader_argument_usage(uint64_t handle, size_t index) noexcept {
+    return _native->shader_argument_usage(handle, index);
+}
+
+// buffer
+BufferCreationInfo Device::create_buffer(const Type *element, size_t elem_count) noexcept {
+    auto buffer = _native->create_buffer(element, elem_count);
+    _profiler.add_resource(buffer.handle, false, buffer.total_size_bytes);
+    return buffer;
+}
+BufferCreationInfo Device::create_buffer(const ir::CArc<ir::Type> *element, size_t elem_count) noexcept {
+    auto buffer = _native->create_buffer(element, elem_count);
+    _profiler.add_resource(buffer.handle, false, buffer.total_size_bytes);
+    return buffer;
+}
+void Device::destroy_buffer(uint64_t handle) noexcept {
+    _profiler.remove_resource(handle);
+    _native->destroy_buffer(handle);
+}
+
+// texture
+ResourceCreationInfo Device::create_texture(
+    PixelFormat format, uint dimension,
+    uint width, uint height, uint depth,
+    uint mipmap_levels, bool simultaneous_access) noexcept {
+    auto tex = _native->create_texture(format, dimension, width, height, depth, mipmap_levels, simultaneous_access);
+    if (tex.valid()) {
+        auto size_bytes = static_cast<size_t>(0u);
+        for (auto level = 0u; level < mipmap_levels; level++) {
+            auto size = luisa::max(make_uint3(width, height, depth) >> level, 1u);
+            size_bytes += pixel_format_size(format, size);
+        }
+        _profiler.add_resource(tex.handle, true, size_bytes);
+    }
+    return tex;
+}
+void Device::destroy_texture(uint64_t handle) noexcept {
+    _profiler.remove_resource(handle);
+    _native->destroy_texture(handle);
+}
+
+// bindless array
+ResourceCreationInfo Device::create_bindless_array(size_t size) noexcept {
+    return _native->create_bindless_array(size);
+}
+void Device::destroy_bindless_array(uint64_t handle) noexcept {
+    _native->destroy_bindless_array(handle);
+}
+
+// stream
+ResourceCreationInfo Device::create_stream(StreamTag stream_tag) noexcept {
+    auto stream = _native->create_stream(stream_tag);
+    if (stream.valid()) { _profiler.add_stream(stream.handle, stream_tag); }
+    return stream;
+}
+void Device::destroy_stream(uint64_t handle) noexcept {
+    _native->destroy_stream(handle);
+    _profiler.remove_stream(handle);
+}
+void Device::synchronize_stream(uint64_t stream_handle) noexcept {
+    auto begin = _profiler.now();
+    _native->synchronize_stream(stream_handle);
+    _profiler.host_wait("synchronize_stream", begin);
+}
+void Device::dispatch(uint64_t stream_handle, CommandList &&list) noexcept {
+    if (list.commands().empty()) {
+        _native->dispatch(stream_handle, std::move(list));
+        return;
+    }
+    // the completion is recorded before the user callbacks run
+    auto commands = list.steal_commands();
+    auto callbacks = list.steal_callbacks();
+    auto submit = [&](luisa::span<luisa::unique_ptr<Command>> sub_commands, bool last) noexcept {
+        auto sub_list = CommandList::create(sub_commands.size(), last ? callbacks.size() + 1u : 1u);
+        auto submission = _profiler.submit(stream_handle, sub_commands);
+        for (auto &&command : sub_commands) { sub_list << std::move(command); }
+        sub_list.add_callback([this, submission = std::move(submission)]() mutable noexcept {
+            _profiler.complete(std::move(submission));
+        });
+        if (last) {
+            for (auto &&callback : callbacks) { sub_list.add_callback(std::move(callback)); }
+        }
+        _native->dispatch(stream_handle, sub_list.commit().command_list());
+    };
+    if (_profiler.per_command_timing()) {
+        for (auto i = 0u; i < commands.size(); i++) {
+            submit(luisa::span{commands}.subspan(i, 1u), i + 1u == commands.size());
+        }
+    } else {
+        submit(commands, true);
+    }
+}
+
+// swap chain
+SwapchainCreationInfo Device::create_swapchain(
+    uint64_t window_handle, uint64_t stream_handle,
+    uint width, uint height, bool allow_hdr,
+    bool vsync, uint back_buffer_size) noexcept {
+    return _native->create_swapchain(window_handle, stream_handle, width, height, allow_hdr, vsync, back_buffer_size);
+}
+void Device::destroy_swap_chain(uint64_t handle) noexcept {
+    _native->destroy_swap_chain(handle);
+}
+void Device::present_display_in_stream(uint64_t stream_handle, uint64_t swapchain_handle, uint64_t image_handle) noexcept {
+    _native->present_display_in_stream(stream_handle, swapchain_handle, image_handle);
+}
+
+// kernel
+ShaderCreationInfo Device::create_shader(const ShaderOption &option, Function kernel) noexcept {
+    auto shader = _native->create_shader(option, kernel);
+    if (shader.valid()) { _profiler.add_shader(shader.handle, option.name); }
+    return shader;
+}
+ShaderCreationInfo Device::create_shader(const ShaderOption &option, const ir::KernelModule *kernel) noexcept {
+    auto shader = _native->create_shader(option, kernel);
+    if (shader.valid()) { _profiler.add_shader(shader.handle, option.name); }
+    return shader;
+}
+ShaderCreationInfo Device::load_shader(luisa::string_view name, luisa::span<const Type *const> arg_types) noexcept {
+    auto shader = _native->load_shader(name, arg_types);
+    if (shader.valid()) { _profiler.add_shader(shader.handle, name); }
+    return shader;
+}
+void Device::destroy_shader(uint64_t handle) noexcept {
+    _native->destroy_shader(handle);
+}
+
+// event
+ResourceCreationInfo Device::create_event() noexcept {
+    return _native->create_event();
+}
+void Device::destroy_event(uint64_t handle) noexcept {
+    _native->destroy_event(handle);
+}
+void Device::signal_event(uint64_t handle, uint64_t stream_handle, uint64_t fence) noexcept {
+    _profiler.signal(handle, stream_handle, fence);
+    _native->signal_event(handle, stream_handle, fence);
+}
+void Device::wait_event(uint64_t handle, uint64_t stream_handle, uint64_t fence) noexcept {
+    _profiler.wait(handle, stream_handle, fence);
+    _native->wait_event(handle, stream_handle, fence);
+}
+bool Device::is_event_completed(uint64_t handle, uint64_t fence) const noexcept {
+    return _native->is_event_completed(handle, fence);
+}
+void Device::synchronize_event(uint64_t handle, uint64_t fence) noexcept {
+    auto begin = _profiler.now();
+    _native->synchronize_event(handle, fence);
+    _profiler.host_wait("synchronize_event", begin);
+}
+
+// accel
+ResourceCreationInfo Device::create_mesh(const AccelOption &option) noexcept {
+    return _native->create_mesh(option);
+}
+void Device::destroy_mesh(uint64_t handle) noexcept {
+    _native->destroy_mesh(handle);
+}
+ResourceCreationInfo Device::create_procedural_primitive(const AccelOption &option) noexcept {
+    return _native->create_procedural_primitive(option);
+}
+void Device::destroy_procedural_primitive(uint64_t handle) noexcept {
+    _native->destroy_procedural_primitive(handle);
+}
+ResourceCreationInfo Device::create_accel(const AccelOption &option) noexcept {
+    return _native->create_accel(option);
+}
+void Device::destroy_accel(uint64_t handle) noexcept {
+    _native->destroy_accel(handle);
+}
+
+// query
+luisa::string Device::query(luisa::string_view property) noexcept {
+    return _native->query(property);
+}
+DeviceExtension *Device::extension(luisa::string_view name) noexcept {
+    if (name == ProfilingExt::name) { return &_profiler; }
+    return _native->extension(name);
+}
+void Device::set_name(luisa::compute::Resource::Tag resource_tag, uint64_t resource_handle, luisa::string_view name) noexcept {
+    _profiler.set_name(resource_handle, name);
+    _native->set_name(resource_tag, resource_handle, name);
+}
+
+// sparse resources
+SparseBufferCreationInfo Device::create_sparse_buffer(const Type *element, size_t elem_count) noexcept {
+    return _native->create_sparse_buffer(element, elem_count);
+}
+void Device::destroy_sparse_buffer(uint64_t handle) noexcept {
+    _native->destroy_sparse_buffer(handle);
+}
+SparseTextureCreationInfo Device::create_sparse_texture(
+    PixelFormat format, uint dimension,
+    uint width, uint height, uint depth,
+    uint mipmap_levels, bool simultaneous_access) noexcept {
+    return _native->create_sparse_texture(format, dimension, width, height, depth, mipmap_levels, simultaneous_access);
+}
+void Device::destroy_sparse_texture(uint64_t handle) noexcept {
+    _native->destroy_sparse_texture(handle);
+}
+void Device::update_sparse_resources(
+    uint64_t stream_handle,
+    luisa::vector<SparseUpdateTile> &&update_cmds) noexcept {
+    _native->update_sparse_resources(stream_handle, std::move(update_cmds));
+}
+// heaps back the sparse resources, so they are what the memory counter tracks
+ResourceCreationInfo Device::allocate_sparse_buffer_heap(size_t byte_size) noexcept {
+    auto heap = _native->allocate_sparse_buffer_heap(byte_size);
+    if (heap.valid()) { _profiler.add_resource(heap.handle, false, byte_size); }
+    return heap;
+}
+void Device::deallocate_sparse_buffer_heap(uint64_t handle) noexcept {
+    _profiler.remove_resource(handle);
+    _native->deallocate_sparse_buffer_heap(handle);
+}
+ResourceCreationInfo Device::allocate_sparse_texture_heap(size_t byte_size) noexcept {
+    auto heap = _native->allocate_sparse_texture_heap(byte_size);
+    if (heap.valid()) { _profiler.add_resource(heap.handle, true, byte_size); }
+    return heap;
+}
+void Device::deallocate_sparse_texture_heap(uint64_t handle) noexcept {
+    _profiler.remove_resource(handle);
+    _native->deallocate_sparse_texture_heap(handle);
+}
+
+VSTL_EXPORT_C void destroy(DeviceInterface *d) {
+    delete d;
+}
+VSTL_EXPORT_C DeviceInterface *create(Context &&ctx, luisa::shared_ptr<DeviceInterface> &&native) {
+    return new Device{std::move(ctx), std::move(native)};
+}
+
+}// namespace lc::profiling
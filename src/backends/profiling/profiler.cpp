@@ -0,0 +1,342 @@
+#include <fstream>
+#include <algorithm>
+
+#include <luisa/core/logging.h>
+#include <luisa/core/magic_enum.h>
+#include "profiler.h"
+
+namespace lc::profiling {
+
+namespace detail {
+
+[[nodiscard]] static auto json_escape(luisa::string_view s) noexcept {
+    luisa::string escaped;
+    escaped.reserve(s.size());
+    for (auto c : s) {
+        switch (c) {
+            case '"': escaped.append("\\\""); break;
+            case '\\': escaped.append("\\\\"); break;
+            case '\n': escaped.append("\\n"); break;
+            case '\t': escaped.append("\\t"); break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20u) {
+                    escaped.append(luisa::format("\\u{:04x}", static_cast<uint>(c)));
+                } else {
+                    escaped.push_back(c);
+                }
+                break;
+        }
+    }
+    return escaped;
+}
+
+[[nodiscard]] static auto command_name(const Command *command) noexcept {
+    // EBufferUploadCommand -> BufferUpload
+    auto name = luisa::to_string(command->tag());
+    if (name.starts_with('E')) { name.remove_prefix(1u); }
+    if (name.ends_with("Command")) { name.remove_suffix(7u); }
+    return luisa::string{name};
+}
+
+// flow events pair a signal with the waits on the same event and fence
+[[nodiscard]] static auto flow_id(uint64_t event, uint64_t fence) noexcept {
+    return luisa::hash_value(fence, luisa::hash_value(event));
+}
+
+}// namespace detail
+
+Profiler::Profiler() noexcept {
+    _track_names.emplace_back("host");
+}
+
+luisa::string Profiler::_name_of(uint64_t handle, luisa::string_view fallback) const noexcept {
+    if (auto iter = _names.find(handle); iter != _names.end()) { return iter->second; }
+    return luisa::format("{}#{}", fallback, handle);
+}
+
+void Profiler::_record_memory_counter(double time) noexcept {
+    _events.emplace_back(TraceEvent{
+        .name = "memory",
+        .category = "memory",
+        .phase = 'C',
+        .timestamp = time,
+        .args = luisa::format(R"("buffers": {}, "textures": {})", _buffer_bytes, _texture_bytes)});
+}
+
+void Profiler::_record_queue_counter(uint64_t stream, const StreamState &s, double time) noexcept {
+    _events.emplace_back(TraceEvent{
+        .name = luisa::format("queue depth ({})", _track_names[s.track]),
+        .category = "queue",
+        .phase = 'C',
+        .timestamp = time,
+        .args = luisa::format(R"("in flight": {})", s.in_flight)});
+}
+
+void Profiler::add_stream(uint64_t handle, StreamTag tag) noexcept {
+    std::scoped_lock lock{_mutex};
+    auto track = static_cast<uint64_t>(_track_names.size());
+    _track_names.emplace_back(luisa::format("stream#{} ({})", handle, luisa::to_string(tag)));
+    _streams.insert_or_assign(handle, StreamState{
+                                          .track = track,
+                                          .tag = tag,
+                                          .in_flight = 0u,
+                                          .last_completion = 0.});
+}
+
+void Profiler::remove_stream(uint64_t handle) noexcept {
+    std::scoped_lock lock{_mutex};
+    _streams.erase(handle);
+}
+
+void Profiler::add_shader(uint64_t handle, luisa::string_view name) noexcept {
+    std::scoped_lock lock{_mutex};
+    if (!name.empty()) { _names.insert_or_assign(handle, luisa::string{name}); }
+    _shaders.insert_or_assign(handle, ShaderStatistics{
+                                          .handle = handle,
+                                          .name = _name_of(handle, "shader"),
+                                          .dispatch_count = 0u,
+                                          .thread_count = 0u,
+                                          .total_milliseconds = 0.,
+                                          .min_milliseconds = 0.,
+                                          .max_milliseconds = 0.});
+}
+
+void Profiler::add_resource(uint64_t handle, bool is_texture, size_t size_bytes) noexcept {
+    auto time = _now();
+    std::scoped_lock lock{_mutex};
+    _resources.insert_or_assign(handle, ResourceState{is_texture, size_bytes});
+    (is_texture ? _texture_bytes : _buffer_bytes) += size_bytes;
+    _record_memory_counter(time);
+}
+
+void Profiler::remove_resource(uint64_t handle) noexcept {
+    auto time = _now();
+    std::scoped_lock lock{_mutex};
+    if (auto iter = _resources.find(handle); iter != _resources.end()) {
+        (iter->second.is_texture ? _texture_bytes : _buffer_bytes) -= iter->second.size_bytes;
+        _resources.erase(iter);
+        _record_memory_counter(time);
+    }
+}
+
+void Profiler::set_name(uint64_t handle, luisa::string_view name) noexcept {
+    std::scoped_lock lock{_mutex};
+    _names.insert_or_assign(handle, luisa::string{name});
+    if (auto iter = _shaders.find(handle); iter != _shaders.end()) {
+        iter->second.name = name;
+    }
+    if (auto iter = _streams.find(handle); iter != _streams.end()) {
+        _track_names[iter->second.track] = luisa::format(
+            "{} ({})", name, luisa::to_string(iter->second.tag));
+    }
+}
+
+bool Profiler::per_command_timing() noexcept {
+    std::scoped_lock lock{_mutex};
+    return _per_command_timing;
+}
+
+Profiler::Submission Profiler::submit(uint64_t stream, luisa::span<const luisa::unique_ptr<Command>> commands) noexcept {
+    auto time = _now();
+    std::scoped_lock lock{_mutex};
+    Submission submission{
+        .stream = stream,
+        .shader = invalid_resource_handle,
+        .submit_time = time};
+    auto dispatch_count = 0u;
+    for (auto &&command : commands) {
+        if (command->tag() != Command::Tag::EShaderDispatchCommand) { continue; }
+        dispatch_count++;
+        auto dispatch = static_cast<const ShaderDispatchCommand *>(command.get());
+        auto iter = _shaders.find(dispatch->handle());
+        if (iter == _shaders.end()) { continue; }
+        iter->second.dispatch_count++;
+        if (!dispatch->is_indirect()) {
+            auto size = dispatch->dispatch_size();
+            iter->second.thread_count += static_cast<uint64_t>(size.x) * size.y * size.z;
+        }
+    }
+    if (commands.size() == 1u) {
+        auto command = commands.front().get();
+        if (command->tag() == Command::Tag::EShaderDispatchCommand) {
+            auto dispatch = static_cast<const ShaderDispatchCommand *>(command);
+            submission.shader = dispatch->handle();
+            submission.name = _name_of(dispatch->handle(), "shader");
+            if (dispatch->is_indirect()) {
+                submission.args = R"("indirect": true)";
+            } else {
+                auto size = dispatch->dispatch_size();
+                submission.args = luisa::format(R"("dispatch size": [{}, {}, {}])", size.x, size.y, size.z);
+            }
+        } else {
+            submission.name = detail::command_name(command);
+        }
+    } else {
+        submission.name = "CommandList";
+        submission.args = luisa::format(R"("commands": {}, "dispatches": {})", commands.size(), dispatch_count);
+    }
+    if (auto iter = _streams.find(stream); iter != _streams.end()) {
+        iter->second.in_flight++;
+        _record_queue_counter(stream, iter->second, time);
+    }
+    return submission;
+}
+
+void Profiler::complete(Submission submission) noexcept {
+    auto time = _now();
+    std::scoped_lock lock{_mutex};
+    auto iter = _streams.find(submission.stream);
+    if (iter == _streams.end()) { return; }
+    auto &&s = iter->second;
+    // streams execute in order, so the command starts when it is submitted
+    // or when the previous one on the same stream completes, whichever is later
+    auto begin = std::max(submission.submit_time, s.last_completion);
+    auto duration = time - begin;
+    s.last_completion = time;
+    s.in_flight--;
+    _events.emplace_back(TraceEvent{
+        .name = std::move(submission.name),
+        .category = submission.shader == invalid_resource_handle ? "command" : "dispatch",
+        .phase = 'X',
+        .timestamp = begin,
+        .duration = duration,
+        .track = s.track,
+        .args = luisa::format(R"("queued (us)": {:.3f}{}{})",
+                              begin - submission.submit_time,
+                              submission.args.empty() ? "" : ", ",
+                              submission.args)});
+    _record_queue_counter(submission.stream, s, time);
+    if (submission.shader != invalid_resource_handle) {
+        if (auto shader = _shaders.find(submission.shader); shader != _shaders.end()) {
+            auto &&stat = shader->second;
+            auto ms = duration * 1e-3;
+            stat.min_milliseconds = stat.total_milliseconds == 0. ? ms : std::min(stat.min_milliseconds, ms);
+            stat.max_milliseconds = std::max(stat.max_milliseconds, ms);
+            stat.total_milliseconds += ms;
+        }
+    }
+}
+
+void Profiler::signal(uint64_t event, uint64_t stream, uint64_t fence) noexcept {
+    auto time = _now();
+    std::scoped_lock lock{_mutex};
+    auto iter = _streams.find(stream);
+    if (iter == _streams.end()) { return; }
+    auto name = luisa::format("signal {} ({})", _name_of(event, "event"), fence);
+    _events.emplace_back(TraceEvent{.name = name, .category = "sync", .phase = 'i', .timestamp = time, .track = iter->second.track});
+    _events.emplace_back(TraceEvent{
+        .name = "event", .category = "sync", .phase = 's', .timestamp = time,
+        .track = iter->second.track, .id = detail::flow_id(event, fence)});
+}
+
+void Profiler::wait(uint64_t event, uint64_t stream, uint64_t fence) noexcept {
+    auto time = _now();
+    std::scoped_lock lock{_mutex};
+    auto iter = _streams.find(stream);
+    if (iter == _streams.end()) { return; }
+    auto name = luisa::format("wait {} ({})", _name_of(event, "event"), fence);
+    _events.emplace_back(TraceEvent{.name = name, .category = "sync", .phase = 'i', .timestamp = time, .track = iter->second.track});
+    _events.emplace_back(TraceEvent{
+        .name = "event", .category = "sync", .phase = 'f', .timestamp = time,
+        .track = iter->second.track, .id = detail::flow_id(event, fence)});
+}
+
+void Profiler::host_wait(luisa::string_view name, double begin) noexcept {
+    auto time = _now();
+    std::scoped_lock lock{_mutex};
+    _events.emplace_back(TraceEvent{
+        .name = luisa::string{name},
+        .category = "host",
+        .phase = 'X',
+        .timestamp = begin,
+        .duration = time - begin,
+        .track = 0u});
+}
+
+void Profiler::set_per_command_timing(bool enabled) noexcept {
+    std::scoped_lock lock{_mutex};
+    _per_command_timing = enabled;
+}
+
+void Profiler::clear() noexcept {
+    std::scoped_lock lock{_mutex};
+    _events.clear();
+    for (auto &&[_, stat] : _shaders) {
+        stat.dispatch_count = 0u;
+        stat.thread_count = 0u;
+        stat.total_milliseconds = 0.;
+        stat.min_milliseconds = 0.;
+        stat.max_milliseconds = 0.;
+    }
+}
+
+luisa::string Profiler::chrome_trace() noexcept {
+    std::scoped_lock lock{_mutex};
+    luisa::string json{R"({"displayTimeUnit": "ms", "traceEvents": [)"};
+    json.append("\n  {\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 0, \"args\": {\"name\": \"LuisaCompute\"}}");
+    for (auto track = 0u; track < _track_names.size(); track++) {
+        json.append(luisa::format(
+            ",\n  {{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": {}, \"args\": {{\"name\": \"{}\"}}}}",
+            track, detail::json_escape(_track_names[track])));
+    }
+    for (auto &&e : _events) {
+        json.append(luisa::format(
+            ",\n  {{\"name\": \"{}\", \"cat\": \"{}\", \"ph\": \"{}\", \"ts\": {:.3f}, \"pid\": 0, \"tid\": {}",
+            detail::json_escape(e.name), e.category, e.phase, e.timestamp, e.track));
+        switch (e.phase) {
+            case 'X': json.append(luisa::format(", \"dur\": {:.3f}", e.duration)); break;
+            case 'i': json.append(", \"s\": \"t\""); break;
+            case 's': json.append(luisa::format(", \"id\": {}", e.id)); break;
+            case 'f': json.append(luisa::format(", \"id\": {}, \"bp\": \"e\"", e.id)); break;
+            default: break;
+        }
+        if (!e.args.empty()) { json.append(luisa::format(", \"args\": {{{}}}", e.args)); }
+        json.append("}");
+    }
+    json.append("\n]}\n");
+    return json;
+}
+
+void Profiler::dump_chrome_trace(const luisa::filesystem::path &path) noexcept {
+    auto json = chrome_trace();
+    std::ofstream file{path, std::ios::binary};
+    if (!file) {
+        LUISA_WARNING_WITH_LOCATION("Failed to open '{}' for writing the trace.", to_string(path));
+        return;
+    }
+    file.write(json.data(), static_cast<std::streamsize>(json.size()));
+    LUISA_INFO("Profiling trace written to '{}'.", to_string(path));
+}
+
+luisa::vector<ProfilingExt::ShaderStatistics> Profiler::shader_statistics() noexcept {
+    luisa::vector<ShaderStatistics> stats;
+    {
+        std::scoped_lock lock{_mutex};
+        stats.reserve(_shaders.size());
+        for (auto &&[_, stat] : _shaders) { stats.emplace_back(stat); }
+    }
+    std::sort(stats.begin(), stats.end(), [](auto &&lhs, auto &&rhs) noexcept {
+        if (lhs.total_milliseconds != rhs.total_milliseconds) {
+            return lhs.total_milliseconds > rhs.total_milliseconds;
+        }
+        return lhs.dispatch_count > rhs.dispatch_count;
+    });
+    return stats;
+}
+
+luisa::string Profiler::dump_shader_statistics() noexcept {
+    auto stats = shader_statistics();
+    auto s = luisa::format("{:<32} {:>10} {:>14} {:>12} {:>12} {:>12} {:>12}",
+                           "shader", "dispatches", "threads", "total (ms)", "avg (ms)", "min (ms)", "max (ms)");
+    for (auto &&stat : stats) {
+        if (stat.dispatch_count == 0u) { continue; }
+        s.append(luisa::format("\n{:<32} {:>10} {:>14} {:>12.3f} {:>12.3f} {:>12.3f} {:>12.3f}",
+                               stat.name, stat.dispatch_count, stat.thread_count,
+                               stat.total_milliseconds,
+                               stat.total_milliseconds / static_cast<double>(stat.dispatch_count),
+                               stat.min_milliseconds, stat.max_milliseconds));
+    }
+    return s;
+}
+
+}// namespace lc::profiling
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <mutex>
+
+#include <luisa/core/clock.h>
+#include <luisa/core/stl/unordered_map.h>
+#include <luisa/runtime/rhi/command.h>
+#include <luisa/runtime/rhi/stream_tag.h>
+#include <luisa/backends/ext/profiling_ext.h>
+
+namespace lc::profiling {
+
+using namespace luisa;
+using namespace luisa::compute;
+
+class Profiler final : public ProfilingExt {
+
+public:
+    // a submitted command (list) waiting for its completion callback
+    struct Submission {
+        uint64_t stream;
+        uint64_t shader;// invalid_resource_handle if not a single shader dispatch
+        luisa::string name;
+        luisa::string args;// JSON object members
+        double submit_time;
+    };
+
+private:
+    struct TraceEvent {
+        luisa::string name;
+        luisa::string_view category;
+        char phase;
+        double timestamp;// microseconds since the layer is created
+        double duration;
+        uint64_t track;
+        uint64_t id;
+        luisa::string args;
+    };
+
+    struct StreamState {
+        uint64_t track;
+        StreamTag tag;
+        uint64_t in_flight;
+        double last_completion;
+    };
+
+    struct ResourceState {
+        bool is_texture;
+        size_t size_bytes;
+    };
+
+private:
+    std::mutex _mutex;
+    Clock _clock;
+    bool _per_command_timing{true};
+    luisa::vector<TraceEvent> _events;
+    luisa::unordered_map<uint64_t, luisa::string> _names;
+    luisa::vector<luisa::string> _track_names;// track 0 is the host
+    luisa::unordered_map<uint64_t, StreamState> _streams;
+    luisa::unordered_map<uint64_t, ShaderStatistics> _shaders;
+    luisa::unordered_map<uint64_t, ResourceState> _resources;
+    size_t _buffer_bytes{};
+    size_t _texture_bytes{};
+
+private:
+    [[nodiscard]] double _now() const noexcept { return _clock.toc() * 1e3; }
+    [[nodiscard]] luisa::string _name_of(uint64_t handle, luisa::string_view fallback) const noexcept;
+    void _record_memory_counter(double time) noexcept;
+    void _record_queue_counter(uint64_t stream, const StreamState &s, double time) noexcept;
+
+public:
+    Profiler() noexcept;
+    // recorders, called by the layer device
+    void add_stream(uint64_t handle, StreamTag tag) noexcept;
+    void remove_stream(uint64_t handle) noexcept;
+    void add_shader(uint64_t handle, luisa::string_view name) noexcept;
+    void add_resource(uint64_t handle, bool is_texture, size_t size_bytes) noexcept;
+    void remove_resource(uint64_t handle) noexcept;
+    void set_name(uint64_t handle, luisa::string_view name) noexcept;
+    [[nodiscard]] bool per_command_timing() noexcept;
+    [[nodiscard]] Submission submit(uint64_t stream, luisa::span<const luisa::unique_ptr<Command>> commands) noexcept;
+    void complete(Submission submission) noexcept;
+    void signal(uint64_t event, uint64_t stream, uint64_t fence) noexcept;
+    void wait(uint64_t event, uint64_t stream, uint64_t fence) noexcept;
+    void host_wait(luisa::string_view name, double begin) noexcept;
+    [[nodiscard]] double now() const noexcept { return _now(); }
+
+public:
+    void set_per_command_timing(bool enabled) noexcept override;
+    void clear() noexcept override;
+    [[nodiscard]] luisa::string chrome_trace() noexcept override;
+    void dump_chrome_trace(const luisa::filesystem::path &path) noexcept override;
+    [[nodiscard]] luisa::vector<ShaderStatistics> shader_statistics() noexcept override;
+    [[nodiscard]] luisa::string dump_shader_statistics() noexcept override;
+};
+
+}// namespace lc::profiling
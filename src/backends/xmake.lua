@@ -18,9 +18,13 @@ if get_config("vk_backend") then
     includes("vk")
 end
 includes("validation")
+includes("profiling")
+includes("capture")
 target("lc-backends-dummy")
 set_kind("phony")
 add_deps("lc-validation-layer", { inherit = false })
+add_deps("lc-profiling-layer", { inherit = false })
+add_deps("lc-capture-layer", { inherit = false })
 if get_config("dx_backend") then
     add_deps("lc-backend-dx", { inherit = false })
 end
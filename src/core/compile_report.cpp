@@ -0,0 +1,262 @@
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+
+#include <luisa/core/logging.h>
+#include <luisa/core/stl/deque.h>
+#include <luisa/core/stl/unordered_map.h>
+#include <luisa/core/compile_report.h>
+
+namespace luisa {
+
+namespace detail {
+
+struct CompileProfilerSession {
+    std::mutex mutex;
+    CompileProfiler::Callback callback;
+    luisa::vector<ShaderCompileReport> reports;
+    // traces of kernels that are not compiled yet, with the sequence numbers
+    // of their entries in the queue (oldest first) used for bounding them
+    luisa::unordered_map<uint64_t, std::pair<uint64_t, ShaderCompileReport>> pending_traces;
+    luisa::deque<std::pair<uint64_t /* hash */, uint64_t /* sequence */>> pending_queue;
+    uint64_t pending_sequence{0u};
+};
+
+// kernels traced but never compiled should not accumulate their traces
+static constexpr auto max_pending_traces = 4096u;
+
+[[nodiscard]] static auto &compile_profiler_enabled() noexcept {
+    static std::atomic_bool enabled{false};
+    return enabled;
+}
+
+[[nodiscard]] static auto &compile_profiler_session() noexcept {
+    static CompileProfilerSession session;
+    return session;
+}
+
+// reports being collected on this thread, innermost last
+[[nodiscard]] static auto &compile_profiler_stack() noexcept {
+    static thread_local luisa::vector<ShaderCompileReport> stack;
+    return stack;
+}
+
+[[nodiscard]] static auto &compile_profiler_last_report() noexcept {
+    static thread_local luisa::optional<ShaderCompileReport> report;
+    return report;
+}
+
+}// namespace detail
+
+double ShaderCompileReport::phase_milliseconds(luisa::string_view phase) const noexcept {
+    auto ms = 0.;
+    for (auto &&p : phases) {
+        if (p.name == phase) { ms += p.milliseconds; }
+    }
+    return ms;
+}
+
+luisa::optional<uint64_t> ShaderCompileReport::counter(luisa::string_view counter) const noexcept {
+    for (auto &&c : counters) {
+        if (c.name == counter) { return c.value; }
+    }
+    return luisa::nullopt;
+}
+
+bool ShaderCompileReport::cache_hit() const noexcept {
+    return std::any_of(cache_events.cbegin(), cache_events.cend(),
+                       [](auto &&e) noexcept { return e.hit; });
+}
+
+luisa::string ShaderCompileReport::dump() const noexcept {
+    auto s = luisa::format("Shader '{}' ({:016x}) compiled in {:.3f} ms", name, hash, total_milliseconds);
+    for (auto &&p : phases) {
+        s.append(luisa::format("\n  phase   {:<24} {:>12.3f} ms", p.name, p.milliseconds));
+    }
+    for (auto &&c : counters) {
+        s.append(luisa::format("\n  counter {:<24} {:>12}", c.name, c.value));
+    }
+    for (auto &&e : cache_events) {
+        s.append(luisa::format("\n  cache   {:<24} {:>12}", e.layer, e.hit ? "hit" : "miss"));
+    }
+    return s;
+}
+
+CompileProfiler::Scope::Scope(luisa::string name, uint64_t hash) noexcept
+    : _active{is_enabled()} {
+    if (!_active) { return; }
+    ShaderCompileReport report;
+    {
+        auto &&session = detail::compile_profiler_session();
+        std::scoped_lock lock{session.mutex};
+        if (auto iter = session.pending_traces.find(hash);
+            iter != session.pending_traces.end()) {
+            report = std::move(iter->second.second);
+            session.pending_traces.erase(iter);
+        }
+    }
+    report.name = name.empty() ? luisa::format("kernel_{:016x}", hash) : std::move(name);
+    report.hash = hash;
+    detail::compile_profiler_stack().emplace_back(std::move(report));
+}
+
+CompileProfiler::Scope::~Scope() noexcept {
+    if (!_active) { return; }
+    auto &&stack = detail::compile_profiler_stack();
+    auto report = std::move(stack.back());
+    stack.pop_back();
+    report.total_milliseconds = _clock.toc();
+    Callback callback;
+    {
+        auto &&session = detail::compile_profiler_session();
+        std::scoped_lock lock{session.mutex};
+        session.reports.emplace_back(report);
+        callback = session.callback;
+    }
+    // invoke the callback outside the lock so that it may query the session
+    if (callback) { callback(report); }
+    detail::compile_profiler_last_report().emplace(std::move(report));
+}
+
+CompileProfiler::Phase::Phase(luisa::string_view name) noexcept
+    : _name{name} {}
+
+CompileProfiler::Phase::~Phase() noexcept {
+    CompileProfiler::phase(_name, _clock.toc());
+}
+
+void CompileProfiler::set_enabled(bool enabled) noexcept {
+    detail::compile_profiler_enabled().store(enabled, std::memory_order_relaxed);
+}
+
+bool CompileProfiler::is_enabled() noexcept {
+    return detail::compile_profiler_enabled().load(std::memory_order_relaxed);
+}
+
+void CompileProfiler::set_callback(Callback callback) noexcept {
+    auto &&session = detail::compile_profiler_session();
+    std::scoped_lock lock{session.mutex};
+    session.callback = std::move(callback);
+}
+
+void CompileProfiler::phase(luisa::string_view name, double milliseconds) noexcept {
+    if (auto &&stack = detail::compile_profiler_stack(); !stack.empty()) {
+        stack.back().phases.emplace_back(ShaderCompileReport::Phase{
+            .name = luisa::string{name},
+            .milliseconds = milliseconds});
+    }
+}
+
+void CompileProfiler::counter(luisa::string_view name, uint64_t value) noexcept {
+    if (auto &&stack = detail::compile_profiler_stack(); !stack.empty()) {
+        stack.back().counters.emplace_back(ShaderCompileReport::Counter{
+            .name = luisa::string{name},
+            .value = value});
+    }
+}
+
+void CompileProfiler::cache(luisa::string_view layer, bool hit) noexcept {
+    if (auto &&stack = detail::compile_profiler_stack(); !stack.empty()) {
+        stack.back().cache_events.emplace_back(ShaderCompileReport::CacheEvent{
+            .layer = luisa::string{layer},
+            .hit = hit});
+    }
+}
+
+void CompileProfiler::record_trace(uint64_t hash, double milliseconds,
+                                   luisa::span<const ShaderCompileReport::Counter> counters) noexcept {
+    if (!is_enabled()) { return; }
+    ShaderCompileReport report;
+    report.phases.emplace_back(ShaderCompileReport::Phase{
+        .name = "trace",
+        .milliseconds = milliseconds});
+    report.counters.reserve(counters.size());
+    for (auto &&c : counters) { report.counters.emplace_back(c); }
+    auto &&session = detail::compile_profiler_session();
+    std::scoped_lock lock{session.mutex};
+    auto sequence = session.pending_sequence++;
+    session.pending_traces.insert_or_assign(hash, std::make_pair(sequence, std::move(report)));
+    session.pending_queue.emplace_back(hash, sequence);
+    while (session.pending_queue.size() > max_pending_traces) {
+        auto [oldest, oldest_sequence] = session.pending_queue.front();
+        session.pending_queue.pop_front();
+        // skip the entries that are consumed or re-recorded since
+        if (auto iter = session.pending_traces.find(oldest);
+            iter != session.pending_traces.end() && iter->second.first == oldest_sequence) {
+            session.pending_traces.erase(iter);
+        }
+    }
+}
+
+luisa::optional<ShaderCompileReport> CompileProfiler::last_report() noexcept {
+    return detail::compile_profiler_last_report();
+}
+
+luisa::vector<ShaderCompileReport> CompileProfiler::session_reports() noexcept {
+    auto &&session = detail::compile_profiler_session();
+    std::scoped_lock lock{session.mutex};
+    return session.reports;
+}
+
+luisa::string CompileProfiler::dump_session() noexcept {
+    auto reports = session_reports();
+    if (reports.empty()) { return "No shader compiled in this session."; }
+
+    // per-phase totals in the order phases are first seen
+    luisa::vector<std::pair<luisa::string, double>> phase_totals;
+    // per-layer (hits, lookups)
+    luisa::vector<std::pair<luisa::string, std::pair<size_t, size_t>>> cache_totals;
+    auto total_ms = 0.;
+    for (auto &&r : reports) {
+        total_ms += r.total_milliseconds;
+        for (auto &&p : r.phases) {
+            auto iter = std::find_if(phase_totals.begin(), phase_totals.end(),
+                                     [&p](auto &&t) noexcept { return t.first == p.name; });
+            if (iter == phase_totals.end()) {
+                phase_totals.emplace_back(p.name, p.milliseconds);
+            } else {
+                iter->second += p.milliseconds;
+            }
+        }
+        for (auto &&e : r.cache_events) {
+            auto iter = std::find_if(cache_totals.begin(), cache_totals.end(),
+                                     [&e](auto &&t) noexcept { return t.first == e.layer; });
+            if (iter == cache_totals.end()) {
+                cache_totals.emplace_back(e.layer, std::make_pair(0u, 0u));
+                iter = std::prev(cache_totals.end());
+            }
+            iter->second.first += e.hit ? 1u : 0u;
+            iter->second.second++;
+        }
+    }
+    auto s = luisa::format("Compiled {} shader(s) in {:.3f} ms.", reports.size(), total_ms);
+    for (auto &&[name, ms] : phase_totals) {
+        s.append(luisa::format("\n  phase {:<24} {:>12.3f} ms", name, ms));
+    }
+    for (auto &&[layer, count] : cache_totals) {
+        s.append(luisa::format("\n  cache {:<24} {:>5}/{:<5} hit(s)", layer, count.first, count.second));
+    }
+
+    // shaders sorted by total compile time, slowest first
+    std::stable_sort(reports.begin(), reports.end(), [](auto &&lhs, auto &&rhs) noexcept {
+        return lhs.total_milliseconds > rhs.total_milliseconds;
+    });
+    s.append("\n  shaders (slowest first):");
+    for (auto &&r : reports) {
+        s.append(luisa::format("\n    {:>12.3f} ms  {:<6} {} ({:016x})",
+                               r.total_milliseconds,
+                               r.cache_events.empty() ? "-" : (r.cache_hit() ? "hit" : "miss"),
+                               r.name, r.hash));
+    }
+    return s;
+}
+
+void CompileProfiler::clear_session() noexcept {
+    auto &&session = detail::compile_profiler_session();
+    std::scoped_lock lock{session.mutex};
+    session.reports.clear();
+    session.pending_traces.clear();
+    session.pending_queue.clear();
+}
+
+}// namespace luisa
@@ -31,6 +31,9 @@ FirstFit::~FirstFit() noexcept { _destroy(); }
 
 FirstFit::FirstFit(FirstFit &&another) noexcept
     : _alignment{another._alignment} {
+    _free_list._next = another._free_list._next;
+    _free_list._size = another._free_list._size;
+    another._free_list._size = 0u;// indicates move
 }
 
 FirstFit &FirstFit::operator=(FirstFit &&rhs) noexcept {
@@ -47,11 +50,11 @@ FirstFit &FirstFit::operator=(FirstFit &&rhs) noexcept {
 FirstFit::Node *FirstFit::allocate(size_t size) noexcept {
     // walk the free list
     for (auto p = &_free_list; p->_next != nullptr; p = p->_next) {
+        // compute aligned size
+        auto mask = _alignment - 1u;
+        auto aligned_size = (size & mask) == 0u ? size : (size & ~mask) + _alignment;
         // found available node
-        if (auto node = p->_next; node->_size > size) {
-            // compute aligned size
-            auto mask = _alignment - 1u;
-            auto aligned_size = (size & mask) == 0u ? size : (size & ~mask) + _alignment;
+        if (auto node = p->_next; node->_size >= aligned_size) {
             // has remaining size, split the node
             if (node->_size > aligned_size) {
                 auto alloc_node = detail::first_fit_node_pool().create();
@@ -145,6 +148,18 @@ inline void FirstFit::_destroy() noexcept {
     }
 }
 
+size_t FirstFit::free_size() const noexcept {
+    auto size = static_cast<size_t>(0u);
+    for (auto p = _free_list._next; p != nullptr; p = p->_next) { size += p->_size; }
+    return size;
+}
+
+size_t FirstFit::largest_free_size() const noexcept {
+    auto size = static_cast<size_t>(0u);
+    for (auto p = _free_list._next; p != nullptr; p = p->_next) { size = std::max(size, p->_size); }
+    return size;
+}
+
 luisa::string FirstFit::dump_free_list() const noexcept {
     luisa::string message{luisa::format("[head (size = {})]", size())};
     for (auto p = _free_list._next; p != nullptr; p = p->_next) {
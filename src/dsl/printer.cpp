@@ -2,11 +2,126 @@
 // Created by Mike Smith on 2022/2/13.
 //
 
+#include <thread>
+#include <condition_variable>
+
+#include <luisa/core/stl/queue.h>
 #include <luisa/runtime/device.h>
 #include <luisa/dsl/printer.h>
 
 namespace luisa::compute {
 
+struct Printer::Streaming {
+
+    struct Flush {
+        uint slot;
+        bool abort_on_error;
+    };
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    luisa::vector<luisa::vector<uint>> slots;
+    luisa::vector<uint> free_slots;
+    luisa::queue<Flush> pending;
+    bool printing{false};
+    bool stop{false};
+    std::thread thread;
+
+    Streaming(Printer *printer, size_t capacity) noexcept {
+        slots.reserve(streaming_slot_count);
+        for (auto i = 0u; i < streaming_slot_count; i++) {
+            slots.emplace_back(capacity);
+            free_slots.emplace_back(streaming_slot_count - 1u - i);
+        }
+        thread = std::thread{[this, printer] {
+            for (;;) {
+                Flush flush{};
+                {
+                    std::unique_lock lock{mutex};
+                    cv.wait(lock, [this] { return stop || !pending.empty(); });
+                    if (pending.empty()) { break; }
+                    flush = pending.front();
+                    pending.pop();
+                    printing = true;
+                }
+                printer->_print(slots[flush.slot], flush.abort_on_error);
+                {
+                    std::scoped_lock lock{mutex};
+                    free_slots.emplace_back(flush.slot);
+                    printing = false;
+                }
+                cv.notify_all();
+            }
+        }};
+    }
+
+    ~Streaming() noexcept {
+        {
+            std::unique_lock lock{mutex};
+            cv.wait(lock, [this] { return free_slots.size() == slots.size(); });
+            stop = true;
+        }
+        cv.notify_all();
+        thread.join();
+    }
+
+    [[nodiscard]] uint acquire() noexcept {
+        std::unique_lock lock{mutex};
+        cv.wait(lock, [this] { return !free_slots.empty(); });
+        auto slot = free_slots.back();
+        free_slots.pop_back();
+        return slot;
+    }
+
+    void release(uint slot) noexcept {
+        {
+            std::scoped_lock lock{mutex};
+            free_slots.emplace_back(slot);
+        }
+        cv.notify_all();
+    }
+
+    void submit(uint slot, bool abort_on_error) noexcept {
+        {
+            std::scoped_lock lock{mutex};
+            pending.push(Flush{slot, abort_on_error});
+        }
+        cv.notify_all();
+    }
+
+    void wait() noexcept {
+        std::unique_lock lock{mutex};
+        cv.wait(lock, [this] { return pending.empty() && !printing; });
+    }
+
+    // Owns a slot until the flush callback runs. If the callback is dropped
+    // without running (e.g., the command list is discarded), the slot is
+    // returned so that later flushes and the destructor do not wait for it.
+    class Ticket {
+
+    private:
+        Streaming *_streaming;
+        uint _slot;
+        bool _abort_on_error;
+
+    public:
+        Ticket(Streaming *streaming, uint slot, bool abort_on_error) noexcept
+            : _streaming{streaming}, _slot{slot}, _abort_on_error{abort_on_error} {}
+        Ticket(Ticket &&another) noexcept
+            : _streaming{std::exchange(another._streaming, nullptr)},
+              _slot{another._slot}, _abort_on_error{another._abort_on_error} {}
+        Ticket(const Ticket &) noexcept = delete;
+        Ticket &operator=(Ticket &&) noexcept = delete;
+        Ticket &operator=(const Ticket &) noexcept = delete;
+        ~Ticket() noexcept {
+            if (_streaming != nullptr) { _streaming->release(_slot); }
+        }
+        void submit() noexcept {
+            std::exchange(_streaming, nullptr)->submit(_slot, _abort_on_error);
+        }
+    };
+};
+
 Printer::Printer(Device &device, luisa::string_view name, size_t capacity) noexcept
     : _buffer{device.create_buffer<uint>(next_pow2(capacity))},
       _host_buffer(next_pow2(capacity)),
@@ -16,12 +131,37 @@ Printer::Printer(Device &device, luisa::string_view name, size_t capacity) noexc
     _logger.set_level(spdlog::level::trace);
 }
 
+Printer::~Printer() noexcept = default;
+
 luisa::unique_ptr<Command> Printer::reset() noexcept {
     _reset_called.store(true);
     static const auto zero = 0u;
     return _buffer.view(_buffer.size() - 1u, 1u).copy_from(&zero);
 }
 
+void Printer::_print(luisa::span<const uint> data, bool abort_on_error) noexcept {
+    std::scoped_lock lock{_items_mutex};
+    auto size = std::min(
+        static_cast<uint>(_buffer.size() - 1u),
+        data.back());
+    auto offset = 0u;
+    auto printed = 0u;
+    while (offset < size) {
+        auto record = data.data() + offset;
+        auto &&item = _items[record[0u]];
+        offset += item.size;
+        if (offset <= size) {
+            item.f(record, abort_on_error);
+            printed = offset;
+        }
+    }
+    if (printed < data.back()) [[unlikely]] {
+        LUISA_WARNING_WITH_LOCATION(
+            "Kernel log truncated ({} of {} words dropped).",
+            data.back() - printed, data.back());
+    }
+}
+
 std::tuple<luisa::unique_ptr<Command>,
            luisa::move_only_function<void()>,
            luisa::unique_ptr<Command>,
@@ -33,27 +173,34 @@ Printer::retrieve(bool abort_on_error) noexcept {
             "retrieved if never reset.");
     }
     auto print = [this, abort_on_error] {
-        auto size = std::min(
-            static_cast<uint>(_buffer.size() - 1u),
-            _host_buffer.back());
-        auto offset = 0u;
-        auto truncated = _host_buffer.back() > size;
-        while (offset < size) {
-            auto data = _host_buffer.data() + offset;
-            auto &&item = _items[data[0u]];
-            offset += item.size;
-            if (offset > size) {
-                truncated = true;
-            } else {
-                item.f(data, abort_on_error);
-            }
-        }
-        if (truncated) [[unlikely]] {
-            LUISA_WARNING_WITH_LOCATION("Kernel log truncated.");
-        }
+        _print(_host_buffer, abort_on_error);
     };
     auto copy = _buffer.copy_to(_host_buffer.data());
     return {std::move(copy), print, reset(), synchronize()};
 }
 
+std::tuple<luisa::unique_ptr<Command>,
+           luisa::move_only_function<void()>,
+           luisa::unique_ptr<Command>>
+Printer::flush(bool abort_on_error) noexcept {
+    if (!_reset_called.load()) [[unlikely]] {
+        LUISA_ERROR_WITH_LOCATION(
+            "Printer results cannot be "
+            "flushed if never reset.");
+    }
+    if (_streaming == nullptr) {
+        _streaming = luisa::make_unique<Streaming>(this, _host_buffer.size());
+    }
+    auto slot = _streaming->acquire();
+    auto copy = _buffer.copy_to(_streaming->slots[slot].data());
+    auto print = [ticket = Streaming::Ticket{_streaming.get(), slot, abort_on_error}]() mutable noexcept {
+        ticket.submit();
+    };
+    return {std::move(copy), std::move(print), reset()};
+}
+
+void Printer::wait_flushed() noexcept {
+    if (_streaming != nullptr) { _streaming->wait(); }
+}
+
 }// namespace luisa::compute
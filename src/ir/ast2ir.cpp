@@ -623,6 +623,27 @@ ir::NodeRef AST2IR::_convert(const CallExpr *expr) noexcept {
             case CallOp::TRANSPOSE: return ir::Func::Tag::Transpose;
             case CallOp::INVERSE: return ir::Func::Tag::Inverse;
             case CallOp::SYNCHRONIZE_BLOCK: return ir::Func::Tag::SynchronizeBlock;
+            case CallOp::WARP_SIZE: return ir::Func::Tag::WarpSize;
+            case CallOp::WARP_LANE_ID: return ir::Func::Tag::WarpLaneId;
+            case CallOp::WARP_IS_FIRST_ACTIVE_LANE: return ir::Func::Tag::WarpIsFirstActiveLane;
+            case CallOp::WARP_FIRST_ACTIVE_LANE: return ir::Func::Tag::WarpFirstActiveLane;
+            case CallOp::WARP_ACTIVE_ALL_EQUAL: return ir::Func::Tag::WarpActiveAllEqual;
+            case CallOp::WARP_ACTIVE_BIT_AND: return ir::Func::Tag::WarpActiveBitAnd;
+            case CallOp::WARP_ACTIVE_BIT_OR: return ir::Func::Tag::WarpActiveBitOr;
+            case CallOp::WARP_ACTIVE_BIT_XOR: return ir::Func::Tag::WarpActiveBitXor;
+            case CallOp::WARP_ACTIVE_COUNT_BITS: return ir::Func::Tag::WarpActiveCountBits;
+            case CallOp::WARP_ACTIVE_MAX: return ir::Func::Tag::WarpActiveMax;
+            case CallOp::WARP_ACTIVE_MIN: return ir::Func::Tag::WarpActiveMin;
+            case CallOp::WARP_ACTIVE_PRODUCT: return ir::Func::Tag::WarpActiveProduct;
+            case CallOp::WARP_ACTIVE_SUM: return ir::Func::Tag::WarpActiveSum;
+            case CallOp::WARP_ACTIVE_ALL: return ir::Func::Tag::WarpActiveAll;
+            case CallOp::WARP_ACTIVE_ANY: return ir::Func::Tag::WarpActiveAny;
+            case CallOp::WARP_ACTIVE_BIT_MASK: return ir::Func::Tag::WarpActiveBitMask;
+            case CallOp::WARP_PREFIX_COUNT_BITS: return ir::Func::Tag::WarpPrefixCountBits;
+            case CallOp::WARP_PREFIX_SUM: return ir::Func::Tag::WarpPrefixSum;
+            case CallOp::WARP_PREFIX_PRODUCT: return ir::Func::Tag::WarpPrefixProduct;
+            case CallOp::WARP_READ_LANE: return ir::Func::Tag::WarpReadLaneAt;
+            case CallOp::WARP_READ_FIRST_ACTIVE_LANE: return ir::Func::Tag::WarpReadFirstLane;
             case CallOp::ATOMIC_EXCHANGE: return ir::Func::Tag::AtomicExchange;
             case CallOp::ATOMIC_COMPARE_EXCHANGE: return ir::Func::Tag::AtomicCompareExchange;
             case CallOp::ATOMIC_FETCH_ADD: return ir::Func::Tag::AtomicFetchAdd;
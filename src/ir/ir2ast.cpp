@@ -473,6 +473,27 @@ const Expression *IR2AST::_convert_instr_call(const ir::Node *node) noexcept {
         case ir::Func::Tag::Transpose: return builtin_func(1, CallOp::TRANSPOSE);
         case ir::Func::Tag::Inverse: return builtin_func(1, CallOp::INVERSE);
         case ir::Func::Tag::SynchronizeBlock: return builtin_func(0, CallOp::SYNCHRONIZE_BLOCK);
+        case ir::Func::Tag::WarpSize: return builtin_func(0, CallOp::WARP_SIZE);
+        case ir::Func::Tag::WarpLaneId: return builtin_func(0, CallOp::WARP_LANE_ID);
+        case ir::Func::Tag::WarpIsFirstActiveLane: return builtin_func(0, CallOp::WARP_IS_FIRST_ACTIVE_LANE);
+        case ir::Func::Tag::WarpFirstActiveLane: return builtin_func(0, CallOp::WARP_FIRST_ACTIVE_LANE);
+        case ir::Func::Tag::WarpActiveAllEqual: return builtin_func(1, CallOp::WARP_ACTIVE_ALL_EQUAL);
+        case ir::Func::Tag::WarpActiveBitAnd: return builtin_func(1, CallOp::WARP_ACTIVE_BIT_AND);
+        case ir::Func::Tag::WarpActiveBitOr: return builtin_func(1, CallOp::WARP_ACTIVE_BIT_OR);
+        case ir::Func::Tag::WarpActiveBitXor: return builtin_func(1, CallOp::WARP_ACTIVE_BIT_XOR);
+        case ir::Func::Tag::WarpActiveCountBits: return builtin_func(1, CallOp::WARP_ACTIVE_COUNT_BITS);
+        case ir::Func::Tag::WarpActiveMax: return builtin_func(1, CallOp::WARP_ACTIVE_MAX);
+        case ir::Func::Tag::WarpActiveMin: return builtin_func(1, CallOp::WARP_ACTIVE_MIN);
+        case ir::Func::Tag::WarpActiveProduct: return builtin_func(1, CallOp::WARP_ACTIVE_PRODUCT);
+        case ir::Func::Tag::WarpActiveSum: return builtin_func(1, CallOp::WARP_ACTIVE_SUM);
+        case ir::Func::Tag::WarpActiveAll: return builtin_func(1, CallOp::WARP_ACTIVE_ALL);
+        case ir::Func::Tag::WarpActiveAny: return builtin_func(1, CallOp::WARP_ACTIVE_ANY);
+        case ir::Func::Tag::WarpActiveBitMask: return builtin_func(1, CallOp::WARP_ACTIVE_BIT_MASK);
+        case ir::Func::Tag::WarpPrefixCountBits: return builtin_func(1, CallOp::WARP_PREFIX_COUNT_BITS);
+        case ir::Func::Tag::WarpPrefixSum: return builtin_func(1, CallOp::WARP_PREFIX_SUM);
+        case ir::Func::Tag::WarpPrefixProduct: return builtin_func(1, CallOp::WARP_PREFIX_PRODUCT);
+        case ir::Func::Tag::WarpReadLaneAt: return builtin_func(2, CallOp::WARP_READ_LANE);
+        case ir::Func::Tag::WarpReadFirstLane: return builtin_func(1, CallOp::WARP_READ_FIRST_ACTIVE_LANE);
         case ir::Func::Tag::AtomicExchange: return builtin_func(3, CallOp::ATOMIC_EXCHANGE);
         case ir::Func::Tag::AtomicCompareExchange: return builtin_func(4, CallOp::ATOMIC_COMPARE_EXCHANGE);
         case ir::Func::Tag::AtomicFetchAdd: return builtin_func(3, CallOp::ATOMIC_FETCH_ADD);
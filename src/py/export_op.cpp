@@ -211,6 +211,29 @@ void export_op(py::module &m) {
         .value("RAY_QUERY_COMMIT_PROCEDURAL", CallOp::RAY_QUERY_COMMIT_PROCEDURAL)
         .value("RAY_QUERY_TERMINATE", CallOp::RAY_QUERY_TERMINATE)
 
+        // warp operations
+        .value("WARP_SIZE", CallOp::WARP_SIZE)
+        .value("WARP_LANE_ID", CallOp::WARP_LANE_ID)
+        .value("WARP_IS_FIRST_ACTIVE_LANE", CallOp::WARP_IS_FIRST_ACTIVE_LANE)
+        .value("WARP_FIRST_ACTIVE_LANE", CallOp::WARP_FIRST_ACTIVE_LANE)
+        .value("WARP_ACTIVE_ALL_EQUAL", CallOp::WARP_ACTIVE_ALL_EQUAL)
+        .value("WARP_ACTIVE_BIT_AND", CallOp::WARP_ACTIVE_BIT_AND)
+        .value("WARP_ACTIVE_BIT_OR", CallOp::WARP_ACTIVE_BIT_OR)
+        .value("WARP_ACTIVE_BIT_XOR", CallOp::WARP_ACTIVE_BIT_XOR)
+        .value("WARP_ACTIVE_COUNT_BITS", CallOp::WARP_ACTIVE_COUNT_BITS)
+        .value("WARP_ACTIVE_MAX", CallOp::WARP_ACTIVE_MAX)
+        .value("WARP_ACTIVE_MIN", CallOp::WARP_ACTIVE_MIN)
+        .value("WARP_ACTIVE_PRODUCT", CallOp::WARP_ACTIVE_PRODUCT)
+        .value("WARP_ACTIVE_SUM", CallOp::WARP_ACTIVE_SUM)
+        .value("WARP_ACTIVE_ALL", CallOp::WARP_ACTIVE_ALL)
+        .value("WARP_ACTIVE_ANY", CallOp::WARP_ACTIVE_ANY)
+        .value("WARP_ACTIVE_BIT_MASK", CallOp::WARP_ACTIVE_BIT_MASK)
+        .value("WARP_PREFIX_COUNT_BITS", CallOp::WARP_PREFIX_COUNT_BITS)
+        .value("WARP_PREFIX_SUM", CallOp::WARP_PREFIX_SUM)
+        .value("WARP_PREFIX_PRODUCT", CallOp::WARP_PREFIX_PRODUCT)
+        .value("WARP_READ_LANE", CallOp::WARP_READ_LANE)
+        .value("WARP_READ_FIRST_ACTIVE_LANE", CallOp::WARP_READ_FIRST_ACTIVE_LANE)
+
         .value("RAY_TRACING_INSTANCE_TRANSFORM", CallOp::RAY_TRACING_INSTANCE_TRANSFORM)
         .value("RAY_TRACING_SET_INSTANCE_TRANSFORM", CallOp::RAY_TRACING_SET_INSTANCE_TRANSFORM)
         .value("RAY_TRACING_SET_INSTANCE_VISIBILITY", CallOp::RAY_TRACING_SET_INSTANCE_VISIBILITY)
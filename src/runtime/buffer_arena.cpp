@@ -0,0 +1,197 @@
+#include <bit>
+#include <algorithm>
+#include <thread>
+
+#include <luisa/core/logging.h>
+#include <luisa/core/first_fit.h>
+#include <luisa/runtime/command_list.h>
+#include <luisa/runtime/buffer_arena.h>
+
+namespace luisa::compute {
+
+struct BufferArena::Page {
+    Buffer<float4> buffer;
+    FirstFit allocator;
+    luisa::unordered_map<size_t, FirstFit::Node *> blocks;// offset -> node
+};
+
+namespace detail {
+
+[[nodiscard]] static auto buffer_arena_size_class(size_t size_bytes) noexcept {
+    auto size = std::max(next_pow2(size_bytes), BufferArena::block_alignment);
+    return static_cast<uint>(std::bit_width(size / BufferArena::block_alignment) - 1u);
+}
+
+[[nodiscard]] static auto buffer_arena_block_size(size_t size_bytes) noexcept {
+    if (size_bytes <= BufferArena::small_block_max) {
+        return BufferArena::block_alignment << buffer_arena_size_class(size_bytes);
+    }
+    return (size_bytes + BufferArena::block_alignment - 1u) &
+           ~(BufferArena::block_alignment - 1u);
+}
+
+[[nodiscard]] static auto buffer_arena_thread_cache_index() noexcept {
+    return std::hash<std::thread::id>{}(std::this_thread::get_id()) %
+           BufferArena::thread_cache_count;
+}
+
+}// namespace detail
+
+BufferArena::BufferArena(Device &device, size_t capacity) noexcept
+    : _device{device}, _page_size{std::max(next_pow2(capacity), 64_k)} {}
+
+BufferArena::~BufferArena() noexcept {
+    // the pages are destroyed as a whole, so their free lists need not be restored
+    for (auto &&page : _pages) {
+        for (auto &&[offset, node] : page->blocks) { page->allocator.free(node); }
+    }
+}
+
+BufferView<float4> BufferArena::_allocate(size_t size_bytes) noexcept {
+    auto block_size = detail::buffer_arena_block_size(std::max<size_t>(size_bytes, 1u));
+    _allocated_bytes.fetch_add(block_size, std::memory_order_relaxed);
+    if (block_size <= small_block_max) {
+        // look into this thread's cache first, then steal from the others
+        auto size_class = detail::buffer_arena_size_class(block_size);
+        auto first = detail::buffer_arena_thread_cache_index();
+        for (auto i = 0u; i < thread_cache_count; i++) {
+            auto &cache = _thread_caches[(first + i) % thread_cache_count];
+            std::scoped_lock lock{cache.mutex};
+            if (auto &blocks = cache.blocks[size_class]; !blocks.empty()) {
+                auto block = blocks.back();
+                blocks.pop_back();
+                _cached_bytes.fetch_sub(block_size, std::memory_order_relaxed);
+                return block;
+            }
+        }
+    }
+    std::scoped_lock lock{_mutex};
+    if (block_size > _page_size) {// too big, will not use the pages
+        auto buffer = luisa::make_unique<Buffer<float4>>(
+            _device.create_buffer<float4>(block_size / sizeof(float4)));
+        auto view = buffer->view();
+        _dedicated_buffers.emplace(view.handle(), std::move(buffer));
+        return view;
+    }
+    return _allocate_from_pages(block_size);
+}
+
+BufferView<float4> BufferArena::_allocate_from_pages(size_t block_size) noexcept {
+    auto carve = [block_size](Page &page) noexcept -> luisa::optional<BufferView<float4>> {
+        auto node = page.allocator.allocate(block_size);
+        if (node == nullptr) { return luisa::nullopt; }
+        page.blocks.emplace(node->offset(), node);
+        return page.buffer.view(node->offset() / sizeof(float4),
+                                block_size / sizeof(float4));
+    };
+    for (auto &&page : _pages) {
+        if (auto block = carve(*page)) { return *block; }
+    }
+    auto page = luisa::make_unique<Page>(Page{
+        .buffer = _device.create_buffer<float4>(_page_size / sizeof(float4)),
+        .allocator = FirstFit{_page_size, block_alignment}});
+    auto block = carve(*page);
+    LUISA_ASSERT(block.has_value(), "Failed to allocate {} bytes from a new arena page.", block_size);
+    _pages.emplace_back(std::move(page));
+    return *block;
+}
+
+void BufferArena::_free(uint64_t handle, size_t offset_bytes, size_t size_bytes) noexcept {
+    auto block_size = detail::buffer_arena_block_size(std::max<size_t>(size_bytes, 1u));
+    _allocated_bytes.fetch_sub(block_size, std::memory_order_relaxed);
+    if (block_size <= small_block_max) {
+        auto size_class = detail::buffer_arena_size_class(block_size);
+        auto &cache = _thread_caches[detail::buffer_arena_thread_cache_index()];
+        BufferView<float4> block{_device.impl(), handle, sizeof(float4), offset_bytes,
+                                 block_size / sizeof(float4), _page_size / sizeof(float4)};
+        std::scoped_lock lock{cache.mutex};
+        cache.blocks[size_class].emplace_back(block);
+        _cached_bytes.fetch_add(block_size, std::memory_order_relaxed);
+        return;
+    }
+    std::scoped_lock lock{_mutex};
+    if (block_size > _page_size) {
+        if (_dedicated_buffers.erase(handle) == 0u) [[unlikely]] {
+            LUISA_ERROR_WITH_LOCATION(
+                "Buffer #{} was not allocated from the arena.", handle);
+        }
+        return;
+    }
+    _free_to_page(handle, offset_bytes);
+}
+
+void BufferArena::_free_to_page(uint64_t handle, size_t offset_bytes) noexcept {
+    auto page = std::find_if(_pages.begin(), _pages.end(), [handle](auto &&p) noexcept {
+        return p->buffer.handle() == handle;
+    });
+    if (page == _pages.end()) [[unlikely]] {
+        LUISA_ERROR_WITH_LOCATION(
+            "Buffer #{} is not an arena page.", handle);
+    }
+    auto iter = (*page)->blocks.find(offset_bytes);
+    if (iter == (*page)->blocks.end()) [[unlikely]] {
+        LUISA_ERROR_WITH_LOCATION(
+            "No arena block at offset {} of buffer #{}.",
+            offset_bytes, handle);
+    }
+    (*page)->allocator.free(iter->second);
+    (*page)->blocks.erase(iter);
+}
+
+void BufferArena::_add_transient(BufferView<float4> block) noexcept {
+    std::scoped_lock lock{_mutex};
+    _transient_blocks.emplace_back(block);
+}
+
+void BufferArena::end_frame(CommandList &list) noexcept {
+    luisa::vector<BufferView<float4>> blocks;
+    {
+        std::scoped_lock lock{_mutex};
+        blocks.swap(_transient_blocks);
+    }
+    if (blocks.empty()) { return; }
+    list.add_callback([this, blocks = std::move(blocks)] {
+        for (auto block : blocks) {
+            _free(block.handle(), block.offset_bytes(), block.size_bytes());
+        }
+    });
+}
+
+void BufferArena::shrink() noexcept {
+    std::scoped_lock lock{_mutex};
+    for (auto &&cache : _thread_caches) {
+        std::scoped_lock cache_lock{cache.mutex};
+        for (auto &&blocks : cache.blocks) {
+            for (auto block : blocks) {
+                _free_to_page(block.handle(), block.offset_bytes());
+                _cached_bytes.fetch_sub(block.size_bytes(), std::memory_order_relaxed);
+            }
+            blocks.clear();
+        }
+    }
+    _pages.erase(std::remove_if(_pages.begin(), _pages.end(), [](auto &&page) noexcept {
+                     return page->blocks.empty();
+                 }),
+                 _pages.end());
+}
+
+BufferArena::Statistics BufferArena::statistics() noexcept {
+    std::scoped_lock lock{_mutex};
+    Statistics stats{};
+    for (auto &&page : _pages) {
+        stats.page_free_bytes += page->allocator.free_size();
+        stats.largest_page_free_bytes = std::max(
+            stats.largest_page_free_bytes, page->allocator.largest_free_size());
+    }
+    stats.page_count = _pages.size();
+    stats.dedicated_buffer_count = _dedicated_buffers.size();
+    stats.reserved_bytes = _page_size * _pages.size();
+    for (auto &&[handle, buffer] : _dedicated_buffers) {
+        stats.reserved_bytes += buffer->size_bytes();
+    }
+    stats.allocated_bytes = _allocated_bytes.load(std::memory_order_relaxed);
+    stats.cached_bytes = _cached_bytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+}// namespace luisa::compute
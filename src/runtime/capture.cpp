@@ -0,0 +1,716 @@
+#include <luisa/core/clock.h>
+#include <luisa/core/logging.h>
+#include <luisa/core/magic_enum.h>
+#include <luisa/ast/function_builder.h>
+#include <luisa/ast/function_serializer.h>
+#include <luisa/runtime/rhi/command_encoder.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/capture.h>
+
+namespace luisa::compute {
+
+CaptureWriter::CaptureWriter(const luisa::filesystem::path &path) noexcept
+    : _file{path, std::ios::binary | std::ios::trunc} {
+    if (!_file) {
+        LUISA_ERROR_WITH_LOCATION("Failed to open capture file '{}'.", to_string(path));
+    }
+    _file.write(reinterpret_cast<const char *>(&magic), sizeof(magic));
+    _file.write(reinterpret_cast<const char *>(&version), sizeof(version));
+    LUISA_INFO("Capturing device calls to '{}'.", to_string(path));
+}
+
+CaptureWriter::~CaptureWriter() noexcept { flush(); }
+
+void CaptureWriter::_write_raw(const void *data, size_t size) noexcept {
+    auto p = static_cast<const std::byte *>(data);
+    _payload.insert(_payload.end(), p, p + size);
+}
+
+void CaptureWriter::_write(luisa::string_view s) noexcept {
+    _write(static_cast<uint64_t>(s.size()));
+    _write_raw(s.data(), s.size());
+}
+
+void CaptureWriter::_write(luisa::span<const std::byte> bytes) noexcept {
+    _write(static_cast<uint64_t>(bytes.size()));
+    _write_raw(bytes.data(), bytes.size());
+}
+
+void CaptureWriter::_commit(CaptureOp op) noexcept {
+    auto size = static_cast<uint64_t>(_payload.size());
+    _file.write(reinterpret_cast<const char *>(&op), sizeof(op));
+    _file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+    _file.write(reinterpret_cast<const char *>(_payload.data()), static_cast<std::streamsize>(size));
+    _payload.clear();
+}
+
+void CaptureWriter::flush() noexcept {
+    std::scoped_lock lock{_mutex};
+    _file.flush();
+}
+
+void CaptureWriter::record_buffer(uint64_t handle, const Type *element, size_t element_count) noexcept {
+    record(CaptureOp::CREATE_BUFFER, handle, element->description(), static_cast<uint64_t>(element_count));
+}
+
+void CaptureWriter::record_shader(uint64_t handle, const ShaderOption &option, Function kernel) noexcept {
+    auto blob = FunctionSerializer::serialize(kernel);
+    record(CaptureOp::CREATE_SHADER, handle,
+           option.enable_fast_math, option.enable_debug_info,
+           luisa::string_view{option.name}, luisa::string_view{option.native_include},
+           luisa::span<const std::byte>{blob});
+}
+
+void CaptureWriter::record_shader(uint64_t handle, luisa::string_view name, luisa::span<const Type *const> arg_types) noexcept {
+    std::scoped_lock lock{_mutex};
+    _write(handle);
+    _write(name);
+    _write(static_cast<uint64_t>(arg_types.size()));
+    for (auto t : arg_types) { _write(t->description()); }
+    _commit(CaptureOp::LOAD_SHADER);
+}
+
+namespace detail {
+
+template<typename T>
+[[nodiscard]] static auto capture_bytes(luisa::span<const T> s) noexcept {
+    return luisa::span{reinterpret_cast<const std::byte *>(s.data()), s.size_bytes()};
+}
+
+}// namespace detail
+
+void CaptureWriter::_write_command(const Command *command) noexcept {
+    _write(command->tag());
+    switch (command->tag()) {
+        case Command::Tag::EBufferUploadCommand: {
+            auto cmd = static_cast<const BufferUploadCommand *>(command);
+            _write(cmd->handle());
+            _write(cmd->offset());
+            _write(luisa::span{static_cast<const std::byte *>(cmd->data()), cmd->size()});
+            break;
+        }
+        case Command::Tag::EBufferDownloadCommand: {
+            auto cmd = static_cast<const BufferDownloadCommand *>(command);
+            _write(cmd->handle());
+            _write(cmd->offset());
+            _write(cmd->size());
+            break;
+        }
+        case Command::Tag::EBufferCopyCommand: {
+            auto cmd = static_cast<const BufferCopyCommand *>(command);
+            _write(cmd->src_handle());
+            _write(cmd->dst_handle());
+            _write(cmd->src_offset());
+            _write(cmd->dst_offset());
+            _write(cmd->size());
+            break;
+        }
+        case Command::Tag::EBufferToTextureCopyCommand: {
+            auto cmd = static_cast<const BufferToTextureCopyCommand *>(command);
+            _write(cmd->buffer());
+            _write(cmd->buffer_offset());
+            _write(cmd->texture());
+            _write(cmd->storage());
+            _write(cmd->level());
+            _write(cmd->size());
+            _write(cmd->texture_offset());
+            break;
+        }
+        case Command::Tag::ETextureToBufferCopyCommand: {
+            auto cmd = static_cast<const TextureToBufferCopyCommand *>(command);
+            _write(cmd->buffer());
+            _write(cmd->buffer_offset());
+            _write(cmd->texture());
+            _write(cmd->storage());
+            _write(cmd->level());
+            _write(cmd->size());
+            _write(cmd->texture_offset());
+            break;
+        }
+        case Command::Tag::ETextureCopyCommand: {
+            auto cmd = static_cast<const TextureCopyCommand *>(command);
+            auto src_offset = cmd->src_offset();
+            auto dst_offset = cmd->dst_offset();
+            _write(cmd->storage());
+            _write(cmd->src_handle());
+            _write(cmd->dst_handle());
+            _write(cmd->src_level());
+            _write(cmd->dst_level());
+            _write(cmd->size());
+            _write(make_uint3(src_offset[0], src_offset[1], src_offset[2]));
+            _write(make_uint3(dst_offset[0], dst_offset[1], dst_offset[2]));
+            break;
+        }
+        case Command::Tag::ETextureUploadCommand: {
+            auto cmd = static_cast<const TextureUploadCommand *>(command);
+            _write(cmd->handle());
+            _write(cmd->storage());
+            _write(cmd->level());
+            _write(cmd->size());
+            _write(cmd->offset());
+            _write(luisa::span{static_cast<const std::byte *>(cmd->data()),
+                               pixel_storage_size(cmd->storage(), cmd->size())});
+            break;
+        }
+        case Command::Tag::ETextureDownloadCommand: {
+            auto cmd = static_cast<const TextureDownloadCommand *>(command);
+            _write(cmd->handle());
+            _write(cmd->storage());
+            _write(cmd->level());
+            _write(cmd->size());
+            _write(cmd->offset());
+            break;
+        }
+        case Command::Tag::EShaderDispatchCommand: {
+            auto cmd = static_cast<const ShaderDispatchCommand *>(command);
+            _write(cmd->handle());
+            _write(static_cast<uint64_t>(cmd->arguments().size()));
+            for (auto &&arg : cmd->arguments()) {
+                _write(arg.tag);
+                switch (arg.tag) {
+                    case Argument::Tag::BUFFER: _write(arg.buffer); break;
+                    case Argument::Tag::TEXTURE: _write(arg.texture); break;
+                    case Argument::Tag::UNIFORM: _write(cmd->uniform(arg.uniform)); break;
+                    case Argument::Tag::BINDLESS_ARRAY: _write(arg.bindless_array); break;
+                    case Argument::Tag::ACCEL: _write(arg.accel); break;
+                }
+            }
+            _write(cmd->is_indirect());
+            if (cmd->is_indirect()) {
+                _write(cmd->indirect_dispatch());
+            } else {
+                _write(cmd->dispatch_size());
+            }
+            break;
+        }
+        case Command::Tag::EMeshBuildCommand: {
+            auto cmd = static_cast<const MeshBuildCommand *>(command);
+            _write(cmd->handle());
+            _write(cmd->request());
+            _write(cmd->vertex_buffer());
+            _write(cmd->vertex_buffer_offset());
+            _write(cmd->vertex_buffer_size());
+            _write(cmd->vertex_stride());
+            _write(cmd->triangle_buffer());
+            _write(cmd->triangle_buffer_offset());
+            _write(cmd->triangle_buffer_size());
+            _write(cmd->vertex_format());
+            _write(cmd->index_format());
+            break;
+        }
+        case Command::Tag::EProceduralPrimitiveBuildCommand: {
+            auto cmd = static_cast<const ProceduralPrimitiveBuildCommand *>(command);
+            _write(cmd->handle());
+            _write(cmd->request());
+            _write(cmd->aabb_buffer());
+            _write(cmd->aabb_buffer_offset());
+            _write(cmd->aabb_buffer_size());
+            break;
+        }
+        case Command::Tag::EAccelBuildCommand: {
+            auto cmd = static_cast<const AccelBuildCommand *>(command);
+            _write(cmd->handle());
+            _write(cmd->instance_count());
+            _write(cmd->request());
+            _write(cmd->update_instance_buffer_only());
+            _write(detail::capture_bytes(cmd->modifications()));
+            break;
+        }
+        case Command::Tag::EBindlessArrayUpdateCommand: {
+            auto cmd = static_cast<const BindlessArrayUpdateCommand *>(command);
+            _write(cmd->handle());
+            _write(detail::capture_bytes(cmd->modifications()));
+            break;
+        }
+        default: LUISA_ERROR_WITH_LOCATION("Unsupported command in capture.");
+    }
+}
+
+void CaptureWriter::record_dispatch(uint64_t stream_handle, const CommandList &list) noexcept {
+    auto count = static_cast<uint64_t>(0u);
+    for (auto &&command : list.commands()) {
+        if (command->tag() == Command::Tag::ECustomCommand) {
+            LUISA_WARNING_WITH_LOCATION(
+                "Custom command (uuid = {}) is not captured.",
+                static_cast<const CustomCommand *>(command.get())->uuid());
+        } else {
+            count++;
+        }
+    }
+    std::scoped_lock lock{_mutex};
+    _write(stream_handle);
+    _write(count);
+    for (auto &&command : list.commands()) {
+        if (command->tag() != Command::Tag::ECustomCommand) {
+            _write_command(command.get());
+        }
+    }
+    _commit(CaptureOp::DISPATCH);
+}
+
+namespace detail {
+
+class CaptureReader {
+
+private:
+    luisa::span<const std::byte> _bytes;
+    size_t _offset{0u};
+
+public:
+    explicit CaptureReader(luisa::span<const std::byte> bytes) noexcept : _bytes{bytes} {}
+    [[nodiscard]] auto eof() const noexcept { return _offset >= _bytes.size(); }
+    [[nodiscard]] auto offset() const noexcept { return _offset; }
+    [[nodiscard]] luisa::span<const std::byte> read_raw(size_t size) noexcept {
+        LUISA_ASSERT(_offset + size <= _bytes.size(), "Unexpected end of capture.");
+        auto s = _bytes.subspan(_offset, size);
+        _offset += size;
+        return s;
+    }
+    template<typename T>
+    [[nodiscard]] T read() noexcept {
+        T x;
+        std::memcpy(&x, read_raw(sizeof(T)).data(), sizeof(T));
+        return x;
+    }
+    [[nodiscard]] luisa::span<const std::byte> read_bytes() noexcept {
+        return read_raw(read<uint64_t>());
+    }
+    [[nodiscard]] luisa::string_view read_string() noexcept {
+        auto bytes = read_bytes();
+        return {reinterpret_cast<const char *>(bytes.data()), bytes.size()};
+    }
+    template<typename T>
+    [[nodiscard]] luisa::vector<T> read_array() noexcept {
+        auto bytes = read_bytes();
+        LUISA_ASSERT(bytes.size() % sizeof(T) == 0u, "Invalid array in capture.");
+        luisa::vector<T> v;
+        v.resize_uninitialized(bytes.size() / sizeof(T));
+        std::memcpy(v.data(), bytes.data(), bytes.size());
+        return v;
+    }
+};
+
+}// namespace detail
+
+CaptureReplayer::CaptureReplayer(const Device &device) noexcept
+    : _device{device.impl()} {}
+
+CaptureReplayer::~CaptureReplayer() noexcept = default;
+
+uint64_t CaptureReplayer::_remap(uint64_t handle) const noexcept {
+    auto iter = _handles.find(handle);
+    LUISA_ASSERT(iter != _handles.end(),
+                 "Resource #{} is used by the capture but was not captured.",
+                 handle);
+    return iter->second;
+}
+
+void CaptureReplayer::_add(uint64_t captured, uint64_t replayed, CaptureOp op) noexcept {
+    _handles.insert_or_assign(captured, replayed);
+    _live.insert_or_assign(replayed, op);
+}
+
+uint64_t CaptureReplayer::_remove(uint64_t captured) noexcept {
+    auto replayed = _remap(captured);
+    _handles.erase(captured);
+    _live.erase(replayed);
+    return replayed;
+}
+
+void CaptureReplayer::_destroy(uint64_t handle, CaptureOp op) noexcept {
+    switch (op) {
+        case CaptureOp::CREATE_BUFFER: _device->destroy_buffer(handle); break;
+        case CaptureOp::CREATE_TEXTURE: _device->destroy_texture(handle); break;
+        case CaptureOp::CREATE_BINDLESS_ARRAY: _device->destroy_bindless_array(handle); break;
+        case CaptureOp::CREATE_STREAM: _device->destroy_stream(handle); break;
+        case CaptureOp::CREATE_SHADER: _device->destroy_shader(handle); break;
+        case CaptureOp::CREATE_EVENT: _device->destroy_event(handle); break;
+        case CaptureOp::CREATE_MESH: _device->destroy_mesh(handle); break;
+        case CaptureOp::CREATE_PROCEDURAL_PRIMITIVE: _device->destroy_procedural_primitive(handle); break;
+        case CaptureOp::CREATE_ACCEL: _device->destroy_accel(handle); break;
+        default: break;
+    }
+}
+
+CaptureReplayer::Statistics CaptureReplayer::replay(const luisa::filesystem::path &path) noexcept {
+    std::ifstream file{path, std::ios::binary | std::ios::ate};
+    if (!file) { LUISA_ERROR_WITH_LOCATION("Failed to open capture file '{}'.", to_string(path)); }
+    _data.resize_uninitialized(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(_data.data()), static_cast<std::streamsize>(_data.size()));
+    file.close();
+
+    detail::CaptureReader r{_data};
+    LUISA_ASSERT(r.read<uint32_t>() == CaptureWriter::magic, "Invalid capture file '{}'.", to_string(path));
+    if (auto v = r.read<uint32_t>(); v != CaptureWriter::version) {
+        LUISA_ERROR_WITH_LOCATION("Capture version mismatch (expected {} but got {}).",
+                                  CaptureWriter::version, v);
+    }
+
+    Statistics stats{};
+    Clock clock;
+    auto setup_begin = 0.;
+    auto frame_begin = 0.;
+    auto frame_setup = 0.;
+    auto frame_pending = false;
+    auto end_frame = [&] {
+        auto now = clock.toc();
+        stats.frame_milliseconds.emplace_back(now - frame_begin - frame_setup);
+        frame_begin = now;
+        frame_setup = 0.;
+        frame_pending = false;
+    };
+    auto begin_setup = [&] { setup_begin = clock.toc(); };
+    auto end_setup = [&] {
+        auto elapsed = clock.toc() - setup_begin;
+        stats.setup_milliseconds += elapsed;
+        frame_setup += elapsed;
+    };
+    auto remap_function = [this](uint64_t handle) noexcept { return _remap(handle); };
+
+    while (!r.eof()) {
+        auto op = r.read<CaptureOp>();
+        auto payload = r.read_raw(r.read<uint64_t>());
+        detail::CaptureReader p{payload};
+        stats.record_count++;
+        switch (op) {
+            case CaptureOp::CREATE_BUFFER: {
+                begin_setup();
+                auto handle = p.read<uint64_t>();
+                auto type = Type::from(p.read_string());
+                auto count = p.read<uint64_t>();
+                _add(handle, _device->create_buffer(type, count).handle, op);
+                end_setup();
+                break;
+            }
+            case CaptureOp::CREATE_TEXTURE: {
+                begin_setup();
+                auto handle = p.read<uint64_t>();
+                auto format = p.read<PixelFormat>();
+                auto dimension = p.read<uint>();
+                auto size = p.read<uint3>();
+                auto levels = p.read<uint>();
+                auto simultaneous_access = p.read<bool>();
+                _add(handle, _device->create_texture(format, dimension, size.x, size.y, size.z, levels, simultaneous_access).handle, op);
+                end_setup();
+                break;
+            }
+            case CaptureOp::CREATE_BINDLESS_ARRAY: {
+                begin_setup();
+                auto handle = p.read<uint64_t>();
+                _add(handle, _device->create_bindless_array(p.read<uint64_t>()).handle, op);
+                end_setup();
+                break;
+            }
+            case CaptureOp::CREATE_STREAM: {
+                begin_setup();
+                auto handle = p.read<uint64_t>();
+                _add(handle, _device->create_stream(p.read<StreamTag>()).handle, op);
+                end_setup();
+                break;
+            }
+            case CaptureOp::CREATE_SHADER: {
+                begin_setup();
+                auto handle = p.read<uint64_t>();
+                ShaderOption option{.enable_cache = true};
+                option.enable_fast_math = p.read<bool>();
+                option.enable_debug_info = p.read<bool>();
+                option.name = p.read_string();
+                option.native_include = p.read_string();
+                auto kernel = FunctionSerializer::deserialize(p.read_bytes(), remap_function);
+                _add(handle, _device->create_shader(option, kernel->function()).handle, op);
+                end_setup();
+                break;
+            }
+            case CaptureOp::LOAD_SHADER: {
+                begin_setup();
+                auto handle = p.read<uint64_t>();
+                auto name = p.read_string();
+                luisa::vector<const Type *> arg_types(p.read<uint64_t>());
+                for (auto &t : arg_types) { t = Type::from(p.read_string()); }
+                _add(handle, _device->load_shader(name, arg_types).handle, CaptureOp::CREATE_SHADER);
+                end_setup();
+                break;
+            }
+            case CaptureOp::CREATE_EVENT: {
+                begin_setup();
+                _add(p.read<uint64_t>(), _device->create_event().handle, op);
+                end_setup();
+                break;
+            }
+            case CaptureOp::CREATE_MESH:
+            case CaptureOp::CREATE_PROCEDURAL_PRIMITIVE:
+            case CaptureOp::CREATE_ACCEL: {
+                begin_setup();
+                auto handle = p.read<uint64_t>();
+                auto option = p.read<AccelOption>();
+                auto replayed = op == CaptureOp::CREATE_MESH                  ? _device->create_mesh(option) :
+                                op == CaptureOp::CREATE_PROCEDURAL_PRIMITIVE ? _device->create_procedural_primitive(option) :
+                                                                               _device->create_accel(option);
+                _add(handle, replayed.handle, op);
+                end_setup();
+                break;
+            }
+            case CaptureOp::DESTROY_BUFFER:
+            case CaptureOp::DESTROY_TEXTURE:
+            case CaptureOp::DESTROY_BINDLESS_ARRAY:
+            case CaptureOp::DESTROY_STREAM:
+            case CaptureOp::DESTROY_SHADER:
+            case CaptureOp::DESTROY_EVENT:
+            case CaptureOp::DESTROY_MESH:
+            case CaptureOp::DESTROY_PROCEDURAL_PRIMITIVE:
+            case CaptureOp::DESTROY_ACCEL: {
+                auto captured = p.read<uint64_t>();
+                auto creation = _live.find(_remap(captured))->second;
+                _destroy(_remove(captured), creation);
+                break;
+            }
+            case CaptureOp::SYNCHRONIZE_STREAM: {
+                _device->synchronize_stream(_remap(p.read<uint64_t>()));
+                end_frame();
+                break;
+            }
+            case CaptureOp::SIGNAL_EVENT: {
+                auto event = _remap(p.read<uint64_t>());
+                auto stream = _remap(p.read<uint64_t>());
+                _device->signal_event(event, stream, p.read<uint64_t>());
+                frame_pending = true;
+                break;
+            }
+            case CaptureOp::WAIT_EVENT: {
+                auto event = _remap(p.read<uint64_t>());
+                auto stream = _remap(p.read<uint64_t>());
+                _device->wait_event(event, stream, p.read<uint64_t>());
+                break;
+            }
+            case CaptureOp::SYNCHRONIZE_EVENT: {
+                auto event = _remap(p.read<uint64_t>());
+                _device->synchronize_event(event, p.read<uint64_t>());
+                end_frame();
+                break;
+            }
+            case CaptureOp::SET_NAME: {
+                auto tag = p.read<Resource::Tag>();
+                auto handle = _remap(p.read<uint64_t>());
+                _device->set_name(tag, handle, p.read_string());
+                break;
+            }
+            case CaptureOp::DISPATCH: {
+                auto stream = _remap(p.read<uint64_t>());
+                auto count = p.read<uint64_t>();
+                auto list = CommandList::create(count, 1u);
+                // download targets live until the command list completes
+                luisa::vector<luisa::vector<std::byte>> downloads;
+                auto scratch = [&downloads](size_t size) noexcept {
+                    return downloads.emplace_back(size).data();
+                };
+                for (auto i = 0u; i < count; i++) {
+                    switch (p.read<Command::Tag>()) {
+                        case Command::Tag::EBufferUploadCommand: {
+                            auto handle = _remap(p.read<uint64_t>());
+                            auto offset = p.read<size_t>();
+                            auto data = p.read_bytes();
+                            list << luisa::make_unique<BufferUploadCommand>(handle, offset, data.size(), data.data());
+                            break;
+                        }
+                        case Command::Tag::EBufferDownloadCommand: {
+                            auto handle = _remap(p.read<uint64_t>());
+                            auto offset = p.read<size_t>();
+                            auto size = p.read<size_t>();
+                            list << luisa::make_unique<BufferDownloadCommand>(handle, offset, size, scratch(size));
+                            break;
+                        }
+                        case Command::Tag::EBufferCopyCommand: {
+                            auto src = _remap(p.read<uint64_t>());
+                            auto dst = _remap(p.read<uint64_t>());
+                            auto src_offset = p.read<size_t>();
+                            auto dst_offset = p.read<size_t>();
+                            list << luisa::make_unique<BufferCopyCommand>(src, dst, src_offset, dst_offset, p.read<size_t>());
+                            break;
+                        }
+                        case Command::Tag::EBufferToTextureCopyCommand: {
+                            auto buffer = _remap(p.read<uint64_t>());
+                            auto buffer_offset = p.read<size_t>();
+                            auto texture = _remap(p.read<uint64_t>());
+                            auto storage = p.read<PixelStorage>();
+                            auto level = p.read<uint>();
+                            auto size = p.read<uint3>();
+                            list << luisa::make_unique<BufferToTextureCopyCommand>(
+                                buffer, buffer_offset, texture, storage, level, size, p.read<uint3>());
+                            break;
+                        }
+                        case Command::Tag::ETextureToBufferCopyCommand: {
+                            auto buffer = _remap(p.read<uint64_t>());
+                            auto buffer_offset = p.read<size_t>();
+                            auto texture = _remap(p.read<uint64_t>());
+                            auto storage = p.read<PixelStorage>();
+                            auto level = p.read<uint>();
+                            auto size = p.read<uint3>();
+                            list << luisa::make_unique<TextureToBufferCopyCommand>(
+                                buffer, buffer_offset, texture, storage, level, size, p.read<uint3>());
+                            break;
+                        }
+                        case Command::Tag::ETextureCopyCommand: {
+                            auto storage = p.read<PixelStorage>();
+                            auto src = _remap(p.read<uint64_t>());
+                            auto dst = _remap(p.read<uint64_t>());
+                            auto src_level = p.read<uint>();
+                            auto dst_level = p.read<uint>();
+                            auto size = p.read<uint3>();
+                            auto src_offset = p.read<uint3>();
+                            list << luisa::make_unique<TextureCopyCommand>(
+                                storage, src, dst, src_level, dst_level, size, src_offset, p.read<uint3>());
+                            break;
+                        }
+                        case Command::Tag::ETextureUploadCommand: {
+                            auto handle = _remap(p.read<uint64_t>());
+                            auto storage = p.read<PixelStorage>();
+                            auto level = p.read<uint>();
+                            auto size = p.read<uint3>();
+                            auto offset = p.read<uint3>();
+                            auto data = p.read_bytes();
+                            list << luisa::make_unique<TextureUploadCommand>(
+                                handle, storage, level, size, data.data(), offset);
+                            break;
+                        }
+                        case Command::Tag::ETextureDownloadCommand: {
+                            auto handle = _remap(p.read<uint64_t>());
+                            auto storage = p.read<PixelStorage>();
+                            auto level = p.read<uint>();
+                            auto size = p.read<uint3>();
+                            auto offset = p.read<uint3>();
+                            list << luisa::make_unique<TextureDownloadCommand>(
+                                handle, storage, level, size, scratch(pixel_storage_size(storage, size)), offset);
+                            break;
+                        }
+                        case Command::Tag::EShaderDispatchCommand: {
+                            auto handle = _remap(p.read<uint64_t>());
+                            auto arg_count = p.read<uint64_t>();
+                            // uniforms are encoded as they are read, so reserve
+                            // conservatively with the remaining payload size
+                            ComputeDispatchCmdEncoder encoder{handle, arg_count, payload.size() - p.offset()};
+                            for (auto a = 0u; a < arg_count; a++) {
+                                switch (p.read<Argument::Tag>()) {
+                                    case Argument::Tag::BUFFER: {
+                                        auto b = p.read<Argument::Buffer>();
+                                        encoder.encode_buffer(_remap(b.handle), b.offset, b.size);
+                                        break;
+                                    }
+                                    case Argument::Tag::TEXTURE: {
+                                        auto t = p.read<Argument::Texture>();
+                                        encoder.encode_texture(_remap(t.handle), t.level);
+                                        break;
+                                    }
+                                    case Argument::Tag::UNIFORM: {
+                                        auto u = p.read_bytes();
+                                        encoder.encode_uniform(u.data(), u.size());
+                                        break;
+                                    }
+                                    case Argument::Tag::BINDLESS_ARRAY:
+                                        encoder.encode_bindless_array(_remap(p.read<Argument::BindlessArray>().handle));
+                                        break;
+                                    case Argument::Tag::ACCEL:
+                                        encoder.encode_accel(_remap(p.read<Argument::Accel>().handle));
+                                        break;
+                                }
+                            }
+                            if (p.read<bool>()) {
+                                auto indirect = p.read<IndirectDispatchArg>();
+                                indirect.handle = _remap(indirect.handle);
+                                encoder.set_dispatch_size(indirect);
+                            } else {
+                                encoder.set_dispatch_size(p.read<uint3>());
+                            }
+                            list << std::move(encoder).build();
+                            break;
+                        }
+                        case Command::Tag::EMeshBuildCommand: {
+                            auto handle = _remap(p.read<uint64_t>());
+                            auto request = p.read<AccelBuildRequest>();
+                            auto vertex_buffer = _remap(p.read<uint64_t>());
+                            auto vertex_buffer_offset = p.read<size_t>();
+                            auto vertex_buffer_size = p.read<size_t>();
+                            auto vertex_stride = p.read<size_t>();
+                            auto triangle_buffer = _remap(p.read<uint64_t>());
+                            auto triangle_buffer_offset = p.read<size_t>();
+                            auto triangle_buffer_size = p.read<size_t>();
+                            auto vertex_format = p.read<MeshVertexFormat>();
+                            list << luisa::make_unique<MeshBuildCommand>(
+                                handle, request, vertex_buffer, vertex_buffer_offset, vertex_buffer_size, vertex_stride,
+                                triangle_buffer, triangle_buffer_offset, triangle_buffer_size,
+                                vertex_format, p.read<MeshIndexFormat>());
+                            break;
+                        }
+                        case Command::Tag::EProceduralPrimitiveBuildCommand: {
+                            auto handle = _remap(p.read<uint64_t>());
+                            auto request = p.read<AccelBuildRequest>();
+                            auto aabb_buffer = _remap(p.read<uint64_t>());
+                            auto aabb_buffer_offset = p.read<size_t>();
+                            list << luisa::make_unique<ProceduralPrimitiveBuildCommand>(
+                                handle, request, aabb_buffer, aabb_buffer_offset, p.read<size_t>());
+                            break;
+                        }
+                        case Command::Tag::EAccelBuildCommand: {
+                            auto handle = _remap(p.read<uint64_t>());
+                            auto instance_count = p.read<uint32_t>();
+                            auto request = p.read<AccelBuildRequest>();
+                            auto update_instance_buffer_only = p.read<bool>();
+                            auto modifications = p.read_array<AccelBuildCommand::Modification>();
+                            for (auto &&m : modifications) {
+                                if (m.flags & AccelBuildCommand::Modification::flag_primitive) {
+                                    m.primitive = _remap(m.primitive);
+                                }
+                            }
+                            list << luisa::make_unique<AccelBuildCommand>(
+                                handle, instance_count, request, std::move(modifications), update_instance_buffer_only);
+                            break;
+                        }
+                        case Command::Tag::EBindlessArrayUpdateCommand: {
+                            using Operation = BindlessArrayUpdateCommand::Modification::Operation;
+                            auto handle = _remap(p.read<uint64_t>());
+                            auto modifications = p.read_array<BindlessArrayUpdateCommand::Modification>();
+                            for (auto &&m : modifications) {
+                                if (m.buffer.op == Operation::EMPLACE) { m.buffer.handle = _remap(m.buffer.handle); }
+                                if (m.tex2d.op == Operation::EMPLACE) { m.tex2d.handle = _remap(m.tex2d.handle); }
+                                if (m.tex3d.op == Operation::EMPLACE) { m.tex3d.handle = _remap(m.tex3d.handle); }
+                            }
+                            list << luisa::make_unique<BindlessArrayUpdateCommand>(handle, std::move(modifications));
+                            break;
+                        }
+                        default: LUISA_ERROR_WITH_LOCATION("Invalid command in capture.");
+                    }
+                }
+                if (!downloads.empty()) {
+                    list.add_callback([downloads = std::move(downloads)] {});
+                }
+                stats.command_list_count++;
+                stats.command_count += count;
+                frame_pending = true;
+                _device->dispatch(stream, list.commit().command_list());
+                break;
+            }
+            default:
+                LUISA_WARNING_WITH_LOCATION("Skipping unknown capture record {}.", luisa::to_underlying(op));
+                break;
+        }
+    }
+
+    // wait for the trailing work, then release what the capture left alive
+    for (auto &&[handle, op] : _live) {
+        if (op == CaptureOp::CREATE_STREAM) { _device->synchronize_stream(handle); }
+    }
+    if (frame_pending) { end_frame(); }
+    stats.replay_milliseconds = clock.toc() - stats.setup_milliseconds;
+    for (auto &&[handle, op] : _live) {
+        if (op != CaptureOp::CREATE_STREAM) { _destroy(handle, op); }
+    }
+    for (auto &&[handle, op] : _live) {
+        if (op == CaptureOp::CREATE_STREAM) { _destroy(handle, op); }
+    }
+    _live.clear();
+    _handles.clear();
+    _data.clear();
+    return stats;
+}
+
+}// namespace luisa::compute
@@ -2,6 +2,8 @@
 // Created by Mike Smith on 2021/2/2.
 //
 
+#include <cstdlib>
+
 #include <luisa/core/dynamic_module.h>
 #include <luisa/core/logging.h>
 #include <luisa/core/platform.h>
@@ -22,7 +24,7 @@ struct BackendModule {
     BackendDeviceNames *backend_device_names;
 };
 
-struct ValidationLayer {
+struct DeviceLayer {
     using Creator = DeviceInterface *(Context &&ctx, luisa::shared_ptr<DeviceInterface> &&native);
     DynamicModule module;
     Creator *creator{};
@@ -38,7 +40,9 @@ public:
     std::filesystem::path runtime_directory;
     luisa::unordered_map<luisa::string, BackendModule> loaded_backends;
     luisa::vector<luisa::string> installed_backends;
-    ValidationLayer validation_layer;
+    DeviceLayer validation_layer;
+    DeviceLayer profiling_layer;
+    DeviceLayer capture_layer;
     luisa::unordered_map<luisa::string, luisa::unique_ptr<std::filesystem::path>> runtime_subdir_paths;
     std::mutex runtime_subdir_mutex;
 
@@ -115,7 +119,8 @@ Context::Context(string_view program_path) noexcept
     : _impl{luisa::make_shared<detail::ContextImpl>(program_path)} {
 }
 
-Device Context::create_device(luisa::string_view backend_name_in, const DeviceConfig *settings, bool enable_validation) noexcept {
+Device Context::create_device(luisa::string_view backend_name_in, const DeviceConfig *settings,
+                              bool enable_validation, bool enable_profiling) noexcept {
     auto impl = _impl.get();
     luisa::string backend_name{backend_name_in};
     for (auto &c : backend_name) { c = static_cast<char>(std::tolower(c)); }
@@ -123,20 +128,22 @@ Device Context::create_device(luisa::string_view backend_name_in, const DeviceCo
     auto interface = m.creator(Context{_impl}, settings);
     interface->_backend_name = std::move(backend_name);
     auto handle = Device::Handle{interface, m.deleter};
-    if (enable_validation) {
-        auto &validation_layer = impl->validation_layer;
-        if (!validation_layer.module) {
-            validation_layer.module = DynamicModule::load(
-                impl->runtime_directory,
-                "lc-validation-layer");
-            validation_layer.creator = validation_layer.module.function<ValidationLayer::Creator>("create");
-            validation_layer.deleter = validation_layer.module.function<Device::Deleter>("destroy");
+    // layers wrap the native device in order: native -> validation -> profiling -> capture
+    auto wrap = [&](DeviceLayer &layer, luisa::string_view module_name) noexcept {
+        if (!layer.module) {
+            layer.module = DynamicModule::load(impl->runtime_directory, module_name);
+            layer.creator = layer.module.function<DeviceLayer::Creator>("create");
+            layer.deleter = layer.module.function<Device::Deleter>("destroy");
         }
-        auto layer_handle = Device::Handle{validation_layer.creator(Context{_impl}, std::move(handle)), validation_layer.deleter};
-        return Device{std::move(layer_handle)};
-    } else {
-        return Device{std::move(handle)};
+        handle = Device::Handle{layer.creator(Context{_impl}, std::move(handle)), layer.deleter};
+    };
+    if (enable_validation) { wrap(impl->validation_layer, "lc-validation-layer"); }
+    if (enable_profiling) { wrap(impl->profiling_layer, "lc-profiling-layer"); }
+    // the capture layer records the calls of the application, see CaptureWriter
+    if (auto capture = std::getenv("LUISA_CAPTURE_FILE"); capture != nullptr && capture[0] != '\0') {
+        wrap(impl->capture_layer, "lc-capture-layer");
     }
+    return Device{std::move(handle)};
 }
 
 Context::Context(luisa::shared_ptr<detail::ContextImpl> impl) noexcept
@@ -13,7 +13,8 @@ luisa::unique_ptr<Command> Mesh::build(Mesh::BuildRequest request) noexcept {
     return luisa::make_unique<MeshBuildCommand>(
         handle(), request,
         _v_buffer, _v_buffer_offset, _v_buffer_size, _v_stride,
-        _t_buffer, _t_buffer_offset, _t_buffer_size);
+        _t_buffer, _t_buffer_offset, _t_buffer_size,
+        _v_format, _t_format);
 }
 
 Mesh::~Mesh() noexcept {
@@ -147,6 +147,14 @@ pub enum AccelBuildRequest {
     PreferUpdate,
     ForceBuild,
 }
+
+#[repr(C)]
+#[derive(Debug, Copy, Clone, PartialOrd, PartialEq, Ord, Eq, Hash, Serialize, Deserialize)]
+pub enum MeshVertexFormat {
+    Float3,
+    Half3,
+    Snorm16x3,
+}
 #[repr(C)]
 #[derive(Debug, Copy, Clone, PartialOrd, PartialEq, Ord, Eq, Hash, Serialize, Deserialize)]
 pub struct AccelOption {
@@ -212,9 +220,21 @@ pub enum PixelStorage {
     Float1,
     Float2,
     Float4,
+
+    Bc4,
+    Bc5,
+    Bc6,
+    Bc7,
 }
 
 impl PixelStorage {
+    pub fn is_block_compressed(&self) -> bool {
+        matches!(
+            self,
+            PixelStorage::Bc4 | PixelStorage::Bc5 | PixelStorage::Bc6 | PixelStorage::Bc7
+        )
+    }
+    /// Bytes per pixel, or per 4x4 block for block-compressed storages.
     pub fn size(&self) -> usize {
         match self {
             PixelStorage::Byte1 => 1,
@@ -232,6 +252,8 @@ impl PixelStorage {
             PixelStorage::Float1 => 4,
             PixelStorage::Float2 => 8,
             PixelStorage::Float4 => 16,
+            PixelStorage::Bc4 => 8,
+            PixelStorage::Bc5 | PixelStorage::Bc6 | PixelStorage::Bc7 => 16,
         }
     }
 }
@@ -279,6 +301,11 @@ pub enum PixelFormat {
     R32f,
     Rg32f,
     Rgba32f,
+
+    Bc4Unorm,
+    Bc5Unorm,
+    Bc6hUf16,
+    Bc7Unorm,
 }
 impl PixelFormat {
     pub fn storage(&self) -> PixelStorage {
@@ -308,6 +335,10 @@ impl PixelFormat {
             PixelFormat::Rg32f => PixelStorage::Float2,
             PixelFormat::Rgba32Sint | PixelFormat::Rgba32Uint => PixelStorage::Int4,
             PixelFormat::Rgba32f => PixelStorage::Float4,
+            PixelFormat::Bc4Unorm => PixelStorage::Bc4,
+            PixelFormat::Bc5Unorm => PixelStorage::Bc5,
+            PixelFormat::Bc6hUf16 => PixelStorage::Bc6,
+            PixelFormat::Bc7Unorm => PixelStorage::Bc7,
         }
     }
 }
@@ -511,6 +542,7 @@ pub struct MeshBuildCommand {
     pub vertex_buffer_offset: usize,
     pub vertex_buffer_size: usize,
     pub vertex_stride: usize,
+    pub vertex_format: MeshVertexFormat,
     pub index_buffer: Buffer,
     pub index_buffer_offset: usize,
     pub index_buffer_size: usize,
@@ -633,6 +665,22 @@ pub struct LoggerMessage {
     pub message: *const c_char,
 }
 #[repr(C)]
+#[derive(Debug, Copy, Clone, PartialEq, Eq)]
+pub enum CompileEventKind {
+    Phase,
+    Counter,
+    CacheHit,
+    CacheMiss,
+}
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct CompileEvent {
+    pub kind: CompileEventKind,
+    pub name: *const c_char,
+    pub milliseconds: f64,
+    pub value: u64,
+}
+#[repr(C)]
 #[derive(Copy, Clone)]
 pub struct LibInterface {
     pub inner: *mut c_void,
@@ -642,6 +690,7 @@ pub struct LibInterface {
     pub create_device:
         unsafe extern "C" fn(Context, *const c_char, *const c_char) -> DeviceInterface,
     pub free_string: unsafe extern "C" fn(*mut c_char),
+    pub set_compile_event_callback: unsafe extern "C" fn(unsafe extern "C" fn(CompileEvent)),
 }
 #[repr(C)]
 #[derive(Copy, Clone)]
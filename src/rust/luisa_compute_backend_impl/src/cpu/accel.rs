@@ -1,34 +1,62 @@
-use std::{os::raw::c_void, ptr::null_mut};
+use std::{collections::HashMap, os::raw::c_void, ptr::null_mut, time::Instant};
 
 use super::resource::BufferImpl;
 use crate::panic_abort;
 use api::{
     AccelBuildModification, AccelBuildModificationFlags, AccelBuildRequest, AccelUsageHint,
-    MeshBuildCommand, ProceduralPrimitiveBuildCommand,
+    MeshBuildCommand, MeshVertexFormat, ProceduralPrimitiveBuildCommand,
 };
 use embree_sys as sys;
 use lazy_static::lazy_static;
 use luisa_compute_api_types as api;
 use luisa_compute_cpu_kernel_defs as defs;
 use parking_lot::{Mutex, RwLock};
+use rayon::prelude::*;
 struct Device(sys::RTCDevice);
 unsafe impl Send for Device {}
 unsafe impl Sync for Device {}
 
 lazy_static! {
-    static ref DEVICE: Mutex<Device> = Mutex::new(Device(std::ptr::null_mut()));
+    // The Embree device is thread-safe: geometries and scenes may be created and
+    // committed from any thread as long as a scene is not modified concurrently,
+    // which the per-geometry lock below guarantees.
+    static ref DEVICE: Device = Device(unsafe { sys::rtcNewDevice(std::ptr::null()) });
+    static ref LOG_ACCEL_STATS: bool = std::env::var("LUISA_ACCEL_STATS").is_ok();
 }
-fn init_device() {
-    let mut device = DEVICE.lock();
-    if device.0.is_null() {
-        device.0 = unsafe { sys::rtcNewDevice(std::ptr::null()) }
+#[inline]
+fn device() -> sys::RTCDevice {
+    DEVICE.0
+}
+#[inline]
+fn build_quality(hint: AccelUsageHint) -> sys::RTCBuildQuality {
+    match hint {
+        AccelUsageHint::FastBuild => sys::RTC_BUILD_QUALITY_LOW,
+        AccelUsageHint::FastTrace => sys::RTC_BUILD_QUALITY_HIGH,
+    }
+}
+#[inline]
+fn scene_flags(allow_update: bool) -> sys::RTCSceneFlags {
+    if allow_update {
+        sys::RTC_SCENE_FLAG_DYNAMIC
+    } else {
+        sys::RTC_SCENE_FLAG_NONE
     }
 }
 pub struct GeometryImpl {
     pub(crate) handle: sys::RTCScene,
     #[allow(dead_code)]
     usage: AccelUsageHint,
+    allow_update: bool,
     built: bool,
+    vertex_count: usize,
+    // the layout of the last mesh build; a refit can only reuse the geometry
+    // buffers when the new build decodes the same way
+    vertex_format: MeshVertexFormat,
+    vertex_stride: usize,
+    index_stride: usize,
+    // bumped by every build, so that the accels instancing the geometry
+    // know that their instances need to be committed again
+    generation: u64,
     lock: Mutex<()>,
 }
 macro_rules! check_error {
@@ -40,31 +68,26 @@ macro_rules! check_error {
     }};
 }
 impl GeometryImpl {
-    pub unsafe fn new(
-        hint: api::AccelUsageHint,
-        _allow_compact: bool,
-        _allow_update: bool,
-    ) -> Self {
-        init_device();
-        let device = DEVICE.lock();
-        let handle = sys::rtcNewScene(device.0);
-        let flags = match hint {
-            AccelUsageHint::FastBuild => sys::RTC_BUILD_QUALITY_LOW,
-            AccelUsageHint::FastTrace => sys::RTC_BUILD_QUALITY_HIGH,
-        };
-
-        sys::rtcSetSceneFlags(handle, flags);
+    pub unsafe fn new(hint: api::AccelUsageHint, _allow_compact: bool, allow_update: bool) -> Self {
+        let handle = sys::rtcNewScene(device());
+        sys::rtcSetSceneBuildQuality(handle, build_quality(hint));
+        sys::rtcSetSceneFlags(handle, scene_flags(allow_update));
 
         Self {
             handle,
             usage: hint,
+            allow_update,
             built: false,
+            vertex_count: 0,
+            vertex_format: MeshVertexFormat::Float3,
+            vertex_stride: 0,
+            index_stride: 0,
+            generation: 0,
             lock: Mutex::new(()),
         }
     }
     pub unsafe fn build_procedural(&mut self, cmd: &ProceduralPrimitiveBuildCommand) {
-        let device = DEVICE.lock();
-        let device = device.0;
+        let device = device();
         let _lk = self.lock.lock();
         let request = cmd.request;
         let need_rebuild = request == AccelBuildRequest::ForceBuild || !self.built;
@@ -122,40 +145,86 @@ impl GeometryImpl {
         }
         sys::rtcCommitScene(self.handle);
         check_error!(device);
+        self.generation += 1;
     }
     pub unsafe fn build_mesh(&mut self, cmd: &MeshBuildCommand) {
-        let device = DEVICE.lock();
-        let device = device.0;
+        let device = device();
         let _lk = self.lock.lock();
         let request = cmd.request;
-        let need_rebuild = request == AccelBuildRequest::ForceBuild || !self.built;
+        let vertex_count = cmd.vertex_buffer_size / cmd.vertex_stride;
+        let triangle_count = cmd.index_buffer_size / cmd.index_stride;
+        let need_rebuild = request == AccelBuildRequest::ForceBuild
+            || !self.built
+            || vertex_count != self.vertex_count
+            || cmd.vertex_format != self.vertex_format
+            || cmd.vertex_stride != self.vertex_stride
+            || cmd.index_stride != self.index_stride;
+        let vbuffer = &*(cmd.vertex_buffer.0 as *const BufferImpl);
+        let ibuffer = &*(cmd.index_buffer.0 as *const BufferImpl);
 
         if need_rebuild {
             let geometry = sys::rtcNewGeometry(device, sys::RTC_GEOMETRY_TYPE_TRIANGLE);
-            let vbuffer = &*(cmd.vertex_buffer.0 as *const BufferImpl);
-            let ibuffer = &*(cmd.index_buffer.0 as *const BufferImpl);
-            sys::rtcSetSharedGeometryBuffer(
-                geometry,
-                sys::RTC_BUFFER_TYPE_VERTEX,
-                0,
-                sys::RTC_FORMAT_FLOAT3,
-                vbuffer.data as *const c_void,
-                cmd.vertex_buffer_offset,
-                cmd.vertex_stride,
-                cmd.vertex_buffer_size / cmd.vertex_stride,
-            );
+            // Embree only takes float3 vertices and uint3 indices, other formats
+            // are decoded into buffers owned by the geometry
+            if cmd.vertex_format == MeshVertexFormat::Float3 {
+                sys::rtcSetSharedGeometryBuffer(
+                    geometry,
+                    sys::RTC_BUFFER_TYPE_VERTEX,
+                    0,
+                    sys::RTC_FORMAT_FLOAT3,
+                    vbuffer.data as *const c_void,
+                    cmd.vertex_buffer_offset,
+                    cmd.vertex_stride,
+                    vertex_count,
+                );
+            } else {
+                let decoded = sys::rtcSetNewGeometryBuffer(
+                    geometry,
+                    sys::RTC_BUFFER_TYPE_VERTEX,
+                    0,
+                    sys::RTC_FORMAT_FLOAT3,
+                    std::mem::size_of::<[f32; 3]>(),
+                    vertex_count,
+                );
+                check_error!(device);
+                decode_vertices(cmd, vbuffer, decoded as *mut [f32; 3]);
+            }
             check_error!(device);
-            sys::rtcSetSharedGeometryBuffer(
-                geometry,
-                sys::RTC_BUFFER_TYPE_INDEX,
-                0,
-                sys::RTC_FORMAT_UINT3,
-                ibuffer.data as *const c_void,
-                cmd.index_buffer_offset,
-                cmd.index_stride,
-                cmd.index_buffer_size / cmd.index_stride,
-            );
+            if cmd.index_stride == std::mem::size_of::<[u32; 3]>() {
+                sys::rtcSetSharedGeometryBuffer(
+                    geometry,
+                    sys::RTC_BUFFER_TYPE_INDEX,
+                    0,
+                    sys::RTC_FORMAT_UINT3,
+                    ibuffer.data as *const c_void,
+                    cmd.index_buffer_offset,
+                    cmd.index_stride,
+                    triangle_count,
+                );
+            } else {
+                assert_eq!(cmd.index_stride, std::mem::size_of::<[u16; 3]>());
+                let decoded = sys::rtcSetNewGeometryBuffer(
+                    geometry,
+                    sys::RTC_BUFFER_TYPE_INDEX,
+                    0,
+                    sys::RTC_FORMAT_UINT3,
+                    std::mem::size_of::<[u32; 3]>(),
+                    triangle_count,
+                );
+                check_error!(device);
+                let src = ibuffer.data.add(cmd.index_buffer_offset) as *const [u16; 3];
+                let dst = decoded as *mut [u32; 3];
+                for i in 0..triangle_count {
+                    let [i0, i1, i2] = src.add(i).read_unaligned();
+                    *dst.add(i) = [i0 as u32, i1 as u32, i2 as u32];
+                }
+            }
             check_error!(device);
+            if self.allow_update {
+                // the first commit is a full build, later vertex updates refit it
+                sys::rtcSetGeometryBuildQuality(geometry, sys::RTC_BUILD_QUALITY_REFIT);
+                check_error!(device);
+            }
             sys::rtcCommitGeometry(geometry);
             check_error!(device);
             if self.built {
@@ -168,8 +237,17 @@ impl GeometryImpl {
             check_error!(device);
             sys::rtcReleaseGeometry(geometry);
             check_error!(device);
+            self.vertex_count = vertex_count;
+            self.vertex_format = cmd.vertex_format;
+            self.vertex_stride = cmd.vertex_stride;
+            self.index_stride = cmd.index_stride;
         } else {
             let geometry = sys::rtcGetGeometry(self.handle, 0);
+            if cmd.vertex_format != MeshVertexFormat::Float3 {
+                let decoded =
+                    sys::rtcGetGeometryBufferData(geometry, sys::RTC_BUFFER_TYPE_VERTEX, 0);
+                decode_vertices(cmd, vbuffer, decoded as *mut [f32; 3]);
+            }
             sys::rtcUpdateGeometryBuffer(geometry, sys::RTC_BUFFER_TYPE_VERTEX, 0);
             check_error!(device);
             sys::rtcCommitGeometry(geometry);
@@ -177,6 +255,95 @@ impl GeometryImpl {
         }
         sys::rtcCommitScene(self.handle);
         check_error!(device);
+        self.generation += 1;
+    }
+}
+
+#[inline]
+fn half_to_f32(h: u16) -> f32 {
+    let sign = ((h & 0x8000) as u32) << 16;
+    let exponent = ((h >> 10) & 0x1f) as u32;
+    let mantissa = (h & 0x3ff) as u32;
+    match exponent {
+        0 => {
+            // zero or subnormal
+            let magnitude = mantissa as f32 * (1.0 / (1 << 24) as f32);
+            f32::from_bits(magnitude.to_bits() | sign)
+        }
+        0x1f => f32::from_bits(sign | 0x7f80_0000 | (mantissa << 13)),
+        _ => f32::from_bits(sign | ((exponent + 112) << 23) | (mantissa << 13)),
+    }
+}
+
+unsafe fn decode_vertices(cmd: &MeshBuildCommand, vbuffer: &BufferImpl, dst: *mut [f32; 3]) {
+    let vertex_count = cmd.vertex_buffer_size / cmd.vertex_stride;
+    let src = vbuffer.data.add(cmd.vertex_buffer_offset) as *const u8;
+    for i in 0..vertex_count {
+        let v = src.add(i * cmd.vertex_stride);
+        let raw = (v as *const [u16; 3]).read_unaligned();
+        *dst.add(i) = match cmd.vertex_format {
+            MeshVertexFormat::Half3 => raw.map(half_to_f32),
+            MeshVertexFormat::Snorm16x3 => raw.map(|x| (x as i16 as f32 / 32767.0).max(-1.0)),
+            MeshVertexFormat::Float3 => (v as *const [f32; 3]).read_unaligned(),
+        };
+    }
+}
+
+/// A BLAS build taken from a command list.
+#[derive(Clone, Copy)]
+pub enum GeometryBuild<'a> {
+    Mesh(&'a MeshBuildCommand),
+    Procedural(&'a ProceduralPrimitiveBuildCommand),
+}
+unsafe impl Send for GeometryBuild<'_> {}
+unsafe impl Sync for GeometryBuild<'_> {}
+impl GeometryBuild<'_> {
+    // Builds with fewer primitives than this are run side by side on the rayon
+    // pool; larger ones are committed one at a time so that Embree's own
+    // parallel builder gets the whole machine.
+    const PARALLEL_BUILD_MAX_PRIMITIVES: usize = 1 << 16;
+    #[inline]
+    pub fn geometry(&self) -> u64 {
+        match self {
+            GeometryBuild::Mesh(cmd) => cmd.mesh.0,
+            GeometryBuild::Procedural(cmd) => cmd.handle.0,
+        }
+    }
+    #[inline]
+    fn primitive_count(&self) -> usize {
+        match self {
+            GeometryBuild::Mesh(cmd) => cmd.index_buffer_size / cmd.index_stride.max(1),
+            GeometryBuild::Procedural(cmd) => cmd.aabb_count,
+        }
+    }
+    unsafe fn run(&self) {
+        let geometry = &mut *(self.geometry() as *mut GeometryImpl);
+        match self {
+            GeometryBuild::Mesh(cmd) => geometry.build_mesh(cmd),
+            GeometryBuild::Procedural(cmd) => geometry.build_procedural(cmd),
+        }
+    }
+}
+/// Build a batch of BLASes that target distinct geometries.
+///
+/// Small builds are distributed over `pool`; large builds run sequentially
+/// afterwards and are parallelized internally by Embree.
+pub unsafe fn build_geometries(pool: &rayon::ThreadPool, builds: &[GeometryBuild]) {
+    debug_assert!({
+        let mut handles: Vec<_> = builds.iter().map(|b| b.geometry()).collect();
+        handles.sort_unstable();
+        handles.windows(2).all(|w| w[0] != w[1])
+    });
+    if builds.len() == 1 {
+        builds[0].run();
+        return;
+    }
+    let (small, large): (Vec<_>, Vec<_>) = builds
+        .iter()
+        .partition(|b| b.primitive_count() < GeometryBuild::PARALLEL_BUILD_MAX_PRIMITIVES);
+    pool.install(|| small.par_iter().for_each(|b| unsafe { b.run() }));
+    for b in large {
+        b.run();
     }
 }
 impl Drop for GeometryImpl {
@@ -192,6 +359,9 @@ struct Instance {
     visible: u8,
     geometry: sys::RTCGeometry,
     opaque: bool,
+    blas: *const GeometryImpl,
+    // generation of the BLAS when the instance was last committed
+    blas_generation: u64,
 }
 impl Instance {
     pub fn valid(&self) -> bool {
@@ -206,12 +376,35 @@ impl Default for Instance {
             visible: u8::MAX,
             geometry: std::ptr::null_mut(),
             opaque: true,
+            blas: std::ptr::null(),
+            blas_generation: 0,
         }
     }
 }
 pub struct AccelImpl {
     pub(crate) handle: sys::RTCScene,
+    quality: sys::RTCBuildQuality,
+    allow_update: bool,
+    built: bool,
     instances: Vec<RwLock<Instance>>,
+    // instances whose transform, visibility or opacity changed since the last commit
+    dirty: Mutex<Vec<u32>>,
+    // generations of the BLASes referenced by the instances at the last commit
+    blas_generations: HashMap<usize, u64>,
+    stats: AccelBuildStats,
+}
+/// Statistics of the last AccelImpl::update.
+#[derive(Clone, Copy, Debug, Default)]
+pub struct AccelBuildStats {
+    pub instance_count: usize,
+    pub modification_count: usize,
+    pub committed_instance_count: usize,
+    // the instance set was unchanged and the scene was committed with the
+    // low-quality dynamic builder instead of a full build
+    pub refit: bool,
+    // nothing changed, so the scene was not committed at all
+    pub skipped: bool,
+    pub milliseconds: f64,
 }
 #[derive(Clone, Copy)]
 #[repr(C)]
@@ -222,36 +415,64 @@ struct RayQueryContext {
     on_procedural_hit: defs::OnHitCallback,
 }
 impl AccelImpl {
-    pub unsafe fn new() -> Self {
-        init_device();
-        let device = DEVICE.lock();
-        let handle = sys::rtcNewScene(device.0);
+    pub unsafe fn new(option: &api::AccelOption) -> Self {
+        let handle = sys::rtcNewScene(device());
+        let quality = build_quality(option.hint);
+        sys::rtcSetSceneBuildQuality(handle, quality);
+        sys::rtcSetSceneFlags(handle, scene_flags(option.allow_update));
         Self {
             handle,
+            quality,
+            allow_update: option.allow_update,
+            built: false,
             instances: Vec::new(),
+            dirty: Mutex::new(Vec::new()),
+            blas_generations: HashMap::new(),
+            stats: AccelBuildStats::default(),
+        }
+    }
+    #[inline]
+    pub fn last_build_stats(&self) -> AccelBuildStats {
+        self.stats
+    }
+    #[inline]
+    fn mark_dirty(&self, index: u32, instance: &mut Instance) {
+        if !instance.dirty {
+            instance.dirty = true;
+            self.dirty.lock().push(index);
+        }
+    }
+    // Commits the instances whose BLAS was rebuilt or refit since they were last
+    // committed, and records the generations of the referenced BLASes.
+    unsafe fn commit_rebuilt_blases(&mut self) -> usize {
+        let mut count = 0;
+        self.blas_generations.clear();
+        for instance in &self.instances {
+            let mut instance = instance.write();
+            if !instance.valid() {
+                continue;
+            }
+            let generation = (*instance.blas).generation;
+            if instance.blas_generation != generation {
+                instance.blas_generation = generation;
+                sys::rtcCommitGeometry(instance.geometry);
+                count += 1;
+            }
+            self.blas_generations
+                .insert(instance.blas as usize, generation);
         }
+        count
     }
     pub unsafe fn update(
         &mut self,
         instance_count: usize,
+        request: AccelBuildRequest,
         modifications: &[AccelBuildModification],
         update_instance_buffer_only: bool,
     ) {
-        let device = DEVICE.lock();
-        let device = device.0;
-        for instance in &self.instances {
-            let instance = instance.read();
-            let geometry = instance.geometry;
-            if instance.dirty {
-                sys::rtcSetGeometryTransform(
-                    geometry,
-                    0,
-                    sys::RTC_FORMAT_FLOAT3X4_ROW_MAJOR,
-                    instance.affine.as_ptr() as *const c_void,
-                );
-                sys::rtcSetGeometryMask(geometry, instance.visible as u32);
-            }
-        }
+        let start = Instant::now();
+        let device = device();
+        let mut topology_changed = !self.built || instance_count != self.instances.len();
         while instance_count > self.instances.len() {
             self.instances.push(RwLock::new(Instance::default()));
         }
@@ -267,26 +488,34 @@ impl AccelImpl {
                 if !mesh.built {
                     panic_abort!("Mesh not built");
                 }
-                unsafe {
-                    let affine = m.affine;
-                    let geometry = sys::rtcNewGeometry(device, sys::RTC_GEOMETRY_TYPE_INSTANCE);
-                    sys::rtcCommitGeometry(geometry);
-                    sys::rtcSetGeometryInstancedScene(geometry, mesh.handle);
-                    sys::rtcAttachGeometryByID(self.handle, geometry, m.index);
-                    sys::rtcSetGeometryEnableFilterFunctionFromArguments(geometry, false);
-                    *self.instances[m.index as usize].write() = Instance {
-                        affine,
-                        dirty: false,
-                        visible: u8::MAX,
-                        geometry,
-                        opaque: true,
-                    };
+                topology_changed = true;
+                let mut instance = self.instances[m.index as usize].write();
+                if instance.valid() {
+                    sys::rtcDetachGeometry(self.handle, m.index);
                 }
+                let geometry = sys::rtcNewGeometry(device, sys::RTC_GEOMETRY_TYPE_INSTANCE);
+                sys::rtcSetGeometryInstancedScene(geometry, mesh.handle);
+                sys::rtcSetGeometryEnableFilterFunctionFromArguments(geometry, false);
+                sys::rtcAttachGeometryByID(self.handle, geometry, m.index);
+                // the scene keeps the geometry alive until it is detached
+                sys::rtcReleaseGeometry(geometry);
+                check_error!(device);
+                let dirty = instance.dirty;
+                *instance = Instance {
+                    affine: m.affine,
+                    dirty,
+                    visible: u8::MAX,
+                    geometry,
+                    opaque: true,
+                    blas: mesh,
+                    blas_generation: mesh.generation,
+                };
+                self.mark_dirty(m.index, &mut instance);
             }
             if m.flags.contains(AccelBuildModificationFlags::OPAQUE_ON) {
                 let mut instance = self.instances[m.index as usize].write();
                 instance.opaque = true;
-                instance.dirty = true;
+                self.mark_dirty(m.index, &mut instance);
                 sys::rtcSetGeometryEnableFilterFunctionFromArguments(
                     instance.geometry,
                     !instance.opaque,
@@ -295,7 +524,7 @@ impl AccelImpl {
             if m.flags.contains(AccelBuildModificationFlags::OPAQUE_OFF) {
                 let mut instance = self.instances[m.index as usize].write();
                 instance.opaque = false;
-                instance.dirty = true;
+                self.mark_dirty(m.index, &mut instance);
                 sys::rtcSetGeometryEnableFilterFunctionFromArguments(
                     instance.geometry,
                     !instance.opaque,
@@ -303,40 +532,93 @@ impl AccelImpl {
             };
             if m.flags.contains(AccelBuildModificationFlags::TRANSFORM) {
                 let mut instance = self.instances[m.index as usize].write();
-                let geometry = instance.geometry;
-                assert!(!geometry.is_null());
-                let affine = m.affine;
+                assert!(instance.valid());
                 sys::rtcSetGeometryTransform(
-                    geometry,
+                    instance.geometry,
                     0,
                     sys::RTC_FORMAT_FLOAT3X4_ROW_MAJOR,
-                    affine.as_ptr() as *const c_void,
+                    m.affine.as_ptr() as *const c_void,
                 );
-                instance.affine = affine;
-                instance.dirty = true;
+                instance.affine = m.affine;
+                self.mark_dirty(m.index, &mut instance);
             }
             if m.flags.contains(AccelBuildModificationFlags::VISIBILITY) {
                 let mut instance = self.instances[m.index as usize].write();
-                let geometry = instance.geometry;
-                assert!(!geometry.is_null());
-                sys::rtcEnableGeometry(geometry);
-                sys::rtcSetGeometryMask(geometry, m.visibility as u32);
+                assert!(instance.valid());
+                sys::rtcEnableGeometry(instance.geometry);
+                sys::rtcSetGeometryMask(instance.geometry, m.visibility as u32);
                 instance.visible = m.visibility;
-                instance.dirty = true;
+                self.mark_dirty(m.index, &mut instance);
             }
         }
         if update_instance_buffer_only {
             return;
         }
-        for instance in &self.instances {
-            let mut instance = instance.write();
-            if instance.valid() && instance.dirty {
+        // only the instances touched since the last commit are visited, including
+        // those modified from kernels through set_instance_transform/visibility
+        let dirty = std::mem::take(&mut *self.dirty.lock());
+        let mut committed_instance_count = 0;
+        for &index in &dirty {
+            // skip instances removed by a shrinking build
+            let mut instance = match self.instances.get(index as usize) {
+                Some(instance) => instance.write(),
+                None => continue,
+            };
+            if !instance.dirty {
+                continue;
+            }
+            instance.dirty = false;
+            if instance.valid() {
+                sys::rtcSetGeometryTransform(
+                    instance.geometry,
+                    0,
+                    sys::RTC_FORMAT_FLOAT3X4_ROW_MAJOR,
+                    instance.affine.as_ptr() as *const c_void,
+                );
+                sys::rtcSetGeometryMask(instance.geometry, instance.visible as u32);
                 sys::rtcCommitGeometry(instance.geometry);
-                instance.dirty = false;
+                instance.blas_generation = (*instance.blas).generation;
+                committed_instance_count += 1;
             }
         }
-
-        sys::rtcCommitScene(self.handle);
+        // untouched instances are stale as well if their BLAS was rebuilt or refit;
+        // the referenced BLASes are alive as long as the instance set is unchanged
+        let blas_changed = topology_changed
+            || self.blas_generations.iter().any(|(&blas, &generation)| {
+                (*(blas as *const GeometryImpl)).generation != generation
+            });
+        if blas_changed {
+            committed_instance_count += self.commit_rebuilt_blases();
+        }
+        let skipped = !topology_changed && committed_instance_count == 0;
+        let refit = !skipped
+            && !topology_changed
+            && self.allow_update
+            && request == AccelBuildRequest::PreferUpdate;
+        if !skipped {
+            sys::rtcSetSceneBuildQuality(
+                self.handle,
+                if refit {
+                    sys::RTC_BUILD_QUALITY_LOW
+                } else {
+                    self.quality
+                },
+            );
+            sys::rtcCommitScene(self.handle);
+            check_error!(device);
+            self.built = true;
+        }
+        self.stats = AccelBuildStats {
+            instance_count,
+            modification_count: modifications.len(),
+            committed_instance_count,
+            refit,
+            skipped,
+            milliseconds: start.elapsed().as_secs_f64() * 1e3,
+        };
+        if *LOG_ACCEL_STATS {
+            log::info!("Accel {:p} updated: {:?}", self.handle, self.stats);
+        }
     }
     #[inline]
     pub unsafe fn trace_closest(&self, ray: &defs::Ray, mask: u8) -> defs::Hit {
@@ -434,14 +716,14 @@ impl AccelImpl {
         let mut instance = self.instances[id as usize].write();
         assert!(instance.valid());
         instance.affine = affine;
-        instance.dirty = true;
+        self.mark_dirty(id, &mut instance);
     }
     #[inline]
     pub unsafe fn set_instance_visibility(&self, id: u32, visibility: u8) {
         let mut instance = self.instances[id as usize].write();
         assert!(instance.valid());
         instance.visible = visibility;
-        instance.dirty = true;
+        self.mark_dirty(id, &mut instance);
     }
 
     #[inline]
@@ -14,6 +14,7 @@ use luisa_compute_ir::{
 };
 
 use super::sha256;
+use luisa_compute_api_types::PixelStorage;
 
 use super::decode_const_data;
 use std::fmt::Write;
@@ -251,6 +252,8 @@ struct GlobalEmitter {
     captures: IndexMap<NodeRef, usize>,
     args: IndexMap<NodeRef, usize>,
     cpu_custom_ops: IndexMap<usize, usize>,
+    // template argument naming the pixel storage of each texture resource
+    texture_storages: HashMap<NodeRef, String>,
 }
 struct FunctionEmitter<'a> {
     type_gen: &'a TypeGen,
@@ -756,37 +759,43 @@ impl<'a> FunctionEmitter<'a> {
                 true
             }
             Func::Texture2dRead => {
+                let storage = self.texture_storage(args[0]);
                 writeln!(
                     &mut self.body,
-                    "const {0} {1} = lc_texture2d_read<{0}>(k_args, {2}, {3});",
-                    node_ty_s, var, args_v[0], args_v[1]
+                    "const {0} {1} = lc_texture2d_read<{0}, {4}>(k_args, {2}, {3});",
+                    node_ty_s, var, args_v[0], args_v[1], storage
                 )
                 .unwrap();
                 true
             }
             Func::Texture3dRead => {
+                let storage = self.texture_storage(args[0]);
                 writeln!(
                     &mut self.body,
-                    "const {0} {1} = lc_texture3d_read<{0}>(k_args, {2}, {3});",
-                    node_ty_s, var, args_v[0], args_v[1]
+                    "const {0} {1} = lc_texture3d_read<{0}, {4}>(k_args, {2}, {3});",
+                    node_ty_s, var, args_v[0], args_v[1], storage
                 )
                 .unwrap();
                 true
             }
             Func::Texture2dWrite => {
+                let value_ty = self.type_gen.gen_c_type(args[2].type_());
+                let storage = self.texture_storage(args[0]);
                 writeln!(
                     &mut self.body,
-                    "lc_texture2d_write(k_args, {0}, {1}, {2});",
-                    args_v[0], args_v[1], args_v[2]
+                    "lc_texture2d_write<{0}, {1}>(k_args, {2}, {3}, {4});",
+                    value_ty, storage, args_v[0], args_v[1], args_v[2]
                 )
                 .unwrap();
                 true
             }
             Func::Texture3dWrite => {
+                let value_ty = self.type_gen.gen_c_type(args[2].type_());
+                let storage = self.texture_storage(args[0]);
                 writeln!(
                     &mut self.body,
-                    "lc_texture3d_write(k_args, {0}, {1}, {2});",
-                    args_v[0], args_v[1], args_v[2]
+                    "lc_texture3d_write<{0}, {1}>(k_args, {2}, {3}, {4});",
+                    value_ty, storage, args_v[0], args_v[1], args_v[2]
                 )
                 .unwrap();
                 true
@@ -931,6 +940,56 @@ impl<'a> FunctionEmitter<'a> {
                 writeln!(self.body, "const {} {} = lc_thread_id();", node_ty_s, var).unwrap();
                 true
             }
+            // threads of a block are executed one after another on the CPU,
+            // so every thread forms a warp with a single active lane
+            Func::WarpSize | Func::WarpActiveCountBits | Func::WarpPrefixCountBits => {
+                let v = match f {
+                    Func::WarpSize => "1u".to_string(),
+                    Func::WarpActiveCountBits => format!("({} ? 1u : 0u)", args_v[0]),
+                    _ => "0u".to_string(),
+                };
+                writeln!(self.body, "const {} {} = {};", node_ty_s, var, v).unwrap();
+                true
+            }
+            Func::WarpLaneId | Func::WarpFirstActiveLane => {
+                writeln!(self.body, "const {} {} = 0u;", node_ty_s, var).unwrap();
+                true
+            }
+            Func::WarpIsFirstActiveLane | Func::WarpActiveAllEqual => {
+                writeln!(self.body, "const {0} {1} = lc_one<{0}>();", node_ty_s, var).unwrap();
+                true
+            }
+            Func::WarpActiveBitAnd
+            | Func::WarpActiveBitOr
+            | Func::WarpActiveBitXor
+            | Func::WarpActiveMax
+            | Func::WarpActiveMin
+            | Func::WarpActiveProduct
+            | Func::WarpActiveSum
+            | Func::WarpActiveAll
+            | Func::WarpActiveAny
+            | Func::WarpReadLaneAt
+            | Func::WarpReadFirstLane => {
+                writeln!(self.body, "const {} {} = {};", node_ty_s, var, args_v[0]).unwrap();
+                true
+            }
+            Func::WarpActiveBitMask => {
+                writeln!(
+                    self.body,
+                    "const {} {} = lc_make_uint4({} ? 1u : 0u, 0u, 0u, 0u);",
+                    node_ty_s, var, args_v[0]
+                )
+                .unwrap();
+                true
+            }
+            Func::WarpPrefixSum => {
+                writeln!(self.body, "const {0} {1} = lc_zero<{0}>();", node_ty_s, var).unwrap();
+                true
+            }
+            Func::WarpPrefixProduct => {
+                writeln!(self.body, "const {0} {1} = lc_one<{0}>();", node_ty_s, var).unwrap();
+                true
+            }
             Func::ZeroInitializer => {
                 writeln!(
                     self.body,
@@ -1680,7 +1739,40 @@ impl<'a> FunctionEmitter<'a> {
         self.write_ident();
         writeln!(&mut self.body, "}}").unwrap();
     }
-    fn gen_arg(&mut self, node: NodeRef, index: usize, is_capture: bool) {
+    // textures that are not kernel resources, e.g. callable parameters, read the storage at run time
+    fn texture_storage(&self, node: NodeRef) -> String {
+        self.globals
+            .texture_storages
+            .get(&node)
+            .cloned()
+            .unwrap_or_else(|| "LC_PIXEL_STORAGE_DYNAMIC".to_string())
+    }
+    // Captured textures are specialized on their storage right away. Texture arguments go through
+    // LC_TEXTURE_ARG_STORAGE_<index>, which the shader defines when it specializes on the
+    // storages it is dispatched with, and which is dynamic otherwise.
+    fn gen_texture_storage(&mut self, node: NodeRef, index: usize, storage: Option<PixelStorage>) {
+        let storage = match storage {
+            Some(storage) => pixel_storage_name(storage),
+            None => {
+                let name = format!("LC_TEXTURE_ARG_STORAGE_{}", index);
+                writeln!(
+                    &mut self.fwd_defs,
+                    "#ifndef {0}\n#define {0} LC_PIXEL_STORAGE_DYNAMIC\n#endif",
+                    name
+                )
+                .unwrap();
+                name
+            }
+        };
+        self.globals.texture_storages.insert(node, storage);
+    }
+    fn gen_arg(
+        &mut self,
+        node: NodeRef,
+        index: usize,
+        is_capture: bool,
+        texture_storage: Option<PixelStorage>,
+    ) {
         let arg_name = self.gen_node(node);
         let arg_array = if is_capture {
             "k_args->captured"
@@ -1713,6 +1805,7 @@ impl<'a> FunctionEmitter<'a> {
                 .unwrap();
             }
             Instruction::Texture2D => {
+                self.gen_texture_storage(node, index, texture_storage);
                 writeln!(
                     &mut self.fwd_defs,
                     "    const Texture2D& {} = {}[{}].texture;",
@@ -1721,6 +1814,7 @@ impl<'a> FunctionEmitter<'a> {
                 .unwrap();
             }
             Instruction::Texture3D => {
+                self.gen_texture_storage(node, index, texture_storage);
                 writeln!(
                     &mut self.fwd_defs,
                     "    const Texture3D& {} = {}[{}].texture;",
@@ -1747,7 +1841,11 @@ impl<'a> FunctionEmitter<'a> {
             self.globals.args.insert(node, index);
         }
     }
-    fn gen_module(&mut self, module: &ir::KernelModule) {
+    fn gen_module(
+        &mut self,
+        module: &ir::KernelModule,
+        captured_texture_storages: &[Option<PixelStorage>],
+    ) {
         let mut phi_collector = PhiCollector::new();
         phi_collector.visit_block(module.module.entry);
         let PhiCollector {
@@ -1757,10 +1855,10 @@ impl<'a> FunctionEmitter<'a> {
         self.phis_per_block = phis_per_block;
         self.phis = phis;
         for (i, capture) in module.captures.as_ref().iter().enumerate() {
-            self.gen_arg(capture.node, i, true);
+            self.gen_arg(capture.node, i, true, captured_texture_storages[i]);
         }
         for (i, arg) in module.args.iter().enumerate() {
-            self.gen_arg(*arg, i, false);
+            self.gen_arg(*arg, i, false, None);
         }
         assert!(self.globals.global_vars.is_empty());
         self.globals.global_vars = self.node_to_var.clone();
@@ -1798,7 +1896,11 @@ pub struct Generated {
     pub messages: Vec<String>,
 }
 impl CpuCodeGen {
-    pub(crate) fn run(module: &ir::KernelModule) -> Generated {
+    // captured_texture_storages holds the storage of each captured texture, and None for other captures
+    pub(crate) fn run(
+        module: &ir::KernelModule,
+        captured_texture_storages: &[Option<PixelStorage>],
+    ) -> Generated {
         let mut globals = GlobalEmitter {
             message: vec![],
             generated_callables: HashMap::new(),
@@ -1807,11 +1909,12 @@ impl CpuCodeGen {
             captures: IndexMap::new(),
             args: IndexMap::new(),
             cpu_custom_ops: IndexMap::new(),
+            texture_storages: HashMap::new(),
             callable_def: String::new(),
         };
         let type_gen = TypeGen::new();
         let mut codegen = FunctionEmitter::new(&mut globals, &type_gen);
-        codegen.gen_module(module);
+        codegen.gen_module(module, captured_texture_storages);
         let defs = r#"using uint8_t = unsigned char;
 using uint16_t = unsigned short;
 using uint32_t = unsigned int;
@@ -1825,11 +1928,12 @@ struct Accel;"#;
         let kernel_fn_decl = r#"lc_kernel void ##kernel_fn##(const KernelFnArgs* k_args) {"#;
         Generated {
             source: format!(
-                "{}\n{}\n{}\n{}\n{}\n{}\n{}\n{}\n{}\n{}\n{}\n{}\n{}",
+                "{}\n{}\n{}\n{}\n{}\n{}\n{}\n{}\n{}\n{}\n{}\n{}\n{}\n{}",
                 defs,
                 CPU_LIBM_DEF,
                 CPU_KERNEL_DEFS,
                 CPU_PRELUDE,
+                CPU_MATH,
                 DEVICE_MATH_SRC,
                 CPU_RESOURCE,
                 CPU_TEXTURE,
@@ -1845,7 +1949,13 @@ struct Accel;"#;
     }
 }
 
+pub(crate) fn pixel_storage_name(storage: PixelStorage) -> String {
+    // Float4 -> LC_PIXEL_STORAGE_FLOAT4, Bc7 -> LC_PIXEL_STORAGE_BC7
+    format!("LC_PIXEL_STORAGE_{:?}", storage).to_uppercase()
+}
+
 pub const CPU_PRELUDE: &str = include_str!("cpu_prelude.h");
+pub const CPU_MATH: &str = include_str!("cpu_math.h");
 pub const CPU_RESOURCE: &str = include_str!("cpu_resource.h");
 pub const DEVICE_MATH_SRC: &str = include_str!("device_math.h");
 pub const CPU_LIBM_DEF: &str = include_str!("cpu_libm_def.h");
@@ -0,0 +1,438 @@
+// Transcendental functions of CPU kernels. They are inlined into the kernel
+// instead of calling into libm, so that LLVM can vectorize them across the
+// components of vector types and unrolled loops. There are two tiers:
+//  - accurate: evaluated in double precision, within 1 ULP of the exact result
+//  - fast: evaluated in single precision, within a few ULPs for |x| < 1e5 in
+//    trigonometric functions, with subnormal results of exp flushed to zero
+// Kernels compiled with ShaderOption::enable_fast_math use the fast tier.
+namespace lc_math {
+
+[[nodiscard]] inline float as_float(unsigned int x) noexcept { return __builtin_bit_cast(float, x); }
+[[nodiscard]] inline unsigned int as_uint(float x) noexcept { return __builtin_bit_cast(unsigned int, x); }
+[[nodiscard]] inline double as_double(unsigned long long x) noexcept { return __builtin_bit_cast(double, x); }
+[[nodiscard]] inline float mad(float a, float b, float c) noexcept { return __builtin_fmaf(a, b, c); }
+[[nodiscard]] inline double mad(double a, double b, double c) noexcept { return __builtin_fma(a, b, c); }
+[[nodiscard]] inline float copy_sign(float x, float s) noexcept { return as_float((as_uint(x) & 0x7fffffffu) | (as_uint(s) & 0x80000000u)); }
+
+// c0 + x * (c1 + x * (c2 + ...))
+template<typename T, typename... C>
+[[nodiscard]] inline T horner(T x, double c0, C... c) noexcept {
+    if constexpr (sizeof...(c) == 0) {
+        return static_cast<T>(c0);
+    } else {
+        return mad(x, horner(x, c...), static_cast<T>(c0));
+    }
+}
+
+// 2^k for -1022 <= k <= 1023
+[[nodiscard]] inline double exp2i(long long k) noexcept {
+    return as_double(static_cast<unsigned long long>(k + 1023) << 52);
+}
+
+// logarithms of zero, negative, infinite and NaN arguments
+[[nodiscard]] inline float log_special(float x, float r) noexcept {
+    r = x == 0.f ? -__builtin_inff() : r;
+    r = x < 0.f ? __builtin_nanf("") : r;
+    return x == __builtin_inff() || x != x ? x : r;
+}
+
+// bits of 2 / pi after the binary point
+constexpr unsigned int two_over_pi_bits[] = {
+    0xa2f9836eu, 0x4e441529u, 0xfc2757d1u, 0xf534ddc0u,
+    0xdb629599u, 0x3c439041u, 0xfe5163abu, 0xdebbc561u};
+
+// x - q * pi / 2 for finite |x| >= 2^25, with the quadrant q mod 4. Since x = m * 2^(e - 150),
+// the bits of 2 / pi from j = e - 152 on give the fraction of x * 2 / pi mod 4 as m * w / 2^94,
+// and the bits before them only add multiples of 4
+[[nodiscard]] inline double reduce_pio2_large(unsigned int u, int &q) noexcept {
+    auto j = static_cast<int>((u >> 23u) & 0xffu) - 152;
+    auto t = two_over_pi_bits + (j >> 5);
+    auto s = 32u - static_cast<unsigned int>(j & 31);
+    auto window = [t, s](int i) noexcept {
+        auto bits = (static_cast<unsigned long long>(t[i]) << 32u) | t[i + 1];
+        return (bits >> s) & 0xffffffffull;
+    };
+    auto m = static_cast<unsigned long long>((u & 0x7fffffu) | 0x800000u);
+    auto p0 = (m * window(0)) & 0xffffffffull;
+    auto p1 = m * window(1);
+    auto p2 = m * window(2);
+    // 2 integer and 62 fraction bits of x * 2 / pi mod 4
+    auto f = (p0 << 32u) + p1 + (p2 >> 32u);
+    auto n = (f + (1ull << 61u)) >> 62u;
+    auto r = static_cast<double>(static_cast<long long>(f - (n << 62u))) * 0x1.921fb54442d18p-62;
+    auto negative = (u >> 31u) != 0u;
+    q = negative ? -static_cast<int>(n) : static_cast<int>(n);
+    return negative ? -r : r;
+}
+
+// x - q * pi / 2 in [-pi / 4, pi / 4] for finite x, with the quadrant q mod 4
+[[nodiscard]] inline double reduce_pio2(float x, int &q) noexcept {
+    auto u = as_uint(x);
+    if (((u >> 23u) & 0xffu) >= 152u) [[unlikely]] { return reduce_pio2_large(u, q); }
+    // subtract the nearest multiple of pi / 2 split into two doubles
+    auto d = static_cast<double>(x);
+    auto k = __builtin_rint(d * 0.63661977236758134);
+    auto r = mad(-k, 0x1.921fb54442d18p0, d);
+    q = static_cast<int>(k);
+    return mad(-k, 0x1.1a62633145c07p-54, r);
+}
+
+namespace accurate {
+
+// e^r for |r| <= ln(2) / 2
+[[nodiscard]] inline double exp_poly(double r) noexcept {
+    return horner(r, 1., 1., 1. / 2., 1. / 6., 1. / 24., 1. / 120., 1. / 720., 1. / 5040.,
+                  1. / 40320., 1. / 362880., 1. / 3628800., 1. / 39916800.);
+}
+
+// 2^x for |x| <= 1000
+[[nodiscard]] inline double exp2_core(double x) noexcept {
+    auto k = __builtin_rint(x);
+    return exp_poly((x - k) * 0.69314718055994531) * exp2i(static_cast<long long>(k));
+}
+
+// e^x for |x| <= 700
+[[nodiscard]] inline double exp_core(double x) noexcept {
+    auto k = __builtin_rint(x * 1.4426950408889634);
+    auto r = mad(-k, 0x1.62e42fefa39efp-1, x);
+    r = mad(-k, 0x1.abc9e3b39803fp-56, r);
+    return exp_poly(r) * exp2i(static_cast<long long>(k));
+}
+
+// ln(x) for positive finite x, split into the exponent and ln of the significand
+[[nodiscard]] inline double log_core(float x, double &e) noexcept {
+    auto sub = x < 0x1p-126f;
+    auto u = as_uint(sub ? x * 0x1p23f : x) - 0x3f3504f3u;
+    e = static_cast<double>((static_cast<int>(u) >> 23) - (sub ? 23 : 0));
+    // m in [sqrt(2) / 2, sqrt(2)), ln(m) = 2 atanh(s) with s = (m - 1) / (m + 1)
+    auto m = static_cast<double>(as_float((u & 0x7fffffu) + 0x3f3504f3u));
+    auto s = (m - 1.) / (m + 1.);
+    auto z = s * s;
+    return 2. * s * horner(z, 1., 1. / 3., 1. / 5., 1. / 7., 1. / 9., 1. / 11., 1. / 13., 1. / 15., 1. / 17.);
+}
+
+[[nodiscard]] inline float exp(float x) noexcept {
+    auto d = x > -110.f ? static_cast<double>(x) : -110.;
+    auto r = static_cast<float>(exp_core(d < 100. ? d : 100.));
+    return x != x ? x : r;
+}
+
+[[nodiscard]] inline float exp2(float x) noexcept {
+    auto d = x > -160.f ? static_cast<double>(x) : -160.;
+    auto r = static_cast<float>(exp2_core(d < 140. ? d : 140.));
+    return x != x ? x : r;
+}
+
+[[nodiscard]] inline float exp10(float x) noexcept {
+    auto d = x > -50.f ? static_cast<double>(x) : -50.;
+    auto r = static_cast<float>(exp_core((d < 40. ? d : 40.) * 2.3025850929940457));
+    return x != x ? x : r;
+}
+
+[[nodiscard]] inline float log(float x) noexcept {
+    double e;
+    auto l = log_core(x, e);
+    return log_special(x, static_cast<float>(mad(e, 0.69314718055994531, l)));
+}
+
+[[nodiscard]] inline float log2(float x) noexcept {
+    double e;
+    auto l = log_core(x, e);
+    return log_special(x, static_cast<float>(mad(l, 1.4426950408889634, e)));
+}
+
+[[nodiscard]] inline float log10(float x) noexcept {
+    double e;
+    auto l = log_core(x, e);
+    return log_special(x, static_cast<float>(mad(e, 0.69314718055994531, l) * 0.43429448190325183));
+}
+
+[[nodiscard]] inline float pow(float x, float y) noexcept {
+    auto ax = __builtin_fabsf(x);
+    double e;
+    auto l = log_core(ax, e);
+    auto log2_x = mad(l, 1.4426950408889634, e);
+    log2_x = ax == 0.f ? -__builtin_inf() : log2_x;
+    log2_x = ax == __builtin_inff() ? __builtin_inf() : log2_x;
+    auto t = static_cast<double>(y) * log2_x;
+    t = t > -1000. ? t : -1000.;
+    auto r = static_cast<float>(exp2_core(t < 1000. ? t : 1000.));
+    auto ay = y < 0.f ? -y : y;
+    auto y_int = __builtin_rintf(y) == y;
+    auto y_odd = y_int && ay < 0x1p24f && (static_cast<int>(ay < 0x1p24f ? y : 0.f) & 1);
+    r = (as_uint(x) >> 31u) && y_odd ? -r : r;
+    r = x < 0.f && x > -__builtin_inff() && !y_int ? __builtin_nanf("") : r;
+    r = x != x || y != y ? x + y : r;
+    r = x == -1.f && ay == __builtin_inff() ? 1.f : r;
+    return y == 0.f || x == 1.f ? 1.f : r;
+}
+
+// sin(r) and cos(r) for |r| <= pi / 4
+[[nodiscard]] inline double sin_poly(double r) noexcept {
+    auto z = r * r;
+    return mad(r * z, horner(z, -1. / 6., 1. / 120., -1. / 5040., 1. / 362880., -1. / 39916800., 1. / 6227020800.), r);
+}
+
+[[nodiscard]] inline double cos_poly(double r) noexcept {
+    auto z = r * r;
+    return horner(z, 1., -1. / 2., 1. / 24., -1. / 720., 1. / 40320., -1. / 3628800., 1. / 479001600., -1. / 87178291200.);
+}
+
+[[nodiscard]] inline float sin(float x) noexcept {
+    int q;
+    auto r = reduce_pio2(x, q);
+    auto s = (q & 1) ? cos_poly(r) : sin_poly(r);
+    auto v = static_cast<float>((q & 2) ? -s : s);
+    // sin(-0) = -0
+    return x - x == 0.f ? (x == 0.f ? x : v) : x - x;
+}
+
+[[nodiscard]] inline float cos(float x) noexcept {
+    int q;
+    auto r = reduce_pio2(x, q);
+    auto c = (q & 1) ? sin_poly(r) : cos_poly(r);
+    auto v = static_cast<float>(((q + 1) & 2) ? -c : c);
+    return x - x == 0.f ? v : x - x;
+}
+
+[[nodiscard]] inline float tan(float x) noexcept {
+    int q;
+    auto r = reduce_pio2(x, q);
+    auto s = sin_poly(r);
+    auto c = cos_poly(r);
+    auto v = static_cast<float>((q & 1) ? -c / s : s / c);
+    return x - x == 0.f ? (x == 0.f ? x : v) : x - x;
+}
+
+// atan(t) for t in [0, 1]
+[[nodiscard]] inline double atan_core(double t) noexcept {
+    // atan(t) = pi / 6 + atan((sqrt(3) t - 1) / (t + sqrt(3))) for t > tan(pi / 12)
+    auto reduce = t > 0.26794919243112270;
+    t = reduce ? (t * 1.7320508075688773 - 1.) / (t + 1.7320508075688773) : t;
+    auto z = t * t;
+    auto p = mad(t * z, horner(z, -1. / 3., 1. / 5., -1. / 7., 1. / 9., -1. / 11., 1. / 13., -1. / 15., 1. / 17., -1. / 19., 1. / 21.), t);
+    return reduce ? p + 0.52359877559829887 : p;
+}
+
+[[nodiscard]] inline double atan2_core(double y, double x) noexcept {
+    auto ay = __builtin_fabs(y);
+    auto ax = __builtin_fabs(x);
+    auto swap = ay > ax;
+    auto n = swap ? ax : ay;
+    auto d = swap ? ay : ax;
+    // equal magnitudes, including both zero or both infinite
+    auto t = n == d ? (n == 0. ? 0. : 1.) : n / d;
+    auto v = atan_core(t);
+    v = swap ? 1.5707963267948966 - v : v;
+    v = __builtin_signbit(x) ? 3.1415926535897932 - v : v;
+    return __builtin_copysign(v, y);
+}
+
+[[nodiscard]] inline float atan(float x) noexcept {
+    return static_cast<float>(atan2_core(static_cast<double>(x), 1.));
+}
+
+[[nodiscard]] inline float atan2(float y, float x) noexcept {
+    return static_cast<float>(atan2_core(static_cast<double>(y), static_cast<double>(x)));
+}
+
+[[nodiscard]] inline float asin(float x) noexcept {
+    auto d = static_cast<double>(x);
+    return static_cast<float>(atan2_core(d, __builtin_sqrt((1. - d) * (1. + d))));
+}
+
+[[nodiscard]] inline float acos(float x) noexcept {
+    auto d = static_cast<double>(x);
+    return static_cast<float>(atan2_core(__builtin_sqrt((1. - d) * (1. + d)), d));
+}
+
+}// namespace accurate
+
+namespace fast {
+
+// e^r for |r| <= ln(2) / 2
+[[nodiscard]] inline float exp_poly(float r) noexcept {
+    auto p = horner(r, 5.0000001201e-1, 1.6666665459e-1, 4.1665795894e-2,
+                    8.3334519073e-3, 1.3981999507e-3, 1.9875691500e-4);
+    return mad(r * r, p, r) + 1.f;
+}
+
+// e^r * 2^k, k in [-150, 150] is applied in two steps to reach subnormals and infinity
+[[nodiscard]] inline float exp_scale(float p, float k) noexcept {
+    auto k0 = static_cast<int>(k) >> 1;
+    auto k1 = static_cast<int>(k) - k0;
+    return p * as_float(static_cast<unsigned int>(k0 + 127) << 23u) *
+           as_float(static_cast<unsigned int>(k1 + 127) << 23u);
+}
+
+[[nodiscard]] inline float exp(float x) noexcept {
+    x = x > -104.f ? x : -104.f;
+    x = x < 89.f ? x : 89.f;
+    auto k = __builtin_rintf(x * 1.44269504f);
+    auto r = mad(-k, 0x1.62e430p-1f, x);
+    r = mad(-k, -0x1.05c610p-29f, r);
+    return exp_scale(exp_poly(r), k);
+}
+
+[[nodiscard]] inline float exp2(float x) noexcept {
+    x = x > -150.f ? x : -150.f;
+    x = x < 129.f ? x : 129.f;
+    auto k = __builtin_rintf(x);
+    return exp_scale(exp_poly((x - k) * 0.693147181f), k);
+}
+
+[[nodiscard]] inline float exp10(float x) noexcept {
+    x = x > -46.f ? x : -46.f;
+    x = x < 39.f ? x : 39.f;
+    auto k = __builtin_rintf(x * 3.32192809f);
+    auto r = mad(-k, 0x1.344136p-2f, x);
+    r = mad(-k, -0x1.ec10c0p-27f, r);
+    // r * ln(10) with ln(10) split into two floats
+    return exp_scale(exp_poly(mad(r, 0x1.26bb1cp1f, r * -0x1.12aabap-25f)), k);
+}
+
+// ln(x) for positive finite x, split into the exponent and ln of the significand
+[[nodiscard]] inline float log_core(float x, float &e) noexcept {
+    auto sub = x < 0x1p-126f;
+    auto u = as_uint(sub ? x * 0x1p23f : x) - 0x3f3504f3u;
+    e = static_cast<float>((static_cast<int>(u) >> 23) - (sub ? 23 : 0));
+    // f = m - 1 with m in [sqrt(2) / 2, sqrt(2))
+    auto f = as_float((u & 0x7fffffu) + 0x3f3504f3u) - 1.f;
+    auto z = f * f;
+    auto p = horner(f, 3.3333331174e-1, -2.4999993993e-1, 2.0000714765e-1,
+                    -1.6668057665e-1, 1.4249322787e-1, -1.2420140846e-1,
+                    1.1676998740e-1, -1.1514610310e-1, 7.0376836292e-2);
+    return f + mad(f * z, p, -0.5f * z);
+}
+
+[[nodiscard]] inline float log(float x) noexcept {
+    float e;
+    auto l = log_core(x, e);
+    // ln(2) split so that e * ln2_hi is exact
+    return log_special(x, mad(e, 0.693359375f, mad(e, -2.12194440e-4f, l)));
+}
+
+[[nodiscard]] inline float log2(float x) noexcept {
+    float e;
+    auto l = log_core(x, e);
+    return log_special(x, mad(l, 1.44269504f, e));
+}
+
+[[nodiscard]] inline float log10(float x) noexcept {
+    float e;
+    auto l = log_core(x, e);
+    // log10(2) split so that e * lg2_hi is exact
+    return log_special(x, mad(e, 0.30078125f, mad(l, 0.434294482f, e * 2.48745664e-4f)));
+}
+
+// a single-precision logarithm would lose the accuracy of large results
+[[nodiscard]] inline float pow(float x, float y) noexcept {
+    return accurate::pow(x, y);
+}
+
+// x - q * pi / 2 with pi / 2 split into three floats
+[[nodiscard]] inline float reduce_pio2(float x, int &q) noexcept {
+    auto k = __builtin_rintf(x * 0.636619772f);
+    auto r = mad(-k, 0x1.921fb6p0f, x);
+    r = mad(-k, -0x1.777a5cp-25f, r);
+    r = mad(-k, -0x1.ee59dap-50f, r);
+    q = static_cast<int>(k - 4.f * __builtin_floorf(k * .25f));
+    return r;
+}
+
+// sin(r) and cos(r) for |r| <= pi / 4
+[[nodiscard]] inline float sin_poly(float r) noexcept {
+    auto z = r * r;
+    return mad(r * z, horner(z, -1.6666654611e-1, 8.3321608736e-3, -1.9515295891e-4), r);
+}
+
+[[nodiscard]] inline float cos_poly(float r) noexcept {
+    auto z = r * r;
+    return mad(z * z, horner(z, 4.166664568298827e-2, -1.388731625493765e-3, 2.443315711809948e-5), mad(-.5f, z, 1.f));
+}
+
+[[nodiscard]] inline float sin(float x) noexcept {
+    int q;
+    auto r = reduce_pio2(x, q);
+    auto s = (q & 1) ? cos_poly(r) : sin_poly(r);
+    return (q & 2) ? -s : s;
+}
+
+[[nodiscard]] inline float cos(float x) noexcept {
+    int q;
+    auto r = reduce_pio2(x, q);
+    auto c = (q & 1) ? sin_poly(r) : cos_poly(r);
+    return ((q + 1) & 2) ? -c : c;
+}
+
+[[nodiscard]] inline float tan(float x) noexcept {
+    int q;
+    auto r = reduce_pio2(x, q);
+    auto s = sin_poly(r);
+    auto c = cos_poly(r);
+    return (q & 1) ? -c / s : s / c;
+}
+
+// atan(t) for t >= 0
+[[nodiscard]] inline float atan_core(float t) noexcept {
+    // reduced by atan(t) = pi / 2 + atan(-1 / t) and atan(t) = pi / 4 + atan((t - 1) / (t + 1))
+    auto large = t > 2.414213562f;
+    auto medium = t > 0.414213562f;
+    auto n = large ? -1.f : (medium ? t - 1.f : t);
+    auto d = large ? t : (medium ? t + 1.f : 1.f);
+    t = n / d;
+    auto z = t * t;
+    auto p = mad(t * z, horner(z, -3.33329491539e-1, 1.99777106478e-1, -1.38776856032e-1, 8.05374449538e-2), t);
+    return p + (large ? 1.570796327f : (medium ? 0.785398163f : 0.f));
+}
+
+[[nodiscard]] inline float atan(float x) noexcept {
+    return copy_sign(atan_core(__builtin_fabsf(x)), x);
+}
+
+[[nodiscard]] inline float atan2(float y, float x) noexcept {
+    auto ay = __builtin_fabsf(y);
+    auto ax = __builtin_fabsf(x);
+    auto swap = ay > ax;
+    auto n = swap ? ax : ay;
+    auto d = swap ? ay : ax;
+    auto t = n == d ? (n == 0.f ? 0.f : 1.f) : n / d;
+    auto v = atan_core(t);
+    v = swap ? 1.570796327f - v : v;
+    v = (as_uint(x) >> 31u) ? 3.141592654f - v : v;
+    return copy_sign(v, y);
+}
+
+// asin(s) for |s| <= 1 / 2 and z = s * s
+[[nodiscard]] inline float asin_poly(float s, float z) noexcept {
+    return mad(s * z, horner(z, 1.6666752422e-1, 7.4953002686e-2, 4.5470025998e-2, 2.4181311049e-2, 4.2163199048e-2), s);
+}
+
+[[nodiscard]] inline float asin(float x) noexcept {
+    // asin(x) = pi / 2 - 2 asin(sqrt((1 - x) / 2)) for x > 1 / 2
+    auto a = __builtin_fabsf(x);
+    auto large = a > .5f;
+    auto z = large ? .5f * (1.f - a) : a * a;
+    auto s = large ? __builtin_sqrtf(z) : a;
+    auto p = asin_poly(s, z);
+    return copy_sign(large ? 1.570796327f - 2.f * p : p, x);
+}
+
+[[nodiscard]] inline float acos(float x) noexcept {
+    auto a = __builtin_fabsf(x);
+    auto large = a > .5f;
+    auto z = large ? .5f * (1.f - a) : x * x;
+    auto s = large ? __builtin_sqrtf(z) : x;
+    auto p = asin_poly(s, z);
+    return large ? (x > 0.f ? 2.f * p : 3.141592654f - 2.f * p) : 1.570796327f - p;
+}
+
+}// namespace fast
+
+}// namespace lc_math
+
+#ifdef LUISA_FAST_MATH
+namespace lc_math_impl = lc_math::fast;
+#else
+namespace lc_math_impl = lc_math::accurate;
+#endif
@@ -120,12 +120,12 @@ inline BindlessArray lc_bindless_capture(const KernelFnArgs *k_args, size_t i) n
 inline BufferView
 lc_bindless_buffer(const KernelFnArgs *k_args, const BindlessArray &array, size_t buf_index) noexcept {
 #ifdef LUISA_DEBUG
-    if (buf_index >= array.buffers_count) {
+    if (buf_index >= array.slots_count) {
         lc_abort_and_print_sll(k_args->internal_data, "Bindless buffer index out of bounds: {} >= {}", buf_index,
-                               array.buffers_count);
+                               array.slots_count);
     }
 #endif
-    return array.buffers[buf_index];
+    return array.slots[buf_index].buffer;
 }
 
 inline uint64_t
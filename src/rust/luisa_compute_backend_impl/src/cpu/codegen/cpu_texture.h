@@ -26,8 +26,15 @@ typedef enum LCPixelStorage {
     LC_PIXEL_STORAGE_FLOAT1,
     LC_PIXEL_STORAGE_FLOAT2,
     LC_PIXEL_STORAGE_FLOAT4,
+    LC_PIXEL_STORAGE_BC4,
+    LC_PIXEL_STORAGE_BC5,
+    LC_PIXEL_STORAGE_BC6,
+    LC_PIXEL_STORAGE_BC7,
 } LCPixelStorage;
 
+// texture accessors take the storage as a template argument, this one defers it to the texture
+constexpr int LC_PIXEL_STORAGE_DYNAMIC = -1;
+
 typedef enum LCSamplerAddress {
     LC_SAMPLER_ADDRESS_EDGE,
     LC_SAMPLER_ADDRESS_REPEAT,
@@ -385,6 +392,423 @@ namespace detail {
         }
     }
 
+    // element type and channel count of a storage known when the kernel is compiled
+    template<int storage>
+    struct pixel_format {};
+
+#define LC_PIXEL_FORMAT(storage_, type_, channels_)    \
+    template<>                                         \
+    struct pixel_format<storage_> {                    \
+        using type = type_;                            \
+        static constexpr lc_uint channels = channels_; \
+    };
+    LC_PIXEL_FORMAT(LC_PIXEL_STORAGE_BYTE1, uint8_t, 1u)
+    LC_PIXEL_FORMAT(LC_PIXEL_STORAGE_BYTE2, uint8_t, 2u)
+    LC_PIXEL_FORMAT(LC_PIXEL_STORAGE_BYTE4, uint8_t, 4u)
+    LC_PIXEL_FORMAT(LC_PIXEL_STORAGE_SHORT1, uint16_t, 1u)
+    LC_PIXEL_FORMAT(LC_PIXEL_STORAGE_SHORT2, uint16_t, 2u)
+    LC_PIXEL_FORMAT(LC_PIXEL_STORAGE_SHORT4, uint16_t, 4u)
+    LC_PIXEL_FORMAT(LC_PIXEL_STORAGE_INT1, uint32_t, 1u)
+    LC_PIXEL_FORMAT(LC_PIXEL_STORAGE_INT2, uint32_t, 2u)
+    LC_PIXEL_FORMAT(LC_PIXEL_STORAGE_INT4, uint32_t, 4u)
+    LC_PIXEL_FORMAT(LC_PIXEL_STORAGE_HALF1, float16_t, 1u)
+    LC_PIXEL_FORMAT(LC_PIXEL_STORAGE_HALF2, float16_t, 2u)
+    LC_PIXEL_FORMAT(LC_PIXEL_STORAGE_HALF4, float16_t, 4u)
+    LC_PIXEL_FORMAT(LC_PIXEL_STORAGE_FLOAT1, float, 1u)
+    LC_PIXEL_FORMAT(LC_PIXEL_STORAGE_FLOAT2, float, 2u)
+    LC_PIXEL_FORMAT(LC_PIXEL_STORAGE_FLOAT4, float, 4u)
+#undef LC_PIXEL_FORMAT
+
+    template<class V, typename T, int storage>
+    [[nodiscard]] inline V read_static_pixel(const uint8_t *p) noexcept {
+        using F = pixel_format<storage>;
+        return detail::read_pixel<V, T, typename F::type, F::channels>(p);
+    }
+
+    template<typename V, typename T, int storage>
+    inline void write_static_pixel(uint8_t *p, V v) noexcept {
+        using F = pixel_format<storage>;
+        detail::write_pixel<V, T, typename F::type, F::channels>(p, v);
+    }
+
+// Block compression (BC4-BC7) decoding, following the Direct3D 11 functional specification
+    struct BCBitReader {
+        uint64_t lo;
+        uint64_t hi;
+        lc_uint offset;
+
+        explicit BCBitReader(const uint8_t *block) noexcept : lo{0u}, hi{0u}, offset{0u} {
+            for (auto i = 0u; i < 8u; i++) {
+                lo |= static_cast<uint64_t>(block[i]) << (i * 8u);
+                hi |= static_cast<uint64_t>(block[i + 8u]) << (i * 8u);
+            }
+        }
+
+        [[nodiscard]] lc_uint read(lc_uint n) noexcept {
+            if (n == 0u) { return 0u; }
+            auto bits = offset >= 64u ? hi >> (offset - 64u) :
+                        offset == 0u  ? lo :
+                                        (lo >> offset) | (hi << (64u - offset));
+            offset += n;
+            return static_cast<lc_uint>(bits & ((static_cast<uint64_t>(1u) << n) - 1u));
+        }
+    };
+
+    // subset of each texel in the 2-subset partitions, one bit per texel
+    static constexpr const uint16_t bc_partitions2[64] = {
+            0xccccu, 0x8888u, 0xeeeeu, 0xecc8u, 0xc880u, 0xfeecu, 0xfec8u, 0xec80u,
+            0xc800u, 0xffecu, 0xfe80u, 0xe800u, 0xffe8u, 0xff00u, 0xfff0u, 0xf000u,
+            0xf710u, 0x008eu, 0x7100u, 0x08ceu, 0x008cu, 0x7310u, 0x3100u, 0x8cceu,
+            0x088cu, 0x3110u, 0x6666u, 0x366cu, 0x17e8u, 0x0ff0u, 0x718eu, 0x399cu,
+            0xaaaau, 0xf0f0u, 0x5a5au, 0x33ccu, 0x3c3cu, 0x55aau, 0x9696u, 0xa55au,
+            0x73ceu, 0x13c8u, 0x324cu, 0x3bdcu, 0x6996u, 0xc33cu, 0x9966u, 0x0660u,
+            0x0272u, 0x04e4u, 0x4e40u, 0x2720u, 0xc936u, 0x936cu, 0x39c6u, 0x639cu,
+            0x9336u, 0x9cc6u, 0x817eu, 0xe718u, 0xccf0u, 0x0fccu, 0x7744u, 0xee22u,
+    };
+
+    // subset of each texel in the 3-subset partitions, two bits per texel
+    static constexpr const uint32_t bc_partitions3[64] = {
+            0xaa685050u, 0x6a5a5040u, 0x5a5a4200u, 0x5450a0a8u,
+            0xa5a50000u, 0xa0a05050u, 0x5555a0a0u, 0x5a5a5050u,
+            0xaa550000u, 0xaa555500u, 0xaaaa5500u, 0x90909090u,
+            0x94949494u, 0xa4a4a4a4u, 0xa9a59450u, 0x2a0a4250u,
+            0xa5945040u, 0x0a425054u, 0xa5a5a500u, 0x55a0a0a0u,
+            0xa8a85454u, 0x6a6a4040u, 0xa4a45000u, 0x1a1a0500u,
+            0x0050a4a4u, 0xaaa59090u, 0x14696914u, 0x69691400u,
+            0xa08585a0u, 0xaa821414u, 0x50a4a450u, 0x6a5a0200u,
+            0xa9a58000u, 0x5090a0a8u, 0xa8a09050u, 0x24242424u,
+            0x00aa5500u, 0x24924924u, 0x24499224u, 0x50a50a50u,
+            0x500aa550u, 0xaaaa4444u, 0x66660000u, 0xa5a0a5a0u,
+            0x50a050a0u, 0x69286928u, 0x44aaaa44u, 0x66666600u,
+            0xaa444444u, 0x54a854a8u, 0x95809580u, 0x96969600u,
+            0xa85454a8u, 0x80959580u, 0xaa141414u, 0x96960000u,
+            0xaaaa1414u, 0xa05050a0u, 0xa0a5a5a0u, 0x96000000u,
+            0x40804080u, 0xa9a8a9a8u, 0xaaaaaa44u, 0x2a4a5254u,
+    };
+
+    // anchor texel of the second subset in the 2-subset partitions
+    static constexpr const uint8_t bc_anchors2[64] = {
+            15u, 15u, 15u, 15u, 15u, 15u, 15u, 15u, 15u, 15u, 15u, 15u, 15u, 15u, 15u, 15u,
+            15u, 2u, 8u, 2u, 2u, 8u, 8u, 15u, 2u, 8u, 2u, 2u, 8u, 8u, 2u, 2u,
+            15u, 15u, 6u, 8u, 2u, 8u, 15u, 15u, 2u, 8u, 2u, 2u, 2u, 15u, 15u, 6u,
+            6u, 2u, 6u, 8u, 15u, 15u, 2u, 2u, 15u, 15u, 15u, 15u, 15u, 2u, 2u, 15u,
+    };
+
+    // anchor texels of the second and third subsets in the 3-subset partitions
+    static constexpr const uint8_t bc_anchors3[64][2] = {
+            {3u, 15u}, {3u, 8u}, {15u, 8u}, {15u, 3u}, {8u, 15u}, {3u, 15u}, {15u, 3u}, {15u, 8u},
+            {8u, 15u}, {8u, 15u}, {6u, 15u}, {6u, 15u}, {6u, 15u}, {5u, 15u}, {3u, 15u}, {3u, 8u},
+            {3u, 15u}, {3u, 8u}, {8u, 15u}, {15u, 3u}, {3u, 15u}, {3u, 8u}, {6u, 15u}, {10u, 8u},
+            {5u, 3u}, {8u, 15u}, {8u, 6u}, {6u, 10u}, {8u, 15u}, {5u, 15u}, {15u, 10u}, {15u, 8u},
+            {8u, 15u}, {15u, 3u}, {3u, 15u}, {5u, 10u}, {6u, 10u}, {10u, 8u}, {8u, 9u}, {15u, 10u},
+            {15u, 6u}, {3u, 15u}, {15u, 8u}, {5u, 15u}, {15u, 3u}, {15u, 6u}, {15u, 6u}, {15u, 8u},
+            {3u, 15u}, {15u, 3u}, {5u, 15u}, {5u, 15u}, {5u, 15u}, {8u, 15u}, {5u, 15u}, {10u, 15u},
+            {5u, 15u}, {10u, 15u}, {8u, 15u}, {13u, 15u}, {15u, 3u}, {12u, 15u}, {3u, 15u}, {3u, 8u},
+    };
+
+    static constexpr const lc_uint bc_weights2[4] = {0u, 21u, 43u, 64u};
+    static constexpr const lc_uint bc_weights3[8] = {0u, 9u, 18u, 27u, 37u, 46u, 55u, 64u};
+    static constexpr const lc_uint bc_weights4[16] = {0u, 4u, 9u, 13u, 17u, 21u, 26u, 30u,
+                                                      34u, 38u, 43u, 47u, 51u, 55u, 60u, 64u};
+
+    [[nodiscard]] inline lc_uint bc_interpolate(lc_uint e0, lc_uint e1, lc_uint index, lc_uint index_bits) noexcept {
+        auto w = index_bits == 2u ? bc_weights2[index] :
+                 index_bits == 3u ? bc_weights3[index] :
+                                    bc_weights4[index];
+        return ((64u - w) * e0 + w * e1 + 32u) >> 6u;
+    }
+
+    inline void decode_bc4_channel(const uint8_t *block, float (*texels)[4], lc_uint channel) noexcept {
+        auto r0 = static_cast<float>(block[0]);
+        auto r1 = static_cast<float>(block[1]);
+        float palette[8];
+        palette[0] = r0 / 255.f;
+        palette[1] = r1 / 255.f;
+        if (block[0] > block[1]) {
+            for (auto i = 1u; i < 7u; i++) {
+                palette[i + 1u] = (static_cast<float>(7u - i) * r0 + static_cast<float>(i) * r1) / (7.f * 255.f);
+            }
+        } else {
+            for (auto i = 1u; i < 5u; i++) {
+                palette[i + 1u] = (static_cast<float>(5u - i) * r0 + static_cast<float>(i) * r1) / (5.f * 255.f);
+            }
+            palette[6] = 0.f;
+            palette[7] = 1.f;
+        }
+        auto indices = static_cast<uint64_t>(0u);
+        for (auto i = 0u; i < 6u; i++) { indices |= static_cast<uint64_t>(block[i + 2u]) << (i * 8u); }
+        for (auto i = 0u; i < 16u; i++) { texels[i][channel] = palette[(indices >> (i * 3u)) & 7u]; }
+    }
+
+    struct BC7ModeInfo {
+        uint8_t subset_count;
+        uint8_t partition_bits;
+        uint8_t rotation_bits;
+        uint8_t index_selection_bits;
+        uint8_t color_bits;
+        uint8_t alpha_bits;
+        uint8_t endpoint_pbits;
+        uint8_t shared_pbits;
+        uint8_t index_bits;
+        uint8_t secondary_index_bits;
+    };
+
+    static constexpr const BC7ModeInfo bc7_modes[8] = {
+            {3u, 4u, 0u, 0u, 4u, 0u, 1u, 0u, 3u, 0u},
+            {2u, 6u, 0u, 0u, 6u, 0u, 0u, 1u, 3u, 0u},
+            {3u, 6u, 0u, 0u, 5u, 0u, 0u, 0u, 2u, 0u},
+            {2u, 6u, 0u, 0u, 7u, 0u, 1u, 0u, 2u, 0u},
+            {1u, 0u, 2u, 1u, 5u, 6u, 0u, 0u, 2u, 3u},
+            {1u, 0u, 2u, 0u, 7u, 8u, 0u, 0u, 2u, 2u},
+            {1u, 0u, 0u, 0u, 7u, 7u, 1u, 0u, 4u, 0u},
+            {2u, 6u, 0u, 0u, 5u, 5u, 1u, 0u, 2u, 0u},
+    };
+
+    inline void decode_bc7(const uint8_t *block, float (*texels)[4]) noexcept {
+        BCBitReader reader{block};
+        auto mode = 0u;
+        while (mode < 8u && reader.read(1u) == 0u) { mode++; }
+        if (mode == 8u) [[unlikely]] {// reserved
+            for (auto i = 0u; i < 16u; i++) {
+                for (auto c = 0u; c < 4u; c++) { texels[i][c] = 0.f; }
+            }
+            return;
+        }
+        auto &&m = bc7_modes[mode];
+        auto partition = reader.read(m.partition_bits);
+        auto rotation = reader.read(m.rotation_bits);
+        auto index_selection = reader.read(m.index_selection_bits);
+        auto endpoint_count = m.subset_count * 2u;
+        lc_uint endpoints[6][4];
+        for (auto c = 0u; c < 3u; c++) {
+            for (auto e = 0u; e < endpoint_count; e++) { endpoints[e][c] = reader.read(m.color_bits); }
+        }
+        for (auto e = 0u; e < endpoint_count; e++) {
+            endpoints[e][3] = m.alpha_bits == 0u ? 255u : reader.read(m.alpha_bits);
+        }
+        auto channel_count = m.alpha_bits == 0u ? 3u : 4u;
+        auto pbit_count = m.endpoint_pbits != 0u || m.shared_pbits != 0u ? 1u : 0u;
+        if (pbit_count != 0u) {
+            lc_uint pbits[6];
+            for (auto e = 0u; e < endpoint_count; e++) {
+                pbits[e] = m.shared_pbits == 0u || e % 2u == 0u ? reader.read(1u) : pbits[e - 1u];
+            }
+            for (auto e = 0u; e < endpoint_count; e++) {
+                for (auto c = 0u; c < channel_count; c++) { endpoints[e][c] = (endpoints[e][c] << 1u) | pbits[e]; }
+            }
+        }
+        // expand the endpoints to 8 bits by replicating their high bits
+        for (auto e = 0u; e < endpoint_count; e++) {
+            for (auto c = 0u; c < channel_count; c++) {
+                auto bits = (c == 3u ? m.alpha_bits : m.color_bits) + pbit_count;
+                auto v = endpoints[e][c] << (8u - bits);
+                endpoints[e][c] = v | (v >> bits);
+            }
+        }
+        lc_uint subsets[16];
+        lc_uint anchors[3] = {0u, 0u, 0u};
+        for (auto i = 0u; i < 16u; i++) {
+            subsets[i] = m.subset_count == 1u ? 0u :
+                         m.subset_count == 2u ? (bc_partitions2[partition] >> i) & 1u :
+                                                (bc_partitions3[partition] >> (i * 2u)) & 3u;
+        }
+        if (m.subset_count == 2u) {
+            anchors[1] = bc_anchors2[partition];
+        } else if (m.subset_count == 3u) {
+            anchors[1] = bc_anchors3[partition][0];
+            anchors[2] = bc_anchors3[partition][1];
+        }
+        // the most significant bit of an anchor index is implicitly zero
+        lc_uint color_indices[16];
+        lc_uint alpha_indices[16];
+        for (auto i = 0u; i < 16u; i++) {
+            color_indices[i] = reader.read(m.index_bits - (i == anchors[subsets[i]] ? 1u : 0u));
+        }
+        for (auto i = 0u; i < 16u; i++) {
+            alpha_indices[i] = m.secondary_index_bits == 0u ?
+                                   color_indices[i] :
+                                   reader.read(m.secondary_index_bits - (i == 0u ? 1u : 0u));
+        }
+        auto color_index_bits = static_cast<lc_uint>(m.index_bits);
+        auto alpha_index_bits = m.secondary_index_bits == 0u ? color_index_bits : m.secondary_index_bits;
+        if (index_selection != 0u) {
+            auto t = color_index_bits;
+            color_index_bits = alpha_index_bits;
+            alpha_index_bits = t;
+        }
+        for (auto i = 0u; i < 16u; i++) {
+            auto color_index = index_selection != 0u ? alpha_indices[i] : color_indices[i];
+            auto alpha_index = index_selection != 0u ? color_indices[i] : alpha_indices[i];
+            auto &&e0 = endpoints[subsets[i] * 2u];
+            auto &&e1 = endpoints[subsets[i] * 2u + 1u];
+            lc_uint v[4];
+            for (auto c = 0u; c < 3u; c++) { v[c] = bc_interpolate(e0[c], e1[c], color_index, color_index_bits); }
+            v[3] = bc_interpolate(e0[3], e1[3], alpha_index, alpha_index_bits);
+            if (rotation != 0u) {
+                auto t = v[3];
+                v[3] = v[rotation - 1u];
+                v[rotation - 1u] = t;
+            }
+            for (auto c = 0u; c < 4u; c++) { texels[i][c] = static_cast<float>(v[c]) / 255.f; }
+        }
+    }
+
+    // a run of endpoint bits, in the order they are stored in the block
+    struct BC6HSegment {
+        uint8_t field;// endpoint * 3 + channel
+        uint8_t lsb;
+        uint8_t count;
+        bool reversed;
+    };
+
+    struct BC6HModeInfo {
+        bool partitioned;
+        bool transformed;
+        uint8_t endpoint_bits;
+        uint8_t delta_bits[3];
+        BC6HSegment segments[24];
+    };
+
+    enum BC6HField : uint8_t { rw, gw, bw, rx, gx, bx, ry, gy, by, rz, gz, bz };
+
+    static constexpr const BC6HModeInfo bc6h_modes[14] = {
+            {true, true, 10u, {5u, 5u, 5u}, {{gy, 4, 1}, {by, 4, 1}, {bz, 4, 1}, {rw, 0, 10}, {gw, 0, 10}, {bw, 0, 10}, {rx, 0, 5}, {gz, 4, 1}, {gy, 0, 4}, {gx, 0, 5}, {bz, 0, 1}, {gz, 0, 4}, {bx, 0, 5}, {bz, 1, 1}, {by, 0, 4}, {ry, 0, 5}, {bz, 2, 1}, {rz, 0, 5}, {bz, 3, 1}}},
+            {true, true, 7u, {6u, 6u, 6u}, {{gy, 5, 1}, {gz, 4, 1}, {gz, 5, 1}, {rw, 0, 7}, {bz, 0, 1}, {bz, 1, 1}, {by, 4, 1}, {gw, 0, 7}, {by, 5, 1}, {bz, 2, 1}, {gy, 4, 1}, {bw, 0, 7}, {bz, 3, 1}, {bz, 5, 1}, {bz, 4, 1}, {rx, 0, 6}, {gy, 0, 4}, {gx, 0, 6}, {gz, 0, 4}, {bx, 0, 6}, {by, 0, 4}, {ry, 0, 6}, {rz, 0, 6}}},
+            {true, true, 11u, {5u, 4u, 4u}, {{rw, 0, 10}, {gw, 0, 10}, {bw, 0, 10}, {rx, 0, 5}, {rw, 10, 1}, {gy, 0, 4}, {gx, 0, 4}, {gw, 10, 1}, {bz, 0, 1}, {gz, 0, 4}, {bx, 0, 4}, {bw, 10, 1}, {bz, 1, 1}, {by, 0, 4}, {ry, 0, 5}, {bz, 2, 1}, {rz, 0, 5}, {bz, 3, 1}}},
+            {true, true, 11u, {4u, 5u, 4u}, {{rw, 0, 10}, {gw, 0, 10}, {bw, 0, 10}, {rx, 0, 4}, {rw, 10, 1}, {gz, 4, 1}, {gy, 0, 4}, {gx, 0, 5}, {gw, 10, 1}, {gz, 0, 4}, {bx, 0, 4}, {bw, 10, 1}, {bz, 1, 1}, {by, 0, 4}, {ry, 0, 4}, {bz, 0, 1}, {bz, 2, 1}, {rz, 0, 4}, {gy, 4, 1}, {bz, 3, 1}}},
+            {true, true, 11u, {4u, 4u, 5u}, {{rw, 0, 10}, {gw, 0, 10}, {bw, 0, 10}, {rx, 0, 4}, {rw, 10, 1}, {by, 4, 1}, {gy, 0, 4}, {gx, 0, 4}, {gw, 10, 1}, {bz, 0, 1}, {gz, 0, 4}, {bx, 0, 5}, {bw, 10, 1}, {by, 0, 4}, {ry, 0, 4}, {bz, 1, 1}, {bz, 2, 1}, {rz, 0, 4}, {bz, 4, 1}, {bz, 3, 1}}},
+            {true, true, 9u, {5u, 5u, 5u}, {{rw, 0, 9}, {by, 4, 1}, {gw, 0, 9}, {gy, 4, 1}, {bw, 0, 9}, {bz, 4, 1}, {rx, 0, 5}, {gz, 4, 1}, {gy, 0, 4}, {gx, 0, 5}, {bz, 0, 1}, {gz, 0, 4}, {bx, 0, 5}, {bz, 1, 1}, {by, 0, 4}, {ry, 0, 5}, {bz, 2, 1}, {rz, 0, 5}, {bz, 3, 1}}},
+            {true, true, 8u, {6u, 5u, 5u}, {{rw, 0, 8}, {gz, 4, 1}, {by, 4, 1}, {gw, 0, 8}, {bz, 2, 1}, {gy, 4, 1}, {bw, 0, 8}, {bz, 3, 1}, {bz, 4, 1}, {rx, 0, 6}, {gy, 0, 4}, {gx, 0, 5}, {bz, 0, 1}, {gz, 0, 4}, {bx, 0, 5}, {bz, 1, 1}, {by, 0, 4}, {ry, 0, 6}, {rz, 0, 6}}},
+            {true, true, 8u, {5u, 6u, 5u}, {{rw, 0, 8}, {bz, 0, 1}, {by, 4, 1}, {gw, 0, 8}, {gy, 5, 1}, {gy, 4, 1}, {bw, 0, 8}, {gz, 5, 1}, {bz, 4, 1}, {rx, 0, 5}, {gz, 4, 1}, {gy, 0, 4}, {gx, 0, 6}, {gz, 0, 4}, {bx, 0, 5}, {bz, 1, 1}, {by, 0, 4}, {ry, 0, 5}, {bz, 2, 1}, {rz, 0, 5}, {bz, 3, 1}}},
+            {true, true, 8u, {5u, 5u, 6u}, {{rw, 0, 8}, {bz, 1, 1}, {by, 4, 1}, {gw, 0, 8}, {by, 5, 1}, {gy, 4, 1}, {bw, 0, 8}, {bz, 5, 1}, {bz, 4, 1}, {rx, 0, 5}, {gz, 4, 1}, {gy, 0, 4}, {gx, 0, 5}, {bz, 0, 1}, {gz, 0, 4}, {bx, 0, 6}, {by, 0, 4}, {ry, 0, 5}, {bz, 2, 1}, {rz, 0, 5}, {bz, 3, 1}}},
+            {true, false, 6u, {6u, 6u, 6u}, {{rw, 0, 6}, {gz, 4, 1}, {bz, 0, 1}, {bz, 1, 1}, {by, 4, 1}, {gw, 0, 6}, {gy, 5, 1}, {by, 5, 1}, {bz, 2, 1}, {gy, 4, 1}, {bw, 0, 6}, {gz, 5, 1}, {bz, 3, 1}, {bz, 5, 1}, {bz, 4, 1}, {rx, 0, 6}, {gy, 0, 4}, {gx, 0, 6}, {gz, 0, 4}, {bx, 0, 6}, {by, 0, 4}, {ry, 0, 6}, {rz, 0, 6}}},
+            {false, false, 10u, {10u, 10u, 10u}, {{rw, 0, 10}, {gw, 0, 10}, {bw, 0, 10}, {rx, 0, 10}, {gx, 0, 10}, {bx, 0, 10}}},
+            {false, true, 11u, {9u, 9u, 9u}, {{rw, 0, 10}, {gw, 0, 10}, {bw, 0, 10}, {rx, 0, 9}, {rw, 10, 1}, {gx, 0, 9}, {gw, 10, 1}, {bx, 0, 9}, {bw, 10, 1}}},
+            {false, true, 12u, {8u, 8u, 8u}, {{rw, 0, 10}, {gw, 0, 10}, {bw, 0, 10}, {rx, 0, 8}, {rw, 10, 2, true}, {gx, 0, 8}, {gw, 10, 2, true}, {bx, 0, 8}, {bw, 10, 2, true}}},
+            {false, true, 16u, {4u, 4u, 4u}, {{rw, 0, 10}, {gw, 0, 10}, {bw, 0, 10}, {rx, 0, 4}, {rw, 10, 6, true}, {gx, 0, 4}, {gw, 10, 6, true}, {bx, 0, 4}, {bw, 10, 6, true}}},
+    };
+
+    // maps the 2- or 5-bit mode field to an index into bc6h_modes, or -1 if the mode is reserved
+    [[nodiscard]] inline int bc6h_mode_index(lc_uint mode) noexcept {
+        switch (mode) {
+            case 0x00u: return 0;
+            case 0x01u: return 1;
+            case 0x02u: return 2;
+            case 0x06u: return 3;
+            case 0x0au: return 4;
+            case 0x0eu: return 5;
+            case 0x12u: return 6;
+            case 0x16u: return 7;
+            case 0x1au: return 8;
+            case 0x1eu: return 9;
+            case 0x03u: return 10;
+            case 0x07u: return 11;
+            case 0x0bu: return 12;
+            case 0x0fu: return 13;
+            default: break;
+        }
+        return -1;
+    }
+
+    [[nodiscard]] inline lc_uint bc6h_unquantize(lc_uint v, lc_uint bits) noexcept {
+        if (bits >= 15u) { return v; }
+        if (v == 0u) { return 0u; }
+        if (v == (1u << bits) - 1u) { return 0xffffu; }
+        return ((v << 16u) + 0x8000u) >> bits;
+    }
+
+    inline void decode_bc6h(const uint8_t *block, float (*texels)[4]) noexcept {
+        BCBitReader reader{block};
+        auto mode_field = reader.read(2u);
+        if (mode_field > 1u) { mode_field |= reader.read(3u) << 2u; }
+        auto mode = bc6h_mode_index(mode_field);
+        if (mode < 0) [[unlikely]] {// reserved
+            for (auto i = 0u; i < 16u; i++) {
+                for (auto c = 0u; c < 3u; c++) { texels[i][c] = 0.f; }
+                texels[i][3] = 1.f;
+            }
+            return;
+        }
+        auto &&m = bc6h_modes[mode];
+        lc_uint endpoints[4][3] = {};
+        for (auto &&s : m.segments) {
+            if (s.count == 0u) { break; }
+            auto v = reader.read(s.count);
+            if (s.reversed) {
+                auto r = 0u;
+                for (auto i = 0u; i < s.count; i++) { r |= ((v >> i) & 1u) << (s.count - 1u - i); }
+                v = r;
+            }
+            endpoints[s.field / 3u][s.field % 3u] |= v << s.lsb;
+        }
+        auto partition = m.partitioned ? reader.read(5u) : 0u;
+        auto endpoint_count = m.partitioned ? 4u : 2u;
+        auto mask = (1u << m.endpoint_bits) - 1u;
+        for (auto e = 1u; e < endpoint_count; e++) {
+            for (auto c = 0u; c < 3u; c++) {
+                if (m.transformed) {// stored as signed deltas from the first endpoint
+                    auto d = static_cast<int>(endpoints[e][c]);
+                    if (d & (1 << (m.delta_bits[c] - 1u))) { d -= 1 << m.delta_bits[c]; }
+                    endpoints[e][c] = static_cast<lc_uint>(static_cast<int>(endpoints[0][c]) + d) & mask;
+                }
+            }
+        }
+        for (auto e = 0u; e < endpoint_count; e++) {
+            for (auto c = 0u; c < 3u; c++) { endpoints[e][c] = bc6h_unquantize(endpoints[e][c], m.endpoint_bits); }
+        }
+        auto index_bits = m.partitioned ? 3u : 4u;
+        auto anchor = m.partitioned ? static_cast<lc_uint>(bc_anchors2[partition]) : 0u;
+        for (auto i = 0u; i < 16u; i++) {
+            auto index = reader.read(index_bits - (i == 0u || i == anchor ? 1u : 0u));
+            auto subset = m.partitioned ? (bc_partitions2[partition] >> i) & 1u : 0u;
+            for (auto c = 0u; c < 3u; c++) {
+                auto v = bc_interpolate(endpoints[subset * 2u][c], endpoints[subset * 2u + 1u][c], index, index_bits);
+                texels[i][c] = half_to_float(static_cast<float16_t>((v * 31u) >> 6u));
+            }
+            texels[i][3] = 1.f;
+        }
+    }
+
+    inline void decode_bc_block(LCPixelStorage storage, const uint8_t *block, float (*texels)[4]) noexcept {
+        switch (storage) {
+            case LC_PIXEL_STORAGE_BC4:
+            case LC_PIXEL_STORAGE_BC5:
+                for (auto i = 0u; i < 16u; i++) {
+                    for (auto c = 1u; c < 4u; c++) { texels[i][c] = 0.f; }
+                }
+                decode_bc4_channel(block, texels, 0u);
+                if (storage == LC_PIXEL_STORAGE_BC5) { decode_bc4_channel(block + 8u, texels, 1u); }
+                break;
+            case LC_PIXEL_STORAGE_BC6:
+                decode_bc6h(block, texels);
+                break;
+            case LC_PIXEL_STORAGE_BC7:
+                decode_bc7(block, texels);
+                break;
+            default:
+                break;
+        }
+    }
+
+    // neighboring texels usually share a block, so decoded blocks are kept in the worker's cache
+    [[nodiscard]] inline lc_float4 read_bc_texel(LCPixelStorage storage, const uint8_t *block,
+                                                 lc_uint texel, TextureBlockCache *cache) noexcept {
+        constexpr auto to_float4 = [](const float *t) noexcept { return lc_make_float4(t[0], t[1], t[2], t[3]); };
+        if (cache == nullptr) {
+            float texels[16][4];
+            decode_bc_block(storage, block, texels);
+            return to_float4(texels[texel]);
+        }
+        for (auto &&entry : cache->entries) {
+            if (entry.block == block) { return to_float4(entry.texels[texel]); }
+        }
+        constexpr auto entry_count = static_cast<lc_uint>(sizeof(cache->entries) / sizeof(cache->entries[0]));
+        auto &&entry = cache->entries[cache->next++ % entry_count];
+        decode_bc_block(storage, block, entry.texels);
+        entry.block = block;
+        return to_float4(entry.texels[texel]);
+    }
+
 // MIP-Map EWA filtering LUT from PBRT-v4
     static constexpr const float ewa_filter_weight_lut[] = {
             0.8646647330f, 0.8490400310f, 0.8336595300f, 0.8185192940f, 0.8036156300f, 0.78894478100f, 0.7745032310f,
@@ -422,6 +846,37 @@ namespace detail {
     static constexpr const int ewa_filter_weight_lut_size = sizeof(ewa_filter_weight_lut) / sizeof(float);
 }// namespace detail
 
+// order of the texels of non-compressed textures, see TextureLayout in texture.rs
+typedef enum LCTextureLayout {
+    LC_TEXTURE_LAYOUT_LINEAR,
+    LC_TEXTURE_LAYOUT_TILED,
+    LC_TEXTURE_LAYOUT_MORTON,
+} LCTextureLayout;
+
+namespace detail {
+// spreads the low bits of x to every second (third) bit, with PDEP where the target has BMI2
+[[nodiscard]] inline lc_uint morton_spread2(lc_uint x) noexcept {
+#ifdef __BMI2__
+    return __builtin_ia32_pdep_si(x, 0x55555555u);
+#else
+    x = (x | (x << 8u)) & 0x00ff00ffu;
+    x = (x | (x << 4u)) & 0x0f0f0f0fu;
+    x = (x | (x << 2u)) & 0x33333333u;
+    return (x | (x << 1u)) & 0x55555555u;
+#endif
+}
+[[nodiscard]] inline lc_uint morton_spread3(lc_uint x) noexcept {
+#ifdef __BMI2__
+    return __builtin_ia32_pdep_si(x, 0x09249249u);
+#else
+    x = (x | (x << 16u)) & 0x030000ffu;
+    x = (x | (x << 8u)) & 0x0300f00fu;
+    x = (x | (x << 4u)) & 0x030c30c3u;
+    return (x | (x << 2u)) & 0x09249249u;
+#endif
+}
+}// namespace detail
+
 struct TextureView {
     uint8_t *data;
     uint8_t dimension;
@@ -429,29 +884,120 @@ struct TextureView {
     uint32_t height;
     uint32_t depth;
     uint8_t storage;
-    uint8_t pixel_stride_shift;
+    uint8_t pixel_stride_shift;// log2 of the bytes per 4x4 block for block-compressed storages
+    uint8_t layout;
+    uint8_t tile_shift;// log2 of the side of the Morton tiles of this level
+    TextureBlockCache *block_cache;
 
     static constexpr auto block_size = 4;
 
-    [[nodiscard]] inline uint8_t *_pixel2d(lc_uint2 xy) const noexcept {
+    template<int S>
+    [[nodiscard]] inline auto _storage() const noexcept {
+        if constexpr (S == LC_PIXEL_STORAGE_DYNAMIC) {
+            return LCPixelStorage(storage);
+        } else {
+            return LCPixelStorage(S);
+        }
+    }
+
+    template<int S = LC_PIXEL_STORAGE_DYNAMIC>
+    [[nodiscard]] inline auto _block_compressed() const noexcept {
+        return _storage<S>() >= LC_PIXEL_STORAGE_BC4;
+    }
+
+    // block-compressed levels are stored as rows of 4x4 blocks, one slice after another
+    [[nodiscard]] inline const uint8_t *_block2d(lc_uint2 xy) const noexcept {
+        auto grid_width = (width + block_size - 1u) / block_size;
+        auto block_index = grid_width * (xy.y / block_size) + xy.x / block_size;
+        return data + (static_cast<size_t>(block_index) << pixel_stride_shift);
+    }
+
+    [[nodiscard]] inline const uint8_t *_block3d(lc_uint3 xyz) const noexcept {
+        auto grid_width = (width + block_size - 1u) / block_size;
+        auto grid_height = (height + block_size - 1u) / block_size;
+        auto block_index = (grid_height * xyz.z + xyz.y / block_size) * grid_width + xyz.x / block_size;
+        return data + (static_cast<size_t>(block_index) << pixel_stride_shift);
+    }
+
+    template<typename V, typename T, int S>
+    [[nodiscard]] inline V _read_block(const uint8_t *block, lc_uint texel) const noexcept {
+        if constexpr (lc_is_same_v<T, float>) {
+            return detail::read_bc_texel(_storage<S>(), block, texel, block_cache);
+        } else {// block-compressed textures are always read as floats
+            return {};
+        }
+    }
+
+    // a known storage turns the fetch into a typed load instead of a switch
+    template<typename V, typename T, int S>
+    [[nodiscard]] inline V _read_pixel(const uint8_t *p) const noexcept {
+        if constexpr (S == LC_PIXEL_STORAGE_DYNAMIC) {
+            return detail::read_pixel<V, T>(LCPixelStorage(storage), p);
+        } else if constexpr (S >= LC_PIXEL_STORAGE_BC4) {// read by _read_block
+            return {};
+        } else {
+            return detail::read_static_pixel<V, T, S>(p);
+        }
+    }
+
+    template<typename V, typename T, int S>
+    inline void _write_pixel(uint8_t *p, V value) const noexcept {
+        if constexpr (S == LC_PIXEL_STORAGE_DYNAMIC) {
+            detail::write_pixel<V, T>(LCPixelStorage(storage), p, value);
+        } else if constexpr (S < LC_PIXEL_STORAGE_BC4) {
+            detail::write_static_pixel<V, T, S>(p, value);
+        }
+    }
+
+    [[nodiscard]] inline size_t _pixel_index2d(lc_uint2 xy) const noexcept {
+        if (layout == LC_TEXTURE_LAYOUT_MORTON) {
+            auto mask = (1u << tile_shift) - 1u;
+            auto grid_width = (width + mask) >> tile_shift;
+            auto tile_index = static_cast<size_t>(grid_width) * (xy.y >> tile_shift) + (xy.x >> tile_shift);
+            return (tile_index << (2u * tile_shift)) |
+                   detail::morton_spread2(xy.x & mask) | (detail::morton_spread2(xy.y & mask) << 1u);
+        }
+        if (layout == LC_TEXTURE_LAYOUT_LINEAR) {
+            return static_cast<size_t>(width) * xy.y + xy.x;
+        }
         auto block = xy / block_size;
         auto pixel = xy % block_size;
         auto grid_width = (width + block_size - 1u) / block_size;
         auto block_index = grid_width * block.y + block.x;
-        auto pixel_index = block_index * block_size * block_size +
-                           pixel.y * block_size + pixel.x;
-        return data + (static_cast<size_t>(pixel_index) << pixel_stride_shift);
+        return static_cast<size_t>(block_index) * block_size * block_size +
+               pixel.y * block_size + pixel.x;
     }
 
-    [[nodiscard]] inline uint8_t *_pixel3d(lc_uint3 xyz) const noexcept {
+    [[nodiscard]] inline size_t _pixel_index3d(lc_uint3 xyz) const noexcept {
+        if (layout == LC_TEXTURE_LAYOUT_MORTON) {
+            auto mask = (1u << tile_shift) - 1u;
+            auto grid_width = (width + mask) >> tile_shift;
+            auto grid_height = (height + mask) >> tile_shift;
+            auto tile_index = (static_cast<size_t>(grid_height) * (xyz.z >> tile_shift) + (xyz.y >> tile_shift)) * grid_width +
+                              (xyz.x >> tile_shift);
+            return (tile_index << (3u * tile_shift)) |
+                   detail::morton_spread3(xyz.x & mask) |
+                   (detail::morton_spread3(xyz.y & mask) << 1u) |
+                   (detail::morton_spread3(xyz.z & mask) << 2u);
+        }
+        if (layout == LC_TEXTURE_LAYOUT_LINEAR) {
+            return (static_cast<size_t>(height) * xyz.z + xyz.y) * width + xyz.x;
+        }
         auto block = xyz / block_size;
         auto pixel = xyz % block_size;
         auto grid_width = (width + block_size - 1u) / block_size;
         auto grid_height = (height + block_size - 1u) / block_size;
-        auto block_index = grid_width * grid_height * block.z + grid_width * block.y + block.x;
-        auto pixel_index = block_index * block_size * block_size * block_size +
-                           (pixel.z * block_size + pixel.y) * block_size + pixel.x;
-        return data + (static_cast<size_t>(pixel_index) << pixel_stride_shift);
+        auto block_index = static_cast<size_t>(grid_width) * grid_height * block.z + grid_width * block.y + block.x;
+        return block_index * block_size * block_size * block_size +
+               (pixel.z * block_size + pixel.y) * block_size + pixel.x;
+    }
+
+    [[nodiscard]] inline uint8_t *_pixel2d(lc_uint2 xy) const noexcept {
+        return data + (_pixel_index2d(xy) << pixel_stride_shift);
+    }
+
+    [[nodiscard]] inline uint8_t *_pixel3d(lc_uint3 xyz) const noexcept {
+        return data + (_pixel_index3d(xyz) << pixel_stride_shift);
     }
 
     [[nodiscard]] inline auto _out_of_bounds(lc_uint2 xy) const noexcept {
@@ -462,28 +1008,34 @@ struct TextureView {
         return !(xyz[0] < width & xyz[1] < height & xyz[2] < depth);
     }
 
-    template<typename V, typename T>
+    template<typename V, typename T, int S = LC_PIXEL_STORAGE_DYNAMIC>
     [[nodiscard]] inline V read2d(lc_uint2 xy) const noexcept {
         if (_out_of_bounds(xy)) [[unlikely]] { return {}; }
-        return detail::read_pixel<V, T>(LCPixelStorage(storage), _pixel2d(xy));
+        if (_block_compressed<S>()) [[unlikely]] {
+            return _read_block<V, T, S>(_block2d(xy), (xy.y % block_size) * block_size + xy.x % block_size);
+        }
+        return _read_pixel<V, T, S>(_pixel2d(xy));
     }
 
-    template<typename V, typename T>
+    template<typename V, typename T, int S = LC_PIXEL_STORAGE_DYNAMIC>
     [[nodiscard]] inline V read3d(lc_uint3 xyz) const noexcept {
         if (_out_of_bounds(xyz)) [[unlikely]] { return {}; }
-        return detail::read_pixel<V, T>(LCPixelStorage(storage), _pixel3d(xyz));
+        if (_block_compressed<S>()) [[unlikely]] {
+            return _read_block<V, T, S>(_block3d(xyz), (xyz.y % block_size) * block_size + xyz.x % block_size);
+        }
+        return _read_pixel<V, T, S>(_pixel3d(xyz));
     }
 
-    template<typename V, typename T>
+    template<typename V, typename T, int S = LC_PIXEL_STORAGE_DYNAMIC>
     inline void write2d(lc_uint2 xy, V value) const noexcept {
-        if (_out_of_bounds(xy)) [[unlikely]] { return; }
-        detail::write_pixel<V, T>(LCPixelStorage(storage), _pixel2d(xy), value);
+        if (_out_of_bounds(xy) | _block_compressed<S>()) [[unlikely]] { return; }
+        _write_pixel<V, T, S>(_pixel2d(xy), value);
     }
 
-    template<typename V, typename T>
+    template<typename V, typename T, int S = LC_PIXEL_STORAGE_DYNAMIC>
     inline void write3d(lc_uint3 xyz, V value) const noexcept {
-        if (_out_of_bounds(xyz)) [[unlikely]] { return; }
-        detail::write_pixel<V, T>(LCPixelStorage(storage), _pixel3d(xyz), value);
+        if (_out_of_bounds(xyz) | _block_compressed<S>()) [[unlikely]] { return; }
+        _write_pixel<V, T, S>(_pixel3d(xyz), value);
     }
 
     [[nodiscard]] auto size2d() const noexcept { return lc_make_uint2(width, height); }
@@ -545,6 +1097,7 @@ template<typename T>
     return detail::lc_make_pair(lc_min(c_min, c_max), lc_max(c_min, c_max));
 }
 
+template<int S = LC_PIXEL_STORAGE_DYNAMIC>
 [[nodiscard]] inline lc_float4
 texture_sample_linear(TextureView view, LCSamplerAddress address, lc_float2 uv) noexcept {
     auto size = lc_make_float2(view.size2d());
@@ -552,14 +1105,15 @@ texture_sample_linear(TextureView view, LCSamplerAddress address, lc_float2 uv)
     auto t = lc_fract(st_max);
     auto c0 = lc_make_uint2(st_min);
     auto c1 = lc_make_uint2(st_max);
-    auto v00 = view.read2d<lc_float4, float>(c0);
-    auto v01 = view.read2d<lc_float4, float>(lc_make_uint2(c1.x, c0.y));
-    auto v10 = view.read2d<lc_float4, float>(lc_make_uint2(c0.x, c1.y));
-    auto v11 = view.read2d<lc_float4, float>(c1);
+    auto v00 = view.read2d<lc_float4, float, S>(c0);
+    auto v01 = view.read2d<lc_float4, float, S>(lc_make_uint2(c1.x, c0.y));
+    auto v10 = view.read2d<lc_float4, float, S>(lc_make_uint2(c0.x, c1.y));
+    auto v11 = view.read2d<lc_float4, float, S>(c1);
     return lc_lerp(lc_lerp(v00, v01, lc_float4(t.x)),
                    lc_lerp(v10, v11, lc_float4(t.x)), lc_float4(t.y));
 }
 
+template<int S = LC_PIXEL_STORAGE_DYNAMIC>
 [[nodiscard]] inline lc_float4
 texture_sample_linear(TextureView view, LCSamplerAddress address, lc_float3 uvw) noexcept {
     auto size = lc_make_float3(view.size3d());
@@ -567,14 +1121,14 @@ texture_sample_linear(TextureView view, LCSamplerAddress address, lc_float3 uvw)
     auto t = lc_fract(st_max);
     auto c0 = lc_make_uint3(st_min);
     auto c1 = lc_make_uint3(st_max);
-    auto v000 = view.read3d<lc_float4, float>(lc_make_uint3(c0.x, c0.y, c0.z));
-    auto v001 = view.read3d<lc_float4, float>(lc_make_uint3(c1.x, c0.y, c0.z));
-    auto v010 = view.read3d<lc_float4, float>(lc_make_uint3(c0.x, c1.y, c0.z));
-    auto v011 = view.read3d<lc_float4, float>(lc_make_uint3(c1.x, c1.y, c0.z));
-    auto v100 = view.read3d<lc_float4, float>(lc_make_uint3(c0.x, c0.y, c1.z));
-    auto v101 = view.read3d<lc_float4, float>(lc_make_uint3(c1.x, c0.y, c1.z));
-    auto v110 = view.read3d<lc_float4, float>(lc_make_uint3(c0.x, c1.y, c1.z));
-    auto v111 = view.read3d<lc_float4, float>(lc_make_uint3(c1.x, c1.y, c1.z));
+    auto v000 = view.read3d<lc_float4, float, S>(lc_make_uint3(c0.x, c0.y, c0.z));
+    auto v001 = view.read3d<lc_float4, float, S>(lc_make_uint3(c1.x, c0.y, c0.z));
+    auto v010 = view.read3d<lc_float4, float, S>(lc_make_uint3(c0.x, c1.y, c0.z));
+    auto v011 = view.read3d<lc_float4, float, S>(lc_make_uint3(c1.x, c1.y, c0.z));
+    auto v100 = view.read3d<lc_float4, float, S>(lc_make_uint3(c0.x, c0.y, c1.z));
+    auto v101 = view.read3d<lc_float4, float, S>(lc_make_uint3(c1.x, c0.y, c1.z));
+    auto v110 = view.read3d<lc_float4, float, S>(lc_make_uint3(c0.x, c1.y, c1.z));
+    auto v111 = view.read3d<lc_float4, float, S>(lc_make_uint3(c1.x, c1.y, c1.z));
     return lc_lerp(
             lc_lerp(lc_lerp(v000, v001, lc_float4(t.x)),
                     lc_lerp(v010, v011, lc_float4(t.x)), lc_float4(t.y)),
@@ -583,20 +1137,69 @@ texture_sample_linear(TextureView view, LCSamplerAddress address, lc_float3 uvw)
             lc_float4(t.z));
 }
 
+template<int S = LC_PIXEL_STORAGE_DYNAMIC>
 [[nodiscard]] inline lc_float4 texture_sample_point(TextureView view, LCSamplerAddress address, lc_float2 uv) noexcept {
     auto size = lc_make_float2(view.size2d());
     auto c = lc_make_uint2(texture_coord_point(address, uv, size));
-    return view.read2d<lc_float4, float>(c);
+    return view.read2d<lc_float4, float, S>(c);
 }
 
+template<int S = LC_PIXEL_STORAGE_DYNAMIC>
 [[nodiscard]] inline lc_float4
 texture_sample_point(TextureView view, LCSamplerAddress address, lc_float3 uvw) noexcept {
     auto size = lc_make_float3(view.size3d());
     auto c = lc_make_uint3(texture_coord_point(address, uvw, size));
-    return view.read3d<lc_float4, float>(c);
+    return view.read3d<lc_float4, float, S>(c);
+}
+
+// texel index of c along an axis of the given size, out of range for the zero address mode
+[[nodiscard]] inline lc_uint texture_address_texel(LCSamplerAddress address, int c, int size) noexcept {
+    switch (address) {
+        case LC_SAMPLER_ADDRESS_EDGE:
+            return static_cast<lc_uint>(c < 0 ? 0 : (c < size ? c : size - 1));
+        case LC_SAMPLER_ADDRESS_REPEAT: {
+            auto m = c % size;
+            return static_cast<lc_uint>(m < 0 ? m + size : m);
+        }
+        case LC_SAMPLER_ADDRESS_MIRROR: {
+            auto m = c % (2 * size);
+            m = m < 0 ? m + 2 * size : m;
+            return static_cast<lc_uint>(m < size ? m : 2 * size - 1 - m);
+        }
+        case LC_SAMPLER_ADDRESS_ZERO:
+            return static_cast<lc_uint>(c);
+    }
+    return static_cast<lc_uint>(c);
+}
+
+// Accumulates the texels s of a row inside the ellipse a * ds^2 + b * ds + c < 1, ds = s - center.
+// The span of the row is solved for directly, and the squared radius indexing the Gaussian weights
+// is stepped by forward differences.
+template<typename F>
+inline void texture_ewa_row(float center, float a, float b, float c,
+                            lc_float4 &sum, float &sum_w, F &&texel) noexcept {
+    auto disc = b * b - 4.f * a * (c - 1.f);
+    if (disc <= 0.f) { return; }
+    auto root = sqrtf(disc);
+    auto inv_2a = .5f / a;
+    auto s_min = static_cast<int>(ceilf(center + (-b - root) * inv_2a));
+    auto s_max = static_cast<int>(floorf(center + (-b + root) * inv_2a));
+    auto ds = static_cast<float>(s_min) - center;
+    auto rr = (a * ds + b) * ds + c;
+    auto drr = a * (2.f * ds + 1.f) + b;
+    constexpr auto lut_size = detail::ewa_filter_weight_lut_size;
+    for (auto s = s_min; s <= s_max; s++) {
+        auto index = lc_clamp(static_cast<int>(rr * static_cast<float>(lut_size)), 0, lut_size - 1);
+        auto weight = detail::ewa_filter_weight_lut[index];
+        sum += weight * texel(s);
+        sum_w += weight;
+        rr += drr;
+        drr += 2.f * a;
+    }
 }
 
-// from PBRT-v4
+// from PBRT-v4, the footprint has the covariance dst0 dst0^T + dst1 dst1^T + I in texels
+template<int S = LC_PIXEL_STORAGE_DYNAMIC>
 [[nodiscard]] inline auto texture_sample_ewa(TextureView view, LCSamplerAddress address,
                                              lc_float2 uv, lc_float2 dst0, lc_float2 dst1) noexcept {
     auto size = lc_make_float2(view.size2d());
@@ -604,60 +1207,129 @@ texture_sample_point(TextureView view, LCSamplerAddress address, lc_float3 uvw)
     dst0 = dst0 * size;
     dst1 = dst1 * size;
 
-    constexpr auto sqr = [](float x) noexcept { return x * x; };
-    constexpr auto safe_sqrt = [](float x) noexcept { return lc_select(sqrtf(x), 0.f, x <= 0.f); };
-
     // Find ellipse coefficients that bound EWA filter region
-    auto A = sqr(dst0.y) + sqr(dst1.y) + 1.f;
-    auto B = -2.f * (dst0.x * dst0.y + dst1.x * dst1.y);
-    auto C = sqr(dst0.x) + sqr(dst1.x) + 1.f;
-    auto inv_f = 1.f / (A * C - sqr(B) * 0.25f);
-    A *= inv_f;
-    B *= inv_f;
-    C *= inv_f;
-
-    // Compute the ellipse's $(s,t)$ bounding box in texture space
-    auto det = -sqr(B) + 4.f * A * C;
-    auto inv_det = 1.f / det;
-    auto sqrt_u = safe_sqrt(det * C);
-    auto sqrt_v = safe_sqrt(A * det);
-    auto s_min = static_cast<int>(ceilf(st.x - 2.f * inv_det * sqrt_u));
-    auto s_max = static_cast<int>(floorf(st.x + 2.f * inv_det * sqrt_u));
-    auto t_min = static_cast<int>(ceilf(st.y - 2.f * inv_det * sqrt_v));
-    auto t_max = static_cast<int>(floorf(st.y + 2.f * inv_det * sqrt_v));
-
-    // Scan over ellipse bound and evaluate quadratic equation to filter image
+    auto sxx = dst0.x * dst0.x + dst1.x * dst1.x + 1.f;
+    auto sxy = dst0.x * dst0.y + dst1.x * dst1.y;
+    auto syy = dst0.y * dst0.y + dst1.y * dst1.y + 1.f;
+    auto inv_det = 1.f / (sxx * syy - sxy * sxy);
+    auto A = syy * inv_det;
+    auto B = -2.f * sxy * inv_det;
+    auto C = sxx * inv_det;
+
+    // Scan over the rows of the ellipse and filter their texels
+    auto extent = sqrtf(syy);
+    auto t_min = static_cast<int>(ceilf(st.y - extent));
+    auto t_max = static_cast<int>(floorf(st.y + extent));
+    auto w = static_cast<int>(view.width);
+    auto h = static_cast<int>(view.height);
     auto sum = lc_make_float4();
     auto sum_w = 0.f;
-    auto inv_size = 1.f / size;
     for (auto t = t_min; t <= t_max; t++) {
-        for (auto s = s_min; s <= s_max; s++) {
-            auto ss = static_cast<float>(s) - st.x;
-            auto tt = static_cast<float>(t) - st.y;
-            // Compute squared radius and filter texel if it is inside the ellipse
-            if (auto rr = A * sqr(ss) + B * ss * tt + C * sqr(tt); rr < 1.f) {
-                constexpr auto lut_size = static_cast<float>(detail::ewa_filter_weight_lut_size);
-                auto index = lc_clamp(rr * lut_size, 0.f, lut_size - 1.f);
-                auto weight = detail::ewa_filter_weight_lut[static_cast<int>(index)];
-                auto p = texture_coord_point(address, uv + lc_make_float2(ss, tt) * inv_size, size);
-                sum += weight * view.read2d<lc_float4, float>(lc_make_uint2(p));
-                sum_w += weight;
-            }
-        }
+        auto dt = static_cast<float>(t) - st.y;
+        auto y = texture_address_texel(address, t, h);
+        texture_ewa_row(st.x, A, B * dt, C * dt * dt, sum, sum_w, [&](int s) noexcept {
+            return view.read2d<lc_float4, float, S>(lc_make_uint2(texture_address_texel(address, s, w), y));
+        });
     }
     return lc_select(sum / sum_w, lc_make_float4(0.f), sum_w <= 0.f);
 }
 
+// the 3D counterpart, filtering the texels inside the ellipsoid of the footprint
+template<int S = LC_PIXEL_STORAGE_DYNAMIC>
 [[nodiscard]] inline auto texture_sample_ewa(TextureView view, LCSamplerAddress address,
-                                             lc_float3 uvw, lc_float3 ddx, lc_float3 ddy) noexcept {
-    // FIXME: anisotropic filtering
-    return texture_sample_linear(view, address, uvw);
+                                             lc_float3 uvw, lc_float3 dst0, lc_float3 dst1) noexcept {
+    auto size = lc_make_float3(view.size3d());
+    auto str = uvw * size - .5f;
+    dst0 = dst0 * size;
+    dst1 = dst1 * size;
+
+    // covariance of the footprint and its inverse, the quadratic form of the ellipsoid
+    auto s00 = dst0.x * dst0.x + dst1.x * dst1.x + 1.f;
+    auto s01 = dst0.x * dst0.y + dst1.x * dst1.y;
+    auto s02 = dst0.x * dst0.z + dst1.x * dst1.z;
+    auto s11 = dst0.y * dst0.y + dst1.y * dst1.y + 1.f;
+    auto s12 = dst0.y * dst0.z + dst1.y * dst1.z;
+    auto s22 = dst0.z * dst0.z + dst1.z * dst1.z + 1.f;
+    auto q00 = s11 * s22 - s12 * s12;
+    auto q01 = s02 * s12 - s01 * s22;
+    auto q02 = s01 * s12 - s02 * s11;
+    auto inv_det = 1.f / (s00 * q00 + s01 * q01 + s02 * q02);
+    q00 *= inv_det;
+    q01 *= inv_det;
+    q02 *= inv_det;
+    auto q11 = (s00 * s22 - s02 * s02) * inv_det;
+    auto q12 = (s01 * s02 - s00 * s12) * inv_det;
+    auto q22 = (s00 * s11 - s01 * s01) * inv_det;
+
+    // Scan over the rows of the ellipsoid and filter their texels
+    auto extent_y = sqrtf(s11);
+    auto extent_z = sqrtf(s22);
+    auto t_min = static_cast<int>(ceilf(str.y - extent_y));
+    auto t_max = static_cast<int>(floorf(str.y + extent_y));
+    auto r_min = static_cast<int>(ceilf(str.z - extent_z));
+    auto r_max = static_cast<int>(floorf(str.z + extent_z));
+    auto w = static_cast<int>(view.width);
+    auto h = static_cast<int>(view.height);
+    auto d = static_cast<int>(view.depth);
+    auto sum = lc_make_float4();
+    auto sum_w = 0.f;
+    for (auto r = r_min; r <= r_max; r++) {
+        auto dr = static_cast<float>(r) - str.z;
+        auto z = texture_address_texel(address, r, d);
+        for (auto t = t_min; t <= t_max; t++) {
+            auto dt = static_cast<float>(t) - str.y;
+            auto y = texture_address_texel(address, t, h);
+            auto b = 2.f * (q01 * dt + q02 * dr);
+            auto c = q11 * dt * dt + 2.f * q12 * dt * dr + q22 * dr * dr;
+            texture_ewa_row(str.x, q00, b, c, sum, sum_w, [&](int s) noexcept {
+                return view.read3d<lc_float4, float, S>(lc_make_uint3(texture_address_texel(address, s, w), y, z));
+            });
+        }
+    }
+    return lc_select(sum / sum_w, lc_make_float4(0.f), sum_w <= 0.f);
 }
 
-[[nodiscard]] inline TextureView lc_texture_view(const Texture *tex, lc_uint level) noexcept {
+[[nodiscard]] inline TextureView lc_texture_view(const KernelFnArgs *k_args, const Texture *tex, lc_uint level) noexcept {
     auto size = lc_max(lc_make_uint3(tex->width, tex->height, tex->depth) >> level, lc_make_uint3(1u));
-    return TextureView{tex->data + (static_cast<size_t>(tex->mip_offsets[level]) << tex->pixel_stride_shift),
-                       tex->dimension, size.x, size.y, size.z, tex->storage, tex->pixel_stride_shift};
+    // Morton tiles shrink with the levels to their shortest side, as in TextureImpl::view
+    auto shortest = tex->dimension == 2u ? lc_min(size.x, size.y) : lc_min(lc_min(size.x, size.y), size.z);
+    auto tile_shift = lc_min(static_cast<lc_uint>(tex->tile_shift), 31u - __builtin_clz(shortest));
+    // mip offsets are in bytes
+    return TextureView{tex->data + tex->mip_offsets[level],
+                       tex->dimension, size.x, size.y, size.z, tex->storage, tex->pixel_stride_shift,
+                       tex->layout, static_cast<uint8_t>(tile_shift), k_args->texture_block_cache};
+}
+
+// calls f with the storage of the texture as a template argument, so that the texels
+// of a filter footprint are read with typed loads instead of a switch per texel
+template<typename F>
+[[nodiscard]] inline lc_float4 lc_texture_with_storage(const Texture *tex, F &&f) noexcept {
+#define LC_TEXTURE_STORAGE_CASE(storage) \
+    case storage: return f.template operator()<storage>();
+    switch (tex->storage) {
+        LC_TEXTURE_STORAGE_CASE(LC_PIXEL_STORAGE_BYTE1)
+        LC_TEXTURE_STORAGE_CASE(LC_PIXEL_STORAGE_BYTE2)
+        LC_TEXTURE_STORAGE_CASE(LC_PIXEL_STORAGE_BYTE4)
+        LC_TEXTURE_STORAGE_CASE(LC_PIXEL_STORAGE_SHORT1)
+        LC_TEXTURE_STORAGE_CASE(LC_PIXEL_STORAGE_SHORT2)
+        LC_TEXTURE_STORAGE_CASE(LC_PIXEL_STORAGE_SHORT4)
+        LC_TEXTURE_STORAGE_CASE(LC_PIXEL_STORAGE_INT1)
+        LC_TEXTURE_STORAGE_CASE(LC_PIXEL_STORAGE_INT2)
+        LC_TEXTURE_STORAGE_CASE(LC_PIXEL_STORAGE_INT4)
+        LC_TEXTURE_STORAGE_CASE(LC_PIXEL_STORAGE_HALF1)
+        LC_TEXTURE_STORAGE_CASE(LC_PIXEL_STORAGE_HALF2)
+        LC_TEXTURE_STORAGE_CASE(LC_PIXEL_STORAGE_HALF4)
+        LC_TEXTURE_STORAGE_CASE(LC_PIXEL_STORAGE_FLOAT1)
+        LC_TEXTURE_STORAGE_CASE(LC_PIXEL_STORAGE_FLOAT2)
+        LC_TEXTURE_STORAGE_CASE(LC_PIXEL_STORAGE_FLOAT4)
+        LC_TEXTURE_STORAGE_CASE(LC_PIXEL_STORAGE_BC4)
+        LC_TEXTURE_STORAGE_CASE(LC_PIXEL_STORAGE_BC5)
+        LC_TEXTURE_STORAGE_CASE(LC_PIXEL_STORAGE_BC6)
+        LC_TEXTURE_STORAGE_CASE(LC_PIXEL_STORAGE_BC7)
+        default: break;
+    }
+#undef LC_TEXTURE_STORAGE_CASE
+    return lc_make_float4();
 }
 
 struct LCSampler {
@@ -675,72 +1347,73 @@ struct LCSampler {
 using Texture2D = KernelFnArg::Texture_Body;
 using Texture3D = KernelFnArg::Texture_Body;
 
-template<class V>
+template<class V, int S = LC_PIXEL_STORAGE_DYNAMIC>
 [[nodiscard]] inline V lc_texture2d_read(
         const KernelFnArgs* k_args,
         const Texture2D &tex, lc_uint2 uv) noexcept {
     using T = element_type<V>;
-    return lc_texture_view(&tex._0, tex._1).read2d<V, T>(uv);
+    return lc_texture_view(k_args, &tex._0, tex._1).read2d<V, T, S>(uv);
 }
 
-template<class V>
+template<class V, int S = LC_PIXEL_STORAGE_DYNAMIC>
 [[nodiscard]] inline V lc_texture3d_read(
         const KernelFnArgs* k_args,
         const Texture3D &tex, lc_uint3 uvw) noexcept {
     using T = element_type<V>;
-    return lc_texture_view(&tex._0, tex._1).read3d<V, T>(uvw);
+    return lc_texture_view(k_args, &tex._0, tex._1).read3d<V, T, S>(uvw);
 }
 
-template<class V>
+template<class V, int S = LC_PIXEL_STORAGE_DYNAMIC>
 inline void lc_texture2d_write(const KernelFnArgs* k_args,const Texture2D &tex, lc_uint2 uv, V value) noexcept {
     using T = element_type<V>;
-    lc_texture_view(&tex._0, tex._1).write2d<V, T>(uv, value);
+    lc_texture_view(k_args, &tex._0, tex._1).write2d<V, T, S>(uv, value);
 }
 
-template<class V>
+template<class V, int S = LC_PIXEL_STORAGE_DYNAMIC>
 inline void lc_texture3d_write(const KernelFnArgs* k_args,const Texture3D &tex, lc_uint3 uv, V value) noexcept {
     using T = element_type<V>;
-    lc_texture_view(&tex._0, tex._1).write3d<V, T>(uv, value);
+    lc_texture_view(k_args, &tex._0, tex._1).write3d<V, T, S>(uv, value);
 }
 
+template<int S = LC_PIXEL_STORAGE_DYNAMIC>
 [[nodiscard]] inline lc_float4 lc_texture_2d_sample(const KernelFnArgs *k_args,
                                                     const Texture *tex, LCSampler sampler, lc_float2 uv) noexcept {
-    auto view = lc_texture_view(tex, 0u);
+    auto view = lc_texture_view(k_args, tex, 0u);
     if (sampler.filter == LC_SAMPLER_FILTER_POINT) {
-        return texture_sample_point(view, sampler.address, uv);
+        return texture_sample_point<S>(view, sampler.address, uv);
     } else {
-        return texture_sample_linear(view, sampler.address, uv);
+        return texture_sample_linear<S>(view, sampler.address, uv);
     }
 }
 
 [[nodiscard]] inline const Texture &
 lc_bindless_texture_2d(const KernelFnArgs *k_args, const BindlessArray &array, size_t index) noexcept {
 #ifdef LUISA_DEBUG
-    if (index >= array.texture2ds_count) {
+    if (index >= array.slots_count) {
         lc_abort_and_print_sll(k_args->internal_data, "Bindless texture2d index out of bounds: %zu >= %zu", index,
-                               array.texture2ds_count);
+                               array.slots_count);
     }
 #endif
-    return array.texture2ds[index];
+    return array.slots[index].texture2d;
 }
 
 [[nodiscard]] inline const Texture &
 lc_bindless_texture_3d(const KernelFnArgs *k_args, const BindlessArray &array, size_t index) noexcept {
 #ifdef LUISA_DEBUG
-    if (index >= array.texture3ds_count) {
+    if (index >= array.slots_count) {
         lc_abort_and_print_sll(k_args->internal_data, "Bindless texture3d index out of bounds: %zu >= %zu", index,
-                               array.texture3ds_count);
+                               array.slots_count);
 
     }
 #endif
-    return array.texture3ds[index];
+    return array.slots[index].texture3d;
 }
 
 [[nodiscard]] inline lc_float4 lc_bindless_texture2d_read(
         const KernelFnArgs *k_args,
         const BindlessArray &array, size_t index, lc_uint2 uv) noexcept {
     auto &&tex = lc_bindless_texture_2d(k_args, array, index);
-    auto view = lc_texture_view(&tex, 0u);
+    auto view = lc_texture_view(k_args, &tex, 0u);
     return view.read2d<lc_float4, float>(uv);
 }
 
@@ -748,7 +1421,7 @@ lc_bindless_texture_3d(const KernelFnArgs *k_args, const BindlessArray &array, s
         const KernelFnArgs *k_args,
         const BindlessArray &array, size_t index, lc_uint3 uvw) noexcept {
     auto &&tex = lc_bindless_texture_3d(k_args, array, index);
-    auto view = lc_texture_view(&tex, 0u);
+    auto view = lc_texture_view(k_args, &tex, 0u);
     return view.read3d<lc_float4, float>(uvw);
 }
 
@@ -757,16 +1430,19 @@ lc_bindless_texture_3d(const KernelFnArgs *k_args, const BindlessArray &array, s
                                                             lc_float2 uv) noexcept {
     auto &&tex = lc_bindless_texture_2d(k_args, array, index);
     auto sampler = LCSampler::decode(tex.sampler);
-    return lc_texture_2d_sample(k_args, &tex, sampler, uv);
+    return lc_texture_with_storage(&tex, [&]<int S>() noexcept {
+        return lc_texture_2d_sample<S>(k_args, &tex, sampler, uv);
+    });
 }
 
+template<int S = LC_PIXEL_STORAGE_DYNAMIC>
 [[nodiscard]] inline lc_float4 lc_texture_3d_sample(const KernelFnArgs *k_args,
                                                     const Texture *tex, LCSampler sampler, lc_float3 uvw) noexcept {
-    auto view = lc_texture_view(tex, 0u);
+    auto view = lc_texture_view(k_args, tex, 0u);
     if (sampler.filter == LC_SAMPLER_FILTER_POINT) {
-        return texture_sample_point(view, sampler.address, uvw);
+        return texture_sample_point<S>(view, sampler.address, uvw);
     } else {
-        return texture_sample_linear(view, sampler.address, uvw);
+        return texture_sample_linear<S>(view, sampler.address, uvw);
     }
 }
 
@@ -775,20 +1451,23 @@ lc_bindless_texture_3d(const KernelFnArgs *k_args, const BindlessArray &array, s
                                                             lc_float3 uv) noexcept {
     auto &&tex = lc_bindless_texture_3d(k_args, array, index);
     auto sampler = LCSampler::decode(tex.sampler);
-    return lc_texture_3d_sample(k_args, &tex, sampler, uv);
+    return lc_texture_with_storage(&tex, [&]<int S>() noexcept {
+        return lc_texture_3d_sample<S>(k_args, &tex, sampler, uv);
+    });
 }
 
+template<int S = LC_PIXEL_STORAGE_DYNAMIC>
 [[nodiscard]] inline lc_float4 lc_texture_2d_sample_level(const KernelFnArgs *k_args,
                                                           const Texture *tex, LCSampler sampler, lc_float2 uv,
                                                           lc_float lod) noexcept {
     auto filter = sampler.filter;
     if (lod <= 0.0f || tex->mip_levels == 0 || filter == LC_SAMPLER_FILTER_POINT) {
-        return lc_texture_2d_sample(k_args, tex, sampler, uv);
+        return lc_texture_2d_sample<S>(k_args, tex, sampler, uv);
     }
     auto level0 = lc_min(static_cast<lc_uint>(lod), tex->mip_levels - 1u);
-    auto v0 = texture_sample_linear(lc_texture_view(tex, level0), sampler.address, uv);
+    auto v0 = texture_sample_linear<S>(lc_texture_view(k_args, tex, level0), sampler.address, uv);
     if (level0 == tex->mip_levels - 1u || filter == LC_SAMPLER_FILTER_LINEAR_POINT) { return v0; }
-    auto v1 = texture_sample_linear(lc_texture_view(tex, level0 + 1u), sampler.address, uv);
+    auto v1 = texture_sample_linear<S>(lc_texture_view(k_args, tex, level0 + 1u), sampler.address, uv);
     return lc_lerp(v0, v1, lc_float4(lod - level0));
 }
 
@@ -797,20 +1476,23 @@ lc_bindless_texture_3d(const KernelFnArgs *k_args, const BindlessArray &array, s
                                                                    lc_float2 uv, lc_float lod) noexcept {
     auto &&tex = lc_bindless_texture_2d(k_args, array, index);
     auto sampler = LCSampler::decode(tex.sampler);
-    return lc_texture_2d_sample_level(k_args, &tex, sampler, uv, lod);
+    return lc_texture_with_storage(&tex, [&]<int S>() noexcept {
+        return lc_texture_2d_sample_level<S>(k_args, &tex, sampler, uv, lod);
+    });
 }
 
+template<int S = LC_PIXEL_STORAGE_DYNAMIC>
 [[nodiscard]] inline lc_float4 lc_texture_3d_sample_level(const KernelFnArgs *k_args,
                                                           const Texture *tex, LCSampler sampler, lc_float3 uvw,
                                                           lc_float lod) noexcept {
     auto filter = sampler.filter;
     if (lod <= 0.0f || tex->mip_levels == 0 || filter == LC_SAMPLER_FILTER_POINT) {
-        return lc_texture_3d_sample(k_args, tex, sampler, uvw);
+        return lc_texture_3d_sample<S>(k_args, tex, sampler, uvw);
     }
     auto level0 = lc_min(static_cast<lc_uint>(lod), tex->mip_levels - 1u);
-    auto v0 = texture_sample_linear(lc_texture_view(tex, level0), sampler.address, uvw);
+    auto v0 = texture_sample_linear<S>(lc_texture_view(k_args, tex, level0), sampler.address, uvw);
     if (level0 == tex->mip_levels - 1u || filter == LC_SAMPLER_FILTER_LINEAR_POINT) { return v0; }
-    auto v1 = texture_sample_linear(lc_texture_view(tex, level0 + 1u), sampler.address, uvw);
+    auto v1 = texture_sample_linear<S>(lc_texture_view(k_args, tex, level0 + 1u), sampler.address, uvw);
     return lc_lerp(v0, v1, lc_float4(lod - level0));
 }
 
@@ -819,38 +1501,59 @@ lc_bindless_texture_3d(const KernelFnArgs *k_args, const BindlessArray &array, s
                                                                    lc_float3 uvw, lc_float lod) noexcept {
     auto &&tex = lc_bindless_texture_3d(k_args, array, index);
     auto sampler = LCSampler::decode(tex.sampler);
-    return lc_texture_3d_sample_level(k_args, &tex, sampler, uvw, lod);
+    return lc_texture_with_storage(&tex, [&]<int S>() noexcept {
+        return lc_texture_3d_sample_level<S>(k_args, &tex, sampler, uvw, lod);
+    });
 }
 
+template<int S = LC_PIXEL_STORAGE_DYNAMIC>
 [[nodiscard]] inline lc_float4 lc_texture_2d_sample_grad(const KernelFnArgs *k_args,
                                                          const Texture *tex, LCSampler sampler, lc_float2 uv,
                                                          lc_float2 dpdx, lc_float2 dpdy) noexcept {
     constexpr auto ll = [](lc_float2 v) noexcept { return lc_dot(v, v); };
     if (lc_all(dpdx == 0.0) || lc_all(dpdy == 0.0)) {
-        return lc_texture_2d_sample(k_args, tex, sampler, uv);
+        return lc_texture_2d_sample<S>(k_args, tex, sampler, uv);
     }
     if (sampler.filter != LC_SAMPLER_FILTER_ANISOTROPIC) {
         auto s = lc_make_float2(tex->width, tex->height);
         auto level = 0.5f * log2f(lc_max(ll(dpdx * s), ll(dpdy * s)));
-        return lc_texture_2d_sample_level(k_args, tex, sampler, uv, level);
+        return lc_texture_2d_sample_level<S>(k_args, tex, sampler, uv, level);
+    }
+    // axes of the footprint in texels of level 0, the longer one first
+    auto size = lc_make_float2(tex->width, tex->height);
+    auto len_dpdx = lc_length(dpdx * size);
+    auto len_dpdy = lc_length(dpdy * size);
+    if (len_dpdx < len_dpdy) {
+        auto d = dpdx;
+        dpdx = dpdy;
+        dpdy = d;
     }
-    auto len_dpdx = lc_length(dpdx);
-    auto len_dpdy = lc_length(dpdy);
     auto longer = lc_max(len_dpdx, len_dpdy);
     auto shorter = lc_min(len_dpdx, len_dpdy);
+    // magnified footprints are covered by the linear filter at a fraction of the cost
+    if (longer <= 1.f) { return texture_sample_linear<S>(lc_texture_view(k_args, tex, 0u), sampler.address, uv); }
+    // Clamp ellipse vector ratio if too large
     constexpr auto max_anisotropy = 16.f;
-    auto s = shorter * max_anisotropy;
-    if (s != 0.0 && s < longer) {
-        auto scale = longer / s;
+    if (shorter > 0.f && shorter * max_anisotropy < longer) {
+        auto scale = longer / (shorter * max_anisotropy);
         dpdy *= scale;
         shorter *= scale;
     }
+    // a zero-length minor axis cannot be scaled, but still selects the level by the clamped ratio
+    shorter = lc_max(shorter, longer / max_anisotropy);
+    // the shorter axis spans a texel at the selected level, unless it is past the last level,
+    // where the footprint is shrunk to keep the filter affordable
     auto last_level = static_cast<float>(tex->mip_levels - 1u);
-    auto level = lc_clamp(last_level + log2f(shorter), 0.f, last_level);
+    auto level = lc_clamp(log2f(shorter), 0.f, last_level);
+    constexpr auto max_footprint = 4.f;
+    if (auto footprint = shorter / static_cast<float>(1u << (tex->mip_levels - 1u)); footprint > max_footprint) {
+        dpdx *= max_footprint / footprint;
+        dpdy *= max_footprint / footprint;
+    }
     auto level_uint = static_cast<lc_uint>(level);
-    auto v0 = texture_sample_ewa(lc_texture_view(tex, level_uint), sampler.address, uv, dpdx, dpdy);
+    auto v0 = texture_sample_ewa<S>(lc_texture_view(k_args, tex, level_uint), sampler.address, uv, dpdx, dpdy);
     if (level == 0.0 || level == last_level) { return v0; }
-    auto v1 = texture_sample_ewa(lc_texture_view(tex, level_uint + 1u), sampler.address, uv, dpdx, dpdy);
+    auto v1 = texture_sample_ewa<S>(lc_texture_view(k_args, tex, level_uint + 1u), sampler.address, uv, dpdx, dpdy);
     return lc_lerp(v0, v1, lc_make_float4(level - level_uint));
 
 }
@@ -860,38 +1563,59 @@ lc_bindless_texture_3d(const KernelFnArgs *k_args, const BindlessArray &array, s
                                                                  lc_float2 dpdx, lc_float2 dpdy) noexcept {
     auto &&tex = lc_bindless_texture_2d(k_args, array, index);
     auto sampler = LCSampler::decode(tex.sampler);
-    return lc_texture_2d_sample_grad(k_args, &tex, sampler, uv, dpdx, dpdy);
+    return lc_texture_with_storage(&tex, [&]<int S>() noexcept {
+        return lc_texture_2d_sample_grad<S>(k_args, &tex, sampler, uv, dpdx, dpdy);
+    });
 }
 
+template<int S = LC_PIXEL_STORAGE_DYNAMIC>
 [[nodiscard]] inline lc_float4 lc_texture_3d_sample_grad(const KernelFnArgs *k_args,
                                                          const Texture *tex, LCSampler sampler, lc_float3 uvw,
                                                          lc_float3 dpdx, lc_float3 dpdy) noexcept {
     constexpr auto ll = [](lc_float3 v) noexcept { return lc_dot(v, v); };
     if (lc_all(dpdx == 0.0) || lc_all(dpdy == 0.0)) {
-        return lc_texture_3d_sample(k_args, tex, sampler, uvw);
+        return lc_texture_3d_sample<S>(k_args, tex, sampler, uvw);
     }
     if (sampler.filter != LC_SAMPLER_FILTER_ANISOTROPIC) {
         auto s = lc_make_float3(tex->width, tex->height, tex->depth);
         auto level = 0.5f * log2f(lc_max(ll(dpdx * s), ll(dpdy * s)));
-        return lc_texture_3d_sample_level(k_args, tex, sampler, uvw, level);
+        return lc_texture_3d_sample_level<S>(k_args, tex, sampler, uvw, level);
+    }
+    // axes of the footprint in texels of level 0, the longer one first
+    auto size = lc_make_float3(tex->width, tex->height, tex->depth);
+    auto len_dpdx = lc_length(dpdx * size);
+    auto len_dpdy = lc_length(dpdy * size);
+    if (len_dpdx < len_dpdy) {
+        auto d = dpdx;
+        dpdx = dpdy;
+        dpdy = d;
     }
-    auto len_dpdx = lc_length(dpdx);
-    auto len_dpdy = lc_length(dpdy);
     auto longer = lc_max(len_dpdx, len_dpdy);
     auto shorter = lc_min(len_dpdx, len_dpdy);
+    // magnified footprints are covered by the linear filter at a fraction of the cost
+    if (longer <= 1.f) { return texture_sample_linear<S>(lc_texture_view(k_args, tex, 0u), sampler.address, uvw); }
+    // Clamp ellipse vector ratio if too large
     constexpr auto max_anisotropy = 16.f;
-    auto s = shorter * max_anisotropy;
-    if (s != 0.0 && s < longer) {
-        auto scale = longer / s;
+    if (shorter > 0.f && shorter * max_anisotropy < longer) {
+        auto scale = longer / (shorter * max_anisotropy);
         dpdy *= scale;
         shorter *= scale;
     }
+    // a zero-length minor axis cannot be scaled, but still selects the level by the clamped ratio
+    shorter = lc_max(shorter, longer / max_anisotropy);
+    // the shorter axis spans a texel at the selected level, unless it is past the last level,
+    // where the footprint is shrunk to keep the filter affordable
     auto last_level = static_cast<float>(tex->mip_levels - 1u);
-    auto level = lc_clamp(last_level + log2f(shorter), 0.f, last_level);
+    auto level = lc_clamp(log2f(shorter), 0.f, last_level);
+    constexpr auto max_footprint = 4.f;
+    if (auto footprint = shorter / static_cast<float>(1u << (tex->mip_levels - 1u)); footprint > max_footprint) {
+        dpdx *= max_footprint / footprint;
+        dpdy *= max_footprint / footprint;
+    }
     auto level_uint = static_cast<lc_uint>(level);
-    auto v0 = texture_sample_ewa(lc_texture_view(tex, level_uint), sampler.address, uvw, dpdx, dpdy);
+    auto v0 = texture_sample_ewa<S>(lc_texture_view(k_args, tex, level_uint), sampler.address, uvw, dpdx, dpdy);
     if (level == 0.0 || level == last_level) { return v0; }
-    auto v1 = texture_sample_ewa(lc_texture_view(tex, level_uint + 1u), sampler.address, uvw, dpdx, dpdy);
+    auto v1 = texture_sample_ewa<S>(lc_texture_view(k_args, tex, level_uint + 1u), sampler.address, uvw, dpdx, dpdy);
     return lc_lerp(v0, v1, lc_make_float4(level - level_uint));
 }
 
@@ -901,5 +1625,7 @@ lc_bindless_texture_3d(const KernelFnArgs *k_args, const BindlessArray &array, s
                                                                   lc_float3 dpdy) noexcept {
     auto &&tex = lc_bindless_texture_3d(k_args, array, index);
     auto sampler = LCSampler::decode(tex.sampler);
-    return lc_texture_3d_sample_grad(k_args, &tex, sampler, uvw, dpdx, dpdy);
+    return lc_texture_with_storage(&tex, [&]<int S>() noexcept {
+        return lc_texture_3d_sample_grad<S>(k_args, &tex, sampler, uvw, dpdx, dpdy);
+    });
 }
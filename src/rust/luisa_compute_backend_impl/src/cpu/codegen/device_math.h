@@ -3956,20 +3956,20 @@ template<typename T>
 [[nodiscard]] __device__ inline auto lc_abs(lc_float3 x) noexcept { return lc_make_float3(fabsf(x.x), fabsf(x.y), fabsf(x.z)); }
 [[nodiscard]] __device__ inline auto lc_abs(lc_float4 x) noexcept { return lc_make_float4(fabsf(x.x), fabsf(x.y), fabsf(x.z), fabsf(x.w)); }
 
-[[nodiscard]] __device__ inline auto lc_acos(lc_float x) noexcept { return acosf(x); }
-[[nodiscard]] __device__ inline auto lc_acos(lc_float2 x) noexcept { return lc_make_float2(acosf(x.x), acosf(x.y)); }
-[[nodiscard]] __device__ inline auto lc_acos(lc_float3 x) noexcept { return lc_make_float3(acosf(x.x), acosf(x.y), acosf(x.z)); }
-[[nodiscard]] __device__ inline auto lc_acos(lc_float4 x) noexcept { return lc_make_float4(acosf(x.x), acosf(x.y), acosf(x.z), acosf(x.w)); }
+[[nodiscard]] __device__ inline auto lc_acos(lc_float x) noexcept { return lc_math_impl::acos(x); }
+[[nodiscard]] __device__ inline auto lc_acos(lc_float2 x) noexcept { return lc_make_float2(lc_math_impl::acos(x.x), lc_math_impl::acos(x.y)); }
+[[nodiscard]] __device__ inline auto lc_acos(lc_float3 x) noexcept { return lc_make_float3(lc_math_impl::acos(x.x), lc_math_impl::acos(x.y), lc_math_impl::acos(x.z)); }
+[[nodiscard]] __device__ inline auto lc_acos(lc_float4 x) noexcept { return lc_make_float4(lc_math_impl::acos(x.x), lc_math_impl::acos(x.y), lc_math_impl::acos(x.z), lc_math_impl::acos(x.w)); }
 
-[[nodiscard]] __device__ inline auto lc_asin(lc_float x) noexcept { return asinf(x); }
-[[nodiscard]] __device__ inline auto lc_asin(lc_float2 x) noexcept { return lc_make_float2(asinf(x.x), asinf(x.y)); }
-[[nodiscard]] __device__ inline auto lc_asin(lc_float3 x) noexcept { return lc_make_float3(asinf(x.x), asinf(x.y), asinf(x.z)); }
-[[nodiscard]] __device__ inline auto lc_asin(lc_float4 x) noexcept { return lc_make_float4(asinf(x.x), asinf(x.y), asinf(x.z), asinf(x.w)); }
+[[nodiscard]] __device__ inline auto lc_asin(lc_float x) noexcept { return lc_math_impl::asin(x); }
+[[nodiscard]] __device__ inline auto lc_asin(lc_float2 x) noexcept { return lc_make_float2(lc_math_impl::asin(x.x), lc_math_impl::asin(x.y)); }
+[[nodiscard]] __device__ inline auto lc_asin(lc_float3 x) noexcept { return lc_make_float3(lc_math_impl::asin(x.x), lc_math_impl::asin(x.y), lc_math_impl::asin(x.z)); }
+[[nodiscard]] __device__ inline auto lc_asin(lc_float4 x) noexcept { return lc_make_float4(lc_math_impl::asin(x.x), lc_math_impl::asin(x.y), lc_math_impl::asin(x.z), lc_math_impl::asin(x.w)); }
 
-[[nodiscard]] __device__ inline auto lc_atan(lc_float x) noexcept { return atanf(x); }
-[[nodiscard]] __device__ inline auto lc_atan(lc_float2 x) noexcept { return lc_make_float2(atanf(x.x), atanf(x.y)); }
-[[nodiscard]] __device__ inline auto lc_atan(lc_float3 x) noexcept { return lc_make_float3(atanf(x.x), atanf(x.y), atanf(x.z)); }
-[[nodiscard]] __device__ inline auto lc_atan(lc_float4 x) noexcept { return lc_make_float4(atanf(x.x), atanf(x.y), atanf(x.z), atanf(x.w)); }
+[[nodiscard]] __device__ inline auto lc_atan(lc_float x) noexcept { return lc_math_impl::atan(x); }
+[[nodiscard]] __device__ inline auto lc_atan(lc_float2 x) noexcept { return lc_make_float2(lc_math_impl::atan(x.x), lc_math_impl::atan(x.y)); }
+[[nodiscard]] __device__ inline auto lc_atan(lc_float3 x) noexcept { return lc_make_float3(lc_math_impl::atan(x.x), lc_math_impl::atan(x.y), lc_math_impl::atan(x.z)); }
+[[nodiscard]] __device__ inline auto lc_atan(lc_float4 x) noexcept { return lc_make_float4(lc_math_impl::atan(x.x), lc_math_impl::atan(x.y), lc_math_impl::atan(x.z), lc_math_impl::atan(x.w)); }
 
 [[nodiscard]] __device__ inline auto lc_acosh(lc_float x) noexcept { return acoshf(x); }
 [[nodiscard]] __device__ inline auto lc_acosh(lc_float2 x) noexcept { return lc_make_float2(acoshf(x.x), acoshf(x.y)); }
@@ -3986,75 +3986,75 @@ template<typename T>
 [[nodiscard]] __device__ inline auto lc_atanh(lc_float3 x) noexcept { return lc_make_float3(atanhf(x.x), atanhf(x.y), atanhf(x.z)); }
 [[nodiscard]] __device__ inline auto lc_atanh(lc_float4 x) noexcept { return lc_make_float4(atanhf(x.x), atanhf(x.y), atanhf(x.z), atanhf(x.w)); }
 
-[[nodiscard]] __device__ inline auto lc_atan2(lc_float y, lc_float x) noexcept { return atan2f(y, x); }
-[[nodiscard]] __device__ inline auto lc_atan2(lc_float2 y, lc_float2 x) noexcept { return lc_make_float2(atan2f(y.x, x.x), atan2f(y.y, x.y)); }
-[[nodiscard]] __device__ inline auto lc_atan2(lc_float3 y, lc_float3 x) noexcept { return lc_make_float3(atan2f(y.x, x.x), atan2f(y.y, x.y), atan2f(y.z, x.z)); }
-[[nodiscard]] __device__ inline auto lc_atan2(lc_float4 y, lc_float4 x) noexcept { return lc_make_float4(atan2f(y.x, x.x), atan2f(y.y, x.y), atan2f(y.z, x.z), atan2f(y.w, x.w)); }
+[[nodiscard]] __device__ inline auto lc_atan2(lc_float y, lc_float x) noexcept { return lc_math_impl::atan2(y, x); }
+[[nodiscard]] __device__ inline auto lc_atan2(lc_float2 y, lc_float2 x) noexcept { return lc_make_float2(lc_math_impl::atan2(y.x, x.x), lc_math_impl::atan2(y.y, x.y)); }
+[[nodiscard]] __device__ inline auto lc_atan2(lc_float3 y, lc_float3 x) noexcept { return lc_make_float3(lc_math_impl::atan2(y.x, x.x), lc_math_impl::atan2(y.y, x.y), lc_math_impl::atan2(y.z, x.z)); }
+[[nodiscard]] __device__ inline auto lc_atan2(lc_float4 y, lc_float4 x) noexcept { return lc_make_float4(lc_math_impl::atan2(y.x, x.x), lc_math_impl::atan2(y.y, x.y), lc_math_impl::atan2(y.z, x.z), lc_math_impl::atan2(y.w, x.w)); }
 
-[[nodiscard]] __device__ inline auto lc_cos(lc_float x) noexcept { return cosf(x); }
-[[nodiscard]] __device__ inline auto lc_cos(lc_float2 x) noexcept { return lc_make_float2(cosf(x.x), cosf(x.y)); }
-[[nodiscard]] __device__ inline auto lc_cos(lc_float3 x) noexcept { return lc_make_float3(cosf(x.x), cosf(x.y), cosf(x.z)); }
-[[nodiscard]] __device__ inline auto lc_cos(lc_float4 x) noexcept { return lc_make_float4(cosf(x.x), cosf(x.y), cosf(x.z), cosf(x.w)); }
+[[nodiscard]] __device__ inline auto lc_cos(lc_float x) noexcept { return lc_math_impl::cos(x); }
+[[nodiscard]] __device__ inline auto lc_cos(lc_float2 x) noexcept { return lc_make_float2(lc_math_impl::cos(x.x), lc_math_impl::cos(x.y)); }
+[[nodiscard]] __device__ inline auto lc_cos(lc_float3 x) noexcept { return lc_make_float3(lc_math_impl::cos(x.x), lc_math_impl::cos(x.y), lc_math_impl::cos(x.z)); }
+[[nodiscard]] __device__ inline auto lc_cos(lc_float4 x) noexcept { return lc_make_float4(lc_math_impl::cos(x.x), lc_math_impl::cos(x.y), lc_math_impl::cos(x.z), lc_math_impl::cos(x.w)); }
 
 [[nodiscard]] __device__ inline auto lc_cosh(lc_float x) noexcept { return coshf(x); }
 [[nodiscard]] __device__ inline auto lc_cosh(lc_float2 x) noexcept { return lc_make_float2(coshf(x.x), coshf(x.y)); }
 [[nodiscard]] __device__ inline auto lc_cosh(lc_float3 x) noexcept { return lc_make_float3(coshf(x.x), coshf(x.y), coshf(x.z)); }
 [[nodiscard]] __device__ inline auto lc_cosh(lc_float4 x) noexcept { return lc_make_float4(coshf(x.x), coshf(x.y), coshf(x.z), coshf(x.w)); }
 
-[[nodiscard]] __device__ inline auto lc_sin(lc_float x) noexcept { return sinf(x); }
-[[nodiscard]] __device__ inline auto lc_sin(lc_float2 x) noexcept { return lc_make_float2(sinf(x.x), sinf(x.y)); }
-[[nodiscard]] __device__ inline auto lc_sin(lc_float3 x) noexcept { return lc_make_float3(sinf(x.x), sinf(x.y), sinf(x.z)); }
-[[nodiscard]] __device__ inline auto lc_sin(lc_float4 x) noexcept { return lc_make_float4(sinf(x.x), sinf(x.y), sinf(x.z), sinf(x.w)); }
+[[nodiscard]] __device__ inline auto lc_sin(lc_float x) noexcept { return lc_math_impl::sin(x); }
+[[nodiscard]] __device__ inline auto lc_sin(lc_float2 x) noexcept { return lc_make_float2(lc_math_impl::sin(x.x), lc_math_impl::sin(x.y)); }
+[[nodiscard]] __device__ inline auto lc_sin(lc_float3 x) noexcept { return lc_make_float3(lc_math_impl::sin(x.x), lc_math_impl::sin(x.y), lc_math_impl::sin(x.z)); }
+[[nodiscard]] __device__ inline auto lc_sin(lc_float4 x) noexcept { return lc_make_float4(lc_math_impl::sin(x.x), lc_math_impl::sin(x.y), lc_math_impl::sin(x.z), lc_math_impl::sin(x.w)); }
 
 [[nodiscard]] __device__ inline auto lc_sinh(lc_float x) noexcept { return sinhf(x); }
 [[nodiscard]] __device__ inline auto lc_sinh(lc_float2 x) noexcept { return lc_make_float2(sinhf(x.x), sinhf(x.y)); }
 [[nodiscard]] __device__ inline auto lc_sinh(lc_float3 x) noexcept { return lc_make_float3(sinhf(x.x), sinhf(x.y), sinhf(x.z)); }
 [[nodiscard]] __device__ inline auto lc_sinh(lc_float4 x) noexcept { return lc_make_float4(sinhf(x.x), sinhf(x.y), sinhf(x.z), sinhf(x.w)); }
 
-[[nodiscard]] __device__ inline auto lc_tan(lc_float x) noexcept { return tanf(x); }
-[[nodiscard]] __device__ inline auto lc_tan(lc_float2 x) noexcept { return lc_make_float2(tanf(x.x), tanf(x.y)); }
-[[nodiscard]] __device__ inline auto lc_tan(lc_float3 x) noexcept { return lc_make_float3(tanf(x.x), tanf(x.y), tanf(x.z)); }
-[[nodiscard]] __device__ inline auto lc_tan(lc_float4 x) noexcept { return lc_make_float4(tanf(x.x), tanf(x.y), tanf(x.z), tanf(x.w)); }
+[[nodiscard]] __device__ inline auto lc_tan(lc_float x) noexcept { return lc_math_impl::tan(x); }
+[[nodiscard]] __device__ inline auto lc_tan(lc_float2 x) noexcept { return lc_make_float2(lc_math_impl::tan(x.x), lc_math_impl::tan(x.y)); }
+[[nodiscard]] __device__ inline auto lc_tan(lc_float3 x) noexcept { return lc_make_float3(lc_math_impl::tan(x.x), lc_math_impl::tan(x.y), lc_math_impl::tan(x.z)); }
+[[nodiscard]] __device__ inline auto lc_tan(lc_float4 x) noexcept { return lc_make_float4(lc_math_impl::tan(x.x), lc_math_impl::tan(x.y), lc_math_impl::tan(x.z), lc_math_impl::tan(x.w)); }
 
 [[nodiscard]] __device__ inline auto lc_tanh(lc_float x) noexcept { return tanhf(x); }
 [[nodiscard]] __device__ inline auto lc_tanh(lc_float2 x) noexcept { return lc_make_float2(tanhf(x.x), tanhf(x.y)); }
 [[nodiscard]] __device__ inline auto lc_tanh(lc_float3 x) noexcept { return lc_make_float3(tanhf(x.x), tanhf(x.y), tanhf(x.z)); }
 [[nodiscard]] __device__ inline auto lc_tanh(lc_float4 x) noexcept { return lc_make_float4(tanhf(x.x), tanhf(x.y), tanhf(x.z), tanhf(x.w)); }
 
-[[nodiscard]] __device__ inline auto lc_exp(lc_float x) noexcept { return expf(x); }
-[[nodiscard]] __device__ inline auto lc_exp(lc_float2 x) noexcept { return lc_make_float2(expf(x.x), expf(x.y)); }
-[[nodiscard]] __device__ inline auto lc_exp(lc_float3 x) noexcept { return lc_make_float3(expf(x.x), expf(x.y), expf(x.z)); }
-[[nodiscard]] __device__ inline auto lc_exp(lc_float4 x) noexcept { return lc_make_float4(expf(x.x), expf(x.y), expf(x.z), expf(x.w)); }
-
-[[nodiscard]] __device__ inline auto lc_exp2(lc_float x) noexcept { return exp2f(x); }
-[[nodiscard]] __device__ inline auto lc_exp2(lc_float2 x) noexcept { return lc_make_float2(exp2f(x.x), exp2f(x.y)); }
-[[nodiscard]] __device__ inline auto lc_exp2(lc_float3 x) noexcept { return lc_make_float3(exp2f(x.x), exp2f(x.y), exp2f(x.z)); }
-[[nodiscard]] __device__ inline auto lc_exp2(lc_float4 x) noexcept { return lc_make_float4(exp2f(x.x), exp2f(x.y), exp2f(x.z), exp2f(x.w)); }
-
-[[nodiscard]] __device__ inline auto lc_exp10(lc_float x) noexcept { return exp10f(x); }
-[[nodiscard]] __device__ inline auto lc_exp10(lc_float2 x) noexcept { return lc_make_float2(exp10f(x.x), exp10f(x.y)); }
-[[nodiscard]] __device__ inline auto lc_exp10(lc_float3 x) noexcept { return lc_make_float3(exp10f(x.x), exp10f(x.y), exp10f(x.z)); }
-[[nodiscard]] __device__ inline auto lc_exp10(lc_float4 x) noexcept { return lc_make_float4(exp10f(x.x), exp10f(x.y), exp10f(x.z), exp10f(x.w)); }
-
-[[nodiscard]] __device__ inline auto lc_log(lc_float x) noexcept { return logf(x); }
-[[nodiscard]] __device__ inline auto lc_log(lc_float2 x) noexcept { return lc_make_float2(logf(x.x), logf(x.y)); }
-[[nodiscard]] __device__ inline auto lc_log(lc_float3 x) noexcept { return lc_make_float3(logf(x.x), logf(x.y), logf(x.z)); }
-[[nodiscard]] __device__ inline auto lc_log(lc_float4 x) noexcept { return lc_make_float4(logf(x.x), logf(x.y), logf(x.z), logf(x.w)); }
-
-[[nodiscard]] __device__ inline auto lc_log2(lc_float x) noexcept { return log2f(x); }
-[[nodiscard]] __device__ inline auto lc_log2(lc_float2 x) noexcept { return lc_make_float2(log2f(x.x), log2f(x.y)); }
-[[nodiscard]] __device__ inline auto lc_log2(lc_float3 x) noexcept { return lc_make_float3(log2f(x.x), log2f(x.y), log2f(x.z)); }
-[[nodiscard]] __device__ inline auto lc_log2(lc_float4 x) noexcept { return lc_make_float4(log2f(x.x), log2f(x.y), log2f(x.z), log2f(x.w)); }
-
-[[nodiscard]] __device__ inline auto lc_log10(lc_float x) noexcept { return log10f(x); }
-[[nodiscard]] __device__ inline auto lc_log10(lc_float2 x) noexcept { return lc_make_float2(log10f(x.x), log10f(x.y)); }
-[[nodiscard]] __device__ inline auto lc_log10(lc_float3 x) noexcept { return lc_make_float3(log10f(x.x), log10f(x.y), log10f(x.z)); }
-[[nodiscard]] __device__ inline auto lc_log10(lc_float4 x) noexcept { return lc_make_float4(log10f(x.x), log10f(x.y), log10f(x.z), log10f(x.w)); }
-
-[[nodiscard]] __device__ inline auto lc_pow(lc_float x, lc_float a) noexcept { return powf(x, a); }
-[[nodiscard]] __device__ inline auto lc_pow(lc_float2 x, lc_float2 a) noexcept { return lc_make_float2(powf(x.x, a.x), powf(x.y, a.y)); }
-[[nodiscard]] __device__ inline auto lc_pow(lc_float3 x, lc_float3 a) noexcept { return lc_make_float3(powf(x.x, a.x), powf(x.y, a.y), powf(x.z, a.z)); }
-[[nodiscard]] __device__ inline auto lc_pow(lc_float4 x, lc_float4 a) noexcept { return lc_make_float4(powf(x.x, a.x), powf(x.y, a.y), powf(x.z, a.z), powf(x.w, a.w)); }
+[[nodiscard]] __device__ inline auto lc_exp(lc_float x) noexcept { return lc_math_impl::exp(x); }
+[[nodiscard]] __device__ inline auto lc_exp(lc_float2 x) noexcept { return lc_make_float2(lc_math_impl::exp(x.x), lc_math_impl::exp(x.y)); }
+[[nodiscard]] __device__ inline auto lc_exp(lc_float3 x) noexcept { return lc_make_float3(lc_math_impl::exp(x.x), lc_math_impl::exp(x.y), lc_math_impl::exp(x.z)); }
+[[nodiscard]] __device__ inline auto lc_exp(lc_float4 x) noexcept { return lc_make_float4(lc_math_impl::exp(x.x), lc_math_impl::exp(x.y), lc_math_impl::exp(x.z), lc_math_impl::exp(x.w)); }
+
+[[nodiscard]] __device__ inline auto lc_exp2(lc_float x) noexcept { return lc_math_impl::exp2(x); }
+[[nodiscard]] __device__ inline auto lc_exp2(lc_float2 x) noexcept { return lc_make_float2(lc_math_impl::exp2(x.x), lc_math_impl::exp2(x.y)); }
+[[nodiscard]] __device__ inline auto lc_exp2(lc_float3 x) noexcept { return lc_make_float3(lc_math_impl::exp2(x.x), lc_math_impl::exp2(x.y), lc_math_impl::exp2(x.z)); }
+[[nodiscard]] __device__ inline auto lc_exp2(lc_float4 x) noexcept { return lc_make_float4(lc_math_impl::exp2(x.x), lc_math_impl::exp2(x.y), lc_math_impl::exp2(x.z), lc_math_impl::exp2(x.w)); }
+
+[[nodiscard]] __device__ inline auto lc_exp10(lc_float x) noexcept { return lc_math_impl::exp10(x); }
+[[nodiscard]] __device__ inline auto lc_exp10(lc_float2 x) noexcept { return lc_make_float2(lc_math_impl::exp10(x.x), lc_math_impl::exp10(x.y)); }
+[[nodiscard]] __device__ inline auto lc_exp10(lc_float3 x) noexcept { return lc_make_float3(lc_math_impl::exp10(x.x), lc_math_impl::exp10(x.y), lc_math_impl::exp10(x.z)); }
+[[nodiscard]] __device__ inline auto lc_exp10(lc_float4 x) noexcept { return lc_make_float4(lc_math_impl::exp10(x.x), lc_math_impl::exp10(x.y), lc_math_impl::exp10(x.z), lc_math_impl::exp10(x.w)); }
+
+[[nodiscard]] __device__ inline auto lc_log(lc_float x) noexcept { return lc_math_impl::log(x); }
+[[nodiscard]] __device__ inline auto lc_log(lc_float2 x) noexcept { return lc_make_float2(lc_math_impl::log(x.x), lc_math_impl::log(x.y)); }
+[[nodiscard]] __device__ inline auto lc_log(lc_float3 x) noexcept { return lc_make_float3(lc_math_impl::log(x.x), lc_math_impl::log(x.y), lc_math_impl::log(x.z)); }
+[[nodiscard]] __device__ inline auto lc_log(lc_float4 x) noexcept { return lc_make_float4(lc_math_impl::log(x.x), lc_math_impl::log(x.y), lc_math_impl::log(x.z), lc_math_impl::log(x.w)); }
+
+[[nodiscard]] __device__ inline auto lc_log2(lc_float x) noexcept { return lc_math_impl::log2(x); }
+[[nodiscard]] __device__ inline auto lc_log2(lc_float2 x) noexcept { return lc_make_float2(lc_math_impl::log2(x.x), lc_math_impl::log2(x.y)); }
+[[nodiscard]] __device__ inline auto lc_log2(lc_float3 x) noexcept { return lc_make_float3(lc_math_impl::log2(x.x), lc_math_impl::log2(x.y), lc_math_impl::log2(x.z)); }
+[[nodiscard]] __device__ inline auto lc_log2(lc_float4 x) noexcept { return lc_make_float4(lc_math_impl::log2(x.x), lc_math_impl::log2(x.y), lc_math_impl::log2(x.z), lc_math_impl::log2(x.w)); }
+
+[[nodiscard]] __device__ inline auto lc_log10(lc_float x) noexcept { return lc_math_impl::log10(x); }
+[[nodiscard]] __device__ inline auto lc_log10(lc_float2 x) noexcept { return lc_make_float2(lc_math_impl::log10(x.x), lc_math_impl::log10(x.y)); }
+[[nodiscard]] __device__ inline auto lc_log10(lc_float3 x) noexcept { return lc_make_float3(lc_math_impl::log10(x.x), lc_math_impl::log10(x.y), lc_math_impl::log10(x.z)); }
+[[nodiscard]] __device__ inline auto lc_log10(lc_float4 x) noexcept { return lc_make_float4(lc_math_impl::log10(x.x), lc_math_impl::log10(x.y), lc_math_impl::log10(x.z), lc_math_impl::log10(x.w)); }
+
+[[nodiscard]] __device__ inline auto lc_pow(lc_float x, lc_float a) noexcept { return lc_math_impl::pow(x, a); }
+[[nodiscard]] __device__ inline auto lc_pow(lc_float2 x, lc_float2 a) noexcept { return lc_make_float2(lc_math_impl::pow(x.x, a.x), lc_math_impl::pow(x.y, a.y)); }
+[[nodiscard]] __device__ inline auto lc_pow(lc_float3 x, lc_float3 a) noexcept { return lc_make_float3(lc_math_impl::pow(x.x, a.x), lc_math_impl::pow(x.y, a.y), lc_math_impl::pow(x.z, a.z)); }
+[[nodiscard]] __device__ inline auto lc_pow(lc_float4 x, lc_float4 a) noexcept { return lc_make_float4(lc_math_impl::pow(x.x, a.x), lc_math_impl::pow(x.y, a.y), lc_math_impl::pow(x.z, a.z), lc_math_impl::pow(x.w, a.w)); }
 
 [[nodiscard]] __device__ inline auto lc_sqrt(lc_float x) noexcept { return sqrtf(x); }
 [[nodiscard]] __device__ inline auto lc_sqrt(lc_float2 x) noexcept { return lc_make_float2(sqrtf(x.x), sqrtf(x.y)); }
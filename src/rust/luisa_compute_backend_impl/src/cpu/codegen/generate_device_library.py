@@ -346,26 +346,26 @@ __device__ inline constexpr void operator+=(lc_float{i}x{i}& lhs, const lc_float
         generate_vector_call("min", "fminf", "f", ["a", "b"])
         generate_vector_call("max", "fmaxf", "f", ["a", "b"])
         generate_vector_call("abs", "fabsf", "f", ["x"])
-        generate_vector_call("acos", "acosf", "f", ["x"])
-        generate_vector_call("asin", "asinf", "f", ["x"])
-        generate_vector_call("atan", "atanf", "f", ["x"])
+        generate_vector_call("acos", "lc_math_impl::acos", "f", ["x"])
+        generate_vector_call("asin", "lc_math_impl::asin", "f", ["x"])
+        generate_vector_call("atan", "lc_math_impl::atan", "f", ["x"])
         generate_vector_call("acosh", "acoshf", "f", ["x"])
         generate_vector_call("asinh", "asinhf", "f", ["x"])
         generate_vector_call("atanh", "atanhf", "f", ["x"])
-        generate_vector_call("atan2", "atan2f", "f", ["y", "x"])
-        generate_vector_call("cos", "cosf", "f", ["x"])
+        generate_vector_call("atan2", "lc_math_impl::atan2", "f", ["y", "x"])
+        generate_vector_call("cos", "lc_math_impl::cos", "f", ["x"])
         generate_vector_call("cosh", "coshf", "f", ["x"])
-        generate_vector_call("sin", "sinf", "f", ["x"])
+        generate_vector_call("sin", "lc_math_impl::sin", "f", ["x"])
         generate_vector_call("sinh", "sinhf", "f", ["x"])
-        generate_vector_call("tan", "tanf", "f", ["x"])
+        generate_vector_call("tan", "lc_math_impl::tan", "f", ["x"])
         generate_vector_call("tanh", "tanhf", "f", ["x"])
-        generate_vector_call("exp", "expf", "f", ["x"])
-        generate_vector_call("exp2", "exp2f", "f", ["x"])
-        generate_vector_call("exp10", "exp10f", "f", ["x"])
-        generate_vector_call("log", "logf", "f", ["x"])
-        generate_vector_call("log2", "log2f", "f", ["x"])
-        generate_vector_call("log10", "log10f", "f", ["x"])
-        generate_vector_call("pow", "powf", "f", ["x", "a"])
+        generate_vector_call("exp", "lc_math_impl::exp", "f", ["x"])
+        generate_vector_call("exp2", "lc_math_impl::exp2", "f", ["x"])
+        generate_vector_call("exp10", "lc_math_impl::exp10", "f", ["x"])
+        generate_vector_call("log", "lc_math_impl::log", "f", ["x"])
+        generate_vector_call("log2", "lc_math_impl::log2", "f", ["x"])
+        generate_vector_call("log10", "lc_math_impl::log10", "f", ["x"])
+        generate_vector_call("pow", "lc_math_impl::pow", "f", ["x", "a"])
         generate_vector_call("sqrt", "sqrtf", "f", ["x"])
         generate_vector_call("rsqrt", "rsqrtf", "f", ["x"])
         generate_vector_call("ceil", "ceilf", "f", ["x"])
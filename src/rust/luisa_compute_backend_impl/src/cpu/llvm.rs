@@ -611,9 +611,12 @@ pub(crate) fn compile_llvm_ir(name: &String, path_: &String) -> Option<KernelFn>
             let mut c = c.borrow_mut();
             let c = c.as_mut().unwrap();
             if let Some(record) = c.cached_functions.get(path_) {
+                crate::compile_cache("jit", true);
                 return Some(*record);
             }
         }
+        crate::compile_cache("jit", false);
+        let tic = std::time::Instant::now();
         let record = {
             let c = c.borrow();
             let c = c.as_ref().unwrap();
@@ -695,6 +698,7 @@ pub(crate) fn compile_llvm_ir(name: &String, path_: &String) -> Option<KernelFn>
             let c = c.as_mut().unwrap();
             c.cached_functions.insert(path_.clone(), record);
         }
+        crate::compile_phase("llvm", tic);
         Some(record)
     }
 }
@@ -884,7 +888,8 @@ impl Context {
             add_libm_symbol!(
                 fminf, fmaxf, sinf, fabsf, acosf, asinf, atanf, acoshf, asinhf, atanhf, atan2f,
                 cosf, coshf, sinf, sinhf, tanf, tanhf, expf, exp2f, exp10f, logf, log2f, log10f,
-                sqrtf, ceilf, floorf, truncf, roundf, fmaf, copysignf, powf, fmodf
+                sqrtf, ceilf, floorf, truncf, roundf, fmaf, copysignf, powf, fmodf, rintf, rint,
+                floor, fma
             );
             extern "C" fn rsqrtf(x: f32) -> f32 {
                 1.0 / x.sqrt()
@@ -0,0 +1,162 @@
+// Memory of buffers and textures.
+//
+// Resources of at least LARGE_ALLOCATION_SIZE are mapped from the OS rather than taken from the
+// heap. The mappings are aligned to huge pages and backed by transparent huge pages, or by
+// explicit ones with LUISA_CPU_HUGE_PAGES=explicit (falling back to transparent ones when none
+// are reserved); LUISA_CPU_HUGE_PAGES=off keeps regular pages. Fresh mappings read as zero, so
+// instead of being cleared they are faulted in in parallel, a huge page per task, to spread the
+// page faults over the cores. This runs on a pool of its own, so that creating a resource does
+// not wait for the kernels running on the device pool. LUISA_CPU_LAZY_ZERO leaves the pages to
+// be faulted in on first use by the kernels instead.
+use std::alloc::Layout;
+
+use lazy_static::lazy_static;
+use rayon::prelude::{IntoParallelIterator, ParallelIterator};
+
+const HUGE_PAGE_SIZE: usize = 2 << 20;
+const LARGE_ALLOCATION_SIZE: usize = HUGE_PAGE_SIZE;
+
+#[derive(Clone, Copy, PartialEq, Eq)]
+enum HugePages {
+    Off,
+    Transparent,
+    Explicit,
+}
+
+lazy_static! {
+    static ref HUGE_PAGES: HugePages = match std::env::var("LUISA_CPU_HUGE_PAGES").as_deref() {
+        Ok("off") => HugePages::Off,
+        Ok("explicit") => HugePages::Explicit,
+        _ => HugePages::Transparent,
+    };
+    static ref LAZY_ZERO: bool = std::env::var("LUISA_CPU_LAZY_ZERO").is_ok();
+    static ref FAULT_IN_POOL: rayon::ThreadPool = rayon::ThreadPoolBuilder::new()
+        .num_threads(std::thread::available_parallelism().map_or(1, |n| n.get()))
+        .thread_name(|i| format!("lc-cpu-fault-in-{}", i))
+        .build()
+        .unwrap();
+}
+
+enum Backing {
+    Heap(Layout),
+    Mapped(usize),
+}
+
+// zero-initialized memory owned by a resource
+pub(crate) struct Allocation {
+    pub(crate) data: *mut u8,
+    backing: Backing,
+}
+unsafe impl Send for Allocation {}
+unsafe impl Sync for Allocation {}
+
+impl Allocation {
+    pub(crate) fn new(size: usize, align: usize) -> Self {
+        if size >= LARGE_ALLOCATION_SIZE && align <= HUGE_PAGE_SIZE {
+            if let Some((data, mapped_size)) = sys::map(size, *HUGE_PAGES) {
+                if !*LAZY_ZERO {
+                    let base = data as usize;
+                    FAULT_IN_POOL.install(|| {
+                        (0..(mapped_size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE)
+                            .into_par_iter()
+                            .for_each(|chunk| {
+                                let begin = chunk * HUGE_PAGE_SIZE;
+                                let end = (begin + HUGE_PAGE_SIZE).min(mapped_size);
+                                for offset in (begin..end).step_by(sys::PAGE_SIZE) {
+                                    unsafe { ((base + offset) as *mut u8).write_volatile(0) };
+                                }
+                            });
+                    });
+                }
+                return Self {
+                    data,
+                    backing: Backing::Mapped(mapped_size),
+                };
+            }
+        }
+        let layout = Layout::from_size_align(size.max(1), align).unwrap();
+        Self {
+            data: unsafe { std::alloc::alloc_zeroed(layout) },
+            backing: Backing::Heap(layout),
+        }
+    }
+}
+
+impl Drop for Allocation {
+    fn drop(&mut self) {
+        match self.backing {
+            Backing::Heap(layout) => unsafe { std::alloc::dealloc(self.data, layout) },
+            Backing::Mapped(mapped_size) => sys::unmap(self.data, mapped_size),
+        }
+    }
+}
+
+#[cfg(target_os = "linux")]
+mod sys {
+    use super::{HugePages, HUGE_PAGE_SIZE};
+
+    pub(super) const PAGE_SIZE: usize = 4096;
+
+    unsafe fn map_anonymous(size: usize, flags: libc::c_int) -> Option<*mut u8> {
+        let data = libc::mmap(
+            std::ptr::null_mut(),
+            size,
+            libc::PROT_READ | libc::PROT_WRITE,
+            libc::MAP_PRIVATE | libc::MAP_ANONYMOUS | flags,
+            -1,
+            0,
+        );
+        (data != libc::MAP_FAILED).then_some(data as *mut u8)
+    }
+
+    // returns the mapping and its size, rounded up to whole huge pages
+    pub(super) fn map(size: usize, huge_pages: HugePages) -> Option<(*mut u8, usize)> {
+        let size = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        unsafe {
+            if huge_pages == HugePages::Explicit {
+                if let Some(data) = map_anonymous(size, libc::MAP_HUGETLB | libc::MAP_HUGE_2MB) {
+                    return Some((data, size));
+                }
+                log::warn!(
+                    "No explicit huge pages for an allocation of {} bytes, using transparent ones",
+                    size
+                );
+            }
+            // over-map by a huge page and trim both ends so that the mapping is aligned to one
+            let data = map_anonymous(size + HUGE_PAGE_SIZE, 0)?;
+            let head = data.align_offset(HUGE_PAGE_SIZE);
+            if head > 0 {
+                libc::munmap(data as *mut libc::c_void, head);
+            }
+            if head < HUGE_PAGE_SIZE {
+                libc::munmap(
+                    data.add(head + size) as *mut libc::c_void,
+                    HUGE_PAGE_SIZE - head,
+                );
+            }
+            let data = data.add(head);
+            if huge_pages != HugePages::Off {
+                libc::madvise(data as *mut libc::c_void, size, libc::MADV_HUGEPAGE);
+            }
+            Some((data, size))
+        }
+    }
+
+    pub(super) fn unmap(data: *mut u8, size: usize) {
+        unsafe { libc::munmap(data as *mut libc::c_void, size) };
+    }
+}
+
+// large allocations come from the heap on other platforms
+#[cfg(not(target_os = "linux"))]
+mod sys {
+    use super::HugePages;
+
+    pub(super) const PAGE_SIZE: usize = 4096;
+
+    pub(super) fn map(_size: usize, _huge_pages: HugePages) -> Option<(*mut u8, usize)> {
+        None
+    }
+
+    pub(super) fn unmap(_data: *mut u8, _size: usize) {}
+}
@@ -6,7 +6,7 @@ use self::{
     accel::{AccelImpl, GeometryImpl},
     resource::{BindlessArrayImpl, BufferImpl, EventImpl},
     stream::{convert_capture, StreamImpl},
-    texture::TextureImpl,
+    texture::{TextureImpl, TextureLayout},
 };
 use super::Backend;
 use crate::{cpu::llvm::LLVM_PATH, SwapChainForCpuContext};
@@ -22,6 +22,8 @@ mod codegen;
 use codegen::sha256;
 mod accel;
 mod llvm;
+mod memory;
+mod paging;
 mod resource;
 mod shader;
 mod stream;
@@ -83,6 +85,7 @@ impl Backend for RustBackend {
             storage,
             mipmap_levels as u8,
             allow_simultaneous_access,
+            TextureLayout::for_texture(dimension as u8),
         );
         let data = texture.data;
         let ptr = Box::into_raw(Box::new(texture));
@@ -100,11 +103,7 @@ impl Backend for RustBackend {
     }
 
     fn create_bindless_array(&self, size: usize) -> luisa_compute_api_types::CreatedResourceInfo {
-        let bindless_array = BindlessArrayImpl {
-            buffers: vec![defs::BufferView::default(); size],
-            tex2ds: vec![defs::Texture::default(); size],
-            tex3ds: vec![defs::Texture::default(); size],
-        };
+        let bindless_array = BindlessArrayImpl::new(size);
         let ptr = Box::into_raw(Box::new(bindless_array));
         CreatedResourceInfo {
             handle: ptr as u64,
@@ -231,7 +230,7 @@ impl Backend for RustBackend {
     fn create_shader(
         &self,
         kernel: &luisa_compute_ir::ir::KernelModule,
-        _options: &api::ShaderOption,
+        options: &api::ShaderOption,
     ) -> luisa_compute_api_types::CreatedShaderInfo {
         // let debug =
         //     luisa_compute_ir::ir::debug::luisa_compute_ir_dump_human_readable(&kernel.module);
@@ -242,12 +241,25 @@ impl Backend for RustBackend {
         //     println!("{}", debug);
         // }
         let tic = std::time::Instant::now();
-        let mut gened = codegen::cpp::CpuCodeGen::run(&kernel);
+        let captured_texture_storages = kernel
+            .captures
+            .as_ref()
+            .iter()
+            .map(|c| match c.binding {
+                ir::Binding::Texture(t) => unsafe {
+                    Some((*(t.handle as *const TextureImpl)).storage)
+                },
+                _ => None,
+            })
+            .collect::<Vec<_>>();
+        let mut gened = codegen::cpp::CpuCodeGen::run(&kernel, &captured_texture_storages);
         info!(
             "Source generated in {:.3}ms",
             (std::time::Instant::now() - tic).as_secs_f64() * 1e3
         );
-        let args = clang_args();
+        crate::compile_phase("codegen", tic);
+        crate::compile_counter("source.bytes", gened.source.len() as u64);
+        let args = clang_args(options.enable_fast_math);
         let args = args.join(",");
         gened.source.push_str(&format!(
             "\n// clang args: {}\n// clang path: {}\n// llvm path:{}",
@@ -255,9 +267,16 @@ impl Backend for RustBackend {
         ));
         let hash = sha256(&gened.source);
         let gened_src = gened.source.replace("##kernel_fn##", &hash);
+        let has_texture_args = kernel.args.iter().any(|a| {
+            matches!(
+                a.get().instruction.as_ref(),
+                ir::Instruction::Texture2D | ir::Instruction::Texture3D
+            )
+        });
         let mut shader = None;
         for tries in 0..2 {
-            let lib_path = shader::compile(&hash, &gened_src, tries == 1).unwrap();
+            let lib_path =
+                shader::compile(&hash, &gened_src, options.enable_fast_math, tries == 1).unwrap();
             let mut captures = vec![];
             let mut custom_ops = vec![];
             unsafe {
@@ -278,6 +297,8 @@ impl Backend for RustBackend {
                 custom_ops,
                 kernel.block_size,
                 &gened.messages,
+                options.enable_fast_math,
+                has_texture_args.then(|| gened.source.clone()),
             );
             if shader.is_some() {
                 break;
@@ -408,9 +429,9 @@ impl Backend for RustBackend {
             drop(Box::from_raw(mesh));
         }
     }
-    fn create_accel(&self, _option: AccelOption) -> api::CreatedResourceInfo {
+    fn create_accel(&self, option: AccelOption) -> api::CreatedResourceInfo {
         unsafe {
-            let accel = Box::new(AccelImpl::new());
+            let accel = Box::new(AccelImpl::new(&option));
             let accel = Box::into_raw(accel);
             api::CreatedResourceInfo {
                 handle: accel as u64,
@@ -0,0 +1,382 @@
+// Out-of-core storage for large textures.
+//
+// With LUISA_CPU_TEXTURE_CACHE_DIR set, textures of at least LUISA_CPU_PAGED_TEXTURE_MIN_MB
+// (16 by default) are backed by a file in that directory instead of the heap. The file is
+// mapped into memory, so kernels read texels through plain pointers and the tiles they touch
+// are faulted in by the OS. A trimmer thread measures the residency of every paged texture and,
+// once the total exceeds LUISA_CPU_TEXTURE_BUDGET_MB (half of the physical memory by default),
+// writes back and drops the least recently used textures until it is below the budget again.
+// LUISA_CPU_TEXTURE_STATS logs the residency of textures as they are evicted and released.
+use std::{
+    fs::File,
+    path::PathBuf,
+    sync::{
+        atomic::{AtomicU64, Ordering},
+        Arc, Weak,
+    },
+    time::Duration,
+};
+
+use lazy_static::lazy_static;
+use parking_lot::Mutex;
+
+// residency is measured in tiles of this many bytes
+const RESIDENCY_TILE_SIZE: usize = 64 << 10;
+const TRIM_INTERVAL: Duration = Duration::from_millis(200);
+const DEFAULT_MIN_PAGED_TEXTURE_SIZE: usize = 16 << 20;
+
+lazy_static! {
+    static ref PAGER: Option<TexturePager> = TexturePager::from_env();
+    static ref LOG_TEXTURE_STATS: bool = std::env::var("LUISA_CPU_TEXTURE_STATS").is_ok();
+}
+
+#[derive(Clone, Copy, Default)]
+struct ResidencyStats {
+    resident_tiles: usize,
+    total_tiles: usize,
+    // tiles brought in by kernels and dropped by the trimmer over the lifetime of the texture
+    page_ins: usize,
+    evictions: usize,
+}
+impl std::fmt::Display for ResidencyStats {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        write!(
+            f,
+            "{}/{} tiles resident, {} paged in, {} evicted",
+            self.resident_tiles, self.total_tiles, self.page_ins, self.evictions
+        )
+    }
+}
+
+struct Residency {
+    // a bit per tile, set when it was resident at the last trim
+    resident: Vec<u64>,
+    stats: ResidencyStats,
+}
+
+pub(crate) struct PagedMemory {
+    pub(crate) data: *mut u8,
+    size: usize,
+    file: File,
+    // trim epoch of the last dispatch that used the texture or of the last observed page-in
+    last_use: AtomicU64,
+    residency: Mutex<Residency>,
+}
+unsafe impl Send for PagedMemory {}
+unsafe impl Sync for PagedMemory {}
+
+struct TexturePager {
+    dir: PathBuf,
+    budget: usize,
+    min_size: usize,
+    epoch: AtomicU64,
+    next_id: AtomicU64,
+    textures: Mutex<Vec<Weak<PagedMemory>>>,
+}
+
+fn env_megabytes(name: &str) -> Option<usize> {
+    let value = std::env::var(name).ok()?;
+    match value.parse::<usize>() {
+        Ok(mb) => Some(mb << 20),
+        Err(_) => {
+            log::warn!("Ignoring {}={}: expected a size in megabytes", name, value);
+            None
+        }
+    }
+}
+
+impl TexturePager {
+    fn from_env() -> Option<Self> {
+        let dir = PathBuf::from(std::env::var("LUISA_CPU_TEXTURE_CACHE_DIR").ok()?);
+        if !cfg!(target_os = "linux") {
+            log::warn!(
+                "Paged textures are only supported on Linux, ignoring LUISA_CPU_TEXTURE_CACHE_DIR"
+            );
+            return None;
+        }
+        if let Err(e) = std::fs::create_dir_all(&dir) {
+            log::warn!(
+                "Cannot create texture cache directory {}: {}",
+                dir.display(),
+                e
+            );
+            return None;
+        }
+        let budget = env_megabytes("LUISA_CPU_TEXTURE_BUDGET_MB")
+            .unwrap_or_else(|| sys::physical_memory() / 2);
+        let min_size = env_megabytes("LUISA_CPU_PAGED_TEXTURE_MIN_MB")
+            .unwrap_or(DEFAULT_MIN_PAGED_TEXTURE_SIZE);
+        log::info!(
+            "Paging textures of at least {} MB to {} with a residency budget of {} MB",
+            min_size >> 20,
+            dir.display(),
+            budget >> 20
+        );
+        std::thread::spawn(|| {
+            let mut pages = Vec::new();
+            loop {
+                std::thread::sleep(TRIM_INTERVAL);
+                PAGER.as_ref().unwrap().trim(&mut pages);
+            }
+        });
+        Some(Self {
+            dir,
+            budget,
+            min_size,
+            epoch: AtomicU64::new(0),
+            next_id: AtomicU64::new(0),
+            textures: Mutex::new(Vec::new()),
+        })
+    }
+
+    fn allocate(&self, size: usize) -> std::io::Result<Arc<PagedMemory>> {
+        let id = self.next_id.fetch_add(1, Ordering::Relaxed);
+        let path = self
+            .dir
+            .join(format!("luisa-texture-{}-{}.bin", std::process::id(), id));
+        let file = File::options()
+            .read(true)
+            .write(true)
+            .create_new(true)
+            .open(&path)?;
+        // the mapping keeps the file alive, so it never outlives the process
+        std::fs::remove_file(&path)?;
+        file.set_len(size as u64)?;
+        let data = sys::map_file(&file, size)?;
+        let tiles = (size + RESIDENCY_TILE_SIZE - 1) / RESIDENCY_TILE_SIZE;
+        let memory = Arc::new(PagedMemory {
+            data,
+            size,
+            file,
+            last_use: AtomicU64::new(self.epoch.load(Ordering::Relaxed)),
+            residency: Mutex::new(Residency {
+                resident: vec![0; (tiles + 63) / 64],
+                stats: ResidencyStats {
+                    total_tiles: tiles,
+                    ..Default::default()
+                },
+            }),
+        });
+        self.textures.lock().push(Arc::downgrade(&memory));
+        Ok(memory)
+    }
+
+    fn trim(&self, pages: &mut Vec<u8>) {
+        let epoch = self.epoch.fetch_add(1, Ordering::Relaxed) + 1;
+        let mut textures = {
+            let mut textures = self.textures.lock();
+            textures.retain(|t| t.strong_count() > 0);
+            textures
+                .iter()
+                .filter_map(|t| t.upgrade())
+                .collect::<Vec<_>>()
+        };
+        let mut resident = 0;
+        for t in &textures {
+            resident += t.update_residency(pages, epoch) * RESIDENCY_TILE_SIZE;
+        }
+        if resident <= self.budget {
+            return;
+        }
+        // evict down to 7/8 of the budget so that the trimmer does not run on every tick
+        textures.sort_by_key(|t| t.last_use.load(Ordering::Relaxed));
+        for t in &textures {
+            if resident <= self.budget / 8 * 7 {
+                break;
+            }
+            resident -= t.evict() * RESIDENCY_TILE_SIZE;
+        }
+    }
+}
+
+impl PagedMemory {
+    // backs a texture of the given size with a file if paging is enabled and the texture is large enough
+    pub(crate) fn allocate(size: usize) -> Option<Arc<Self>> {
+        let pager = PAGER.as_ref()?;
+        if size < pager.min_size {
+            return None;
+        }
+        match pager.allocate(size) {
+            Ok(memory) => Some(memory),
+            Err(e) => {
+                log::warn!(
+                    "Failed to page a texture of {} bytes, keeping it in memory: {}",
+                    size,
+                    e
+                );
+                None
+            }
+        }
+    }
+
+    #[inline]
+    pub(crate) fn mark_used(&self) {
+        if let Some(pager) = PAGER.as_ref() {
+            self.last_use
+                .fetch_max(pager.epoch.load(Ordering::Relaxed), Ordering::Relaxed);
+        }
+    }
+
+    // returns the number of resident tiles
+    fn update_residency(&self, pages: &mut Vec<u8>, epoch: u64) -> usize {
+        let page_size = sys::page_size();
+        pages.resize((self.size + page_size - 1) / page_size, 0);
+        if let Err(e) = sys::page_residency(self.data, self.size, pages) {
+            log::warn!(
+                "Cannot query the residency of paged texture {:p}: {}",
+                self.data,
+                e
+            );
+            return 0;
+        }
+        let pages_per_tile = (RESIDENCY_TILE_SIZE / page_size).max(1);
+        let mut residency = self.residency.lock();
+        let Residency { resident, stats } = &mut *residency;
+        let mut page_ins = 0;
+        stats.resident_tiles = 0;
+        for (tile, tile_pages) in pages.chunks(pages_per_tile).enumerate() {
+            let (word, bit) = (tile / 64, 1u64 << (tile % 64));
+            if tile_pages.iter().any(|p| p & 1 != 0) {
+                page_ins += (resident[word] & bit == 0) as usize;
+                resident[word] |= bit;
+                stats.resident_tiles += 1;
+            } else {
+                resident[word] &= !bit;
+            }
+        }
+        stats.page_ins += page_ins;
+        if page_ins > 0 {
+            self.last_use.fetch_max(epoch, Ordering::Relaxed);
+        }
+        stats.resident_tiles
+    }
+
+    // writes back and drops every resident tile, returns the number of dropped tiles
+    fn evict(&self) -> usize {
+        if let Err(e) = sys::drop_pages(&self.file, self.data, self.size) {
+            log::warn!("Failed to evict paged texture {:p}: {}", self.data, e);
+            return 0;
+        }
+        let mut residency = self.residency.lock();
+        let Residency { resident, stats } = &mut *residency;
+        let evicted = stats.resident_tiles;
+        resident.fill(0);
+        stats.evictions += evicted;
+        stats.resident_tiles = 0;
+        if *LOG_TEXTURE_STATS {
+            log::info!("Paged texture {:p} evicted: {}", self.data, stats);
+        }
+        evicted
+    }
+}
+
+impl Drop for PagedMemory {
+    fn drop(&mut self) {
+        if *LOG_TEXTURE_STATS {
+            log::info!(
+                "Paged texture {:p} released: {}",
+                self.data,
+                self.residency.lock().stats
+            );
+        }
+        sys::unmap(self.data, self.size);
+    }
+}
+
+#[cfg(target_os = "linux")]
+mod sys {
+    use std::{fs::File, io::Error, os::fd::AsRawFd};
+
+    pub(super) fn page_size() -> usize {
+        unsafe { libc::sysconf(libc::_SC_PAGESIZE) as usize }
+    }
+
+    pub(super) fn physical_memory() -> usize {
+        unsafe { libc::sysconf(libc::_SC_PHYS_PAGES) as usize * page_size() }
+    }
+
+    pub(super) fn map_file(file: &File, size: usize) -> std::io::Result<*mut u8> {
+        let data = unsafe {
+            libc::mmap(
+                std::ptr::null_mut(),
+                size,
+                libc::PROT_READ | libc::PROT_WRITE,
+                libc::MAP_SHARED,
+                file.as_raw_fd(),
+                0,
+            )
+        };
+        if data == libc::MAP_FAILED {
+            return Err(Error::last_os_error());
+        }
+        Ok(data as *mut u8)
+    }
+
+    pub(super) fn unmap(data: *mut u8, size: usize) {
+        unsafe { libc::munmap(data as *mut libc::c_void, size) };
+    }
+
+    // the low bit of each byte is set if the page is in the page cache
+    pub(super) fn page_residency(
+        data: *mut u8,
+        size: usize,
+        pages: &mut [u8],
+    ) -> std::io::Result<()> {
+        match unsafe { libc::mincore(data as *mut libc::c_void, size, pages.as_mut_ptr()) } {
+            0 => Ok(()),
+            _ => Err(Error::last_os_error()),
+        }
+    }
+
+    // Unmaps the pages, writes the dirty ones back and drops them from the page cache. Kernels
+    // still reading the texture fault the texels back in from the file.
+    pub(super) fn drop_pages(file: &File, data: *mut u8, size: usize) -> std::io::Result<()> {
+        unsafe {
+            if libc::madvise(data as *mut libc::c_void, size, libc::MADV_DONTNEED) != 0 {
+                return Err(Error::last_os_error());
+            }
+            file.sync_data()?;
+            match libc::posix_fadvise(
+                file.as_raw_fd(),
+                0,
+                size as libc::off_t,
+                libc::POSIX_FADV_DONTNEED,
+            ) {
+                0 => Ok(()),
+                e => Err(Error::from_raw_os_error(e)),
+            }
+        }
+    }
+}
+
+// the pager is never created on other platforms
+#[cfg(not(target_os = "linux"))]
+mod sys {
+    use std::{fs::File, io::Error, io::ErrorKind};
+
+    pub(super) fn page_size() -> usize {
+        4096
+    }
+
+    pub(super) fn physical_memory() -> usize {
+        0
+    }
+
+    pub(super) fn map_file(_file: &File, _size: usize) -> std::io::Result<*mut u8> {
+        Err(Error::from(ErrorKind::Unsupported))
+    }
+
+    pub(super) fn unmap(_data: *mut u8, _size: usize) {}
+
+    pub(super) fn page_residency(
+        _data: *mut u8,
+        _size: usize,
+        _pages: &mut [u8],
+    ) -> std::io::Result<()> {
+        Err(Error::from(ErrorKind::Unsupported))
+    }
+
+    pub(super) fn drop_pages(_file: &File, _data: *mut u8, _size: usize) -> std::io::Result<()> {
+        Err(Error::from(ErrorKind::Unsupported))
+    }
+}
@@ -1,13 +1,19 @@
 use std::{
-    alloc::Layout,
-    sync::atomic::{AtomicBool, AtomicU64},
+    collections::HashMap,
+    sync::{
+        atomic::{AtomicBool, AtomicU64},
+        Arc,
+    },
     time::Duration,
 };
 
 use luisa_compute_api_types::{BindlessArrayUpdateModification, BindlessArrayUpdateOperation};
 use luisa_compute_cpu_kernel_defs as defs;
 use parking_lot::{Condvar, Mutex};
+use rayon::prelude::{ParallelIterator, ParallelSlice};
 
+use super::memory::Allocation;
+use super::paging::PagedMemory;
 use super::texture::TextureImpl;
 
 pub struct EventImpl {
@@ -50,95 +56,167 @@ pub struct BufferImpl {
     pub size: usize,
     pub align: usize,
     pub ty: u64,
+    _memory: Allocation,
 }
-#[repr(C)]
+// Bindless slots are a single table of defs::BindlessSlot, which maps to zero-filled memory as
+// all slots start out empty, and is read by the kernels without locking: updates are stream
+// commands, so they never overlap with the dispatches that read the table.
 pub struct BindlessArrayImpl {
-    pub buffers: Vec<defs::BufferView>,
-    pub tex2ds: Vec<defs::Texture>,
-    pub tex3ds: Vec<defs::Texture>,
+    slots: *mut defs::BindlessSlot,
+    slots_count: usize,
+    _memory: Allocation,
+    // the paged textures in the array by slot and dimension, marked as used on every dispatch
+    pub(crate) paged_textures: HashMap<(usize, u8), Arc<PagedMemory>>,
 }
+unsafe impl Send for BindlessArrayImpl {}
+unsafe impl Sync for BindlessArrayImpl {}
+
+// updates with fewer modifications than this are applied on the stream thread
+const PARALLEL_UPDATE_MIN_MODIFICATIONS: usize = 4096;
+const PARALLEL_UPDATE_CHUNK: usize = 1024;
 
 impl BindlessArrayImpl {
-    pub unsafe fn update(&mut self, modifications: &[BindlessArrayUpdateModification]) {
+    pub(super) fn new(size: usize) -> Self {
+        let memory = Allocation::new(
+            size * std::mem::size_of::<defs::BindlessSlot>(),
+            std::mem::align_of::<defs::BindlessSlot>(),
+        );
+        Self {
+            slots: memory.data as *mut defs::BindlessSlot,
+            slots_count: size,
+            _memory: memory,
+            paged_textures: HashMap::new(),
+        }
+    }
+    pub(crate) fn into_c_bindless_array(&self) -> defs::BindlessArray {
+        defs::BindlessArray {
+            slots: self.slots,
+            slots_count: self.slots_count,
+        }
+    }
+    // The frontend merges the modifications of a slot into one, so those of a command touch
+    // distinct slots and large commands are split into chunks that are applied in parallel.
+    // Commands from other producers may repeat slots, and are then applied in order instead.
+    pub unsafe fn update(
+        &mut self,
+        modifications: &[BindlessArrayUpdateModification],
+        pool: &rayon::ThreadPool,
+    ) {
+        self.track_paged_textures(modifications);
+        let slots = self.slots as usize;
+        let slots_count = self.slots_count;
+        let apply = |m: &BindlessArrayUpdateModification| {
+            assert!(
+                m.slot < slots_count,
+                "Bindless slot out of bounds: {} >= {}",
+                m.slot,
+                slots_count
+            );
+            Self::apply(&mut *(slots as *mut defs::BindlessSlot).add(m.slot), m);
+        };
+        if modifications.len() < PARALLEL_UPDATE_MIN_MODIFICATIONS
+            || !Self::distinct_slots(modifications, slots_count)
+        {
+            modifications.iter().for_each(apply);
+        } else {
+            pool.install(|| {
+                modifications
+                    .par_chunks(PARALLEL_UPDATE_CHUNK)
+                    .for_each(|chunk| chunk.iter().for_each(apply));
+            });
+        }
+    }
+    // whether the modifications touch distinct slots, all in bounds
+    fn distinct_slots(
+        modifications: &[BindlessArrayUpdateModification],
+        slots_count: usize,
+    ) -> bool {
+        let mut seen = vec![0u64; (slots_count + 63) / 64];
+        modifications.iter().all(|m| {
+            if m.slot >= slots_count {
+                return false;
+            }
+            let (word, bit) = (m.slot / 64, 1u64 << (m.slot % 64));
+            let fresh = seen[word] & bit == 0;
+            seen[word] |= bit;
+            fresh
+        })
+    }
+    unsafe fn apply(slot: &mut defs::BindlessSlot, m: &BindlessArrayUpdateModification) {
+        match m.buffer.op {
+            BindlessArrayUpdateOperation::None => {}
+            BindlessArrayUpdateOperation::Emplace => {
+                let buffer = &*(m.buffer.handle.0 as *mut BufferImpl);
+                slot.buffer = defs::BufferView {
+                    data: buffer.data.add(m.buffer.offset),
+                    size: buffer.size - m.buffer.offset,
+                    ty: buffer.ty,
+                };
+            }
+            BindlessArrayUpdateOperation::Remove => {
+                slot.buffer = defs::BufferView::default();
+            }
+        };
+        match m.tex2d.op {
+            BindlessArrayUpdateOperation::None => {}
+            BindlessArrayUpdateOperation::Emplace => {
+                let tex = &*(m.tex2d.handle.0 as *mut TextureImpl);
+                slot.texture2d = tex.into_c_texture(m.tex2d.sampler);
+            }
+            BindlessArrayUpdateOperation::Remove => {
+                slot.texture2d = defs::Texture::default();
+            }
+        };
+        match m.tex3d.op {
+            BindlessArrayUpdateOperation::None => {}
+            BindlessArrayUpdateOperation::Emplace => {
+                let tex = &*(m.tex3d.handle.0 as *mut TextureImpl);
+                slot.texture3d = tex.into_c_texture(m.tex3d.sampler);
+            }
+            BindlessArrayUpdateOperation::Remove => {
+                slot.texture3d = defs::Texture::default();
+            }
+        };
+    }
+    unsafe fn track_paged_textures(&mut self, modifications: &[BindlessArrayUpdateModification]) {
         for m in modifications {
-            let slot = m.slot;
-            match m.buffer.op {
-                BindlessArrayUpdateOperation::None => {}
-                BindlessArrayUpdateOperation::Emplace => {
-                    let buffer = &*(m.buffer.handle.0 as *mut BufferImpl);
-                    let view = &mut self.buffers[slot];
-                    view.data = buffer.data as *mut u8;
-                    view.size = buffer.size;
-                    view.data = view.data.add(m.buffer.offset);
-                    view.size -= m.buffer.offset;
-                    view.ty = buffer.ty;
-                    self.buffers[slot] = *view;
-                }
-                BindlessArrayUpdateOperation::Remove => {
-                    self.buffers[slot] = defs::BufferView::default();
-                }
-            };
-            match m.tex2d.op {
-                BindlessArrayUpdateOperation::None => {}
-                BindlessArrayUpdateOperation::Emplace => {
-                    let tex = &*(m.tex2d.handle.0 as *mut TextureImpl);
-                    self.tex2ds[slot] = defs::Texture {
-                        data: tex.data,
-                        width: tex.size[0],
-                        height: tex.size[1],
-                        depth: 1,
-                        storage: tex.storage as u8,
-                        dimension: 2,
-                        mip_levels: tex.mip_levels,
-                        pixel_stride_shift: tex.pixel_stride_shift.try_into().unwrap(),
-                        mip_offsets: tex.mip_offsets,
-                        sampler: m.tex2d.sampler.encode(),
-                    };
-                }
-                BindlessArrayUpdateOperation::Remove => {
-                    self.tex2ds[slot] = defs::Texture::default();
-                }
-            };
-            match m.tex3d.op {
-                BindlessArrayUpdateOperation::None => {}
-                BindlessArrayUpdateOperation::Emplace => {
-                    let tex = &*(m.tex3d.handle.0 as *mut TextureImpl);
-                    self.tex3ds[slot] = defs::Texture {
-                        data: tex.data,
-                        width: tex.size[0],
-                        height: tex.size[1],
-                        depth: tex.size[2],
-                        storage: tex.storage as u8,
-                        dimension: 3,
-                        mip_levels: tex.mip_levels,
-                        pixel_stride_shift: tex.pixel_stride_shift.try_into().unwrap(),
-                        mip_offsets: tex.mip_offsets,
-                        sampler: m.tex2d.sampler.encode(),
-                    };
+            for (update, dimension) in [(&m.tex2d, 2u8), (&m.tex3d, 3u8)] {
+                let paged = match update.op {
+                    BindlessArrayUpdateOperation::None => continue,
+                    BindlessArrayUpdateOperation::Emplace => {
+                        (*(update.handle.0 as *mut TextureImpl)).paged.as_ref()
+                    }
+                    BindlessArrayUpdateOperation::Remove => None,
+                };
+                match paged {
+                    Some(paged) => {
+                        self.paged_textures
+                            .insert((m.slot, dimension), paged.clone());
+                    }
+                    None if !self.paged_textures.is_empty() => {
+                        self.paged_textures.remove(&(m.slot, dimension));
+                    }
+                    None => {}
                 }
-                BindlessArrayUpdateOperation::Remove => {
-                    self.tex3ds[slot] = defs::Texture::default();
-                }
-            };
+            }
+        }
+    }
+    #[inline]
+    pub fn mark_used(&self) {
+        for paged in self.paged_textures.values() {
+            paged.mark_used();
         }
     }
 }
 impl BufferImpl {
     pub(super) fn new(size: usize, align: usize, ty: u64) -> Self {
-        let layout = Layout::from_size_align(size, align).unwrap();
-        let data = unsafe { std::alloc::alloc_zeroed(layout) };
+        let memory = Allocation::new(size, align);
         Self {
-            data,
+            data: memory.data,
             size,
             align,
             ty,
+            _memory: memory,
         }
     }
 }
-
-impl Drop for BufferImpl {
-    fn drop(&mut self) {
-        let layout = Layout::from_size_align(self.size, self.align).unwrap();
-        unsafe { std::alloc::dealloc(self.data, layout) };
-    }
-}
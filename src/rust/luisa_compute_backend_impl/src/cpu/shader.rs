@@ -1,17 +1,28 @@
 use crate::cpu::llvm::LLVM_PATH;
 use crate::panic_abort;
+use lazy_static::lazy_static;
+use luisa_compute_api_types::{self as api, PixelStorage};
 use luisa_compute_cpu_kernel_defs as defs;
 use luisa_compute_cpu_kernel_defs::KernelFnArgs;
+use parking_lot::{Condvar, Mutex};
 use std::{
+    collections::HashMap,
     env::{self, current_exe},
+    fmt::Write as _,
     fs::{canonicalize, File},
     io::Write,
     mem::transmute,
     path::PathBuf,
     process::{Command, Stdio},
+    sync::{
+        atomic::{AtomicBool, Ordering},
+        Arc,
+    },
 };
 
+use super::codegen::{cpp::pixel_storage_name, sha256};
 use super::llvm;
+use super::texture::TextureImpl;
 fn canonicalize_and_fix_windows_path(path: PathBuf) -> std::io::Result<PathBuf> {
     let path = canonicalize(path)?;
     let mut s: String = path.to_str().unwrap().into();
@@ -28,7 +39,8 @@ fn canonicalize_and_fix_windows_path(path: PathBuf) -> std::io::Result<PathBuf>
 //     file.unlock().unwrap();
 //     ret
 // }
-pub(super) fn clang_args() -> Vec<&'static str> {
+// fast math selects the single-precision tier of cpu_math.h
+pub(super) fn clang_args(fast_math: bool) -> Vec<&'static str> {
     let mut args = vec![];
     match env::var("LUISA_DEBUG") {
         Ok(s) => {
@@ -57,7 +69,10 @@ pub(super) fn clang_args() -> Vec<&'static str> {
     } else {
         panic_abort!("unsupported target architecture");
     }
-    args.push("-ffast-math");
+    if fast_math {
+        args.push("-ffast-math");
+        args.push("-DLUISA_FAST_MATH");
+    }
     args.push("-fno-rtti");
     args.push("-fno-exceptions");
     args.push("-fno-stack-protector");
@@ -66,6 +81,7 @@ pub(super) fn clang_args() -> Vec<&'static str> {
 pub(super) fn compile(
     target: &String,
     source: &String,
+    fast_math: bool,
     force_recompile: bool,
 ) -> std::io::Result<PathBuf> {
     let self_path = current_exe().map_err(|e| {
@@ -90,8 +106,10 @@ pub(super) fn compile(
     let lib_path = PathBuf::from(format!("{}/{}", build_dir.display(), target_lib));
     if lib_path.exists() && !force_recompile {
         log::info!("Loading cached LLVM IR {}", &target_lib[1..17]);
+        crate::compile_cache("disk", true);
         return Ok(lib_path);
     }
+    crate::compile_cache("disk", false);
     let dump_src = match env::var("LUISA_DUMP_SOURCE") {
         Ok(s) => s == "1",
         Err(_) => false,
@@ -108,7 +126,7 @@ pub(super) fn compile(
     };
     // log::info!("compiling kernel {}", source_file);
     {
-        let mut args: Vec<&str> = clang_args();
+        let mut args: Vec<&str> = clang_args(fast_math);
         args.push("-c");
         args.push("-emit-llvm");
         args.push("-x");
@@ -138,6 +156,7 @@ pub(super) fn compile(
                         "LLVM IR generated in {:.3}ms",
                         (std::time::Instant::now() - tic).as_secs_f64() * 1e3
                     );
+                    crate::compile_phase("clang", tic);
                 }
                 false => {
                     eprintln!(
@@ -155,6 +174,63 @@ pub(super) fn compile(
 
 pub(crate) type KernelFn = unsafe extern "C" fn(*const KernelFnArgs);
 
+// storages of the texture arguments of a dispatch, by argument index
+type TextureArgStorages = Vec<(usize, PixelStorage)>;
+
+// a kernel that keeps adding storage combinations stays on the generic entry past this
+const MAX_TEXTURE_SPECIALIZATIONS: usize = 8;
+
+lazy_static! {
+    // Background compiles of texture specializations share a small pool, so that
+    // they neither pile up threads nor take the kernel workers of the device.
+    static ref SPECIALIZATION_POOL: rayon::ThreadPool = rayon::ThreadPoolBuilder::new()
+        .num_threads(2)
+        .thread_name(|i| format!("lc-cpu-specialize-{}", i))
+        .build()
+        .unwrap();
+}
+
+// Variants of a kernel with texture arguments, compiled with the storages of the arguments
+// defined as LC_TEXTURE_ARG_STORAGE_<index> so that texel accesses become typed loads.
+// A variant is compiled in the background on first sight of its storages, and the generic
+// entry runs until it is ready.
+struct TextureSpecializations {
+    source: String,
+    fast_math: bool,
+    variants: Mutex<HashMap<TextureArgStorages, Option<KernelFn>>>,
+    // compiles queued or running on the pool; the shader waits for them when dropped
+    pending: Mutex<usize>,
+    idle: Condvar,
+    // set when the shader is dropped, compiles that have not started yet are skipped
+    cancelled: AtomicBool,
+}
+
+impl TextureSpecializations {
+    fn wait_idle(&self) {
+        let mut pending = self.pending.lock();
+        while *pending != 0 {
+            self.idle.wait(&mut pending);
+        }
+    }
+    fn compile(&self, storages: &TextureArgStorages) -> Option<KernelFn> {
+        let mut source = String::new();
+        for (index, storage) in storages {
+            writeln!(
+                &mut source,
+                "#define LC_TEXTURE_ARG_STORAGE_{} {}",
+                index,
+                pixel_storage_name(*storage)
+            )
+            .unwrap();
+        }
+        source.push_str(&self.source);
+        let hash = sha256(&source);
+        let source = source.replace("##kernel_fn##", &hash);
+        let path = compile(&hash, &source, self.fast_math, false).ok()?;
+        llvm::compile_llvm_ir(&hash, &String::from(path.to_str().unwrap()))
+    }
+}
+
 pub(crate) struct ShaderImpl {
     // #[allow(dead_code)]
     // lib: libloading::Library,
@@ -165,6 +241,7 @@ pub(crate) struct ShaderImpl {
     pub(crate) custom_ops: Vec<defs::CpuCustomOp>,
     pub(crate) block_size: [u32; 3],
     pub(crate) messages: Vec<String>,
+    specializations: Option<Arc<TextureSpecializations>>,
 }
 impl ShaderImpl {
     pub(crate) fn new(
@@ -174,6 +251,8 @@ impl ShaderImpl {
         custom_ops: Vec<defs::CpuCustomOp>,
         block_size: [u32; 3],
         messages: &Vec<String>,
+        fast_math: bool,
+        specialization_source: Option<String>,
     ) -> Option<Self> {
         // unsafe {
         // let lib = libloading::Library::new(&path)
@@ -192,10 +271,75 @@ impl ShaderImpl {
             custom_ops,
             block_size,
             messages: messages.clone(),
+            specializations: specialization_source.map(|source| {
+                Arc::new(TextureSpecializations {
+                    source,
+                    fast_math,
+                    variants: Mutex::new(HashMap::new()),
+                    pending: Mutex::new(0),
+                    idle: Condvar::new(),
+                    cancelled: AtomicBool::new(false),
+                })
+            }),
         })
         // }
     }
-    pub(crate) fn fn_ptr(&self) -> KernelFn {
+    // the entry specialized on the storages of the texture arguments once it is compiled
+    pub(crate) unsafe fn fn_ptr_for(&self, args: &[api::Argument]) -> KernelFn {
+        let specializations = match &self.specializations {
+            Some(specializations) => specializations,
+            None => return self.entry,
+        };
+        let storages = args
+            .iter()
+            .enumerate()
+            .filter_map(|(i, arg)| match arg {
+                api::Argument::Texture(t) => {
+                    Some((i, (*(t.texture.0 as *const TextureImpl)).storage))
+                }
+                _ => None,
+            })
+            .collect::<TextureArgStorages>();
+        let mut variants = specializations.variants.lock();
+        if let Some(variant) = variants.get(&storages) {
+            return variant.unwrap_or(self.entry);
+        }
+        if variants.len() < MAX_TEXTURE_SPECIALIZATIONS {
+            variants.insert(storages.clone(), None);
+            *specializations.pending.lock() += 1;
+            let specializations = specializations.clone();
+            SPECIALIZATION_POOL.spawn(move || {
+                if !specializations.cancelled.load(Ordering::Relaxed) {
+                    let tic = std::time::Instant::now();
+                    let variant = specializations.compile(&storages);
+                    match variant {
+                        Some(_) => log::info!(
+                            "Kernel specialized on texture storages {:?} in {:.3}ms",
+                            storages,
+                            (std::time::Instant::now() - tic).as_secs_f64() * 1e3
+                        ),
+                        None => log::warn!(
+                            "Failed to specialize kernel on texture storages {:?}",
+                            storages
+                        ),
+                    }
+                    specializations.variants.lock().insert(storages, variant);
+                }
+                let mut pending = specializations.pending.lock();
+                *pending -= 1;
+                if *pending == 0 {
+                    specializations.idle.notify_all();
+                }
+            });
+        }
         self.entry
     }
 }
+impl Drop for ShaderImpl {
+    fn drop(&mut self) {
+        if let Some(specializations) = &self.specializations {
+            specializations.cancelled.store(true, Ordering::Relaxed);
+            specializations.wait_idle();
+        }
+    }
+}
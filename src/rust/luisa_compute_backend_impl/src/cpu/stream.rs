@@ -21,7 +21,7 @@ use std::{
 };
 
 use super::{
-    accel::{AccelImpl, GeometryImpl},
+    accel::{build_geometries, AccelImpl, GeometryBuild},
     resource::{BindlessArrayImpl, BufferImpl},
     shader::ShaderImpl,
     texture::TextureImpl,
@@ -231,7 +231,32 @@ impl StreamImpl {
             let bump = &mut staging_buffers.bump;
             let buffers = &mut staging_buffers.buffers;
             let mut cnt = 0;
+            // consecutive BLAS builds on distinct geometries are built together
+            let mut geometry_builds: Vec<GeometryBuild> = Vec::new();
+            let mut pending_geometries: HashSet<u64> = HashSet::new();
             for cmd in command_list {
+                let geometry_build = match cmd {
+                    api::Command::MeshBuild(cmd) => Some(GeometryBuild::Mesh(cmd)),
+                    api::Command::ProceduralPrimitiveBuild(cmd) => {
+                        Some(GeometryBuild::Procedural(cmd))
+                    }
+                    _ => None,
+                };
+                if let Some(build) = geometry_build {
+                    if !pending_geometries.insert(build.geometry()) {
+                        build_geometries(&self.shared_pool, &geometry_builds);
+                        geometry_builds.clear();
+                        pending_geometries.clear();
+                        pending_geometries.insert(build.geometry());
+                    }
+                    geometry_builds.push(build);
+                    continue;
+                }
+                if !geometry_builds.is_empty() {
+                    build_geometries(&self.shared_pool, &geometry_builds);
+                    geometry_builds.clear();
+                    pending_geometries.clear();
+                }
                 match cmd {
                     api::Command::BufferUpload(cmd) => {
                         let buffer = &*(cmd.buffer.0 as *mut BufferImpl);
@@ -333,6 +358,13 @@ impl StreamImpl {
                         if src_view.data == dst_view.data {
                             return;
                         }
+                        if src_view.texel_layout != dst_view.texel_layout
+                            || src_view.tile_shift != dst_view.tile_shift
+                            || src_view.data_size != dst_view.data_size
+                        {
+                            dst_view.copy_texels_from(&src_view);
+                            return;
+                        }
                         std::ptr::copy_nonoverlapping(
                             src_view.data,
                             dst_view.data,
@@ -351,7 +383,8 @@ impl StreamImpl {
                         ];
                         let block_count =
                             blocks[0] as usize * blocks[1] as usize * blocks[2] as usize;
-                        let kernel = shader.fn_ptr();
+                        let kernel =
+                            shader.fn_ptr_for(std::slice::from_raw_parts(cmd.args, cmd.args_count));
                         let mut args: Vec<defs::KernelFnArg> = Vec::new();
 
                         for i in 0..cmd.args_count {
@@ -375,11 +408,15 @@ impl StreamImpl {
                             custom_ops: shader.custom_ops.as_ptr(),
                             custom_ops_count: shader.custom_ops.len(),
                             internal_data: Arc::as_ptr(&ctx) as *const _ as *const _,
+                            texture_block_cache: std::ptr::null_mut(),
                         };
 
                         self.parallel_for(
                             move |i| {
                                 let mut args = kernel_args;
+                                // threads of a block run on the same worker and share its cache
+                                let mut texture_block_cache = defs::TextureBlockCache::default();
+                                args.texture_block_cache = &mut texture_block_cache;
                                 let block_z = i / (blocks[0] * blocks[1]) as usize;
                                 let block_y =
                                     (i % (blocks[0] * blocks[1]) as usize) / blocks[0] as usize;
@@ -411,14 +448,11 @@ impl StreamImpl {
                             block_count,
                         );
                     }
-                    api::Command::MeshBuild(mesh_build) => {
-                        let mesh = &mut *(mesh_build.mesh.0 as *mut GeometryImpl);
-                        mesh.build_mesh(mesh_build);
-                    }
                     api::Command::AccelBuild(accel_build) => {
                         let accel = &mut *(accel_build.accel.0 as *mut AccelImpl);
                         accel.update(
                             accel_build.instance_count as usize,
+                            accel_build.request,
                             std::slice::from_raw_parts(
                                 accel_build.modifications,
                                 accel_build.modifications_count,
@@ -428,17 +462,22 @@ impl StreamImpl {
                     }
                     api::Command::BindlessArrayUpdate(bindless_update) => {
                         let array = &mut *(bindless_update.handle.0 as *mut BindlessArrayImpl);
-                        array.update(std::slice::from_raw_parts(
-                            bindless_update.modifications,
-                            bindless_update.modifications_count,
-                        ));
+                        array.update(
+                            std::slice::from_raw_parts(
+                                bindless_update.modifications,
+                                bindless_update.modifications_count,
+                            ),
+                            &self.shared_pool,
+                        );
                     }
-                    api::Command::ProceduralPrimitiveBuild(mesh_build) => {
-                        let mesh = &mut *(mesh_build.handle.0 as *mut GeometryImpl);
-                        mesh.build_procedural(mesh_build);
+                    api::Command::MeshBuild(_) | api::Command::ProceduralPrimitiveBuild(_) => {
+                        unreachable!()
                     }
                 }
             }
+            if !geometry_builds.is_empty() {
+                build_geometries(&self.shared_pool, &geometry_builds);
+            }
             bump.reset();
             buffers.clear();
             self.ctx.staging_buffer_pool.push(staging_buffers);
@@ -463,6 +502,7 @@ pub unsafe fn convert_arg(arg: Argument) -> defs::KernelFnArg {
         api::Argument::Texture(t) => {
             let texture = &*(t.texture.0 as *mut TextureImpl);
             let level = t.level as usize;
+            texture.mark_used();
             defs::KernelFnArg::Texture(
                 texture.into_c_texture(Sampler {
                     address: api::SamplerAddress::Edge,
@@ -486,14 +526,8 @@ pub unsafe fn convert_arg(arg: Argument) -> defs::KernelFnArg {
         }
         api::Argument::BindlessArray(a) => {
             let a = &*(a.0 as *mut BindlessArrayImpl);
-            defs::KernelFnArg::BindlessArray(defs::BindlessArray {
-                buffers: a.buffers.as_ptr(),
-                buffers_count: a.buffers.len(),
-                texture2ds: a.tex2ds.as_ptr(),
-                texture2ds_count: a.tex2ds.len(),
-                texture3ds: a.tex3ds.as_ptr(),
-                texture3ds_count: a.tex3ds.len(),
-            })
+            a.mark_used();
+            defs::KernelFnArg::BindlessArray(a.into_c_bindless_array())
         }
     }
 }
@@ -521,6 +555,7 @@ pub unsafe fn convert_capture(c: Capture) -> defs::KernelFnArg {
         Binding::Texture(t) => {
             let texture = &*(t.handle as *mut TextureImpl);
             let level = t.level as usize;
+            texture.mark_used();
             defs::KernelFnArg::Texture(
                 texture.into_c_texture(Sampler {
                     address: api::SamplerAddress::Edge,
@@ -531,14 +566,8 @@ pub unsafe fn convert_capture(c: Capture) -> defs::KernelFnArg {
         }
         Binding::BindlessArray(a) => {
             let a = &*(a.handle as *mut BindlessArrayImpl);
-            defs::KernelFnArg::BindlessArray(defs::BindlessArray {
-                buffers: a.buffers.as_ptr(),
-                buffers_count: a.buffers.len(),
-                texture2ds: a.tex2ds.as_ptr(),
-                texture2ds_count: a.tex2ds.len(),
-                texture3ds: a.tex3ds.as_ptr(),
-                texture3ds_count: a.tex3ds.len(),
-            })
+            a.mark_used();
+            defs::KernelFnArg::BindlessArray(a.into_c_bindless_array())
         }
         Binding::Accel(accel) => {
             let accel = &*(accel.handle as *mut AccelImpl);
@@ -1,8 +1,110 @@
 use luisa_compute_api_types::PixelStorage;
 use parking_lot::RwLock;
 use rayon::prelude::{IntoParallelIterator, ParallelIterator};
+use std::sync::Arc;
+
+use super::memory::Allocation;
+use super::paging::PagedMemory;
 
 const BLOCK_SIZE: usize = 4;
+// Morton tiles are at most 128x128 texels in images and 32x32x32 in volumes
+const MAX_MORTON_TILE_SHIFT_2D: u32 = 7;
+const MAX_MORTON_TILE_SHIFT_3D: u32 = 5;
+
+/// Order of the texels of a non-compressed texture in memory, chosen at creation.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+#[repr(u8)]
+pub(crate) enum TextureLayout {
+    /// rows of texels, one slice after another
+    Linear = 0,
+    /// 4x4(x4) tiles of texels in row-major order
+    Tiled = 1,
+    /// Z-order curve within power-of-two tiles, the tiles in row-major order
+    Morton = 2,
+}
+impl TextureLayout {
+    // Images stay tiled and volumes are stored in Morton order, so that neighbours along z
+    // are as close as those along x. LUISA_CPU_TEXTURE_LAYOUT=linear|tiled|morton overrides.
+    pub(crate) fn for_texture(dimension: u8) -> Self {
+        match std::env::var("LUISA_CPU_TEXTURE_LAYOUT").as_deref() {
+            Ok("linear") => TextureLayout::Linear,
+            Ok("tiled") => TextureLayout::Tiled,
+            Ok("morton") => TextureLayout::Morton,
+            _ if dimension == 3 => TextureLayout::Morton,
+            _ => TextureLayout::Tiled,
+        }
+    }
+}
+
+// The Morton tiles of a level are no larger than its shortest side, so that small mip levels
+// are not padded to a whole tile of the top level.
+fn morton_level_tile_shift(tile_shift: u8, dimension: u8, size: [u32; 3]) -> u32 {
+    let shortest = if dimension == 2 {
+        size[0].min(size[1])
+    } else {
+        size[0].min(size[1]).min(size[2])
+    };
+    (tile_shift as u32).min(31 - shortest.leading_zeros())
+}
+
+// texels allocated for a level, including the padding to whole tiles
+fn level_texels(
+    texel_layout: TextureLayout,
+    tile_shift: u8,
+    dimension: u8,
+    size: [u32; 3],
+) -> usize {
+    let round_up = |x: u32, tile: usize| (x as usize + tile - 1) / tile * tile;
+    let tile = match texel_layout {
+        TextureLayout::Linear => 1,
+        TextureLayout::Tiled => BLOCK_SIZE,
+        TextureLayout::Morton => 1 << morton_level_tile_shift(tile_shift, dimension, size),
+    };
+    let depth = if dimension == 2 {
+        size[2] as usize
+    } else {
+        round_up(size[2], tile)
+    };
+    round_up(size[0], tile) * round_up(size[1], tile) * depth
+}
+
+// the largest tiles that waste at most 1/8 of the texture on padding
+fn choose_morton_tile_shift(dimension: u8, size: [u32; 3]) -> u8 {
+    let max_shift = if dimension == 2 {
+        MAX_MORTON_TILE_SHIFT_2D
+    } else {
+        MAX_MORTON_TILE_SHIFT_3D
+    };
+    let texels = level_texels(TextureLayout::Linear, 0, dimension, size);
+    for shift in (3..=max_shift as u8).rev() {
+        if level_texels(TextureLayout::Morton, shift, dimension, size) * 8 <= texels * 9 {
+            return shift;
+        }
+    }
+    2
+}
+
+#[inline]
+fn part1by1(x: u32) -> u32 {
+    let x = x & 0x0000ffff;
+    let x = (x | (x << 8)) & 0x00ff00ff;
+    let x = (x | (x << 4)) & 0x0f0f0f0f;
+    let x = (x | (x << 2)) & 0x33333333;
+    (x | (x << 1)) & 0x55555555
+}
+
+#[inline]
+fn part1by2(x: u32) -> u32 {
+    let x = x & 0x000003ff;
+    let x = (x | (x << 16)) & 0x030000ff;
+    let x = (x | (x << 8)) & 0x0300f00f;
+    let x = (x | (x << 4)) & 0x030c30c3;
+    (x | (x << 2)) & 0x09249249
+}
+
+// Non-compressed textures are stored in the TextureLayout chosen at creation. Block-compressed
+// textures keep their 4x4 blocks in row-major order, one block per "pixel", and are decoded on
+// access by the kernels.
 pub struct TextureImpl {
     pub(crate) data: *mut u8,
     pub(crate) data_size: usize,
@@ -12,20 +114,18 @@ pub struct TextureImpl {
     pub(crate) mip_levels: u8,
     pub(crate) mip_offsets: [usize; 16],
     pub(crate) storage: PixelStorage,
-    layout: std::alloc::Layout,
+    pub(crate) texel_layout: TextureLayout,
+    // log2 of the side of the Morton tiles of the top level
+    pub(crate) tile_shift: u8,
+    // the memory of the texture unless it is paged to a file, see paging.rs
+    _memory: Option<Allocation>,
+    pub(crate) paged: Option<Arc<PagedMemory>>,
 }
 unsafe impl Send for TextureImpl {}
 unsafe impl Sync for TextureImpl {}
-impl Drop for TextureImpl {
-    fn drop(&mut self) {
-        unsafe {
-            std::alloc::dealloc(self.data, self.layout);
-        }
-    }
-}
 impl TextureImpl {
     pub(super) fn new(dimension: u8, size: [u32; 3], storage: PixelStorage,
-                      levels: u8, allow_simultaneous_access: bool) -> Self {
+                      levels: u8, allow_simultaneous_access: bool, texel_layout: TextureLayout) -> Self {
         let pixel_size = storage.size();
         let pixel_stride_shift = match pixel_size {
             1 => 0,
@@ -38,32 +138,43 @@ impl TextureImpl {
         if dimension == 2 {
             assert_eq!(size[2], 1);
         }
+        let block_compressed = storage.is_block_compressed();
+        let texel_layout = if block_compressed {
+            TextureLayout::Tiled
+        } else {
+            texel_layout
+        };
+        let tile_shift = match texel_layout {
+            TextureLayout::Morton => choose_morton_tile_shift(dimension, size),
+            _ => 0,
+        };
         let mut data_size = 0;
         let mut mip_offsets = [0; 16];
         for level in 0..levels {
             mip_offsets[level as usize] = data_size;
-            let blocks = [
-                (((size[0] as usize >> level).max(1)) + BLOCK_SIZE - 1) / BLOCK_SIZE,
-                (((size[1] as usize >> level).max(1)) + BLOCK_SIZE - 1) / BLOCK_SIZE,
-                (((size[2] as usize >> level).max(1)) + BLOCK_SIZE - 1) / BLOCK_SIZE,
+            let level_size = [
+                (size[0] >> level).max(1),
+                (size[1] >> level).max(1),
+                (size[2] >> level).max(1),
             ];
-            data_size += if dimension == 2 {
-                blocks[0] * blocks[1] * blocks[2] * BLOCK_SIZE * BLOCK_SIZE * pixel_size
-            } else {
-                blocks[0]
-                    * blocks[1]
-                    * blocks[2]
-                    * BLOCK_SIZE
-                    * BLOCK_SIZE
-                    * BLOCK_SIZE
-                    * pixel_size
-            };
+            if block_compressed {
+                data_size += ((level_size[0] as usize + BLOCK_SIZE - 1) / BLOCK_SIZE)
+                    * ((level_size[1] as usize + BLOCK_SIZE - 1) / BLOCK_SIZE)
+                    * level_size[2] as usize
+                    * pixel_size;
+                continue;
+            }
+            data_size += level_texels(texel_layout, tile_shift, dimension, level_size) * pixel_size;
         }
         for level in levels..16 {
             mip_offsets[level as usize] = data_size;
         }
-        let layout = std::alloc::Layout::from_size_align(data_size, 16).unwrap();
-        let data = unsafe { std::alloc::alloc(layout) };
+        let paged = PagedMemory::allocate(data_size);
+        let memory = paged.is_none().then(|| Allocation::new(data_size, 16));
+        let data = match &paged {
+            Some(paged) => paged.data,
+            None => memory.as_ref().unwrap().data,
+        };
         Self {
             data,
             data_size,
@@ -73,7 +184,17 @@ impl TextureImpl {
             mip_levels: levels,
             mip_offsets,
             storage,
-            layout,
+            texel_layout,
+            tile_shift,
+            _memory: memory,
+            paged,
+        }
+    }
+    // keeps a paged texture resident in preference to those not used recently
+    #[inline]
+    pub(crate) fn mark_used(&self) {
+        if let Some(paged) = &self.paged {
+            paged.mark_used();
         }
     }
     pub(crate) fn view(&self, level: u8) -> TextureView {
@@ -88,7 +209,16 @@ impl TextureImpl {
             TextureView {
                 data: self.data.add(offset) as *mut u8,
                 size,
+                dimension: self.dimension,
                 pixel_stride_shift: self.pixel_stride_shift,
+                block_compressed: self.storage.is_block_compressed(),
+                texel_layout: self.texel_layout,
+                tile_shift: match self.texel_layout {
+                    TextureLayout::Morton => {
+                        morton_level_tile_shift(self.tile_shift, self.dimension, size)
+                    }
+                    _ => 0,
+                },
                 data_size: if level == 15 {
                     self.data_size - offset
                 } else {
@@ -111,6 +241,8 @@ impl TextureImpl {
             dimension: self.dimension,
             mip_levels: self.mip_levels,
             pixel_stride_shift: self.pixel_stride_shift as u8,
+            layout: self.texel_layout as u8,
+            tile_shift: self.tile_shift,
             mip_offsets: self.mip_offsets,
         }
     }
@@ -119,48 +251,100 @@ impl TextureImpl {
 pub(crate) struct TextureView {
     pub(crate) data: *mut u8,
     pub(crate) size: [u32; 3],
+    pub(crate) dimension: u8,
     pub(crate) pixel_stride_shift: usize,
+    pub(crate) block_compressed: bool,
+    pub(crate) texel_layout: TextureLayout,
+    // log2 of the side of the Morton tiles of this level
+    pub(crate) tile_shift: u32,
     pub(crate) data_size: usize,
 }
 unsafe impl Send for TextureView {}
 unsafe impl Sync for TextureView {}
 impl TextureView {
     pub(crate) fn unpadded_data_size(&self) -> usize {
+        if self.block_compressed {
+            return ((self.size[0] as usize + BLOCK_SIZE - 1) / BLOCK_SIZE)
+                * ((self.size[1] as usize + BLOCK_SIZE - 1) / BLOCK_SIZE)
+                * self.size[2] as usize
+                * (1 << self.pixel_stride_shift);
+        }
         self.size[0] as usize
             * self.size[1] as usize
             * self.size[2] as usize
             * (1 << self.pixel_stride_shift)
     }
     #[inline]
+    fn pixel_index_2d(&self, x: u32, y: u32) -> usize {
+        match self.texel_layout {
+            TextureLayout::Linear => x as usize + y as usize * self.size[0] as usize,
+            TextureLayout::Tiled => {
+                let block_x = x / BLOCK_SIZE as u32;
+                let block_y = y / BLOCK_SIZE as u32;
+                let grid_width = (self.size[0] + BLOCK_SIZE as u32 - 1) / BLOCK_SIZE as u32;
+                let block_idx = block_x + block_y * grid_width;
+                let pixel_x = x % BLOCK_SIZE as u32;
+                let pixel_y = y % BLOCK_SIZE as u32;
+                (block_idx as usize) * BLOCK_SIZE * BLOCK_SIZE
+                    + (pixel_x + pixel_y * BLOCK_SIZE as u32) as usize
+            }
+            TextureLayout::Morton => {
+                let shift = self.tile_shift;
+                let mask = (1u32 << shift) - 1;
+                let grid_width = (self.size[0] + mask) >> shift;
+                let tile_idx = (x >> shift) as usize + (y >> shift) as usize * grid_width as usize;
+                (tile_idx << (2 * shift))
+                    + (part1by1(x & mask) | (part1by1(y & mask) << 1)) as usize
+            }
+        }
+    }
+    #[inline]
+    fn pixel_index_3d(&self, x: u32, y: u32, z: u32) -> usize {
+        match self.texel_layout {
+            TextureLayout::Linear => {
+                x as usize
+                    + (y as usize + z as usize * self.size[1] as usize) * self.size[0] as usize
+            }
+            TextureLayout::Tiled => {
+                let block_x = x / BLOCK_SIZE as u32;
+                let block_y = y / BLOCK_SIZE as u32;
+                let block_z = z / BLOCK_SIZE as u32;
+                let grid_width = (self.size[0] + BLOCK_SIZE as u32 - 1) / BLOCK_SIZE as u32;
+                let grid_height = (self.size[1] + BLOCK_SIZE as u32 - 1) / BLOCK_SIZE as u32;
+                let block_idx = block_x as usize
+                    + (block_y as usize + block_z as usize * grid_height as usize)
+                        * grid_width as usize;
+                let pixel_x = x % BLOCK_SIZE as u32;
+                let pixel_y = y % BLOCK_SIZE as u32;
+                let pixel_z = z % BLOCK_SIZE as u32;
+                block_idx * BLOCK_SIZE * BLOCK_SIZE * BLOCK_SIZE
+                    + (pixel_x
+                        + pixel_y * BLOCK_SIZE as u32
+                        + pixel_z * BLOCK_SIZE as u32 * BLOCK_SIZE as u32)
+                        as usize
+            }
+            TextureLayout::Morton => {
+                let shift = self.tile_shift;
+                let mask = (1u32 << shift) - 1;
+                let grid_width = ((self.size[0] + mask) >> shift) as usize;
+                let grid_height = ((self.size[1] + mask) >> shift) as usize;
+                let tile_idx = (x >> shift) as usize
+                    + ((y >> shift) as usize + (z >> shift) as usize * grid_height) * grid_width;
+                (tile_idx << (3 * shift))
+                    + (part1by2(x & mask) | (part1by2(y & mask) << 1) | (part1by2(z & mask) << 2))
+                        as usize
+            }
+        }
+    }
+    #[inline]
     pub(crate) fn get_pixel_2d(&self, x: u32, y: u32) -> *mut u8 {
-        let block_x = x / BLOCK_SIZE as u32;
-        let block_y = y / BLOCK_SIZE as u32;
-        let grid_width = (self.size[0] + BLOCK_SIZE as u32 - 1) / BLOCK_SIZE as u32;
-        let block_idx = block_x + block_y * grid_width;
-        let pixel_x = x % BLOCK_SIZE as u32;
-        let pixel_y = y % BLOCK_SIZE as u32;
-        let pixel_idx =
-            block_idx * (BLOCK_SIZE * BLOCK_SIZE) as u32 + pixel_x + pixel_y * BLOCK_SIZE as u32;
-        let i = (pixel_idx as usize) << self.pixel_stride_shift;
+        let i = self.pixel_index_2d(x, y) << self.pixel_stride_shift;
         assert!(i <= self.data_size);
         unsafe { self.data.add(i) }
     }
     #[inline]
     pub(crate) fn get_pixel_3d(&self, x: u32, y: u32, z: u32) -> *mut u8 {
-        let block_x = x / BLOCK_SIZE as u32;
-        let block_y = y / BLOCK_SIZE as u32;
-        let block_z = z / BLOCK_SIZE as u32;
-        let grid_width = (self.size[0] + BLOCK_SIZE as u32 - 1) / BLOCK_SIZE as u32;
-        let grid_height = (self.size[1] + BLOCK_SIZE as u32 - 1) / BLOCK_SIZE as u32;
-        let block_idx = block_x + block_y * grid_width + block_z * grid_width * grid_height;
-        let pixel_x = x % BLOCK_SIZE as u32;
-        let pixel_y = y % BLOCK_SIZE as u32;
-        let pixel_z = z % BLOCK_SIZE as u32;
-        let pixel_idx = block_idx * (BLOCK_SIZE * BLOCK_SIZE * BLOCK_SIZE) as u32
-            + pixel_x
-            + pixel_y * BLOCK_SIZE as u32
-            + pixel_z * BLOCK_SIZE as u32 * BLOCK_SIZE as u32;
-        let i = (pixel_idx as usize) << self.pixel_stride_shift;
+        let i = self.pixel_index_3d(x, y, z) << self.pixel_stride_shift;
         assert!(i <= self.data_size);
         unsafe { self.data.add(i) }
     }
@@ -189,6 +373,11 @@ impl TextureView {
     }
     #[inline]
     pub(crate) fn copy_from_2d(&self, mut data: *const u8) {
+        if self.block_compressed || self.texel_layout == TextureLayout::Linear {
+            // blocks and linear texels are stored in the same order as the host data
+            unsafe { std::ptr::copy_nonoverlapping(data, self.data, self.unpadded_data_size()) };
+            return;
+        }
         for y in 0..self.size[1] {
             for x in 0..self.size[0] {
                 let dst = self.get_pixel_2d(x, y);
@@ -201,6 +390,11 @@ impl TextureView {
     }
     #[inline]
     pub(crate) fn copy_from_3d(&self, mut data: *const u8) {
+        if self.block_compressed || self.texel_layout == TextureLayout::Linear {
+            // blocks and linear texels are stored in the same order as the host data
+            unsafe { std::ptr::copy_nonoverlapping(data, self.data, self.unpadded_data_size()) };
+            return;
+        }
         for z in 0..self.size[2] {
             for y in 0..self.size[1] {
                 for x in 0..self.size[0] {
@@ -215,6 +409,10 @@ impl TextureView {
     }
     #[inline]
     pub(crate) fn copy_to_2d(&self, mut data: *mut u8) {
+        if self.block_compressed || self.texel_layout == TextureLayout::Linear {
+            unsafe { std::ptr::copy_nonoverlapping(self.data, data, self.unpadded_data_size()) };
+            return;
+        }
         for y in 0..self.size[1] {
             for x in 0..self.size[0] {
                 let src = self.get_pixel_2d(x, y);
@@ -227,6 +425,10 @@ impl TextureView {
     }
     #[inline]
     pub(crate) fn copy_to_3d(&self, mut data: *mut u8) {
+        if self.block_compressed || self.texel_layout == TextureLayout::Linear {
+            unsafe { std::ptr::copy_nonoverlapping(self.data, data, self.unpadded_data_size()) };
+            return;
+        }
         for z in 0..self.size[2] {
             for y in 0..self.size[1] {
                 for x in 0..self.size[0] {
@@ -239,4 +441,21 @@ impl TextureView {
             }
         }
     }
+    // copies a level of the same size and storage stored in another layout
+    pub(crate) fn copy_texels_from(&self, src: &TextureView) {
+        assert_eq!(self.size, src.size);
+        assert!(!self.block_compressed && !src.block_compressed);
+        for z in 0..self.size[2] {
+            for y in 0..self.size[1] {
+                for x in 0..self.size[0] {
+                    let (s, d) = if self.dimension == 2 {
+                        (src.get_pixel_2d(x, y), self.get_pixel_2d(x, y))
+                    } else {
+                        (src.get_pixel_3d(x, y, z), self.get_pixel_3d(x, y, z))
+                    };
+                    unsafe { std::ptr::copy_nonoverlapping(s, d, 1 << self.pixel_stride_shift) };
+                }
+            }
+        }
+    }
 }
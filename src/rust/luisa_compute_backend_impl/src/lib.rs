@@ -15,6 +15,7 @@ use std::ffi::{c_char, c_void, CStr, CString};
 use std::panic::Location;
 use std::path::{Path, PathBuf};
 use std::process::{abort, exit};
+use std::sync::atomic::{AtomicPtr, Ordering};
 use std::sync::Arc;
 
 pub struct SwapChainForCpuContext {
@@ -154,6 +155,53 @@ extern "C" fn free_string(ptr: *mut c_char) {
 
 static INIT_LOGGER: std::sync::Once = std::sync::Once::new();
 
+// the frontend may set the callback while other threads compile shaders
+static COMPILE_EVENT_CALLBACK: AtomicPtr<c_void> = AtomicPtr::new(std::ptr::null_mut());
+
+extern "C" fn set_compile_event_callback(cb: unsafe extern "C" fn(api::CompileEvent)) {
+    COMPILE_EVENT_CALLBACK.store(cb as *mut c_void, Ordering::Release);
+}
+
+// Reports a shader compile event to the frontend, which records it into the
+// compile report being collected on the calling thread (if any).
+#[cfg(feature = "cpu")]
+fn compile_event(kind: api::CompileEventKind, name: &str, milliseconds: f64, value: u64) {
+    let cb = COMPILE_EVENT_CALLBACK.load(Ordering::Acquire);
+    if !cb.is_null() {
+        let cb: unsafe extern "C" fn(api::CompileEvent) = unsafe { std::mem::transmute(cb) };
+        let name = CString::new(name).unwrap();
+        unsafe {
+            cb(api::CompileEvent {
+                kind,
+                name: name.as_ptr(),
+                milliseconds,
+                value,
+            });
+        }
+    }
+}
+
+#[cfg(feature = "cpu")]
+pub(crate) fn compile_phase(name: &str, tic: std::time::Instant) {
+    let ms = (std::time::Instant::now() - tic).as_secs_f64() * 1e3;
+    compile_event(api::CompileEventKind::Phase, name, ms, 0);
+}
+
+#[cfg(feature = "cpu")]
+pub(crate) fn compile_counter(name: &str, value: u64) {
+    compile_event(api::CompileEventKind::Counter, name, 0.0, value);
+}
+
+#[cfg(feature = "cpu")]
+pub(crate) fn compile_cache(layer: &str, hit: bool) {
+    let kind = if hit {
+        api::CompileEventKind::CacheHit
+    } else {
+        api::CompileEventKind::CacheMiss
+    };
+    compile_event(kind, layer, 0.0, 0);
+}
+
 extern "C" fn set_logger_callback(cb: unsafe extern "C" fn(api::LoggerMessage)) {
     INIT_LOGGER.call_once(|| {
         init();
@@ -245,5 +293,6 @@ pub extern "C" fn luisa_compute_lib_interface() -> api::LibInterface {
         destroy_context,
         create_device,
         free_string,
+        set_compile_event_callback,
     }
 }
@@ -78,17 +78,25 @@ struct Texture {
     uint8_t dimension;
     uint8_t mip_levels;
     uint8_t pixel_stride_shift;
-    size_t mip_offsets[16];
+    /// texel order of non-compressed textures: 0 linear, 1 4x4(x4) tiles, 2 Morton tiles
+    uint8_t layout;
+    /// log2 of the side of the Morton tiles of the top level
+    uint8_t tile_shift;
     uint8_t sampler;
+    size_t mip_offsets[16];
+};
+
+/// The resources bound to one index of a bindless array, kept together so that a lookup
+/// touches a single region of the table. All-zero bytes form an empty slot.
+struct BindlessSlot {
+    BufferView buffer;
+    Texture texture2d;
+    Texture texture3d;
 };
 
 struct BindlessArray {
-    const BufferView *buffers;
-    size_t buffers_count;
-    const Texture *texture2ds;
-    size_t texture2ds_count;
-    const Texture *texture3ds;
-    size_t texture3ds_count;
+    const BindlessSlot *slots;
+    size_t slots_count;
 };
 
 struct KernelFnArg {
@@ -137,6 +145,17 @@ struct CpuCustomOp {
     void (*func)(uint8_t*, uint8_t*);
 };
 
+/// Recently decoded blocks of block-compressed textures, private to a worker.
+struct TextureBlockCacheEntry {
+    const uint8_t *block;
+    float texels[16][4];
+};
+
+struct TextureBlockCache {
+    TextureBlockCacheEntry entries[4];
+    uint32_t next;
+};
+
 struct KernelFnArgs {
     const KernelFnArg *captured;
     size_t captured_count;
@@ -149,4 +168,5 @@ struct KernelFnArgs {
     const CpuCustomOp *custom_ops;
     size_t custom_ops_count;
     const void *internal_data;
+    TextureBlockCache *texture_block_cache;
 };
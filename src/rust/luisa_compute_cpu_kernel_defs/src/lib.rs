@@ -14,6 +14,7 @@ pub struct KernelFnArgs {
     pub custom_ops: *const CpuCustomOp,
     pub custom_ops_count: usize,
     pub internal_data: *const c_void,
+    pub texture_block_cache: *mut TextureBlockCache,
 }
 #[repr(C)]
 pub struct CpuCustomOp {
@@ -140,12 +141,8 @@ pub struct RayQuery {
 #[repr(C)]
 #[derive(Copy, Clone)]
 pub struct BindlessArray {
-    pub buffers: *const BufferView,
-    pub buffers_count: usize,
-    pub texture2ds: *const Texture,
-    pub texture2ds_count: usize,
-    pub texture3ds: *const Texture,
-    pub texture3ds_count: usize,
+    pub slots: *const BindlessSlot,
+    pub slots_count: usize,
 }
 
 #[derive(Clone, Copy)]
@@ -159,8 +156,12 @@ pub struct Texture {
     pub dimension: u8,
     pub mip_levels: u8,
     pub pixel_stride_shift: u8,
-    pub mip_offsets: [usize; 16],
+    /// texel order of non-compressed textures: 0 linear, 1 4x4(x4) tiles, 2 Morton tiles
+    pub layout: u8,
+    /// log2 of the side of the Morton tiles of the top level
+    pub tile_shift: u8,
     pub sampler: u8,
+    pub mip_offsets: [usize; 16],
 }
 impl Default for Texture {
     fn default() -> Self {
@@ -173,8 +174,42 @@ impl Default for Texture {
             dimension: 0,
             mip_levels: 0,
             pixel_stride_shift: 0,
-            mip_offsets: [0; 16],
+            layout: 0,
+            tile_shift: 0,
             sampler: 0,
+            mip_offsets: [0; 16],
+        }
+    }
+}
+/// The resources bound to one index of a bindless array, kept together so that a lookup
+/// touches a single region of the table. All-zero bytes form an empty slot.
+#[derive(Clone, Copy, Default)]
+#[repr(C)]
+pub struct BindlessSlot {
+    pub buffer: BufferView,
+    pub texture2d: Texture,
+    pub texture3d: Texture,
+}
+/// Recently decoded blocks of block-compressed textures, private to a worker.
+#[derive(Clone, Copy)]
+#[repr(C)]
+pub struct TextureBlockCacheEntry {
+    pub block: *const u8,
+    pub texels: [[f32; 4]; 16],
+}
+#[repr(C)]
+pub struct TextureBlockCache {
+    pub entries: [TextureBlockCacheEntry; 4],
+    pub next: u32,
+}
+impl Default for TextureBlockCache {
+    fn default() -> Self {
+        Self {
+            entries: [TextureBlockCacheEntry {
+                block: std::ptr::null(),
+                texels: [[0.0; 4]; 16],
+            }; 4],
+            next: 0,
         }
     }
 }
@@ -0,0 +1,502 @@
+//! Compact, versioned binary encoding of [`SerializedKernelModule`].
+//!
+//! Layout (all fixed-width fields are little-endian):
+//!
+//! ```text
+//! header (88 bytes):
+//!   magic: [u8; 4] = b"LCIR"
+//!   version: u32
+//!   type_count, node_count, block_count, reserved: u32 x 4
+//!   section offsets: u64 x 8
+//!     type_index, type_data, node_index, node_data,
+//!     block_index, block_data, module_data, end
+//! index sections: (count + 1) x u32 record offsets, relative to the data section
+//! data sections: bincode (varint) encoded records
+//! ```
+//!
+//! The types, nodes and blocks are stored as individually decodable records
+//! addressed through the index sections, so a [`BinaryKernelModule`] can be
+//! opened directly on a borrowed (e.g. memory-mapped) byte slice and records
+//! decoded on demand without materializing the whole module. Node, block and
+//! type references inside records are varints, and the type table is shared
+//! (deduplicated) by all the nodes.
+
+use std::fmt::{Display, Formatter};
+
+use bincode::Options;
+use serde::{de::DeserializeOwned, Deserialize, Serialize};
+
+use super::{
+    SerializedBlock, SerializedBlockRef, SerializedCapture, SerializedKernelModule,
+    SerializedNode, SerializedNodeRef, SerializedType,
+};
+
+pub const BINARY_MAGIC: [u8; 4] = *b"LCIR";
+pub const BINARY_VERSION: u32 = 2;
+const HEADER_SIZE: usize = 88;
+
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub enum BinaryModuleError {
+    InvalidMagic,
+    UnsupportedVersion(u32),
+    Truncated,
+    Corrupted(String),
+}
+
+impl Display for BinaryModuleError {
+    fn fmt(&self, f: &mut Formatter<'_>) -> std::fmt::Result {
+        match self {
+            Self::InvalidMagic => write!(f, "invalid magic number"),
+            Self::UnsupportedVersion(v) => write!(
+                f,
+                "unsupported version {} (expected {})",
+                v, BINARY_VERSION
+            ),
+            Self::Truncated => write!(f, "unexpected end of data"),
+            Self::Corrupted(msg) => write!(f, "corrupted data: {}", msg),
+        }
+    }
+}
+
+impl std::error::Error for BinaryModuleError {}
+
+fn options() -> impl Options + Copy {
+    bincode::DefaultOptions::new()
+        .with_varint_encoding()
+        .with_little_endian()
+}
+
+#[derive(Serialize, Deserialize)]
+struct ModuleRecord {
+    entry: SerializedBlockRef,
+    captures: Vec<SerializedCapture>,
+    args: Vec<SerializedNodeRef>,
+    shared: Vec<SerializedNodeRef>,
+    block_size: [u32; 3],
+}
+
+fn write_records<T: Serialize>(records: &[T], index: &mut Vec<u8>, data: &mut Vec<u8>) {
+    let opts = options();
+    index.extend_from_slice(&0u32.to_le_bytes());
+    for r in records {
+        opts.serialize_into(&mut *data, r).unwrap();
+        let offset = u32::try_from(data.len()).expect("binary IR section exceeds 4GB");
+        index.extend_from_slice(&offset.to_le_bytes());
+    }
+}
+
+/// Encodes the module into the compact binary format.
+pub fn encode_kernel_module(m: &SerializedKernelModule) -> Vec<u8> {
+    let mut sections: [Vec<u8>; 7] = Default::default();
+    let [type_index, type_data, node_index, node_data, block_index, block_data, module_data] =
+        &mut sections;
+    write_records(&m.types, type_index, type_data);
+    write_records(&m.nodes, node_index, node_data);
+    write_records(&m.blocks, block_index, block_data);
+    let module = ModuleRecord {
+        entry: m.entry,
+        captures: m.captures.clone(),
+        args: m.args.clone(),
+        shared: m.shared.clone(),
+        block_size: m.block_size,
+    };
+    options().serialize_into(&mut *module_data, &module).unwrap();
+
+    let total = HEADER_SIZE + sections.iter().map(|s| s.len()).sum::<usize>();
+    let mut out = Vec::with_capacity(total);
+    out.extend_from_slice(&BINARY_MAGIC);
+    out.extend_from_slice(&BINARY_VERSION.to_le_bytes());
+    for count in [m.types.len(), m.nodes.len(), m.blocks.len(), 0] {
+        out.extend_from_slice(&(count as u32).to_le_bytes());
+    }
+    let mut offset = HEADER_SIZE as u64;
+    for s in &sections {
+        out.extend_from_slice(&offset.to_le_bytes());
+        offset += s.len() as u64;
+    }
+    out.extend_from_slice(&offset.to_le_bytes());
+    debug_assert_eq!(out.len(), HEADER_SIZE);
+    for s in &sections {
+        out.extend_from_slice(s);
+    }
+    out
+}
+
+fn read_u32(bytes: &[u8], offset: usize) -> Result<u32, BinaryModuleError> {
+    bytes
+        .get(offset..offset + 4)
+        .map(|b| u32::from_le_bytes(b.try_into().unwrap()))
+        .ok_or(BinaryModuleError::Truncated)
+}
+
+fn read_u64(bytes: &[u8], offset: usize) -> Result<u64, BinaryModuleError> {
+    bytes
+        .get(offset..offset + 8)
+        .map(|b| u64::from_le_bytes(b.try_into().unwrap()))
+        .ok_or(BinaryModuleError::Truncated)
+}
+
+/// A table of individually encoded records, borrowed from the underlying bytes.
+#[derive(Clone, Copy)]
+struct RecordTable<'a> {
+    index: &'a [u8],
+    data: &'a [u8],
+    count: usize,
+}
+
+impl<'a> RecordTable<'a> {
+    fn new(index: &'a [u8], data: &'a [u8], count: usize) -> Result<Self, BinaryModuleError> {
+        if index.len() != (count + 1) * 4 {
+            return Err(BinaryModuleError::Corrupted(format!(
+                "index section of {} bytes for {} records",
+                index.len(),
+                count
+            )));
+        }
+        let table = Self { index, data, count };
+        if read_u32(index, count * 4)? as usize != data.len() {
+            return Err(BinaryModuleError::Corrupted(
+                "record offsets do not cover the data section".to_string(),
+            ));
+        }
+        Ok(table)
+    }
+    fn raw(&self, i: usize) -> Result<&'a [u8], BinaryModuleError> {
+        if i >= self.count {
+            return Err(BinaryModuleError::Corrupted(format!(
+                "record {} out of bounds ({})",
+                i, self.count
+            )));
+        }
+        let begin = read_u32(self.index, i * 4)? as usize;
+        let end = read_u32(self.index, (i + 1) * 4)? as usize;
+        self.data
+            .get(begin..end)
+            .ok_or(BinaryModuleError::Truncated)
+    }
+    fn get<T: DeserializeOwned>(&self, i: usize) -> Result<T, BinaryModuleError> {
+        let raw = self.raw(i)?;
+        options()
+            .deserialize(raw)
+            .map_err(|e| BinaryModuleError::Corrupted(e.to_string()))
+    }
+    fn all<T: DeserializeOwned>(&self) -> Result<Vec<T>, BinaryModuleError> {
+        (0..self.count).map(|i| self.get(i)).collect()
+    }
+}
+
+/// A read-only view of a binary encoded kernel module.
+///
+/// Only the header and the module record are decoded on construction;
+/// types, nodes and blocks are decoded lazily from the borrowed bytes.
+pub struct BinaryKernelModule<'a> {
+    types: RecordTable<'a>,
+    nodes: RecordTable<'a>,
+    blocks: RecordTable<'a>,
+    module: ModuleRecord,
+}
+
+impl<'a> BinaryKernelModule<'a> {
+    pub fn new(bytes: &'a [u8]) -> Result<Self, BinaryModuleError> {
+        if bytes.len() < HEADER_SIZE {
+            return Err(BinaryModuleError::Truncated);
+        }
+        if bytes[0..4] != BINARY_MAGIC {
+            return Err(BinaryModuleError::InvalidMagic);
+        }
+        let version = read_u32(bytes, 4)?;
+        if version != BINARY_VERSION {
+            return Err(BinaryModuleError::UnsupportedVersion(version));
+        }
+        let type_count = read_u32(bytes, 8)? as usize;
+        let node_count = read_u32(bytes, 12)? as usize;
+        let block_count = read_u32(bytes, 16)? as usize;
+        let mut offsets = [0usize; 8];
+        for (i, o) in offsets.iter_mut().enumerate() {
+            *o = read_u64(bytes, 24 + i * 8)? as usize;
+        }
+        if offsets[0] != HEADER_SIZE
+            || offsets.windows(2).any(|w| w[0] > w[1])
+            || offsets[7] > bytes.len()
+        {
+            return Err(BinaryModuleError::Corrupted(
+                "invalid section offsets".to_string(),
+            ));
+        }
+        let section = |i: usize| &bytes[offsets[i]..offsets[i + 1]];
+        let types = RecordTable::new(section(0), section(1), type_count)?;
+        let nodes = RecordTable::new(section(2), section(3), node_count)?;
+        let blocks = RecordTable::new(section(4), section(5), block_count)?;
+        let module: ModuleRecord = options()
+            .deserialize(section(6))
+            .map_err(|e| BinaryModuleError::Corrupted(e.to_string()))?;
+        Ok(Self {
+            types,
+            nodes,
+            blocks,
+            module,
+        })
+    }
+    pub fn type_count(&self) -> usize {
+        self.types.count
+    }
+    pub fn node_count(&self) -> usize {
+        self.nodes.count
+    }
+    pub fn block_count(&self) -> usize {
+        self.blocks.count
+    }
+    pub fn type_(&self, i: usize) -> Result<SerializedType, BinaryModuleError> {
+        self.types.get(i)
+    }
+    pub fn node(&self, i: usize) -> Result<SerializedNode, BinaryModuleError> {
+        self.nodes.get(i)
+    }
+    pub fn block(&self, i: usize) -> Result<SerializedBlock, BinaryModuleError> {
+        self.blocks.get(i)
+    }
+    pub fn entry(&self) -> SerializedBlockRef {
+        self.module.entry
+    }
+    pub fn captures(&self) -> &[SerializedCapture] {
+        &self.module.captures
+    }
+    pub fn args(&self) -> &[SerializedNodeRef] {
+        &self.module.args
+    }
+    pub fn shared(&self) -> &[SerializedNodeRef] {
+        &self.module.shared
+    }
+    pub fn block_size(&self) -> [u32; 3] {
+        self.module.block_size
+    }
+    /// Decodes the whole module.
+    pub fn decode(&self) -> Result<SerializedKernelModule, BinaryModuleError> {
+        Ok(SerializedKernelModule {
+            blocks: self.blocks.all()?,
+            nodes: self.nodes.all()?,
+            types: self.types.all()?,
+            entry: self.module.entry,
+            captures: self.module.captures.clone(),
+            args: self.module.args.clone(),
+            shared: self.module.shared.clone(),
+            block_size: self.module.block_size,
+        })
+    }
+}
+
+/// Decodes a module in the compact binary format.
+pub fn decode_kernel_module(bytes: &[u8]) -> Result<SerializedKernelModule, BinaryModuleError> {
+    BinaryKernelModule::new(bytes)?.decode()
+}
+
+#[cfg(test)]
+mod test {
+    use super::*;
+    use crate::ir::{
+        new_node, BufferBinding, Capture, Const, Func, Instruction, IrBuilder, KernelModule,
+        Module, ModuleKind, ModulePools, Node, Primitive, StructType, Type,
+    };
+    use crate::serialize::*;
+    use crate::{context, CArc, CBoxedSlice};
+    use sha2::{Digest, Sha256};
+
+    fn sample_module() -> SerializedKernelModule {
+        let t = |i| SerializedTypeRef(i);
+        let n = |i| SerializedNodeRef(i);
+        let b = |i| SerializedBlockRef(i);
+        let node = |ty, inst| SerializedNode { ty: t(ty), inst };
+        let types = vec![
+            SerializedType::Void,
+            SerializedType::Primitive(Primitive::Float32),
+            SerializedType::Vector(Primitive::Float32, 4),
+            SerializedType::Matrix(Primitive::Float32, 4),
+            SerializedType::Array(t(1), 16),
+            SerializedType::Struct {
+                fields: vec![t(2), t(1)],
+                align: 16,
+                size: 32,
+            },
+            SerializedType::Opqaue("LC_Buffer".to_string()),
+        ];
+        let nodes = vec![
+            node(6, SerializedInstruction::Buffer),
+            node(1, SerializedInstruction::Argument { by_value: true }),
+            node(1, SerializedInstruction::Const(SerializedConst::Float32(1.5))),
+            node(
+                4,
+                SerializedInstruction::Const(SerializedConst::Generic(vec![0u8; 64], t(4))),
+            ),
+            node(
+                1,
+                SerializedInstruction::Call(SerializedFunc::Add, vec![n(1), n(2)]),
+            ),
+            node(1, SerializedInstruction::Local { init: n(4) }),
+            node(
+                0,
+                SerializedInstruction::Call(SerializedFunc::BufferWrite, vec![n(0), n(2), n(5)]),
+            ),
+            node(0, SerializedInstruction::Break),
+            node(0, SerializedInstruction::Comment(b"hello".to_vec())),
+            node(
+                0,
+                SerializedInstruction::Switch {
+                    value: n(1),
+                    default: b(1),
+                    cases: vec![SerializedSwitchCase {
+                        value: -3,
+                        block: b(0),
+                    }],
+                },
+            ),
+        ];
+        let blocks = vec![
+            SerializedBlock {
+                nodes: vec![n(4), n(5), n(6)],
+            },
+            SerializedBlock {
+                nodes: vec![n(7), n(8)],
+            },
+            SerializedBlock { nodes: vec![n(9)] },
+        ];
+        SerializedKernelModule {
+            blocks,
+            nodes,
+            types,
+            entry: b(2),
+            captures: vec![SerializedCapture {
+                node: n(0),
+                binding: crate::ir::Binding::Buffer(BufferBinding {
+                    handle: 0xdeadbeef,
+                    offset: 16,
+                    size: 1024,
+                }),
+            }],
+            args: vec![n(1)],
+            shared: vec![],
+            block_size: [64, 1, 1],
+        }
+    }
+
+    #[test]
+    fn round_trip_matches_json() {
+        let m = sample_module();
+        let bytes = encode_kernel_module(&m);
+        let decoded = decode_kernel_module(&bytes).unwrap();
+        assert_eq!(
+            serde_json::to_value(&m).unwrap(),
+            serde_json::to_value(&decoded).unwrap()
+        );
+        // the binary form should be much smaller than the JSON form
+        let json = serde_json::to_string(&m).unwrap();
+        assert!(bytes.len() < json.len() / 2);
+    }
+
+    #[test]
+    fn lazy_record_access() {
+        let m = sample_module();
+        let bytes = encode_kernel_module(&m);
+        let view = BinaryKernelModule::new(&bytes).unwrap();
+        assert_eq!(view.node_count(), m.nodes.len());
+        assert_eq!(view.block_size(), [64, 1, 1]);
+        assert_eq!(
+            serde_json::to_value(view.node(3).unwrap()).unwrap(),
+            serde_json::to_value(&m.nodes[3]).unwrap()
+        );
+        assert!(view.node(m.nodes.len()).is_err());
+    }
+
+    #[test]
+    fn rejects_invalid_data() {
+        let bytes = encode_kernel_module(&sample_module());
+        assert_eq!(
+            BinaryKernelModule::new(&bytes[..HEADER_SIZE - 1]).err(),
+            Some(BinaryModuleError::Truncated)
+        );
+        let mut bad = bytes.clone();
+        bad[0] = b'X';
+        assert_eq!(
+            BinaryKernelModule::new(&bad).err(),
+            Some(BinaryModuleError::InvalidMagic)
+        );
+        let mut bad = bytes.clone();
+        bad[4] = 0xff;
+        assert!(matches!(
+            BinaryKernelModule::new(&bad).err(),
+            Some(BinaryModuleError::UnsupportedVersion(_))
+        ));
+        assert!(BinaryKernelModule::new(&bytes[..bytes.len() - 1]).is_err());
+    }
+
+    // a kernel that writes to a captured buffer in one branch and updates a local of a nested
+    // struct type in the other
+    fn sample_kernel() -> KernelModule {
+        let pools = CArc::new(ModulePools::new());
+        let f32_t = context::register_type(Type::Primitive(Primitive::Float32));
+        let bool_t = context::register_type(Type::Primitive(Primitive::Bool));
+        let struct_t = context::register_type(Type::Struct(StructType {
+            fields: CBoxedSlice::new(vec![Type::vector(Primitive::Float32, 3), f32_t.clone()]),
+            alignment: 16,
+            size: 16,
+        }));
+        let buffer = new_node(
+            &pools,
+            Node::new(CArc::new(Instruction::Buffer), f32_t.clone()),
+        );
+        let arg = new_node(
+            &pools,
+            Node::new(CArc::new(Instruction::Uniform), f32_t.clone()),
+        );
+        let mut builder = IrBuilder::new(pools.clone());
+        let one = builder.const_(Const::Float32(1.0));
+        let index = builder.const_(Const::Uint32(0));
+        let x = builder.call(Func::Add, &[arg, one], f32_t.clone());
+        let v = builder.local_zero_init(struct_t.clone());
+        let cond = builder.call(Func::Lt, &[x, one], bool_t);
+        let mut true_builder = IrBuilder::new(pools.clone());
+        true_builder.call(Func::BufferWrite, &[buffer, index, x], Type::void());
+        let true_branch = true_builder.finish();
+        let mut false_builder = IrBuilder::new(pools.clone());
+        let zero = false_builder.const_(Const::Zero(struct_t));
+        false_builder.update(v, zero);
+        let false_branch = false_builder.finish();
+        builder.if_(cond, true_branch, false_branch);
+        let entry = builder.finish();
+        KernelModule {
+            module: Module {
+                kind: ModuleKind::Kernel,
+                entry,
+                pools: pools.clone(),
+            },
+            captures: CBoxedSlice::new(vec![Capture {
+                node: buffer,
+                binding: crate::ir::Binding::Buffer(BufferBinding {
+                    handle: 1,
+                    offset: 0,
+                    size: 256,
+                }),
+            }]),
+            args: CBoxedSlice::new(vec![arg]),
+            shared: CBoxedSlice::new(vec![]),
+            cpu_custom_ops: CBoxedSlice::new(vec![]),
+            callables: CBoxedSlice::new(vec![]),
+            block_size: [32, 1, 1],
+            pools,
+        }
+    }
+
+    #[test]
+    fn kernel_module_round_trip() {
+        let m = sample_kernel();
+        let bytes = serialize_kernel_module_to_binary(&m);
+        let decoded = deserialize_kernel_module_from_binary(&bytes).unwrap();
+        assert_eq!(decoded.module.entry.len(), m.module.entry.len());
+        assert_eq!(decoded.block_size, m.block_size);
+        // the decoded module encodes to the same bytes
+        let decoded_bytes = serialize_kernel_module_to_binary(&decoded);
+        assert_eq!(
+            Sha256::digest(&bytes).as_slice(),
+            Sha256::digest(&decoded_bytes).as_slice()
+        );
+    }
+}
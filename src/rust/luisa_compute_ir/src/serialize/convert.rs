@@ -1,11 +1,12 @@
 use std::collections::HashMap;
 
 use crate::{
+    context,
     ir::{
-        BasicBlock, Capture, Const, Func, Instruction, KernelModule, Node, NodeRef, PhiIncoming,
-        SwitchCase, Type,
+        new_node, ArrayType, BasicBlock, Capture, Const, Func, Instruction, KernelModule, Module,
+        ModuleKind, ModulePools, Node, NodeRef, PhiIncoming, StructType, SwitchCase, Type,
     },
-    CArc, Pooled,
+    CArc, CBoxedSlice, Pooled,
 };
 
 use super::{
@@ -27,11 +28,11 @@ impl KernelSerializer {
     fn serialize_type_inner(&mut self, ty: &CArc<Type>) -> SerializedType {
         match ty.as_ref() {
             Type::Void => SerializedType::Void,
-            Type::UserData => SerializedType::Void,
+            Type::UserData => SerializedType::UserData,
             Type::Primitive(p) => SerializedType::Primitive(*p),
             Type::Vector(v) => SerializedType::Vector(v.element.as_primitive().unwrap(), v.length),
             Type::Matrix(v) => {
-                SerializedType::Vector(v.element.as_primitive().unwrap(), v.dimension)
+                SerializedType::Matrix(v.element.as_primitive().unwrap(), v.dimension)
             }
             Type::Struct(v) => {
                 let mut fields = vec![];
@@ -55,10 +56,11 @@ impl KernelSerializer {
         if let Some(id) = self.type_to_id.get(&ptr) {
             *id
         } else {
+            // reserve the slot first, the element and field types are pushed while serializing
             let id = self.types.len();
             self.type_to_id.insert(ptr, SerializedTypeRef(id as u64));
-            let inner = self.serialize_type_inner(ty);
-            self.types.push(inner);
+            self.types.push(SerializedType::Void);
+            self.types[id] = self.serialize_type_inner(ty);
             SerializedTypeRef(id as u64)
         }
     }
@@ -69,8 +71,8 @@ impl KernelSerializer {
         } else {
             let id = self.blocks.len();
             self.block_to_id.insert(ptr, SerializedBlockRef(id as u64));
-            let inner = self.serialize_block_inner(block.get());
-            self.blocks.push(inner);
+            self.blocks.push(SerializedBlock { nodes: vec![] });
+            self.blocks[id] = self.serialize_block_inner(block.get());
             SerializedBlockRef(id as u64)
         }
     }
@@ -78,7 +80,7 @@ impl KernelSerializer {
         let nodes = block
             .nodes()
             .iter()
-            .map(|n| self.serialize_node(n.get()))
+            .map(|n| self.serialize_noderef(*n))
             .collect::<Vec<_>>();
         SerializedBlock { nodes }
     }
@@ -100,8 +102,11 @@ impl KernelSerializer {
         } else {
             let id = self.nodes.len();
             self.node_to_id.insert(node, SerializedNodeRef(id as u64));
-            let inner = self.serialize_node(&node.get());
-            self.nodes.push(inner);
+            self.nodes.push(SerializedNode {
+                ty: SerializedTypeRef(0),
+                inst: SerializedInstruction::Invalid,
+            });
+            self.nodes[id] = self.serialize_node(&node.get());
             SerializedNodeRef(id as u64)
         }
     }
@@ -379,6 +384,27 @@ impl KernelSerializer {
             Func::Transpose => SerializedFunc::Transpose,
             Func::Inverse => SerializedFunc::Inverse,
             Func::SynchronizeBlock => SerializedFunc::SynchronizeBlock,
+            Func::WarpSize => SerializedFunc::WarpSize,
+            Func::WarpLaneId => SerializedFunc::WarpLaneId,
+            Func::WarpIsFirstActiveLane => SerializedFunc::WarpIsFirstActiveLane,
+            Func::WarpFirstActiveLane => SerializedFunc::WarpFirstActiveLane,
+            Func::WarpActiveAllEqual => SerializedFunc::WarpActiveAllEqual,
+            Func::WarpActiveBitAnd => SerializedFunc::WarpActiveBitAnd,
+            Func::WarpActiveBitOr => SerializedFunc::WarpActiveBitOr,
+            Func::WarpActiveBitXor => SerializedFunc::WarpActiveBitXor,
+            Func::WarpActiveCountBits => SerializedFunc::WarpActiveCountBits,
+            Func::WarpActiveMax => SerializedFunc::WarpActiveMax,
+            Func::WarpActiveMin => SerializedFunc::WarpActiveMin,
+            Func::WarpActiveProduct => SerializedFunc::WarpActiveProduct,
+            Func::WarpActiveSum => SerializedFunc::WarpActiveSum,
+            Func::WarpActiveAll => SerializedFunc::WarpActiveAll,
+            Func::WarpActiveAny => SerializedFunc::WarpActiveAny,
+            Func::WarpActiveBitMask => SerializedFunc::WarpActiveBitMask,
+            Func::WarpPrefixCountBits => SerializedFunc::WarpPrefixCountBits,
+            Func::WarpPrefixSum => SerializedFunc::WarpPrefixSum,
+            Func::WarpPrefixProduct => SerializedFunc::WarpPrefixProduct,
+            Func::WarpReadLaneAt => SerializedFunc::WarpReadLaneAt,
+            Func::WarpReadFirstLane => SerializedFunc::WarpReadFirstLane,
             Func::AtomicExchange => SerializedFunc::AtomicExchange,
             Func::AtomicCompareExchange => SerializedFunc::AtomicCompareExchange,
             Func::AtomicFetchAdd => SerializedFunc::AtomicFetchAdd,
@@ -484,3 +510,463 @@ pub fn serialize_kernel_module(m: &KernelModule) -> SerializedKernelModule {
         shared,
     }
 }
+
+struct KernelDeserializer<'a> {
+    m: &'a SerializedKernelModule,
+    pools: CArc<ModulePools>,
+    types: Vec<Option<CArc<Type>>>,
+    nodes: Vec<NodeRef>,
+    blocks: Vec<Pooled<BasicBlock>>,
+}
+
+impl<'a> KernelDeserializer<'a> {
+    fn type_(&mut self, r: SerializedTypeRef) -> Result<CArc<Type>, String> {
+        let i = r.0 as usize;
+        if i >= self.m.types.len() {
+            return Err(format!("type {} out of bounds ({})", i, self.m.types.len()));
+        }
+        if let Some(t) = &self.types[i] {
+            return Ok(t.clone());
+        }
+        let t = match &self.m.types[i] {
+            SerializedType::Void => Type::void(),
+            SerializedType::UserData => Type::userdata(),
+            SerializedType::Primitive(p) => context::register_type(Type::Primitive(*p)),
+            SerializedType::Vector(p, n) => Type::vector(*p, *n),
+            SerializedType::Matrix(p, n) => Type::matrix(*p, *n),
+            SerializedType::Array(e, n) => {
+                let element = self.type_(*e)?;
+                context::register_type(Type::Array(ArrayType {
+                    element,
+                    length: *n as usize,
+                }))
+            }
+            SerializedType::Struct {
+                fields,
+                align,
+                size,
+            } => {
+                let fields = fields
+                    .iter()
+                    .map(|f| self.type_(*f))
+                    .collect::<Result<Vec<_>, _>>()?;
+                context::register_type(Type::Struct(StructType {
+                    fields: CBoxedSlice::new(fields),
+                    alignment: *align as usize,
+                    size: *size as usize,
+                }))
+            }
+            SerializedType::Opqaue(name) => Type::opaque(name.clone()),
+        };
+        self.types[i] = Some(t.clone());
+        Ok(t)
+    }
+    fn node(&self, r: SerializedNodeRef) -> Result<NodeRef, String> {
+        self.nodes
+            .get(r.0 as usize)
+            .copied()
+            .ok_or_else(|| format!("node {} out of bounds ({})", r.0, self.nodes.len()))
+    }
+    fn nodes(&self, rs: &[SerializedNodeRef]) -> Result<CBoxedSlice<NodeRef>, String> {
+        let nodes = rs
+            .iter()
+            .map(|r| self.node(*r))
+            .collect::<Result<Vec<_>, _>>()?;
+        Ok(CBoxedSlice::new(nodes))
+    }
+    fn block(&self, r: SerializedBlockRef) -> Result<Pooled<BasicBlock>, String> {
+        self.blocks
+            .get(r.0 as usize)
+            .copied()
+            .ok_or_else(|| format!("block {} out of bounds ({})", r.0, self.blocks.len()))
+    }
+    fn const_(&mut self, c: &SerializedConst) -> Result<Const, String> {
+        Ok(match c {
+            SerializedConst::Zero(t) => Const::Zero(self.type_(*t)?),
+            SerializedConst::One(t) => Const::One(self.type_(*t)?),
+            SerializedConst::Bool(v) => Const::Bool(*v),
+            SerializedConst::Int32(v) => Const::Int32(*v),
+            SerializedConst::Uint32(v) => Const::Uint32(*v),
+            SerializedConst::Int64(v) => Const::Int64(*v),
+            SerializedConst::Uint64(v) => Const::Uint64(*v),
+            SerializedConst::Float32(v) => Const::Float32(*v),
+            SerializedConst::Float64(v) => Const::Float64(*v),
+            SerializedConst::Generic(v, t) => {
+                Const::Generic(CBoxedSlice::new(v.clone()), self.type_(*t)?)
+            }
+        })
+    }
+    fn instruction(&mut self, inst: &SerializedInstruction) -> Result<Instruction, String> {
+        Ok(match inst {
+            SerializedInstruction::Buffer => Instruction::Buffer,
+            SerializedInstruction::Bindless => Instruction::Bindless,
+            SerializedInstruction::Texture2D => Instruction::Texture2D,
+            SerializedInstruction::Texture3D => Instruction::Texture3D,
+            SerializedInstruction::Accel => Instruction::Accel,
+            SerializedInstruction::Shared => Instruction::Shared,
+            SerializedInstruction::Uniform => Instruction::Uniform,
+            SerializedInstruction::Local { init } => Instruction::Local {
+                init: self.node(*init)?,
+            },
+            SerializedInstruction::Argument { by_value } => Instruction::Argument {
+                by_value: *by_value,
+            },
+            SerializedInstruction::UserData => {
+                return Err("user data nodes cannot be deserialized".to_string());
+            }
+            SerializedInstruction::Invalid => Instruction::Invalid,
+            SerializedInstruction::Const(c) => Instruction::Const(self.const_(c)?),
+            SerializedInstruction::Update { var, value } => Instruction::Update {
+                var: self.node(*var)?,
+                value: self.node(*value)?,
+            },
+            SerializedInstruction::Call(f, args) => {
+                Instruction::Call(self.func(f)?, self.nodes(args)?)
+            }
+            SerializedInstruction::Phi(incomings) => {
+                let incomings = incomings
+                    .iter()
+                    .map(|i| {
+                        Ok(PhiIncoming {
+                            value: self.node(i.value)?,
+                            block: self.block(i.block)?,
+                        })
+                    })
+                    .collect::<Result<Vec<_>, String>>()?;
+                Instruction::Phi(CBoxedSlice::new(incomings))
+            }
+            SerializedInstruction::Return(v) => Instruction::Return(self.node(*v)?),
+            SerializedInstruction::Loop { body, cond } => Instruction::Loop {
+                body: self.block(*body)?,
+                cond: self.node(*cond)?,
+            },
+            SerializedInstruction::GenericLoop {
+                prepare,
+                cond,
+                body,
+                update,
+            } => Instruction::GenericLoop {
+                prepare: self.block(*prepare)?,
+                cond: self.node(*cond)?,
+                body: self.block(*body)?,
+                update: self.block(*update)?,
+            },
+            SerializedInstruction::Break => Instruction::Break,
+            SerializedInstruction::Continue => Instruction::Continue,
+            SerializedInstruction::If {
+                cond,
+                true_branch,
+                false_branch,
+            } => Instruction::If {
+                cond: self.node(*cond)?,
+                true_branch: self.block(*true_branch)?,
+                false_branch: self.block(*false_branch)?,
+            },
+            SerializedInstruction::Switch {
+                value,
+                default,
+                cases,
+            } => {
+                let cases = cases
+                    .iter()
+                    .map(|c| {
+                        Ok(SwitchCase {
+                            value: c.value,
+                            block: self.block(c.block)?,
+                        })
+                    })
+                    .collect::<Result<Vec<_>, String>>()?;
+                Instruction::Switch {
+                    value: self.node(*value)?,
+                    default: self.block(*default)?,
+                    cases: CBoxedSlice::new(cases),
+                }
+            }
+            SerializedInstruction::AdScope { body } => Instruction::AdScope {
+                body: self.block(*body)?,
+            },
+            SerializedInstruction::AdDetach(b) => Instruction::AdDetach(self.block(*b)?),
+            SerializedInstruction::RayQuery {
+                ray_query,
+                on_triangle_hit,
+                on_procedural_hit,
+            } => Instruction::RayQuery {
+                ray_query: self.node(*ray_query)?,
+                on_triangle_hit: self.block(*on_triangle_hit)?,
+                on_procedural_hit: self.block(*on_procedural_hit)?,
+            },
+            SerializedInstruction::Comment(s) => Instruction::Comment(CBoxedSlice::new(s.clone())),
+            SerializedInstruction::Assert(..) => {
+                return Err("assert instructions are not supported by the IR".to_string());
+            }
+        })
+    }
+    fn func(&mut self, func: &SerializedFunc) -> Result<Func, String> {
+        Ok(match func {
+            SerializedFunc::Unreachable(msg) => Func::Unreachable(CBoxedSlice::new(msg.clone())),
+            SerializedFunc::Assert(msg) => Func::Assert(CBoxedSlice::new(msg.clone())),
+            SerializedFunc::BindlessBufferSize(ty) => Func::BindlessBufferSize(self.type_(*ty)?),
+            SerializedFunc::Callable(_) => {
+                return Err("callables cannot be deserialized".to_string());
+            }
+            SerializedFunc::ZeroInitializer => Func::ZeroInitializer,
+            SerializedFunc::Assume => Func::Assume,
+            SerializedFunc::ThreadId => Func::ThreadId,
+            SerializedFunc::BlockId => Func::BlockId,
+            SerializedFunc::DispatchId => Func::DispatchId,
+            SerializedFunc::DispatchSize => Func::DispatchSize,
+            SerializedFunc::Backward => Func::Backward,
+            SerializedFunc::RequiresGradient => Func::RequiresGradient,
+            SerializedFunc::Gradient => Func::Gradient,
+            SerializedFunc::GradientMarker => Func::GradientMarker,
+            SerializedFunc::AccGrad => Func::AccGrad,
+            SerializedFunc::Detach => Func::Detach,
+            SerializedFunc::RayTracingInstanceTransform => Func::RayTracingInstanceTransform,
+            SerializedFunc::RayTracingSetInstanceTransform => Func::RayTracingSetInstanceTransform,
+            SerializedFunc::RayTracingSetInstanceOpacity => Func::RayTracingSetInstanceOpacity,
+            SerializedFunc::RayTracingSetInstanceVisibility => {
+                Func::RayTracingSetInstanceVisibility
+            }
+            SerializedFunc::RayTracingTraceClosest => Func::RayTracingTraceClosest,
+            SerializedFunc::RayTracingTraceAny => Func::RayTracingTraceAny,
+            SerializedFunc::RayTracingQueryAll => Func::RayTracingQueryAll,
+            SerializedFunc::RayTracingQueryAny => Func::RayTracingQueryAny,
+            SerializedFunc::RayQueryWorldSpaceRay => Func::RayQueryWorldSpaceRay,
+            SerializedFunc::RayQueryProceduralCandidateHit => Func::RayQueryProceduralCandidateHit,
+            SerializedFunc::RayQueryTriangleCandidateHit => Func::RayQueryTriangleCandidateHit,
+            SerializedFunc::RayQueryCommittedHit => Func::RayQueryCommittedHit,
+            SerializedFunc::RayQueryCommitTriangle => Func::RayQueryCommitTriangle,
+            SerializedFunc::RayQueryCommitProcedural => Func::RayQueryCommitProcedural,
+            SerializedFunc::RayQueryTerminate => Func::RayQueryTerminate,
+            SerializedFunc::RasterDiscard => Func::RasterDiscard,
+            SerializedFunc::IndirectClearDispatchBuffer => Func::IndirectClearDispatchBuffer,
+            SerializedFunc::IndirectEmplaceDispatchKernel => Func::IndirectEmplaceDispatchKernel,
+            SerializedFunc::Load => Func::Load,
+            SerializedFunc::Cast => Func::Cast,
+            SerializedFunc::Bitcast => Func::Bitcast,
+            SerializedFunc::Add => Func::Add,
+            SerializedFunc::Sub => Func::Sub,
+            SerializedFunc::Mul => Func::Mul,
+            SerializedFunc::Div => Func::Div,
+            SerializedFunc::Rem => Func::Rem,
+            SerializedFunc::BitAnd => Func::BitAnd,
+            SerializedFunc::BitOr => Func::BitOr,
+            SerializedFunc::BitXor => Func::BitXor,
+            SerializedFunc::Shl => Func::Shl,
+            SerializedFunc::Shr => Func::Shr,
+            SerializedFunc::RotRight => Func::RotRight,
+            SerializedFunc::RotLeft => Func::RotLeft,
+            SerializedFunc::Eq => Func::Eq,
+            SerializedFunc::Ne => Func::Ne,
+            SerializedFunc::Lt => Func::Lt,
+            SerializedFunc::Le => Func::Le,
+            SerializedFunc::Gt => Func::Gt,
+            SerializedFunc::Ge => Func::Ge,
+            SerializedFunc::MatCompMul => Func::MatCompMul,
+            SerializedFunc::Neg => Func::Neg,
+            SerializedFunc::Not => Func::Not,
+            SerializedFunc::BitNot => Func::BitNot,
+            SerializedFunc::All => Func::All,
+            SerializedFunc::Any => Func::Any,
+            SerializedFunc::Select => Func::Select,
+            SerializedFunc::Clamp => Func::Clamp,
+            SerializedFunc::Lerp => Func::Lerp,
+            SerializedFunc::Step => Func::Step,
+            SerializedFunc::Saturate => Func::Saturate,
+            SerializedFunc::Abs => Func::Abs,
+            SerializedFunc::Min => Func::Min,
+            SerializedFunc::Max => Func::Max,
+            SerializedFunc::ReduceSum => Func::ReduceSum,
+            SerializedFunc::ReduceProd => Func::ReduceProd,
+            SerializedFunc::ReduceMin => Func::ReduceMin,
+            SerializedFunc::ReduceMax => Func::ReduceMax,
+            SerializedFunc::Clz => Func::Clz,
+            SerializedFunc::Ctz => Func::Ctz,
+            SerializedFunc::PopCount => Func::PopCount,
+            SerializedFunc::Reverse => Func::Reverse,
+            SerializedFunc::IsInf => Func::IsInf,
+            SerializedFunc::IsNan => Func::IsNan,
+            SerializedFunc::Acos => Func::Acos,
+            SerializedFunc::Acosh => Func::Acosh,
+            SerializedFunc::Asin => Func::Asin,
+            SerializedFunc::Asinh => Func::Asinh,
+            SerializedFunc::Atan => Func::Atan,
+            SerializedFunc::Atan2 => Func::Atan2,
+            SerializedFunc::Atanh => Func::Atanh,
+            SerializedFunc::Cos => Func::Cos,
+            SerializedFunc::Cosh => Func::Cosh,
+            SerializedFunc::Sin => Func::Sin,
+            SerializedFunc::Sinh => Func::Sinh,
+            SerializedFunc::Tan => Func::Tan,
+            SerializedFunc::Tanh => Func::Tanh,
+            SerializedFunc::Exp => Func::Exp,
+            SerializedFunc::Exp2 => Func::Exp2,
+            SerializedFunc::Exp10 => Func::Exp10,
+            SerializedFunc::Log => Func::Log,
+            SerializedFunc::Log2 => Func::Log2,
+            SerializedFunc::Log10 => Func::Log10,
+            SerializedFunc::Powi => Func::Powi,
+            SerializedFunc::Powf => Func::Powf,
+            SerializedFunc::Sqrt => Func::Sqrt,
+            SerializedFunc::Rsqrt => Func::Rsqrt,
+            SerializedFunc::Ceil => Func::Ceil,
+            SerializedFunc::Floor => Func::Floor,
+            SerializedFunc::Fract => Func::Fract,
+            SerializedFunc::Trunc => Func::Trunc,
+            SerializedFunc::Round => Func::Round,
+            SerializedFunc::Fma => Func::Fma,
+            SerializedFunc::Copysign => Func::Copysign,
+            SerializedFunc::Cross => Func::Cross,
+            SerializedFunc::Dot => Func::Dot,
+            SerializedFunc::OuterProduct => Func::OuterProduct,
+            SerializedFunc::Length => Func::Length,
+            SerializedFunc::LengthSquared => Func::LengthSquared,
+            SerializedFunc::Normalize => Func::Normalize,
+            SerializedFunc::Faceforward => Func::Faceforward,
+            SerializedFunc::Reflect => Func::Reflect,
+            SerializedFunc::Determinant => Func::Determinant,
+            SerializedFunc::Transpose => Func::Transpose,
+            SerializedFunc::Inverse => Func::Inverse,
+            SerializedFunc::SynchronizeBlock => Func::SynchronizeBlock,
+            SerializedFunc::WarpSize => Func::WarpSize,
+            SerializedFunc::WarpLaneId => Func::WarpLaneId,
+            SerializedFunc::WarpIsFirstActiveLane => Func::WarpIsFirstActiveLane,
+            SerializedFunc::WarpFirstActiveLane => Func::WarpFirstActiveLane,
+            SerializedFunc::WarpActiveAllEqual => Func::WarpActiveAllEqual,
+            SerializedFunc::WarpActiveBitAnd => Func::WarpActiveBitAnd,
+            SerializedFunc::WarpActiveBitOr => Func::WarpActiveBitOr,
+            SerializedFunc::WarpActiveBitXor => Func::WarpActiveBitXor,
+            SerializedFunc::WarpActiveCountBits => Func::WarpActiveCountBits,
+            SerializedFunc::WarpActiveMax => Func::WarpActiveMax,
+            SerializedFunc::WarpActiveMin => Func::WarpActiveMin,
+            SerializedFunc::WarpActiveProduct => Func::WarpActiveProduct,
+            SerializedFunc::WarpActiveSum => Func::WarpActiveSum,
+            SerializedFunc::WarpActiveAll => Func::WarpActiveAll,
+            SerializedFunc::WarpActiveAny => Func::WarpActiveAny,
+            SerializedFunc::WarpActiveBitMask => Func::WarpActiveBitMask,
+            SerializedFunc::WarpPrefixCountBits => Func::WarpPrefixCountBits,
+            SerializedFunc::WarpPrefixSum => Func::WarpPrefixSum,
+            SerializedFunc::WarpPrefixProduct => Func::WarpPrefixProduct,
+            SerializedFunc::WarpReadLaneAt => Func::WarpReadLaneAt,
+            SerializedFunc::WarpReadFirstLane => Func::WarpReadFirstLane,
+            SerializedFunc::AtomicExchange => Func::AtomicExchange,
+            SerializedFunc::AtomicCompareExchange => Func::AtomicCompareExchange,
+            SerializedFunc::AtomicFetchAdd => Func::AtomicFetchAdd,
+            SerializedFunc::AtomicFetchSub => Func::AtomicFetchSub,
+            SerializedFunc::AtomicFetchAnd => Func::AtomicFetchAnd,
+            SerializedFunc::AtomicFetchOr => Func::AtomicFetchOr,
+            SerializedFunc::AtomicFetchXor => Func::AtomicFetchXor,
+            SerializedFunc::AtomicFetchMin => Func::AtomicFetchMin,
+            SerializedFunc::AtomicFetchMax => Func::AtomicFetchMax,
+            SerializedFunc::BufferRead => Func::BufferRead,
+            SerializedFunc::BufferWrite => Func::BufferWrite,
+            SerializedFunc::BufferSize => Func::BufferSize,
+            SerializedFunc::Texture2dRead => Func::Texture2dRead,
+            SerializedFunc::Texture2dWrite => Func::Texture2dWrite,
+            SerializedFunc::Texture3dRead => Func::Texture3dRead,
+            SerializedFunc::Texture3dWrite => Func::Texture3dWrite,
+            SerializedFunc::BindlessTexture2dSample => Func::BindlessTexture2dSample,
+            SerializedFunc::BindlessTexture2dSampleLevel => Func::BindlessTexture2dSampleLevel,
+            SerializedFunc::BindlessTexture2dSampleGrad => Func::BindlessTexture2dSampleGrad,
+            SerializedFunc::BindlessTexture2dSampleGradLevel => {
+                Func::BindlessTexture2dSampleGradLevel
+            }
+            SerializedFunc::BindlessTexture3dSample => Func::BindlessTexture3dSample,
+            SerializedFunc::BindlessTexture3dSampleLevel => Func::BindlessTexture3dSampleLevel,
+            SerializedFunc::BindlessTexture3dSampleGrad => Func::BindlessTexture3dSampleGrad,
+            SerializedFunc::BindlessTexture3dSampleGradLevel => {
+                Func::BindlessTexture3dSampleGradLevel
+            }
+            SerializedFunc::BindlessTexture2dRead => Func::BindlessTexture2dRead,
+            SerializedFunc::BindlessTexture3dRead => Func::BindlessTexture3dRead,
+            SerializedFunc::BindlessTexture2dReadLevel => Func::BindlessTexture2dReadLevel,
+            SerializedFunc::BindlessTexture3dReadLevel => Func::BindlessTexture3dReadLevel,
+            SerializedFunc::BindlessTexture2dSize => Func::BindlessTexture2dSize,
+            SerializedFunc::BindlessTexture3dSize => Func::BindlessTexture3dSize,
+            SerializedFunc::BindlessTexture2dSizeLevel => Func::BindlessTexture2dSizeLevel,
+            SerializedFunc::BindlessTexture3dSizeLevel => Func::BindlessTexture3dSizeLevel,
+            SerializedFunc::BindlessBufferRead => Func::BindlessBufferRead,
+            SerializedFunc::BindlessBufferType => Func::BindlessBufferType,
+            SerializedFunc::Vec => Func::Vec,
+            SerializedFunc::Vec2 => Func::Vec2,
+            SerializedFunc::Vec3 => Func::Vec3,
+            SerializedFunc::Vec4 => Func::Vec4,
+            SerializedFunc::Permute => Func::Permute,
+            SerializedFunc::InsertElement => Func::InsertElement,
+            SerializedFunc::ExtractElement => Func::ExtractElement,
+            SerializedFunc::GetElementPtr => Func::GetElementPtr,
+            SerializedFunc::Struct => Func::Struct,
+            SerializedFunc::Array => Func::Array,
+            SerializedFunc::Mat => Func::Mat,
+            SerializedFunc::Mat2 => Func::Mat2,
+            SerializedFunc::Mat3 => Func::Mat3,
+            SerializedFunc::Mat4 => Func::Mat4,
+        })
+    }
+}
+
+/// Rebuilds a kernel module from its serialized form, the inverse of [`serialize_kernel_module`].
+pub fn deserialize_kernel_module(m: &SerializedKernelModule) -> Result<KernelModule, String> {
+    let pools = CArc::new(ModulePools::new());
+    // all the nodes and blocks are created upfront, as instructions may refer to later ones
+    let nodes = (0..m.nodes.len())
+        .map(|_| {
+            new_node(
+                &pools,
+                Node::new(CArc::new(Instruction::Invalid), Type::void()),
+            )
+        })
+        .collect::<Vec<_>>();
+    let blocks = (0..m.blocks.len())
+        .map(|_| pools.bb_pool.alloc(BasicBlock::new(&pools)))
+        .collect::<Vec<_>>();
+    let mut d = KernelDeserializer {
+        m,
+        pools: pools.clone(),
+        types: vec![None; m.types.len()],
+        nodes,
+        blocks,
+    };
+    for (i, node) in m.nodes.iter().enumerate() {
+        let type_ = d.type_(node.ty)?;
+        let instruction = CArc::new(d.instruction(&node.inst)?);
+        d.nodes[i].update(|n| {
+            n.type_ = type_;
+            n.instruction = instruction;
+        });
+    }
+    for (block, serialized) in d.blocks.iter().zip(&m.blocks) {
+        for r in &serialized.nodes {
+            let node = d.node(*r)?;
+            if node.is_linked() {
+                return Err(format!("node {} appears in more than one block", r.0));
+            }
+            block.push(node);
+        }
+    }
+    let captures = m
+        .captures
+        .iter()
+        .map(|c| {
+            Ok(Capture {
+                node: d.node(c.node)?,
+                binding: c.binding,
+            })
+        })
+        .collect::<Result<Vec<_>, String>>()?;
+    let entry = d.block(m.entry)?;
+    Ok(KernelModule {
+        module: Module {
+            kind: ModuleKind::Kernel,
+            entry,
+            pools: d.pools.clone(),
+        },
+        captures: CBoxedSlice::new(captures),
+        args: d.nodes(&m.args)?,
+        shared: d.nodes(&m.shared)?,
+        cpu_custom_ops: CBoxedSlice::new(vec![]),
+        callables: CBoxedSlice::new(vec![]),
+        block_size: m.block_size,
+        pools: d.pools,
+    })
+}
@@ -1,3 +1,4 @@
+pub mod binary;
 pub mod convert;
 use crate::ir::{Binding, KernelModule, Primitive};
 use crate::CBoxedSlice;
@@ -35,7 +36,7 @@ pub struct SerializedBlockRef(pub u64);
 
 #[derive(Clone, Serialize, Deserialize)]
 pub struct SerializedBlock {
-    pub nodes: Vec<SerializedNode>,
+    pub nodes: Vec<SerializedNodeRef>,
 }
 #[derive(Copy, Clone, Serialize, Deserialize)]
 pub struct SerializedTypeRef(pub u64);
@@ -414,6 +415,29 @@ pub enum SerializedFunc {
     Mat4,
 
     Callable(SerializedCallableModuleRef),
+
+    // warp operations, appended to keep the binary encoding of older variants stable
+    WarpSize,
+    WarpLaneId,
+    WarpIsFirstActiveLane,
+    WarpFirstActiveLane,
+    WarpActiveAllEqual,
+    WarpActiveBitAnd,
+    WarpActiveBitOr,
+    WarpActiveBitXor,
+    WarpActiveCountBits,
+    WarpActiveMax,
+    WarpActiveMin,
+    WarpActiveProduct,
+    WarpActiveSum,
+    WarpActiveAll,
+    WarpActiveAny,
+    WarpActiveBitMask,
+    WarpPrefixCountBits,
+    WarpPrefixSum,
+    WarpPrefixProduct,
+    WarpReadLaneAt,
+    WarpReadFirstLane,
 }
 pub fn serialize_kernel_module_to_json(m: &KernelModule) -> serde_json::Value {
     let v = convert::serialize_kernel_module(m);
@@ -423,3 +447,13 @@ pub fn serialize_kernel_module_to_json_str(m: &KernelModule) -> String {
     let json = serialize_kernel_module_to_json(m);
     serde_json::to_string(&json).unwrap()
 }
+pub fn serialize_kernel_module_to_binary(m: &KernelModule) -> Vec<u8> {
+    let v = convert::serialize_kernel_module(m);
+    binary::encode_kernel_module(&v)
+}
+pub fn deserialize_kernel_module_from_binary(
+    bytes: &[u8],
+) -> Result<KernelModule, binary::BinaryModuleError> {
+    let v = binary::decode_kernel_module(bytes)?;
+    convert::deserialize_kernel_module(&v).map_err(binary::BinaryModuleError::Corrupted)
+}
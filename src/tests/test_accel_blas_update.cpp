@@ -0,0 +1,70 @@
+#include <luisa/core/logging.h>
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/runtime/rtx/accel.h>
+#include <luisa/dsl/syntax.h>
+#include <luisa/dsl/sugar.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+int main(int argc, char *argv[]) {
+
+    log_level_info();
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend>. <backend>: cuda, dx, cpu, metal", argv[0]);
+        exit(1);
+    }
+    Device device = context.create_device(argv[1]);
+    Stream stream = device.create_stream();
+
+    std::array vertices{make_float3(-0.5f, -0.5f, 0.f),
+                        make_float3(0.5f, -0.5f, 0.f),
+                        make_float3(0.f, 0.5f, 0.f)};
+    std::array indices{0u, 1u, 2u};
+    auto vertex_buffer = device.create_buffer<float3>(vertices.size());
+    auto triangle_buffer = device.create_buffer<Triangle>(1u);
+    stream << vertex_buffer.copy_from(vertices.data())
+           << triangle_buffer.copy_from(indices.data());
+
+    auto mesh = device.create_mesh(vertex_buffer, triangle_buffer);
+    auto accel = device.create_accel();
+    accel.emplace_back(mesh);
+
+    // one ray towards the original position, one towards the moved position
+    Kernel1D trace_kernel = [](AccelVar accel, BufferFloat hits) noexcept {
+        auto x = ite(dispatch_x() == 0u, 0.f, 2.f);
+        auto ray = make_ray(make_float3(x, 0.f, 1.f), make_float3(0.f, 0.f, -1.f));
+        auto hit = accel.trace_closest(ray);
+        hits.write(dispatch_x(), ite(hit->miss(), -1.f, hit->committed_ray_t));
+    };
+    auto trace = device.compile(trace_kernel);
+    auto hit_buffer = device.create_buffer<float>(2u);
+
+    std::array<float, 2u> before{};
+    stream << mesh.build()
+           << accel.build()
+           << trace(accel, hit_buffer).dispatch(2u)
+           << hit_buffer.copy_to(before.data())
+           << synchronize();
+
+    // move the vertices and rebuild only the mesh; the instance list of the
+    // accel is unchanged, so the top level must still pick up the new bounds
+    for (auto &v : vertices) { v += make_float3(2.f, 0.f, 0.f); }
+    std::array<float, 2u> after{};
+    stream << vertex_buffer.copy_from(vertices.data())
+           << mesh.build()
+           << accel.build()
+           << trace(accel, hit_buffer).dispatch(2u)
+           << hit_buffer.copy_to(after.data())
+           << synchronize();
+
+    auto ok = before[0] > 0.f && before[1] < 0.f &&
+              after[0] < 0.f && after[1] > 0.f;
+    LUISA_INFO("Before rebuild: {} / {}, after rebuild: {} / {} ({})",
+               before[0], before[1], after[0], after[1], ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,80 @@
+#include <luisa/core/clock.h>
+#include <luisa/core/logging.h>
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/runtime/rtx/accel.h>
+#include <luisa/dsl/syntax.h>
+#include <luisa/dsl/sugar.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+int main(int argc, char *argv[]) {
+
+    log_level_info();
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend>. <backend>: cuda, dx, cpu, metal", argv[0]);
+        exit(1);
+    }
+    Device device = context.create_device(argv[1]);
+    Stream stream = device.create_stream();
+
+    // one small mesh per cell of an n x n grid, all built in a single command list
+    static constexpr uint n = 128u;
+    static constexpr uint mesh_count = n * n;
+    luisa::vector<float3> vertices;
+    vertices.reserve(mesh_count * 3u);
+    for (auto y = 0u; y < n; y++) {
+        for (auto x = 0u; x < n; x++) {
+            auto o = make_float3(static_cast<float>(x), static_cast<float>(y), 0.f);
+            vertices.emplace_back(o + make_float3(.1f, .1f, 0.f));
+            vertices.emplace_back(o + make_float3(.9f, .1f, 0.f));
+            vertices.emplace_back(o + make_float3(.1f, .9f, 0.f));
+        }
+    }
+    std::array indices{0u, 1u, 2u};
+    auto vertex_buffer = device.create_buffer<float3>(vertices.size());
+    auto triangle_buffer = device.create_buffer<Triangle>(1u);
+    stream << vertex_buffer.copy_from(vertices.data())
+           << triangle_buffer.copy_from(indices.data());
+
+    luisa::vector<Mesh> meshes;
+    meshes.reserve(mesh_count);
+    auto accel = device.create_accel();
+    for (auto i = 0u; i < mesh_count; i++) {
+        meshes.emplace_back(device.create_mesh(vertex_buffer.view(i * 3u, 3u), triangle_buffer));
+        accel.emplace_back(meshes.back());
+    }
+
+    Kernel2D trace_kernel = [](AccelVar accel, BufferUInt hits) noexcept {
+        auto coord = dispatch_id().xy();
+        auto p = make_float2(coord) + .3f;
+        auto ray = make_ray(make_float3(p, 1.f), make_float3(0.f, 0.f, -1.f));
+        auto hit = accel.trace_closest(ray);
+        hits.write(coord.y * n + coord.x, ite(hit->miss(), ~0u, hit->inst));
+    };
+    auto trace = device.compile(trace_kernel);
+    auto hit_buffer = device.create_buffer<uint>(mesh_count);
+    luisa::vector<uint> hits(mesh_count);
+
+    Clock clock;
+    CommandList list;
+    for (auto &mesh : meshes) { list << mesh.build(); }
+    // building a mesh twice in a list must not merge the two builds
+    list << meshes.front().build()
+         << accel.build()
+         << trace(accel, hit_buffer).dispatch(n, n)
+         << hit_buffer.copy_to(hits.data());
+    stream << list.commit() << synchronize();
+    LUISA_INFO("Built and traced {} meshes in {} ms.", mesh_count, clock.toc());
+
+    auto mismatches = 0u;
+    for (auto i = 0u; i < mesh_count; i++) {
+        if (hits[i] != i) { mismatches++; }
+    }
+    LUISA_INFO("Mismatched instances: {} ({})", mismatches, mismatches == 0u ? "OK" : "FAILED");
+    return mismatches == 0u ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+#include <luisa/core/clock.h>
+#include <luisa/core/logging.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/runtime/buffer.h>
+#include <luisa/ast/function_serializer.h>
+#include <luisa/dsl/syntax.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+int main(int argc, char *argv[]) {
+
+    log_level_verbose();
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend>. <backend>: cuda, dx, cpu, metal", argv[0]);
+        exit(1);
+    }
+    Device device = context.create_device(argv[1]);
+    Stream stream = device.create_stream();
+
+    static constexpr auto n = 1024u;
+    static constexpr std::array<float, 4> weights{1.f, 2.f, 3.f, 4.f};
+
+    Callable saxpy = [](Float a, Float x, Float y) noexcept {
+        return a * x + y;
+    };
+
+    Kernel1D kernel_def = [&](BufferFloat x, BufferFloat y, Float a) noexcept {
+        Constant w = weights;
+        auto i = dispatch_id().x;
+        auto v = def(0.f);
+        $for (k, 4u) { v += w[k] * x.read(i); };
+        $if (i % 2u == 0u) {
+            y.write(i, saxpy(a, v, y.read(i)));
+        }
+        $else {
+            y.write(i, make_float2(v, a).yx().x);
+        };
+    };
+
+    Clock clock;
+    auto bytes = FunctionSerializer::serialize(kernel_def.function()->function());
+    LUISA_INFO("Serialized kernel ({} bytes) in {} ms.", bytes.size(), clock.toc());
+    LUISA_ASSERT(FunctionSerializer::peek_hash(bytes) == kernel_def.function()->hash(),
+                 "Hash mismatch.");
+    // blobs truncated in the header are rejected without aborting
+    luisa::vector<std::byte> truncated{bytes.begin(), bytes.begin() + sizeof(uint32_t)};
+    LUISA_ASSERT(FunctionSerializer::peek_hash(truncated) == 0u, "Truncated blob accepted.");
+    truncated.emplace_back(static_cast<std::byte>(0x81u));
+    LUISA_ASSERT(FunctionSerializer::peek_hash(truncated) == 0u, "Truncated varint accepted.");
+
+    clock.tic();
+    auto restored = FunctionSerializer::deserialize(bytes);
+    LUISA_INFO("Deserialized kernel in {} ms.", clock.toc());
+    LUISA_ASSERT(restored->hash() == kernel_def.function()->hash(), "Hash mismatch.");
+    LUISA_ASSERT(restored->body()->hash() == kernel_def.function()->body()->hash(),
+                 "Body hash mismatch.");
+
+    // round-trip again, the result should be stable
+    auto bytes2 = FunctionSerializer::serialize(restored->function());
+    LUISA_ASSERT(bytes == bytes2, "Serialization is not stable.");
+
+    // captured resources are moved before the arguments, which the hash has to follow
+    auto offsets = device.create_buffer<float>(n);
+    Kernel1D capture_def = [&](BufferFloat y) noexcept {
+        auto i = dispatch_id().x;
+        y.write(i, y.read(i) + offsets->read(i));
+    };
+    auto capture_restored = FunctionSerializer::deserialize(
+        FunctionSerializer::serialize(capture_def.function()->function()));
+    LUISA_ASSERT(capture_restored->hash() == capture_def.function()->hash(),
+                 "Hash mismatch with captured resources.");
+
+    auto kernel = Kernel1D<Buffer<float>, Buffer<float>, float>::from_function(restored);
+    auto shader = device.compile(kernel);
+
+    luisa::vector<float> host_x(n, 1.f);
+    luisa::vector<float> host_y(n, 2.f);
+    auto x = device.create_buffer<float>(n);
+    auto y = device.create_buffer<float>(n);
+    stream << x.copy_from(host_x.data())
+           << y.copy_from(host_y.data())
+           << shader(x, y, 3.f).dispatch(n)
+           << y.copy_to(host_y.data())
+           << synchronize();
+    for (auto i = 0u; i < n; i++) {
+        auto expected = i % 2u == 0u ? 3.f * 10.f + 2.f : 3.f;
+        LUISA_ASSERT(host_y[i] == expected, "Mismatch at {}: {} vs {}.", i, host_y[i], expected);
+    }
+    LUISA_INFO("OK");
+}
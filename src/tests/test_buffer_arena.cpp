@@ -0,0 +1,95 @@
+#include <thread>
+
+#include <luisa/core/logging.h>
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/runtime/buffer_arena.h>
+#include <luisa/dsl/syntax.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+int main(int argc, char *argv[]) {
+
+    log_level_info();
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend>. <backend>: cuda, dx, cpu, metal", argv[0]);
+        exit(1);
+    }
+    Device device = context.create_device(argv[1]);
+    Stream stream = device.create_stream();
+    BufferArena arena{device, 1_M};
+
+    auto print_statistics = [&](luisa::string_view tag) noexcept {
+        auto stats = arena.statistics();
+        LUISA_INFO("{}: reserved = {}, allocated = {}, cached = {}, pages = {}, dedicated = {}, "
+                   "occupancy = {:.2f}, fragmentation = {:.2f}",
+                   tag, stats.reserved_bytes, stats.allocated_bytes, stats.cached_bytes,
+                   stats.page_count, stats.dedicated_buffer_count,
+                   stats.occupancy(), stats.fragmentation());
+        return stats;
+    };
+
+    // freed blocks are handed out again
+    auto small = arena.allocate<uint>(100u);
+    auto large = arena.allocate<float4>(10000u);
+    auto huge = arena.allocate<float4>(1_M);
+    LUISA_ASSERT(small.handle() == large.handle(), "Small and large blocks should share a page.");
+    LUISA_ASSERT(huge.handle() != small.handle(), "Oversized blocks should get a dedicated buffer.");
+    auto small_offset = small.offset_bytes();
+    auto large_offset = large.offset_bytes();
+    arena.free(small);
+    arena.free(large);
+    arena.free(huge);
+    LUISA_ASSERT(arena.allocate<uint>(128u).offset_bytes() == small_offset, "Small block not reused.");
+    LUISA_ASSERT(arena.allocate<float4>(10000u).offset_bytes() == large_offset, "Large block not reused.");
+    print_statistics("After reuse");
+
+    // transient blocks are recycled once their frame completes
+    Kernel1D fill_kernel = [](BufferUInt buffer, UInt value) noexcept {
+        buffer.write(dispatch_x(), value + dispatch_x());
+    };
+    auto fill = device.compile(fill_kernel);
+    static constexpr auto frame_count = 16u;
+    static constexpr auto n = 4096u;
+    luisa::vector<luisa::vector<uint>> results(frame_count, luisa::vector<uint>(n));
+    for (auto frame = 0u; frame < frame_count; frame++) {
+        auto scratch = arena.allocate_transient<uint>(n);
+        auto output = arena.allocate_transient<uint>(n);
+        CommandList list;
+        list << fill(scratch, frame).dispatch(n)
+             << output.copy_from(scratch)
+             << output.copy_to(results[frame].data());
+        arena.end_frame(list);
+        stream << list.commit();
+    }
+    stream << synchronize();
+    for (auto frame = 0u; frame < frame_count; frame++) {
+        for (auto i = 0u; i < n; i++) {
+            LUISA_ASSERT(results[frame][i] == frame + i, "Mismatch at frame {}, index {}.", frame, i);
+        }
+    }
+    print_statistics("After frames");
+
+    // concurrent allocation and free through the thread caches
+    luisa::vector<std::thread> threads;
+    for (auto t = 0u; t < 4u; t++) {
+        threads.emplace_back([&arena, t] {
+            for (auto i = 0u; i < 1000u; i++) {
+                auto size = 1u + (i * 37u + t * 101u) % 5000u;
+                auto block = arena.allocate<uint>(size);
+                arena.free(block);
+            }
+        });
+    }
+    for (auto &&thread : threads) { thread.join(); }
+    print_statistics("After threads");
+
+    arena.shrink();
+    auto stats = print_statistics("After shrink");
+    LUISA_ASSERT(stats.cached_bytes == 0u, "Cached blocks left after shrink.");
+    LUISA_INFO("OK");
+}
@@ -0,0 +1,117 @@
+#include <cstdlib>
+#include <numeric>
+#include <algorithm>
+
+#include <luisa/core/logging.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/runtime/event.h>
+#include <luisa/runtime/buffer.h>
+#include <luisa/runtime/image.h>
+#include <luisa/runtime/capture.h>
+#include <luisa/dsl/syntax.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+static void set_capture_file(const char *path) noexcept {
+#ifdef _WIN32
+    _putenv_s("LUISA_CAPTURE_FILE", path);
+#else
+    if (path[0] == '\0') {
+        unsetenv("LUISA_CAPTURE_FILE");
+    } else {
+        setenv("LUISA_CAPTURE_FILE", path, 1);
+    }
+#endif
+}
+
+// a small workload touching buffers, images, bound arguments, uniforms and events
+static size_t run_workload(Device &device, uint frame_count) noexcept {
+    static constexpr auto n = 64u * 1024u;
+    static constexpr auto resolution = make_uint2(256u);
+    auto compute_stream = device.create_stream(StreamTag::COMPUTE);
+    auto copy_stream = device.create_stream(StreamTag::COPY);
+    auto event = device.create_event();
+    auto input = device.create_buffer<float>(n);
+    auto output = device.create_buffer<float>(n);
+    auto image = device.create_image<float>(PixelStorage::BYTE4, resolution);
+    auto scale = device.compile<1>([&](Float s) noexcept {
+        auto i = dispatch_id().x;
+        output->write(i, input->read(i) * s);
+    });
+    auto shade = device.compile<2>([](ImageFloat image, Float t) noexcept {
+        auto uv = make_float2(dispatch_id().xy()) / make_float2(dispatch_size().xy());
+        image.write(dispatch_id().xy(), make_float4(uv, sin(t) * .5f + .5f, 1.f));
+    });
+    luisa::vector<float> host_input(n);
+    luisa::vector<float> host_output(n);
+    luisa::vector<std::byte> host_image(image.view().size_bytes());
+    for (auto i = 0u; i < n; i++) { host_input[i] = static_cast<float>(i); }
+    auto command_lists = static_cast<size_t>(0u);
+    for (auto frame = 0u; frame < frame_count; frame++) {
+        auto s = static_cast<float>(frame + 1u);
+        compute_stream << input.copy_from(host_input.data())
+                       << scale(s).dispatch(n)
+                       << shade(image, s).dispatch(resolution)
+                       << event.signal();
+        copy_stream << event.wait()
+                    << output.copy_to(host_output.data())
+                    << image.copy_to(host_image.data())
+                    << synchronize();
+        command_lists += 2u;
+        for (auto i = 0u; i < n; i += 997u) {
+            LUISA_ASSERT(host_output[i] == host_input[i] * s, "Mismatch at {} in frame {}.", i, frame);
+        }
+    }
+    compute_stream << synchronize();
+    return command_lists;
+}
+
+int main(int argc, char *argv[]) {
+
+    log_level_verbose();
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend> [capture file] [repeats]. <backend>: cuda, dx, cpu, metal", argv[0]);
+        exit(1);
+    }
+
+    // without a capture file, capture a small workload and replay it
+    auto path = luisa::string{argc > 2 ? argv[2] : "test_capture_replay.lccap"};
+    auto expected_command_lists = static_cast<size_t>(0u);
+    if (argc <= 2) {
+        set_capture_file(path.c_str());
+        {
+            auto device = context.create_device(argv[1]);
+            expected_command_lists = run_workload(device, 8u);
+        }
+        set_capture_file("");
+    }
+
+    auto device = context.create_device(argv[1]);
+    auto repeats = argc > 3 ? std::max(std::atoi(argv[3]), 1) : 3;
+    CaptureReplayer replayer{device};
+    for (auto r = 0; r < repeats; r++) {
+        auto stats = replayer.replay(path);
+        if (expected_command_lists != 0u) {
+            LUISA_ASSERT(stats.command_list_count == expected_command_lists,
+                         "Replayed {} command lists, expected {}.",
+                         stats.command_list_count, expected_command_lists);
+        }
+        auto frames = luisa::span{stats.frame_milliseconds};
+        auto slowest = std::max_element(frames.begin(), frames.end());
+        auto total = std::accumulate(frames.begin(), frames.end(), 0.);
+        LUISA_INFO("Replay #{}: {} records, {} command lists, {} commands, "
+                   "setup {:.3f} ms, replay {:.3f} ms, {} frames "
+                   "(avg {:.3f} ms, slowest #{} {:.3f} ms).",
+                   r, stats.record_count, stats.command_list_count, stats.command_count,
+                   stats.setup_milliseconds, stats.replay_milliseconds, frames.size(),
+                   frames.empty() ? 0. : total / static_cast<double>(frames.size()),
+                   slowest == frames.end() ? 0 : std::distance(frames.begin(), slowest),
+                   slowest == frames.end() ? 0. : *slowest);
+    }
+    LUISA_INFO("OK");
+}
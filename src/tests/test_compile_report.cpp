@@ -0,0 +1,63 @@
+#include <luisa/core/logging.h>
+#include <luisa/core/compile_report.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/runtime/buffer.h>
+#include <luisa/dsl/syntax.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+int main(int argc, char *argv[]) {
+
+    log_level_verbose();
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend>. <backend>: cuda, dx, cpu, metal", argv[0]);
+        exit(1);
+    }
+    Device device = context.create_device(argv[1]);
+
+    CompileProfiler::set_enabled(true);
+    auto callback_count = 0u;
+    CompileProfiler::set_callback([&callback_count](const ShaderCompileReport &report) noexcept {
+        LUISA_INFO("{}", report.dump());
+        callback_count++;
+    });
+
+    Kernel1D fill = [](BufferFloat x, Float v) noexcept {
+        x.write(dispatch_id().x, v);
+    };
+    Kernel1D saxpy = [](BufferFloat x, BufferFloat y, Float a) noexcept {
+        auto i = dispatch_id().x;
+        y.write(i, a * x.read(i) + y.read(i));
+    };
+
+    auto fill_shader = device.compile(fill);
+    auto report = CompileProfiler::last_report();
+    LUISA_ASSERT(report.has_value() && report->hash == fill.function()->hash(),
+                 "Missing compile report.");
+    LUISA_ASSERT(report->phase_milliseconds("trace") > 0. &&
+                     report->counter("ast.expressions").value_or(0u) > 0u,
+                 "Tracing statistics are not merged into the report.");
+
+    ShaderOption option;
+    option.name = "saxpy";
+    auto saxpy_shader = device.compile(saxpy, option);
+    LUISA_ASSERT(CompileProfiler::last_report()->name == "saxpy",
+                 "Report name mismatch.");
+    LUISA_ASSERT(callback_count == 2u && CompileProfiler::session_reports().size() == 2u,
+                 "Unexpected number of reports.");
+
+    // the backends report their phases and a cache hit when the same kernel is compiled again
+    auto fill_shader_again = device.compile(fill);
+    report = CompileProfiler::last_report();
+    LUISA_ASSERT(report->phase_milliseconds("codegen") > 0. &&
+                     !report->cache_events.empty() && report->cache_hit(),
+                 "Backend phases or cache hits are not reported.");
+
+    LUISA_INFO("{}", CompileProfiler::dump_session());
+    LUISA_INFO("OK");
+}
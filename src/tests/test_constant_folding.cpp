@@ -0,0 +1,109 @@
+#include <luisa/core/logging.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/runtime/buffer.h>
+#include <luisa/dsl/syntax.h>
+#include <luisa/dsl/sugar.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+int main(int argc, char *argv[]) {
+
+    log_level_verbose();
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend>. <backend>: cuda, dx, cpu, metal", argv[0]);
+        exit(1);
+    }
+    Device device = context.create_device(argv[1]);
+    Stream stream = device.create_stream();
+
+    detail::FunctionBuilder::set_constant_folding(true);
+
+    Kernel1D folded_kernel = [](BufferFloat x) noexcept {
+        auto i = dispatch_id().x;
+        auto v = x.read(i);
+        // literal-valued locals are propagated into later reads
+        Float scale = 1.f;
+        scale += 2.f;
+        auto enabled = scale > 1.f;
+        $if (enabled) {
+            x.write(i, v * scale + sqrt(Expr{4.f}));
+        }
+        $else {
+            x.write(i, 0.f);
+        };
+    };
+
+    // kernels that fold to the same AST should hash equal
+    Kernel1D hand_folded_kernel = [](BufferFloat x) noexcept {
+        auto i = dispatch_id().x;
+        auto v = x.read(i);
+        Float scale = 1.f;
+        scale = 3.f;
+        x.write(i, v * 3.f + 2.f);
+    };
+    LUISA_ASSERT(folded_kernel.function()->hash() == hand_folded_kernel.function()->hash(),
+                 "Kernels with propagated locals should hash equal to the hand-folded ones.");
+    Kernel1D branch_kernel = [](BufferFloat x) noexcept {
+        auto i = dispatch_id().x;
+        $if (Expr{true}) { x.write(i, x.read(i) + 1.f); };
+    };
+    Kernel1D straight_kernel = [](BufferFloat x) noexcept {
+        auto i = dispatch_id().x;
+        x.write(i, x.read(i) + 1.f);
+    };
+    LUISA_ASSERT(branch_kernel.function()->hash() == straight_kernel.function()->hash(),
+                 "Kernels with folded branches should hash equal.");
+
+    // removed branches should leave no callables, constants or usages behind
+    Callable add_one = [](Float v) noexcept { return v + 1.f; };
+    Constant<float> table{1.f, 2.f, 3.f, 4.f};
+    Kernel1D dead_call_kernel = [&](BufferFloat x, BufferFloat y) noexcept {
+        auto i = dispatch_id().x;
+        $if (Expr{false}) { y.write(i, add_one(table.read(i % 4u))); };
+        x.write(i, x.read(i) + 1.f);
+    };
+    Kernel1D live_call_kernel = [](BufferFloat x, BufferFloat y) noexcept {
+        auto i = dispatch_id().x;
+        x.write(i, x.read(i) + 1.f);
+    };
+    auto dead_call = dead_call_kernel.function();
+    LUISA_ASSERT(dead_call->hash() == live_call_kernel.function()->hash(),
+                 "Kernels with removed calls should hash equal.");
+    LUISA_ASSERT(dead_call->custom_callables().empty() &&
+                     dead_call->constants().empty() &&
+                     dead_call->variable_usage(dead_call->arguments()[1].uid()) == Usage::NONE,
+                 "Removed branches should not be recorded in the function.");
+
+    Kernel1D dead_loop_kernel = [](BufferFloat x) noexcept {
+        auto i = dispatch_id().x;
+        $for (k, 0u) { x.write(i, cast<float>(k)); };
+        $while (Expr{false}) { x.write(i, 1.f); };
+    };
+    for (auto s : dead_loop_kernel.function()->body()->statements()) {
+        LUISA_ASSERT(s->tag() != Statement::Tag::FOR && s->tag() != Statement::Tag::LOOP,
+                     "Dead loops should be removed.");
+    }
+    for (auto s : folded_kernel.function()->body()->statements()) {
+        LUISA_ASSERT(s->tag() != Statement::Tag::IF, "Constant branches should be removed.");
+    }
+
+    static constexpr auto n = 1024u;
+    luisa::vector<float> host_x(n);
+    for (auto i = 0u; i < n; i++) { host_x[i] = static_cast<float>(i); }
+    auto x = device.create_buffer<float>(n);
+    auto shader = device.compile(folded_kernel);
+    stream << x.copy_from(host_x.data())
+           << shader(x).dispatch(n)
+           << x.copy_to(host_x.data())
+           << synchronize();
+    for (auto i = 0u; i < n; i++) {
+        auto expected = static_cast<float>(i) * 3.f + 2.f;
+        LUISA_ASSERT(host_x[i] == expected, "Mismatch at {}: {} vs {}.", i, host_x[i], expected);
+    }
+    LUISA_INFO("OK");
+}
@@ -0,0 +1,64 @@
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/core/logging.h>
+#include <luisa/core/magic_enum.h>
+#include <luisa/backends/ext/dstorage_ext.hpp>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+int main(int argc, char *argv[]) {
+
+    log_level_info();
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend>. <backend>: cuda, dx, cpu, metal", argv[0]);
+        exit(1);
+    }
+    auto device = context.create_device(argv[1]);
+    auto dstorage_ext = device.extension<DStorageExt>();
+    Stream stream = dstorage_ext->create_stream(DStorageStreamOption{DStorageStreamSource::MemorySource});
+
+    // runs of repeated bytes mixed with noise, with a partial last chunk
+    luisa::vector<std::byte> data(4_M + 123u);
+    auto state = 0x12345678u;
+    for (auto i = 0u; i < data.size(); i++) {
+        state = state * 1664525u + 1013904223u;
+        data[i] = static_cast<std::byte>((state >> 28u) == 0u ? state >> 16u : i / 64u);
+    }
+
+    auto decompress = [&](luisa::vector<std::byte> &compressed, DStorageCompression algorithm) noexcept {
+        luisa::vector<std::byte> result(data.size(), std::byte{0xffu});
+        auto file = dstorage_ext->pin_memory(compressed.data(), compressed.size());
+        stream << file.copy_to(luisa::span{result}, algorithm) << synchronize();
+        return result;
+    };
+
+    auto failed = false;
+    luisa::vector<std::byte> lz4_data;
+    for (auto algorithm : {DStorageCompression::LZ4, DStorageCompression::GDeflate}) {
+        luisa::vector<std::byte> compressed;
+        dstorage_ext->compress(data.data(), data.size(), algorithm,
+                               DStorageCompressionQuality::Default, compressed);
+        if (compressed.empty()) {
+            LUISA_INFO("{}: not supported by the backend, skipped.", to_string(algorithm));
+            continue;
+        }
+        auto ok = decompress(compressed, algorithm) == data;
+        LUISA_INFO("{}: {} -> {} bytes, round trip {}",
+                   to_string(algorithm), data.size(), compressed.size(), ok ? "OK" : "FAILED");
+        failed |= !ok;
+        if (algorithm == DStorageCompression::LZ4) { lz4_data = std::move(compressed); }
+    }
+
+    // a truncated blob must not decode to the original data
+    if (!lz4_data.empty()) {
+        lz4_data.resize(lz4_data.size() / 2u);
+        auto ok = decompress(lz4_data, DStorageCompression::LZ4) != data;
+        LUISA_INFO("Truncated LZ4 data: {}", ok ? "rejected (OK)" : "accepted (FAILED)");
+        failed |= !ok;
+    }
+    return failed ? 1 : 0;
+}
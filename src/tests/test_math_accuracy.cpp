@@ -0,0 +1,108 @@
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include <luisa/core/clock.h>
+#include <luisa/core/logging.h>
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/dsl/syntax.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+// error of v in units in the last place of the float closest to ref
+[[nodiscard]] static double ulp_error(float v, double ref) noexcept {
+    if (std::isnan(ref)) { return std::isnan(v) ? 0. : std::numeric_limits<double>::infinity(); }
+    if (std::abs(ref) > std::numeric_limits<float>::max()) { return std::isinf(v) ? 0. : std::numeric_limits<double>::infinity(); }
+    auto exponent = 0;
+    std::frexp(ref, &exponent);
+    auto ulp = std::ldexp(1., std::max(exponent - 24, -149));
+    return std::abs(static_cast<double>(v) - ref) / ulp;
+}
+
+int main(int argc, char *argv[]) {
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend>. <backend>: cuda, dx, cpu, metal", argv[0]);
+        exit(1);
+    }
+    Device device = context.create_device(argv[1]);
+    Stream stream = device.create_stream();
+
+    static constexpr auto n = 1024u * 1024u;
+    static constexpr auto rounds = 16u;
+    Buffer<float> x_buffer = device.create_buffer<float>(n);
+    Buffer<float> y_buffer = device.create_buffer<float>(n);
+    Buffer<float> result_buffer = device.create_buffer<float>(n);
+    luisa::vector<float> host_x(n);
+    luisa::vector<float> host_y(n);
+    luisa::vector<float> host_result(n);
+
+    // bounds documented in cpu_math.h: 1 ULP for the accurate tier, a few ULPs
+    // for the fast tier (trigonometric arguments here stay below 1e5)
+    static constexpr auto accurate_max_ulp = 1.;
+    static constexpr auto fast_max_ulp = 3.;
+    auto check_bounds = luisa::string_view{argv[1]} == "cpu";
+    auto failed = false;
+
+    // measures the accuracy and the throughput of f on arguments uniformly drawn from the ranges,
+    // with and without fast math
+    auto test = [&](luisa::string_view name, auto &&f, auto &&reference,
+                    float2 x_range, float2 y_range = make_float2(0.f)) noexcept {
+        std::mt19937 random{19260817u};
+        std::uniform_real_distribution<float> x_dist{x_range.x, x_range.y};
+        std::uniform_real_distribution<float> y_dist{y_range.x, y_range.y};
+        for (auto i = 0u; i < n; i++) {
+            host_x[i] = x_dist(random);
+            host_y[i] = y_dist(random);
+        }
+        stream << x_buffer.copy_from(host_x.data())
+               << y_buffer.copy_from(host_y.data());
+        Kernel1D kernel = [&](BufferFloat x, BufferFloat y, BufferFloat result) noexcept {
+            auto i = dispatch_x();
+            result.write(i, f(x.read(i), y.read(i)));
+        };
+        for (auto fast_math : {false, true}) {
+            auto shader = device.compile(kernel, ShaderOption{.enable_fast_math = fast_math});
+            stream << shader(x_buffer, y_buffer, result_buffer).dispatch(n)
+                   << synchronize();
+            Clock clock;
+            for (auto r = 0u; r < rounds; r++) {
+                stream << shader(x_buffer, y_buffer, result_buffer).dispatch(n);
+            }
+            stream << synchronize();
+            auto time = clock.toc();
+            stream << result_buffer.copy_to(host_result.data())
+                   << synchronize();
+            auto max_error = 0.;
+            for (auto i = 0u; i < n; i++) {
+                max_error = std::max(max_error, ulp_error(host_result[i], reference(host_x[i], host_y[i])));
+            }
+            auto ok = !check_bounds || max_error <= (fast_math ? fast_max_ulp : accurate_max_ulp);
+            LUISA_INFO("{:<6} ({}): max error {:.2f} ULP, {:.2f} G evaluations/s{}",
+                       name, fast_math ? "fast" : "accurate", max_error,
+                       static_cast<double>(n) * rounds / (time * 1e-3) * 1e-9,
+                       ok ? "" : " (FAILED)");
+            failed |= !ok;
+        }
+    };
+
+    test("sin", [](Float x, Float) { return sin(x); }, [](double x, double) { return std::sin(x); }, make_float2(-100.f, 100.f));
+    test("cos", [](Float x, Float) { return cos(x); }, [](double x, double) { return std::cos(x); }, make_float2(-100.f, 100.f));
+    test("tan", [](Float x, Float) { return tan(x); }, [](double x, double) { return std::tan(x); }, make_float2(-100.f, 100.f));
+    test("asin", [](Float x, Float) { return asin(x); }, [](double x, double) { return std::asin(x); }, make_float2(-1.f, 1.f));
+    test("acos", [](Float x, Float) { return acos(x); }, [](double x, double) { return std::acos(x); }, make_float2(-1.f, 1.f));
+    test("atan", [](Float x, Float) { return atan(x); }, [](double x, double) { return std::atan(x); }, make_float2(-100.f, 100.f));
+    test("atan2", [](Float x, Float y) { return atan2(y, x); }, [](double x, double y) { return std::atan2(y, x); }, make_float2(-10.f, 10.f), make_float2(-10.f, 10.f));
+    test("exp", [](Float x, Float) { return exp(x); }, [](double x, double) { return std::exp(x); }, make_float2(-80.f, 80.f));
+    test("exp2", [](Float x, Float) { return exp2(x); }, [](double x, double) { return std::exp2(x); }, make_float2(-120.f, 120.f));
+    test("exp10", [](Float x, Float) { return exp10(x); }, [](double x, double) { return std::pow(10., x); }, make_float2(-35.f, 35.f));
+    test("log", [](Float x, Float) { return log(x); }, [](double x, double) { return std::log(x); }, make_float2(1e-3f, 1e3f));
+    test("log2", [](Float x, Float) { return log2(x); }, [](double x, double) { return std::log2(x); }, make_float2(1e-3f, 1e3f));
+    test("log10", [](Float x, Float) { return log10(x); }, [](double x, double) { return std::log10(x); }, make_float2(1e-3f, 1e3f));
+    test("pow", [](Float x, Float y) { return pow(x, y); }, [](double x, double y) { return std::pow(x, y); }, make_float2(0.f, 10.f), make_float2(-20.f, 20.f));
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,143 @@
+#include <luisa/core/logging.h>
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/runtime/rtx/accel.h>
+#include <luisa/dsl/syntax.h>
+#include <luisa/dsl/sugar.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+// an interleaved vertex with the position first, aligned to 16 bytes
+struct PackedVertex {
+    float3 p;
+    float3 n;
+};
+
+LUISA_STRUCT(PackedVertex, p, n) {};
+
+int main(int argc, char *argv[]) {
+
+    log_level_info();
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend>. <backend>: cuda, dx, cpu, metal", argv[0]);
+        exit(1);
+    }
+    Device device = context.create_device(argv[1]);
+    Stream stream = device.create_stream();
+
+    // a wavy grid in [-0.5, 0.5]^2, so that quantization actually changes the hits
+    static constexpr uint n = 32u;
+    luisa::vector<float3> float_vertices;
+    luisa::vector<half4> half_vertices;
+    luisa::vector<short4> snorm_vertices;
+    luisa::vector<PackedVertex> packed_vertices;
+    for (auto y = 0u; y <= n; y++) {
+        for (auto x = 0u; x <= n; x++) {
+            auto p = make_float3(make_float2(uint2{x, y}) / static_cast<float>(n) - 0.5f, 0.f);
+            p.z = 0.1f * std::sin(p.x * 10.f) * std::cos(p.y * 10.f);
+            float_vertices.emplace_back(p);
+            packed_vertices.emplace_back(PackedVertex{p, make_float3(0.f, 0.f, 1.f)});
+            half_vertices.emplace_back(half4{half{p.x}, half{p.y}, half{p.z}, half{0.f}});
+            auto snorm = [](float v) noexcept { return static_cast<short>(std::round(v * 32767.f)); };
+            snorm_vertices.emplace_back(short4{snorm(p.x), snorm(p.y), snorm(p.z), 0});
+        }
+    }
+    luisa::vector<Triangle> triangles;
+    luisa::vector<Triangle16> triangles16;
+    for (auto y = 0u; y < n; y++) {
+        for (auto x = 0u; x < n; x++) {
+            auto i = y * (n + 1u) + x;
+            for (auto t : {Triangle{i, i + 1u, i + n + 2u}, Triangle{i, i + n + 2u, i + n + 1u}}) {
+                triangles.emplace_back(t);
+                triangles16.emplace_back(Triangle16{static_cast<uint16_t>(t.i0),
+                                                    static_cast<uint16_t>(t.i1),
+                                                    static_cast<uint16_t>(t.i2)});
+            }
+        }
+    }
+
+    auto float_vertex_buffer = device.create_buffer<float3>(float_vertices.size());
+    auto half_vertex_buffer = device.create_buffer<half4>(half_vertices.size());
+    auto snorm_vertex_buffer = device.create_buffer<short4>(snorm_vertices.size());
+    auto packed_vertex_buffer = device.create_buffer<PackedVertex>(packed_vertices.size());
+    auto triangle_buffer = device.create_buffer<Triangle>(triangles.size());
+    auto triangle16_buffer = device.create_buffer<Triangle16>(triangles16.size());
+    stream << float_vertex_buffer.copy_from(float_vertices.data())
+           << half_vertex_buffer.copy_from(half_vertices.data())
+           << snorm_vertex_buffer.copy_from(snorm_vertices.data())
+           << packed_vertex_buffer.copy_from(packed_vertices.data())
+           << triangle_buffer.copy_from(triangles.data())
+           << triangle16_buffer.copy_from(triangles16.data());
+
+    luisa::vector<Mesh> meshes;
+    meshes.emplace_back(device.create_mesh(float_vertex_buffer, triangle_buffer));
+    meshes.emplace_back(device.create_mesh(float_vertex_buffer, triangle16_buffer));
+    meshes.emplace_back(device.create_mesh(half_vertex_buffer, triangle16_buffer));
+    meshes.emplace_back(device.create_mesh(snorm_vertex_buffer, triangle16_buffer));
+    meshes.emplace_back(device.create_mesh(packed_vertex_buffer, triangle_buffer));
+    LUISA_ASSERT(meshes[2].vertex_format() == MeshVertexFormat::HALF3 &&
+                     meshes[3].vertex_format() == MeshVertexFormat::SNORM16_3 &&
+                     meshes[4].vertex_format() == MeshVertexFormat::FLOAT3 &&
+                     meshes[1].index_format() == MeshIndexFormat::UINT16,
+                 "Unexpected mesh formats.");
+
+    static constexpr uint resolution = 256u;
+    Kernel2D trace_kernel = [](AccelVar accel, BufferFloat4 hits) noexcept {
+        auto coord = dispatch_id().xy();
+        auto p = (make_float2(coord) + .5f) / make_float2(dispatch_size().xy()) - .5f;
+        auto ray = make_ray(make_float3(p * .9f, 1.f), make_float3(0.f, 0.f, -1.f));
+        auto hit = accel.trace_closest(ray);
+        auto result = def(make_float4(-1.f));
+        $if(!hit->miss()) {
+            result = make_float4(cast<float>(hit->prim), hit->bary.x, hit->bary.y, hit->committed_ray_t);
+        };
+        hits.write(coord.y * dispatch_size_x() + coord.x, result);
+    };
+    auto trace = device.compile(trace_kernel);
+
+    luisa::vector<luisa::vector<float4>> results;
+    auto hit_buffer = device.create_buffer<float4>(resolution * resolution);
+    for (auto &mesh : meshes) {
+        auto accel = device.create_accel();
+        accel.emplace_back(mesh);
+        auto &r = results.emplace_back(resolution * resolution);
+        stream << mesh.build()
+               << accel.build()
+               << trace(accel, hit_buffer).dispatch(resolution, resolution)
+               << hit_buffer.copy_to(r.data())
+               << synchronize();
+    }
+
+    // uint16 indices must match exactly, quantized positions only approximately
+    constexpr std::array names{"float3 + uint32", "float3 + uint16", "half3 + uint16", "snorm16 + uint16",
+                               "interleaved float3 + uint32"};
+    constexpr std::array tolerances{0.f, 0.f, 2e-3f, 1e-4f, 0.f};
+    auto failed = false;
+    for (auto i = 1u; i < results.size(); i++) {
+        auto max_error = 0.f;
+        auto mismatches = 0u;
+        for (auto j = 0u; j < results[i].size(); j++) {
+            auto a = results[0][j];
+            auto b = results[i][j];
+            if ((a.x < 0.f) != (b.x < 0.f)) {
+                mismatches++;
+            } else if (a.x >= 0.f) {
+                max_error = std::max(max_error, std::abs(a.w - b.w));
+            }
+        }
+        // a few rays grazing triangle edges may land on a neighbour after quantization
+        auto ok = max_error <= tolerances[i] + 1e-6f && mismatches <= resolution / 16u;
+        LUISA_INFO("{}: max depth error = {}, coverage mismatches = {} ({})",
+                   names[i], max_error, mismatches, ok ? "OK" : "FAILED");
+        failed |= !ok;
+    }
+    LUISA_INFO("Vertex + index bytes: float3 + uint32 = {}, half3 + uint16 = {}, snorm16 + uint16 = {}",
+               float_vertex_buffer.size_bytes() + triangle_buffer.size_bytes(),
+               half_vertex_buffer.size_bytes() + triangle16_buffer.size_bytes(),
+               snorm_vertex_buffer.size_bytes() + triangle16_buffer.size_bytes());
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,152 @@
+#include <random>
+#include <numeric>
+#include <algorithm>
+
+#include <luisa/core/clock.h>
+#include <luisa/core/logging.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/runtime/buffer.h>
+#include <luisa/algorithms/device_scan.h>
+#include <luisa/algorithms/device_reduce.h>
+#include <luisa/algorithms/device_radix_sort.h>
+#include <luisa/algorithms/device_select.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+int main(int argc, char *argv[]) {
+
+    log_level_verbose();
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend> [count]. <backend>: cuda, dx, cpu, metal", argv[0]);
+        exit(1);
+    }
+    Device device = context.create_device(argv[1]);
+    Stream stream = device.create_stream();
+    auto n = argc > 2 ? static_cast<uint>(std::stoul(argv[2])) : 1000003u;
+
+    DeviceScan<uint> scan{device};
+    DeviceReduce<uint> reduce{device};
+    DeviceRadixSort radix_sort{device};
+    DeviceSelect<uint> select{device};
+
+    std::mt19937 rng{std::random_device{}()};
+    luisa::vector<uint> host_keys(n);
+    luisa::vector<uint> host_values(n);
+    luisa::vector<uint> host_flags(n);
+    for (auto i = 0u; i < n; i++) {
+        host_keys[i] = rng();
+        host_values[i] = i;
+        host_flags[i] = host_keys[i] % 3u == 0u;
+    }
+    auto keys = device.create_buffer<uint>(n);
+    auto values = device.create_buffer<uint>(n);
+    auto flags = device.create_buffer<uint>(n);
+    auto result = device.create_buffer<uint>(n);
+    auto count = device.create_buffer<uint>(1u);
+    stream << keys.copy_from(host_keys.data())
+           << values.copy_from(host_values.data())
+           << flags.copy_from(host_flags.data())
+           << synchronize();
+
+    // runs the primitive once to warm up, then times a second run;
+    // the temporaries of the first run are recycled for the second one
+    BufferArena arena{device};
+    auto time = [&](auto &&record) noexcept {
+        for (auto i = 0u; i < 2u; i++) {
+            CommandList list;
+            record(list, arena);
+            arena.end_frame(list);
+            Clock clock;
+            stream << list.commit() << synchronize();
+            if (i == 1u) { return clock.toc(); }
+        }
+        return 0.;
+    };
+    luisa::vector<uint> host_result(n);
+    luisa::vector<uint> expected(n);
+    Clock clock;
+
+    // exclusive scan
+    auto scan_ms = time([&](CommandList &list, BufferArena &arena) noexcept {
+        scan.exclusive_sum(list, arena, flags, result);
+    });
+    stream << result.copy_to(host_result.data()) << synchronize();
+    clock.tic();
+    std::exclusive_scan(host_flags.cbegin(), host_flags.cend(), expected.begin(), 0u);
+    auto std_scan_ms = clock.toc();
+    LUISA_ASSERT(host_result == expected, "Exclusive scan mismatch.");
+    LUISA_INFO("Scan: {} ms (std::exclusive_scan: {} ms).", scan_ms, std_scan_ms);
+
+    // reduction
+    auto reduce_ms = time([&](CommandList &list, BufferArena &arena) noexcept {
+        reduce.reduce(list, arena, keys, count, ReduceOp::MAX);
+    });
+    auto max_key = 0u;
+    stream << count.copy_to(&max_key) << synchronize();
+    clock.tic();
+    auto expected_max_key = std::reduce(host_keys.cbegin(), host_keys.cend(), 0u,
+                                        [](auto a, auto b) noexcept { return std::max(a, b); });
+    auto std_reduce_ms = clock.toc();
+    LUISA_ASSERT(max_key == expected_max_key, "Reduction mismatch: {} vs {}.", max_key, expected_max_key);
+    LUISA_INFO("Reduce: {} ms (std::reduce: {} ms).", reduce_ms, std_reduce_ms);
+
+    // stream compaction
+    auto select_ms = time([&](CommandList &list, BufferArena &arena) noexcept {
+        select.flagged(list, arena, keys, flags, result, count);
+    });
+    auto selected_count = 0u;
+    stream << result.copy_to(host_result.data()) << count.copy_to(&selected_count) << synchronize();
+    clock.tic();
+    expected.clear();
+    std::copy_if(host_keys.cbegin(), host_keys.cend(), std::back_inserter(expected),
+                 [](auto k) noexcept { return k % 3u == 0u; });
+    auto std_select_ms = clock.toc();
+    LUISA_ASSERT(selected_count == expected.size() &&
+                     std::equal(expected.cbegin(), expected.cend(), host_result.cbegin()),
+                 "Selection mismatch.");
+    LUISA_INFO("Select: {} ms (std::copy_if: {} ms).", select_ms, std_select_ms);
+
+    // radix sort of key-value pairs, restoring the input before the timed run
+    auto sort_ms = time([&](CommandList &list, BufferArena &arena) noexcept {
+        list << keys.copy_from(host_keys.data())
+             << values.copy_from(host_values.data());
+        radix_sort.sort_pairs(list, arena, keys, values);
+    });
+    luisa::vector<uint> sorted_keys(n);
+    stream << keys.copy_to(sorted_keys.data()) << values.copy_to(host_result.data()) << synchronize();
+    clock.tic();
+    expected.resize(n);
+    std::iota(expected.begin(), expected.end(), 0u);
+    std::stable_sort(expected.begin(), expected.end(), [&](auto a, auto b) noexcept {
+        return host_keys[a] < host_keys[b];
+    });
+    auto std_sort_ms = clock.toc();
+    for (auto i = 0u; i < n; i++) {
+        LUISA_ASSERT(host_result[i] == expected[i] && sorted_keys[i] == host_keys[expected[i]],
+                     "Radix sort mismatch at {}.", i);
+    }
+    LUISA_INFO("Radix sort: {} ms (std::stable_sort: {} ms).", sort_ms, std_sort_ms);
+
+    // radix sort of a bit range that is not a multiple of the digit width
+    constexpr auto end_bit = 30u;
+    constexpr auto key_mask = (1u << end_bit) - 1u;
+    time([&](CommandList &list, BufferArena &arena) noexcept {
+        list << keys.copy_from(host_keys.data());
+        radix_sort.sort_keys(list, arena, keys, 0u, end_bit);
+    });
+    stream << keys.copy_to(sorted_keys.data()) << synchronize();
+    std::iota(expected.begin(), expected.end(), 0u);
+    std::stable_sort(expected.begin(), expected.end(), [&](auto a, auto b) noexcept {
+        return (host_keys[a] & key_mask) < (host_keys[b] & key_mask);
+    });
+    for (auto i = 0u; i < n; i++) {
+        LUISA_ASSERT(sorted_keys[i] == host_keys[expected[i]],
+                     "Radix sort of bits [0, {}) mismatch at {}.", end_bit, i);
+    }
+    LUISA_INFO("OK");
+}
@@ -37,4 +37,12 @@ int main(int argc, char *argv[]) {
            << shader().dispatch(128u, 128u);
     stream << printer.retrieve()
            << synchronize();
+
+    // streaming: logs are printed in the background without host synchronization
+    for (auto i = 0u; i < 8u; i++) {
+        stream << shader().dispatch(16u, 16u)
+               << printer.flush();
+    }
+    stream << synchronize();
+    printer.wait_flushed();
 }
@@ -0,0 +1,80 @@
+#include <luisa/core/logging.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/runtime/event.h>
+#include <luisa/runtime/buffer.h>
+#include <luisa/dsl/syntax.h>
+#include <luisa/backends/ext/profiling_ext.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+int main(int argc, char *argv[]) {
+
+    log_level_verbose();
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend>. <backend>: cuda, dx, cpu, metal", argv[0]);
+        exit(1);
+    }
+    Device device = context.create_device(argv[1], nullptr, false, true);
+    auto profiler = device.extension<ProfilingExt>();
+    LUISA_ASSERT(profiler != nullptr, "Profiling extension is not available.");
+
+    Stream compute_stream = device.create_stream(StreamTag::COMPUTE);
+    Stream copy_stream = device.create_stream(StreamTag::COPY);
+    compute_stream.set_name("compute");
+    copy_stream.set_name("copy");
+    Event event = device.create_event();
+
+    static constexpr auto n = 1024u * 1024u;
+    auto fill = device.compile<1>([](BufferUInt buffer) noexcept {
+        auto i = dispatch_id().x;
+        buffer.write(i, i);
+    }, {.name = "fill"});
+    auto square = device.compile<1>([](BufferUInt buffer) noexcept {
+        auto i = dispatch_id().x;
+        auto x = buffer.read(i);
+        buffer.write(i, x * x);
+    }, {.name = "square"});
+
+    auto buffer = device.create_buffer<uint>(n);
+    luisa::vector<uint> host(n);
+    auto callback_count = 0u;
+    for (auto frame = 0u; frame < 4u; frame++) {
+        compute_stream << fill(buffer).dispatch(n)
+                       << square(buffer).dispatch(n)
+                       << square(buffer).dispatch(n)
+                       << [&callback_count] { callback_count++; }
+                       << event.signal();
+        copy_stream << event.wait()
+                    << buffer.copy_to(host.data())
+                    << synchronize();
+    }
+    compute_stream << synchronize();
+    LUISA_ASSERT(callback_count == 4u, "User callbacks are lost.");
+    for (auto i = 0u; i < n; i += 4097u) {
+        auto x = i * i;
+        LUISA_ASSERT(host[i] == x * x, "Mismatch at {}.", i);
+    }
+
+    auto stats = profiler->shader_statistics();
+    for (auto &&s : stats) {
+        auto expected_dispatches = s.name == "square" ? 8u : 4u;
+        LUISA_ASSERT(s.dispatch_count == expected_dispatches,
+                     "Shader '{}' dispatched {} times, expected {}.",
+                     s.name, s.dispatch_count, expected_dispatches);
+        LUISA_ASSERT(s.thread_count == expected_dispatches * n, "Wrong thread count for '{}'.", s.name);
+    }
+    LUISA_INFO("Shader statistics:\n{}", profiler->dump_shader_statistics());
+    auto trace = profiler->chrome_trace();
+    LUISA_ASSERT(trace.find("\"square\"") != luisa::string::npos &&
+                     trace.find("\"memory\"") != luisa::string::npos,
+                 "Trace is missing events.");
+    profiler->dump_chrome_trace("test_profiling.json");
+    profiler->clear();
+    LUISA_ASSERT(profiler->shader_statistics().front().dispatch_count == 0u, "Statistics are not cleared.");
+    LUISA_INFO("OK");
+}
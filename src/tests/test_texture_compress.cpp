@@ -1,3 +1,5 @@
+#include <cmath>
+#include <limits>
 #include <luisa/runtime/stream.h>
 #include <luisa/runtime/image.h>
 #include <luisa/runtime/shader.h>
@@ -7,6 +9,7 @@
 #include <luisa/backends/ext/tex_compress_ext.h>
 #include <luisa/core/clock.h>
 #include <luisa/core/logging.h>
+#include <luisa/core/magic_enum.h>
 #include <luisa/runtime/context.h>
 using namespace luisa;
 using namespace luisa::compute;
@@ -28,28 +31,72 @@ int main(int argc, char *argv[]) {
     Buffer<uint> bc6h_buffer{device.create_buffer<uint>(bc6h_image.view().size_bytes() / sizeof(uint))};
     Buffer<uint> bc7_buffer{device.create_buffer<uint>(bc7_image.view().size_bytes() / sizeof(uint))};
     stream << byte4_image.copy_from(image_pixels) << synchronize();
-    Clock clk;
-    tex_ext->compress_bc6h(stream, byte4_image, bc6h_buffer);
-    tex_ext->compress_bc7(stream, byte4_image, bc7_buffer, 0 /*No need alpha channel*/);
-    stream << synchronize();
-    auto compress_time = clk.toc();
-    LUISA_INFO("Compress {}x{} image spend {} ms", resolution.x, resolution.y, compress_time);
+    auto compress = [&] {
+        Clock clk;
+        tex_ext->compress_bc6h(stream, byte4_image, bc6h_buffer);
+        stream << synchronize();
+        auto bc6h_time = clk.toc();
+        clk.tic();
+        tex_ext->compress_bc7(stream, byte4_image, bc7_buffer, 0 /*No need alpha channel*/);
+        stream << synchronize();
+        auto bc7_time = clk.toc();
+        auto mega_pixels = static_cast<double>(resolution.x) * resolution.y * 1e-6;
+        LUISA_INFO("Compress {}x{} image spend {} ms (BC6H, {:.2f} MPixel/s) and {} ms (BC7, {:.2f} MPixel/s)",
+                   resolution.x, resolution.y, bc6h_time, mega_pixels / (bc6h_time * 1e-3),
+                   bc7_time, mega_pixels / (bc7_time * 1e-3));
+    };
+    // benchmark the quality presets where the backend has them, ending with the best one
+    using Quality = TexCompressExt::Quality;
+    if (tex_ext->set_quality(Quality::Fastest) == TexCompressExt::Result::Success) {
+        for (auto quality : {Quality::Fastest, Quality::Default}) {
+            tex_ext->set_quality(quality);
+            LUISA_INFO("Quality: {}", to_string(quality));
+            compress();
+        }
+        tex_ext->set_quality(Quality::Best);
+        LUISA_INFO("Quality: {}", to_string(Quality::Best));
+    }
+    compress();
     Kernel2D present_kernel = [&](ImageVar<float> image) {
         Var coord = dispatch_id().xy();
         byte4_image->write(coord, make_float4(image.read(coord).xyz(), 1.0f));
     };
     auto present_shader = device.compile(present_kernel);
     luisa::vector<std::byte> host_image(byte4_image.view().size_bytes());
+    // PSNR of the decoded color channels against the source
+    auto failed = false;
+    auto check_quality = [&](const char *format, double min_psnr) noexcept {
+        auto squared_error = 0.;
+        auto max_error = 0;
+        auto decoded = reinterpret_cast<const uint8_t *>(host_image.data());
+        for (auto i = 0u; i < resolution.x * resolution.y; i++) {
+            for (auto c = 0u; c < 3u; c++) {
+                auto e = static_cast<int>(decoded[i * 4u + c]) - static_cast<int>(image_pixels[i * 4u + c]);
+                squared_error += e * e;
+                max_error = std::max(max_error, std::abs(e));
+            }
+        }
+        auto mse = squared_error / (resolution.x * resolution.y * 3.);
+        auto psnr = mse == 0. ? std::numeric_limits<double>::infinity() : 10. * std::log10(255. * 255. / mse);
+        auto ok = psnr >= min_psnr;
+        LUISA_INFO("{}: PSNR = {:.2f} dB, max error = {} ({})", format, psnr, max_error, ok ? "OK" : "FAILED");
+        failed |= !ok;
+    };
     stream
         << bc7_image.copy_from(bc7_buffer.view())
         << present_shader(bc7_image).dispatch(resolution)
         << byte4_image.copy_to(host_image.data())
         << synchronize();
     stbi_write_png("test_bc7_compress.png", resolution.x, resolution.y, 4, host_image.data(), 0);
+    check_quality("BC7", 32.);
     stream
         << bc6h_image.copy_from(bc6h_buffer.view())
         << present_shader(bc6h_image).dispatch(resolution)
         << byte4_image.copy_to(host_image.data())
         << synchronize();
     stbi_write_png("test_bc6h_compress.png", resolution.x, resolution.y, 4, host_image.data(), 0);
+    // BC6H has no alpha and quantizes on a half float scale, so allow more error
+    check_quality("BC6H", 28.);
+    stbi_image_free(image_pixels);
+    return failed ? 1 : 0;
 }
@@ -0,0 +1,96 @@
+#include <luisa/core/clock.h>
+#include <luisa/core/logging.h>
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/runtime/bindless_array.h>
+#include <luisa/dsl/syntax.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+int main(int argc, char *argv[]) {
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend>. <backend>: cuda, dx, cpu, metal", argv[0]);
+        exit(1);
+    }
+    Device device = context.create_device(argv[1]);
+    Stream stream = device.create_stream();
+
+    static constexpr auto image_size = 1024u;
+    static constexpr auto volume_size = 128u;
+    static constexpr auto frame_size = 1024u;
+    static constexpr auto rounds = 8u;
+
+    Image<float> image = device.create_image<float>(PixelStorage::BYTE4, image_size, image_size, 0u);
+    Volume<float> volume = device.create_volume<float>(PixelStorage::HALF4, volume_size, volume_size, volume_size, 0u);
+    Image<float> frame = device.create_image<float>(PixelStorage::BYTE4, frame_size, frame_size);
+
+    // a checkerboard with rings, filled level by level so that every mip has detail to filter
+    Kernel2D fill_image_kernel = [](ImageFloat level) noexcept {
+        auto uv = (make_float2(dispatch_id().xy()) + .5f) / make_float2(dispatch_size().xy());
+        auto checker = cast<float>(((cast<uint>(uv.x * 64.f) ^ cast<uint>(uv.y * 64.f)) & 1u) != 0u);
+        auto rings = sin(length(uv - .5f) * 200.f) * .5f + .5f;
+        level.write(dispatch_id().xy(), make_float4(checker, rings, uv, 1.f));
+    };
+    Kernel3D fill_volume_kernel = [](VolumeFloat level) noexcept {
+        auto uvw = (make_float3(dispatch_id()) + .5f) / make_float3(dispatch_size());
+        auto shells = sin(length(uvw - .5f) * 100.f) * .5f + .5f;
+        level.write(dispatch_id(), make_float4(shells, uvw));
+    };
+
+    // a plane tilted away from the viewer: the footprint grows and stretches towards the horizon
+    Kernel2D sample_image_kernel = [](BindlessVar heap, ImageFloat frame) noexcept {
+        auto p = (make_float2(dispatch_id().xy()) + .5f) / make_float2(dispatch_size().xy());
+        auto depth = 1.f / max(1.f - p.y, 1e-3f);
+        auto uv = make_float2((p.x - .5f) * depth, depth);
+        auto dpdx = make_float2(depth / cast<float>(dispatch_size().x), 0.f);
+        auto dpdy = make_float2((p.x - .5f) * depth * depth, depth * depth) / cast<float>(dispatch_size().y);
+        frame.write(dispatch_id().xy(), heap.tex2d(0u).sample(uv, dpdx, dpdy));
+    };
+    Kernel2D sample_volume_kernel = [](BindlessVar heap, ImageFloat frame) noexcept {
+        auto p = (make_float2(dispatch_id().xy()) + .5f) / make_float2(dispatch_size().xy());
+        auto depth = 1.f / max(1.f - p.y, 1e-3f);
+        auto uvw = make_float3((p.x - .5f) * depth, depth, p.x * .25f);
+        auto dpdx = make_float3(depth / cast<float>(dispatch_size().x), 0.f, .25f / cast<float>(dispatch_size().x));
+        auto dpdy = make_float3((p.x - .5f) * depth * depth, depth * depth, 0.f) / cast<float>(dispatch_size().y);
+        frame.write(dispatch_id().xy(), heap.tex3d(1u).sample(uvw, dpdx, dpdy));
+    };
+
+    auto fill_image = device.compile(fill_image_kernel);
+    auto fill_volume = device.compile(fill_volume_kernel);
+    auto sample_image = device.compile(sample_image_kernel);
+    auto sample_volume = device.compile(sample_volume_kernel);
+
+    for (auto i = 0u; i < image.mip_levels(); i++) {
+        stream << fill_image(image.view(i)).dispatch(image.view(i).size());
+    }
+    for (auto i = 0u; i < volume.mip_levels(); i++) {
+        stream << fill_volume(volume.view(i)).dispatch(volume.view(i).size());
+    }
+    BindlessArray heap = device.create_bindless_array(2u);
+
+    auto benchmark = [&](luisa::string_view name, auto &&shader) noexcept {
+        stream << shader(heap, frame).dispatch(frame_size, frame_size)
+               << synchronize();
+        Clock clock;
+        for (auto r = 0u; r < rounds; r++) {
+            stream << shader(heap, frame).dispatch(frame_size, frame_size);
+        }
+        stream << synchronize();
+        auto time = clock.toc();
+        LUISA_INFO("{}: {:.2f} Msamples/s",
+                   name, static_cast<double>(frame_size * frame_size) * rounds / (time * 1e-3) * 1e-6);
+    };
+
+    for (auto sampler : {Sampler::linear_linear_repeat(), Sampler::anisotropic_repeat()}) {
+        stream << heap.emplace_on_update(0u, image, sampler)
+                      .emplace_on_update(1u, volume, sampler)
+                      .update();
+        auto filter = sampler.filter() == Sampler::Filter::ANISOTROPIC ? "anisotropic" : "trilinear";
+        benchmark(luisa::format("image ({})", filter), sample_image);
+        benchmark(luisa::format("volume ({})", filter), sample_volume);
+    }
+}
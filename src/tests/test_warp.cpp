@@ -0,0 +1,63 @@
+#include <luisa/core/logging.h>
+#include <luisa/runtime/device.h>
+#include <luisa/runtime/context.h>
+#include <luisa/runtime/stream.h>
+#include <luisa/runtime/buffer.h>
+#include <luisa/dsl/syntax.h>
+#include <luisa/dsl/sugar.h>
+
+using namespace luisa;
+using namespace luisa::compute;
+
+int main(int argc, char *argv[]) {
+
+    log_level_verbose();
+
+    Context context{argv[0]};
+    if (argc <= 1) {
+        LUISA_INFO("Usage: {} <backend>. <backend>: cuda, dx, cpu, metal", argv[0]);
+        exit(1);
+    }
+    Device device = context.create_device(argv[1]);
+    Stream stream = device.create_stream();
+
+    // each thread checks the invariants of a fully active warp, which
+    // hold for any warp size as the block size is a multiple of it
+    Kernel1D warp_kernel = [](BufferUInt result) noexcept {
+        set_block_size(256u);
+        auto i = dispatch_id().x;
+        auto n = warp_lane_count();
+        auto lane = warp_lane_id();
+        auto one = def(1u);
+        auto failed = def(0u);
+        $if (warp_active_sum(one) != n) { failed |= 1u << 0u; };
+        $if (warp_prefix_sum(one) != lane) { failed |= 1u << 1u; };
+        $if (warp_active_max(lane) != n - 1u) { failed |= 1u << 2u; };
+        $if (warp_active_min(lane) != 0u) { failed |= 1u << 3u; };
+        $if (warp_active_count_bits(true) != n) { failed |= 1u << 4u; };
+        $if (warp_prefix_count_bits(true) != lane) { failed |= 1u << 5u; };
+        $if (!warp_active_all(true) | warp_active_any(false)) { failed |= 1u << 6u; };
+        $if (warp_first_active_lane() != 0u |
+             warp_is_first_active_lane() != (lane == 0u)) { failed |= 1u << 7u; };
+        $if (warp_read_first_active_lane(i) != i - lane |
+             warp_read_lane(lane, n - 1u) != n - 1u) { failed |= 1u << 8u; };
+        $if (!warp_active_all_equal(i / n) | warp_active_bit_or(one << (lane % 32u)) == 0u) { failed |= 1u << 9u; };
+        // diverged lanes only see each other
+        $if (lane % 2u == 0u) {
+            $if (warp_active_sum(one) != (n + 1u) / 2u) { failed |= 1u << 10u; };
+        };
+        result.write(i, failed);
+    };
+
+    static constexpr auto n = 1024u;
+    auto result = device.create_buffer<uint>(n);
+    luisa::vector<uint> host_result(n);
+    auto shader = device.compile(warp_kernel);
+    stream << shader(result).dispatch(n)
+           << result.copy_to(host_result.data())
+           << synchronize();
+    for (auto i = 0u; i < n; i++) {
+        LUISA_ASSERT(host_result[i] == 0u, "Thread {} failed checks {:#x}.", i, host_result[i]);
+    }
+    LUISA_INFO("OK");
+}
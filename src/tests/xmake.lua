@@ -39,6 +39,17 @@ if get_config("enable_ir") then
 	test_proj('test_autodiff')
 end
 test_proj("test_ast")
+test_proj("test_ast_serialization")
+test_proj("test_constant_folding")
+test_proj("test_compile_report")
+test_proj("test_warp")
+test_proj("test_parallel_primitives")
+test_proj("test_profiling")
+test_proj("test_capture_replay")
+test_proj("test_mesh_formats")
+test_proj("test_accel_blas_update")
+test_proj("test_accel_many_meshes")
+test_proj("test_buffer_arena")
 test_proj("test_atomic")
 test_proj("test_bindless", true)
 test_proj("test_callable")
@@ -69,10 +80,13 @@ test_proj("test_thread_pool")
 test_proj("test_type")
 test_proj("test_raster", true)
 test_proj("test_texture_compress")
+test_proj("test_math_accuracy")
+test_proj("test_texture_sample_benchmark")
 test_proj("test_swapchain", true)
 test_proj("test_swapchain_static", true)
 test_proj("test_select_device", true)
 test_proj("test_dstorage", true)
+test_proj("test_dstorage_compression")
 test_proj("test_indirect", true)
 test_proj("test_texture3d", true)
 test_proj("test_atomic_queue", true)